@@ -0,0 +1,171 @@
+#include <QTimeZone>
+#include <cmath>
+#include <algorithm>
+#include "ArticleSelector.h"
+#include "Logger.h"
+
+
+ArticleSelector::ArticleSelector()
+{
+    m_Random.Seed(m_Info.Seed);
+}
+
+
+// ニュース記事の選択方法に関する設定を指定
+// シード値を指定した場合は、同じ候補プールに対して同じ順序でニュース記事を選択する (再現用)
+void ArticleSelector::setSelectionInfo(const SELECTION_INFO &info)
+{
+    m_Info = info;
+    m_Random.Seed(m_Info.Seed);
+}
+
+
+// タイトルの文字bigram群を取得
+// 空白文字は比較の対象外とする
+QSet<quint32> ArticleSelector::bigrams(const QString &title)
+{
+    QString normalized;
+    normalized.reserve(title.size());
+    for (const auto &ch : title) {
+        if (!ch.isSpace()) normalized.append(ch);
+    }
+
+    QSet<quint32> set;
+    set.reserve(normalized.size());
+    for (auto i = 0; i + 1 < normalized.size(); i++) {
+        set.insert((static_cast<quint32>(normalized.at(i).unicode()) << 16) | normalized.at(i + 1).unicode());
+    }
+
+    return set;
+}
+
+
+// 2つの文字bigram群の類似度 (Jaccard係数)
+double ArticleSelector::similarity(const QSet<quint32> &a, const QSet<quint32> &b)
+{
+    if (a.isEmpty() || b.isEmpty()) return 0.0;
+
+    // 要素数が少ない方を走査する
+    const auto &smaller = a.size() < b.size() ? a : b;
+    const auto &larger  = a.size() < b.size() ? b : a;
+
+    auto common = 0;
+    for (const auto &bigram : smaller) {
+        if (larger.contains(bigram)) common++;
+    }
+
+    return static_cast<double>(common) / static_cast<double>(a.size() + b.size() - common);
+}
+
+
+// 公開日からの経過時間によるスコア (0 - 1)
+// 半減期ごとにスコアは半分になる
+double ArticleSelector::recency(const QString &date, const QDateTime &now) const
+{
+    if (m_Info.HalfLife <= 0.0) return 1.0;
+
+    auto pubDate = QDateTime::fromString(date, "yyyy年M月d日 H時m分");
+    if (!pubDate.isValid()) return 0.5;
+
+    pubDate.setTimeZone(QTimeZone("Asia/Tokyo"));
+
+    auto hours = std::max(static_cast<double>(pubDate.secsTo(now)) / 3600.0, 0.0);
+
+    return std::pow(0.5, hours / m_Info.HalfLife);
+}
+
+
+// ニュース記事のスコアを計算
+// スコア = ニュースサイトの重み × 経過時間によるスコア × (1 - 書き込み済みのタイトルとの最大類似度)^2 × 本文の有無による倍率
+double ArticleSelector::score(const CandidatePool::CANDIDATE &candidate, const QList<QSet<quint32>> &recentTitles, const QDateTime &now) const
+{
+    auto weight = std::max(m_Info.Weights.value(candidate.Source, 1.0), 0.0);
+    if (weight <= 0.0) return 0.0;
+
+    // 公開日から時間が経過したニュース記事も選択される余地を残すため、下限を設ける
+    auto fresh = 0.1 + 0.9 * recency(candidate.Date, now);
+
+    // 直近に書き込んだニュース記事と同じ話題のニュース記事は選択されにくくする
+    auto titleBigrams = bigrams(candidate.Title);
+    auto maxSimilarity = 0.0;
+    for (const auto &recentTitle : recentTitles) {
+        maxSimilarity = std::max(maxSimilarity, similarity(titleBigrams, recentTitle));
+    }
+    auto uniqueness = 1.0 - maxSimilarity;
+
+    auto paragraph = candidate.Paragraph.trimmed().isEmpty() ? m_Info.NoParagraph : 1.0;
+
+    return weight * fresh * uniqueness * uniqueness * paragraph;
+}
+
+
+// 書き込むニュース記事のインデックスを選択
+// 候補プールを1回走査するのみで選択する (O(n))
+int ArticleSelector::select(const QList<CandidatePool::CANDIDATE> &candidates, const QStringList &recentTitles)
+{
+    if (candidates.isEmpty()) return -1;
+
+    const auto count = static_cast<int>(candidates.size());
+
+    // 一様に選択
+    if (m_Info.Mode.compare("uniform", Qt::CaseInsensitive) == 0) {
+        return std::min(static_cast<int>(m_Random.GenerateReal() * count), count - 1);
+    }
+
+    const auto now = QDateTime::currentDateTimeUtc().toTimeZone(QTimeZone("Asia/Tokyo"));
+
+    QList<QSet<quint32>> recentBigrams;
+    recentBigrams.reserve(recentTitles.size());
+    for (const auto &title : recentTitles) {
+        recentBigrams.append(bigrams(title));
+    }
+
+    if (m_Info.Mode.compare("top", Qt::CaseInsensitive) == 0) {
+        // スコアの上位k件を保持して、その中から一様に選択
+        // kは小さいため、スコアの降順を挿入ソートで維持する
+        const auto k = std::max(m_Info.TopK, 1);
+        QList<std::pair<double, int>> top;
+        top.reserve(k + 1);
+
+        for (auto i = 0; i < count; i++) {
+            auto s = score(candidates.at(i), recentBigrams, now);
+            if (top.size() == k && s <= top.last().first) continue;
+
+            auto pos = static_cast<int>(top.size());
+            while (pos > 0 && top.at(pos - 1).first < s) pos--;
+            top.insert(pos, std::make_pair(s, i));
+
+            if (top.size() > k) top.removeLast();
+        }
+
+        if (Logger::isEnabled(Logger::LEVEL_DEBUG)) {
+            for (const auto &entry : std::as_const(top)) {
+                LOG_DEBUG(QString("スコア : %1 : %2").arg(entry.first, 0, 'f', 4).arg(candidates.at(entry.second).Title));
+            }
+        }
+
+        return top.at(std::min(static_cast<int>(m_Random.GenerateReal() * top.size()), static_cast<int>(top.size()) - 1)).second;
+    }
+
+    // スコアに比例した確率で選択 (重み付きリザーバサンプリング)
+    // i番目のニュース記事を、(i番目のスコア / i番目までのスコアの合計) の確率で選択中のニュース記事と置き換える
+    auto total    = 0.0;
+    auto selected = -1;
+    for (auto i = 0; i < count; i++) {
+        auto s = score(candidates.at(i), recentBigrams, now);
+
+        LOG_DEBUG(QString("スコア : %1 : %2").arg(s, 0, 'f', 4).arg(candidates.at(i).Title));
+
+        if (s <= 0.0) continue;
+
+        total += s;
+        if (m_Random.GenerateReal() * total < s) selected = i;
+    }
+
+    // 全てのスコアが0の場合 (全てのニュースサイトの重みが0等) は、一様に選択
+    if (selected < 0) {
+        selected = std::min(static_cast<int>(m_Random.GenerateReal() * count), count - 1);
+    }
+
+    return selected;
+}
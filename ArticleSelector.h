@@ -0,0 +1,49 @@
+#ifndef ARTICLESELECTOR_H
+#define ARTICLESELECTOR_H
+
+#include <QString>
+#include <QList>
+#include <QSet>
+#include <QMap>
+#include <QDateTime>
+#include "CandidatePool.h"
+#include "RandomGenerator.h"
+
+
+// ニュース記事の選択方法に関する設定
+struct SELECTION_INFO {
+    QString                 Mode        = "weighted";   // 選択方法 ("weighted" : スコアに比例した確率で選択、"top" : スコアの上位k件から選択、"uniform" : 一様に選択)
+    int                     TopK        = 3;            // "top"の場合に、候補とするスコアの上位の件数
+    double                  HalfLife    = 3.0;          // 公開日からの経過時間によるスコアの半減期 [時間]
+    double                  NoParagraph = 0.5;          // 本文が無いニュース記事のスコアの倍率
+    int                     History     = 50;           // タイトルの類似度を比較する書き込み済みのニュース記事の件数 (新しい順)
+    quint64                 Seed        = 0;            // 乱数のシード値 (0の場合は起動ごとに異なる値を使用)
+    QMap<QString, double>   Weights;                    // ニュースサイトごとのスコアの倍率 (キーはニュースサイトの設定名、未指定の場合は1.0)
+};
+
+
+// 候補プールから書き込むニュース記事を1つ選択する
+// 各ニュース記事を、公開日からの経過時間、ニュースサイトの重み、書き込み済みのニュース記事とのタイトルの類似度、本文の有無でスコア化して、
+// 候補プールを1回走査するのみで選択する
+class ArticleSelector
+{
+private:    // Variables
+    SELECTION_INFO      m_Info;         // ニュース記事の選択方法に関する設定
+    RandomGenerator     m_Random;       // 乱数生成器 (起動中は同じ内部状態を継続して使用する)
+
+private:    // Methods
+    static QSet<quint32>    bigrams(const QString &title);                                          // タイトルの文字bigram群を取得
+    static double           similarity(const QSet<quint32> &a, const QSet<quint32> &b);             // 2つの文字bigram群の類似度 (Jaccard係数)
+    double                  recency(const QString &date, const QDateTime &now) const;               // 公開日からの経過時間によるスコア (0 - 1)
+
+public:     // Methods
+    ArticleSelector();
+    ~ArticleSelector() = default;
+
+    void            setSelectionInfo(const SELECTION_INFO &info);                                   // ニュース記事の選択方法に関する設定を指定 (乱数のシード値も初期化)
+    double          score(const CandidatePool::CANDIDATE &candidate, const QList<QSet<quint32>> &recentTitles, const QDateTime &now) const;   // ニュース記事のスコアを計算
+    int             select(const QList<CandidatePool::CANDIDATE> &candidates, const QStringList &recentTitles);                              // 書き込むニュース記事のインデックスを選択 (候補が無い場合は-1)
+};
+
+
+#endif // ARTICLESELECTOR_H
@@ -0,0 +1,128 @@
+#include "CandidatePool.h"
+
+
+// ニュース記事を追加
+// 同じURLのニュース記事が既に存在する場合は追加しない
+bool CandidatePool::add(const Article &article, const QString &source, qint64 fetchedAt)
+{
+    CANDIDATE candidate;
+    std::tie(candidate.Title, candidate.Paragraph, candidate.URL, candidate.Date) = article.getArticleData();
+    candidate.Source    = source;
+    candidate.FetchedAt = fetchedAt;
+
+    if (candidate.URL.isEmpty() || m_Candidates.contains(candidate.URL)) {
+        return false;
+    }
+
+    m_Candidates.insert(candidate.URL, candidate);
+    m_TimeIndex.insert(fetchedAt, candidate.URL);
+
+    return true;
+}
+
+
+// 指定されたURLのニュース記事が存在するかどうかを確認
+bool CandidatePool::contains(const QString &url) const
+{
+    return m_Candidates.contains(url);
+}
+
+
+// 指定されたURLのニュース記事を削除
+bool CandidatePool::remove(const QString &url)
+{
+    auto it = m_Candidates.find(url);
+    if (it == m_Candidates.end()) {
+        return false;
+    }
+
+    m_TimeIndex.remove(it->FetchedAt, url);
+    m_Candidates.erase(it);
+
+    return true;
+}
+
+
+// 指定時刻より前に追加したニュース記事を削除
+// 時刻の索引を先頭から走査するため、削除する数に比例した時間で完了する
+int CandidatePool::expire(qint64 olderThan)
+{
+    auto count = 0;
+
+    auto it = m_TimeIndex.begin();
+    while (it != m_TimeIndex.end() && it.key() < olderThan) {
+        m_Candidates.remove(it.value());
+        it = m_TimeIndex.erase(it);
+        count++;
+    }
+
+    return count;
+}
+
+
+// 条件に一致するニュース記事を削除
+int CandidatePool::removeIf(const std::function<bool(const CANDIDATE&)> &predicate)
+{
+    auto count = 0;
+
+    auto it = m_TimeIndex.begin();
+    while (it != m_TimeIndex.end()) {
+        auto candidate = m_Candidates.constFind(it.value());
+        if (candidate != m_Candidates.constEnd() && predicate(*candidate)) {
+            m_Candidates.remove(it.value());
+            it = m_TimeIndex.erase(it);
+            count++;
+        }
+        else {
+            ++it;
+        }
+    }
+
+    return count;
+}
+
+
+// 書き込み候補群を追加した順に取得
+QList<CandidatePool::CANDIDATE> CandidatePool::candidates() const
+{
+    QList<CANDIDATE> list;
+    list.reserve(m_Candidates.size());
+
+    for (auto it = m_TimeIndex.constBegin(); it != m_TimeIndex.constEnd(); ++it) {
+        auto candidate = m_Candidates.constFind(it.value());
+        if (candidate != m_Candidates.constEnd()) {
+            list.append(*candidate);
+        }
+    }
+
+    return list;
+}
+
+
+// 書き込み候補をニュース記事オブジェクトに変換
+Article CandidatePool::toArticle(const CANDIDATE &candidate)
+{
+    return Article(candidate.Title, candidate.Paragraph, candidate.URL, candidate.Date);
+}
+
+
+// 書き込み候補の数
+int CandidatePool::size() const
+{
+    return static_cast<int>(m_Candidates.size());
+}
+
+
+// 書き込み候補が存在しないかどうか
+bool CandidatePool::isEmpty() const
+{
+    return m_Candidates.isEmpty();
+}
+
+
+// 全ての書き込み候補を削除
+void CandidatePool::clear()
+{
+    m_Candidates.clear();
+    m_TimeIndex.clear();
+}
@@ -0,0 +1,49 @@
+#ifndef CANDIDATEPOOL_H
+#define CANDIDATEPOOL_H
+
+#include <QHash>
+#include <QMultiMap>
+#include <QList>
+#include <QString>
+#include <functional>
+#include "Article.h"
+
+
+// 書き込み候補のニュース記事群 (候補プール)
+// 各ニュースサイトから取得したニュース記事を、書き込まれるまで、または、有効期限が切れるまで保持する
+// ニュース記事のURLで重複を排除して、取得した時刻で索引を作成する
+class CandidatePool
+{
+public:     // Variables
+    // 書き込み候補のニュース記事
+    struct CANDIDATE {
+        QString     Title;          // ニュース記事のタイトル
+        QString     Paragraph;      // ニュース記事の本文の一部
+        QString     URL;            // ニュース記事のURL
+        QString     Date;           // ニュース記事の公開日
+        QString     Source;         // 取得元のニュースサイト名
+        qint64      FetchedAt;      // 候補プールに追加した時刻 (エポックタイム) [ミリ秒]
+    };
+
+private:    // Variables
+    QHash<QString, CANDIDATE>   m_Candidates;   // ニュース記事のURLをキーとした書き込み候補群
+    QMultiMap<qint64, QString>  m_TimeIndex;    // 候補プールに追加した時刻をキーとした索引 (値はニュース記事のURL)
+
+public:     // Methods
+    CandidatePool() = default;
+    ~CandidatePool() = default;
+
+    bool                add(const Article &article, const QString &source, qint64 fetchedAt);   // ニュース記事を追加 (既に存在する場合はfalse)
+    bool                contains(const QString &url) const;                                     // 指定されたURLのニュース記事が存在するかどうかを確認
+    bool                remove(const QString &url);                                             // 指定されたURLのニュース記事を削除
+    int                 expire(qint64 olderThan);                                               // 指定時刻より前に追加したニュース記事を削除して、削除した数を返す
+    int                 removeIf(const std::function<bool(const CANDIDATE&)> &predicate);       // 条件に一致するニュース記事を削除して、削除した数を返す
+    QList<CANDIDATE>    candidates() const;                                                     // 書き込み候補群を追加した順に取得
+    static Article      toArticle(const CANDIDATE &candidate);                                  // 書き込み候補をニュース記事オブジェクトに変換
+    [[nodiscard]] int   size() const;                                                           // 書き込み候補の数
+    [[nodiscard]] bool  isEmpty() const;                                                        // 書き込み候補が存在しないかどうか
+    void                clear();                                                                // 全ての書き込み候補を削除
+};
+
+
+#endif // CANDIDATEPOOL_H
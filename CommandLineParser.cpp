@@ -19,6 +19,9 @@ void CommandLineParser::process(const QStringList &arguments)
         else if (arg.startsWith("--sysconf=")) {
             m_SysConfSet  = true;
         }
+        else if (arg.startsWith("--trace=")) {
+            m_TraceSet    = true;
+        }
         else if (arg.startsWith("-")) {
             // 未知のオプションとして扱う
             m_unknownOptionNames.append(arg);
@@ -52,3 +55,9 @@ bool CommandLineParser::isSysConfSet() const
 {
     return m_SysConfSet;
 }
+
+
+bool CommandLineParser::isTraceSet() const
+{
+    return m_TraceSet;
+}
@@ -11,6 +11,7 @@ private:
     bool        m_HelpSet      = false;
     bool        m_VersionSet   = false;
     bool        m_SysConfSet   = false;
+    bool        m_TraceSet     = false;
     QStringList m_unknownOptionNames;
 
 public:
@@ -21,6 +22,7 @@ public:
     bool        isHelpSet()             const;
     bool        isVersionSet()          const;
     bool        isSysConfSet()          const;
+    bool        isTraceSet()            const;
 };
 
 #endif // COMMANDLINEPARSER_H
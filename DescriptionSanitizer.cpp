@@ -0,0 +1,137 @@
+#include <algorithm>
+#include "DescriptionSanitizer.h"
+
+
+// 半角 / 全角数字かどうか
+bool DescriptionSanitizer::isDigit(QChar c)
+{
+    return (c >= u'0' && c <= u'9') || (c >= u'０' && c <= u'９');
+}
+
+
+// 指定位置から連続する半角 / 全角数字の数 (最大max文字)
+qsizetype DescriptionSanitizer::countDigits(QStringView text, qsizetype pos, qsizetype max)
+{
+    qsizetype count = 0;
+    while (count < max && pos + count < text.size() && isDigit(text.at(pos + count))) {
+        count++;
+    }
+
+    return count;
+}
+
+
+// 先頭にあるyyyy年M月d日=<文字数> (全角数字と全角カンマを含む) を削除
+// 正規表現 "^[0-9０-９]{4}年[0-9０-９]{1,2}月[0-9０-９]{1,2}日[=＝][0-9０-９,，]+" と同じ文字列を削除する
+// 一致しない場合は、入力文字列をそのまま返す
+QString DescriptionSanitizer::stripDateline(const QString &text)
+{
+    const QStringView view(text);
+    qsizetype         pos = 0;
+
+    // 年
+    if (countDigits(view, pos, 4) != 4) return text;
+    pos += 4;
+    if (pos >= view.size() || view.at(pos) != u'年') return text;
+    pos++;
+
+    // 月および日
+    for (const auto unit : {u'月', u'日'}) {
+        auto digits = countDigits(view, pos, 2);
+        if (digits == 0) return text;
+        pos += digits;
+
+        if (pos >= view.size() || view.at(pos) != unit) return text;
+        pos++;
+    }
+
+    // "="または"＝"
+    if (pos >= view.size() || (view.at(pos) != u'=' && view.at(pos) != u'＝')) return text;
+    pos++;
+
+    // 文字数 (1文字以上)
+    const auto start = pos;
+    while (pos < view.size() && (isDigit(view.at(pos)) || view.at(pos) == u',' || view.at(pos) == u'，')) {
+        pos++;
+    }
+    if (pos == start) return text;
+
+    return text.mid(pos);
+}
+
+
+// タグ名が一致するかどうか (大文字 / 小文字を区別しない)
+// tagは"<"と">"の間の文字列 (終了タグの場合は先頭の"/"を含む)
+bool DescriptionSanitizer::tagNameIs(QStringView tag, const char *name)
+{
+    qsizetype pos = tag.startsWith(u'/') ? 1 : 0;
+
+    for (; *name != '\0'; name++, pos++) {
+        if (pos >= tag.size() || tag.at(pos).toLower() != QLatin1Char(*name)) return false;
+    }
+
+    // タグ名の直後は、終端、空白、または"/"であること
+    return pos >= tag.size() || tag.at(pos).isSpace() || tag.at(pos) == u'/';
+}
+
+
+// 指定したHTMLタグを除去
+// tableタグおよびaタグは、開始タグから対応する終了タグまで (入れ子を含む) を除去する
+// その他のHTMLタグおよびテキストはそのまま残す
+// "<"の後に">"が存在しない場合は、以降をテキストとして扱う
+QString DescriptionSanitizer::sanitize(const QString &html, int flags)
+{
+    const QStringView view(html);
+    QString           result;
+    result.reserve(html.size());
+
+    int       tableDepth = 0;       // tableタグの入れ子の深さ
+    int       linkDepth  = 0;       // aタグの入れ子の深さ
+    qsizetype nextGt     = -1;      // 次の">"の位置 (各文字を1回のみ検索するため、検索結果を保持する)
+    qsizetype pos        = 0;
+
+    while (pos < view.size()) {
+        // テキスト
+        auto lt = view.indexOf(u'<', pos);
+        if (lt < 0) lt = view.size();
+
+        if (tableDepth == 0 && linkDepth == 0) {
+            result.append(html.constData() + pos, lt - pos);
+        }
+        if (lt >= view.size()) break;
+
+        // タグの終端を検索
+        if (nextGt <= lt) {
+            nextGt = view.indexOf(u'>', lt + 1);
+        }
+        if (nextGt < 0) {
+            // 以降に">"が存在しないため、テキストとして扱う
+            if (tableDepth == 0 && linkDepth == 0) {
+                result.append(html.constData() + lt, view.size() - lt);
+            }
+            break;
+        }
+
+        const auto tag     = view.mid(lt + 1, nextGt - lt - 1);
+        const auto closing = tag.startsWith(u'/');
+        const auto empty   = tag.endsWith(u'/');
+        pos                = nextGt + 1;
+
+        if ((flags & DROP_TABLE) && tagNameIs(tag, "table")) {
+            if (closing) tableDepth = std::max(0, tableDepth - 1);
+            else if (!empty) tableDepth++;
+        }
+        else if ((flags & DROP_LINK) && tagNameIs(tag, "a")) {
+            if (closing) linkDepth = std::max(0, linkDepth - 1);
+            else if (!empty) linkDepth++;
+        }
+        else if ((flags & DROP_BR) && tagNameIs(tag, "br")) {
+            // brタグのみを除去
+        }
+        else if (tableDepth == 0 && linkDepth == 0) {
+            result.append(html.constData() + lt, pos - lt);
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,33 @@
+#ifndef DESCRIPTIONSANITIZER_H
+#define DESCRIPTIONSANITIZER_H
+
+#include <QString>
+#include <QStringView>
+
+
+// RSSの"description"要素に含まれる不要な文字列を除去する
+// 正規表現を使用せず、入力文字列を先頭から1回走査するのみで処理するため、処理時間は入力文字列の長さに比例する (バックトラックが発生しない)
+class DescriptionSanitizer
+{
+public:     // Variables
+    // 除去するHTMLタグ
+    enum FLAG {
+        DROP_TABLE  = 0x01,     // tableタグ (内容も含む)
+        DROP_LINK   = 0x02,     // aタグ (内容も含む)
+        DROP_BR     = 0x04      // brタグ
+    };
+
+private:    // Methods
+    static bool     isDigit(QChar c);                                       // 半角 / 全角数字かどうか
+    static qsizetype countDigits(QStringView text, qsizetype pos, qsizetype max);  // 指定位置から連続する半角 / 全角数字の数 (最大max文字)
+    static bool     tagNameIs(QStringView tag, const char *name);           // タグ名が一致するかどうか (大文字 / 小文字を区別しない)
+
+public:     // Methods
+    DescriptionSanitizer() = delete;
+
+    static QString  stripDateline(const QString &text);                     // 先頭にあるyyyy年M月d日=<文字数> (全角数字と全角カンマを含む) を削除
+    static QString  sanitize(const QString &html, int flags);               // 指定したHTMLタグを除去
+};
+
+
+#endif // DESCRIPTIONSANITIZER_H
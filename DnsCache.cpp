@@ -0,0 +1,250 @@
+#include <QMutexLocker>
+#include <algorithm>
+#include <utility>
+#include "DnsCache.h"
+#include "Logger.h"
+#include "Trace.h"
+
+
+// 静的メンバの初期化
+DnsCache*   DnsCache::m_instance = nullptr;
+QMutex      DnsCache::m_mutex;
+
+
+// Qt内部のQHostInfoキャッシュの有効期間は60[秒]固定で、有効期間内のQHostInfo::lookupHost()はキャッシュを返すのみで名前解決しない
+// また、QHostInfoはDNSレコードのTTLを公開しないため、TTLに基づいて更新することはできない
+// そのため、ホストごとにQt内部のキャッシュが期限切れになった直後に再度名前解決して、キャッシュを更新する
+// これにより、QNetworkAccessManagerが新しく接続する時も、Qt内部のキャッシュから名前解決される
+static constexpr qint64 QT_CACHE_MSEC   = 60 * 1000;        // Qt内部のキャッシュの有効期間 [ミリ秒]
+static constexpr qint64 REFRESH_MSEC    = QT_CACHE_MSEC + 500;  // 名前解決の完了からバックグラウンド更新までの時間 [ミリ秒] (Qt内部のキャッシュの期限切れの直後)
+static constexpr qint64 STALE_MSEC      = 5 * 60 * 1000;    // 名前解決に失敗し続けた場合に、以前のIPアドレス群を使用する期間 [ミリ秒]
+static constexpr qint64 RETRY_MSEC      = 10 * 1000;        // 名前解決に失敗した場合の再試行間隔 [ミリ秒]
+static constexpr qint64 IDLE_MSEC       = 60 * 60 * 1000;   // 設定ファイルに無いホストを削除するまでの未使用の時間 [ミリ秒]
+
+
+DnsCache::DnsCache(QObject *parent) : QObject{parent}
+{
+    m_Clock.start();
+
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &DnsCache::onTimeout);
+}
+
+
+DnsCache::~DnsCache()
+{
+}
+
+
+// シングルトンインスタンスを取得するための静的メソッド
+DnsCache* DnsCache::getInstance()
+{
+    if (m_instance == nullptr) {
+        QMutexLocker locker(&m_mutex);
+
+        if (m_instance == nullptr) {
+            m_instance = new DnsCache();
+        }
+    }
+
+    return m_instance;
+}
+
+
+// DNSキャッシュに関する設定を指定
+void DnsCache::setDnsCacheInfo(const DNSCACHE_INFO &info)
+{
+    m_Info = info;
+
+    if (m_Info.Enable) {
+        prefetch(m_Info.Hosts);
+    }
+    else {
+        m_timer.stop();
+    }
+}
+
+
+// 指定されたホスト群を名前解決して、キャッシュに登録
+// 設定ファイルに記述されているホストのため、使用しない期間が続いても削除しない
+void DnsCache::prefetch(const QStringList &hosts)
+{
+    for (const auto &host : hosts) {
+        insertHost(host, true);
+    }
+}
+
+
+// 未登録のホストの場合は、名前解決してキャッシュに登録
+// 登録済みの場合は、最後に使用した時刻のみを更新する
+void DnsCache::addHost(const QString &host)
+{
+    insertHost(host, false);
+}
+
+
+// ホストをキャッシュに登録
+void DnsCache::insertHost(const QString &host, bool pinned)
+{
+    if (!m_Info.Enable || host.isEmpty()) return;
+
+    // IPアドレスが指定されている場合は、名前解決しない
+    if (!QHostAddress(host).isNull()) return;
+
+    const auto key = host.toLower();
+    {
+        QMutexLocker locker(&m_mutex);
+
+        auto it = m_Entries.find(key);
+        if (it != m_Entries.end()) {
+            it->LastUsed = m_Clock.elapsed();
+            it->Pinned   = it->Pinned || pinned;
+
+            return;
+        }
+
+        ENTRY entry;
+        entry.LastUsed = m_Clock.elapsed();
+        entry.Pinned   = pinned;
+        m_Entries.insert(key, entry);
+    }
+
+    resolve(key);
+}
+
+
+// キャッシュからIPアドレス群を取得
+// 一定期間名前解決に失敗し続けた場合、または、未登録の場合は空のリストを返す (呼び出し元で通常の名前解決を行う)
+QList<QHostAddress> DnsCache::lookup(const QString &host)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_Entries.constFind(host.toLower());
+    if (it == m_Entries.constEnd() || it->Expire <= m_Clock.elapsed()) {
+        return {};
+    }
+
+    return it->Addresses;
+}
+
+
+// 非同期で名前解決する
+// Qt内部のキャッシュが期限切れの場合のみ実際に名前解決されて、Qt内部のキャッシュも更新される
+void DnsCache::resolve(const QString &host)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+
+        auto it = m_Entries.find(host);
+        if (it == m_Entries.end() || it->Resolving) return;
+
+        it->Resolving = true;
+        it->RefreshAt = m_Clock.elapsed() + REFRESH_MSEC;
+    }
+
+    // トレースが有効の場合は、名前解決の所要時間を記録
+    const auto traceStart = Trace::isEnabled() ? Trace::getInstance()->now() : -1;
+    QHostInfo::lookupHost(host, this, [this, host, traceStart](const QHostInfo &info) {
+        if (traceStart >= 0) Trace::getInstance()->completeAsync("net", "DNS", traceStart, host);
+        onHostInfo(info);
+    });
+}
+
+
+// 名前解決が完了した時の処理
+void DnsCache::onHostInfo(const QHostInfo &info)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_Entries.find(info.hostName().toLower());
+    if (it == m_Entries.end()) return;
+
+    it->Resolving = false;
+
+    if (info.error() != QHostInfo::NoError || info.addresses().isEmpty()) {
+        // 名前解決に失敗した場合は、以前のIPアドレス群を有効期限まで使用して、短い間隔で再試行する
+        LOG_WARNING(QString("%1 の名前解決に失敗 (%2)").arg(info.hostName(), info.errorString()));
+        it->RefreshAt = m_Clock.elapsed() + RETRY_MSEC;
+        locker.unlock();
+
+        schedule();
+
+        return;
+    }
+
+    // Qt内部のキャッシュが更新された時刻から、バックグラウンド更新の時刻を決める
+    // (resolve()メソッドの時点で設定した時刻は、名前解決の所要時間の分だけ早い)
+    const auto now = m_Clock.elapsed();
+    it->Addresses  = info.addresses();
+    it->Expire     = now + STALE_MSEC;
+    it->RefreshAt  = now + REFRESH_MSEC;
+
+    if (Logger::isEnabled(Logger::LEVEL_DEBUG)) {
+        QStringList addresses;
+        for (const auto &address : std::as_const(it->Addresses)) addresses.append(address.toString());
+        LOG_DEBUG(QString("DNSキャッシュ : %1").arg(info.hostName()), {{"addresses", addresses.join(",")}});
+    }
+
+    locker.unlock();
+
+    schedule();
+}
+
+
+// 次に期限を迎えるホスト (バックグラウンド更新の時刻、または、未使用のホストを削除する時刻) にタイマを設定
+// 名前解決中のホストは、名前解決の完了時に再度設定する
+void DnsCache::schedule()
+{
+    qint64 next = -1;
+    {
+        QMutexLocker locker(&m_mutex);
+
+        for (auto it = m_Entries.cbegin(); it != m_Entries.cend(); ++it) {
+            if (it->Resolving) continue;
+
+            auto due = it->RefreshAt;
+            if (!it->Pinned) due = std::min(due, it->LastUsed + IDLE_MSEC + 1);
+
+            if (next < 0 || due < next) next = due;
+        }
+    }
+
+    if (!m_Info.Enable || next < 0) {
+        m_timer.stop();
+        return;
+    }
+
+    m_timer.start(static_cast<int>(std::max<qint64>(next - m_Clock.elapsed(), 0)));
+}
+
+
+// バックグラウンド更新の時刻を迎えたホスト (Qt内部のキャッシュが期限切れになったホスト) を再度名前解決する
+// 設定ファイルに無いホスト (ニュース記事のリンク先等) は、一定時間使用しない場合は削除する
+void DnsCache::onTimeout()
+{
+    QStringList hosts;
+    {
+        QMutexLocker locker(&m_mutex);
+
+        const auto now = m_Clock.elapsed();
+        for (auto it = m_Entries.begin(); it != m_Entries.end();) {
+            if (!it->Pinned && !it->Resolving && now - it->LastUsed > IDLE_MSEC) {
+                it = m_Entries.erase(it);
+                continue;
+            }
+
+            if (!it->Resolving && it->RefreshAt <= now) {
+                hosts.append(it.key());
+            }
+
+            ++it;
+        }
+    }
+
+    for (const auto &host : std::as_const(hosts)) {
+        resolve(host);
+    }
+
+    // 次に期限を迎えるホストの時刻にタイマを設定
+    schedule();
+}
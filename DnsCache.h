@@ -0,0 +1,67 @@
+#ifndef DNSCACHE_H
+#define DNSCACHE_H
+
+#include <QObject>
+#include <QMutex>
+#include <QMap>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QHostInfo>
+#include <QHostAddress>
+
+
+// DNSキャッシュに関する設定
+struct DNSCACHE_INFO {
+    bool            Enable  = true;     // DNSキャッシュの有効 / 無効
+    QStringList     Hosts;              // 設定ファイルのURL以外に、起動時に名前解決するホスト名 (NTPサーバ等)
+};
+
+
+class DnsCache : public QObject
+{
+    Q_OBJECT
+
+private:    // Variables
+    // ホストごとの名前解決の結果
+    struct ENTRY {
+        QList<QHostAddress> Addresses;              // 名前解決したIPアドレス群
+        qint64              Expire      = 0;        // IPアドレス群の有効期限 [ミリ秒] (lookup()メソッドで使用する)
+        qint64              RefreshAt   = 0;        // 次回の名前解決 (バックグラウンド更新) の時刻 [ミリ秒]
+        qint64              LastUsed    = 0;        // 最後にリクエストを送信した時刻 [ミリ秒]
+        bool                Pinned      = false;    // 設定ファイルに記述されているホストかどうか (削除しない)
+        bool                Resolving   = false;    // 名前解決中かどうか
+    };
+
+    static DnsCache             *m_instance;    // 静的インスタンスポインタ
+    static QMutex               m_mutex;        // シングルトンとキャッシュの操作用のミューテックス
+
+    DNSCACHE_INFO               m_Info;         // DNSキャッシュに関する設定
+    QMap<QString, ENTRY>        m_Entries;      // ホスト名をキーとした名前解決の結果
+    QTimer                      m_timer;        // 次に期限を迎えるホストのバックグラウンド更新 (または削除) 用のシングルショットタイマ
+    QElapsedTimer               m_Clock;        // 有効期限の計測に使用する単調増加の時計
+
+private:    // Methods
+    explicit DnsCache(QObject *parent = nullptr);                           // プライベートコンストラクタ
+    ~DnsCache() override;                                                   // プライベートデストラクタ
+
+    void            insertHost(const QString &host, bool pinned);           // ホストをキャッシュに登録 (未登録の場合は名前解決する)
+    void            resolve(const QString &host);                           // 非同期で名前解決
+    void            onHostInfo(const QHostInfo &info);                      // 名前解決が完了した時の処理
+    void            schedule();                                             // 次に期限を迎えるホストの時刻にタイマを設定
+
+private slots:
+    void            onTimeout();                                            // 期限を迎えたホストを再度名前解決する (未使用のホストは削除する)
+
+public:     // Methods
+    DnsCache(const DnsCache&)             = delete;                         // コピーコンストラクタの禁止
+    DnsCache& operator=(const DnsCache&)  = delete;                         // 代入の禁止
+
+    static DnsCache* getInstance();                                         // シングルトンインスタンスを取得するための静的メソッド
+    void            setDnsCacheInfo(const DNSCACHE_INFO &info);             // DNSキャッシュに関する設定を指定
+    void            prefetch(const QStringList &hosts);                     // 指定されたホスト群を名前解決して、キャッシュに登録
+    void            addHost(const QString &host);                           // 未登録のホストの場合は、名前解決してキャッシュに登録 (一定時間使用しない場合は削除する)
+    QList<QHostAddress> lookup(const QString &host);                        // キャッシュからIPアドレス群を取得 (有効期限切れ、または、未登録の場合は空)
+};
+
+
+#endif // DNSCACHE_H
@@ -0,0 +1,241 @@
+#include <QTimeZone>
+#include <algorithm>
+#include <bitset>
+#include "DuplicateIndex.h"
+
+
+// 64ビットの値を撹拌する (SplitMix64の最終段)
+static inline quint64 mix64(quint64 x)
+{
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+
+    return x;
+}
+
+
+// 2つのフィンガープリントのハミング距離
+static inline int hammingDistance(quint64 a, quint64 b)
+{
+    return static_cast<int>(std::bitset<64>(a ^ b).count());
+}
+
+
+DuplicateIndex::DuplicateIndex() : m_NextId(1)
+{
+}
+
+
+// 類似ニュース記事の検出に関する設定を指定
+// 帯の数が変わるため、登録済みのニュース記事は削除する (呼び出し元で再作成すること)
+void DuplicateIndex::setDedupInfo(const DEDUP_INFO &info)
+{
+    m_Info          = info;
+    m_Info.Distance = std::clamp(m_Info.Distance, 0, 7);
+
+    m_Entries.clear();
+    m_Buckets.clear();
+    m_TimeIndex.clear();
+}
+
+
+// NFKC正規化、大文字 / 小文字の統一、空白および記号の除去
+// NFKC正規化により、全角英数字は半角に、半角カタカナは全角に統一される
+QString DuplicateIndex::normalize(const QString &text)
+{
+    auto folded = text.normalized(QString::NormalizationForm_KC).toCaseFolded();
+
+    QString normalized;
+    normalized.reserve(folded.size());
+    for (const auto &ch : std::as_const(folded)) {
+        if (ch.isSpace() || ch.isPunct() || ch.isSymbol()) continue;
+        normalized.append(ch);
+    }
+
+    return normalized;
+}
+
+
+// 正規化した文字列の文字bigramからSimHashを生成
+// 各文字bigramのハッシュ値の各ビットについて、1の場合は+1、0の場合は-1を加算して、合計が正のビットを1とする
+quint64 DuplicateIndex::simhash(const QString &text)
+{
+    auto normalized = normalize(text);
+    if (normalized.size() < 2) return 0;
+
+    int votes[64] = {};
+    for (auto i = 0; i + 1 < normalized.size(); i++) {
+        auto bigram = (static_cast<quint64>(normalized.at(i).unicode()) << 16) | normalized.at(i + 1).unicode();
+        auto hash   = mix64(bigram + 0x9E3779B97F4A7C15ULL);
+
+        for (auto bit = 0; bit < 64; bit++) {
+            votes[bit] += ((hash >> bit) & 1) ? 1 : -1;
+        }
+    }
+
+    quint64 fingerprint = 0;
+    for (auto bit = 0; bit < 64; bit++) {
+        if (votes[bit] > 0) fingerprint |= (1ULL << bit);
+    }
+
+    // 0は"フィンガープリント無し"として使用するため、避ける
+    return fingerprint == 0 ? 1 : fingerprint;
+}
+
+
+// フィンガープリントの帯の数
+// 許容するハミング距離がdの場合、d + 1個の帯に分割すれば、類似のフィンガープリントは少なくとも1つの帯が一致する
+int DuplicateIndex::bands() const
+{
+    return m_Info.Distance + 1;
+}
+
+
+// バケットのキー
+// 種類 (タイトル / 本文)、帯の番号、帯の値から生成する (衝突した場合も、比較時にハミング距離を確認するため問題ない)
+quint64 DuplicateIndex::bucketKey(bool paragraph, int band, quint64 fingerprint) const
+{
+    const auto count = bands();
+    const auto width = 64 / count;
+    const auto shift = band * width;
+    const auto bits  = (band == count - 1) ? (64 - shift) : width;
+    const auto mask  = bits >= 64 ? ~0ULL : ((1ULL << bits) - 1);
+    const auto value = (fingerprint >> shift) & mask;
+
+    return mix64(value ^ (static_cast<quint64>(band) << 56) ^ (paragraph ? (1ULL << 63) : 0));
+}
+
+
+// バケットに登録
+void DuplicateIndex::insertBuckets(quint64 id, const ENTRY &entry)
+{
+    for (auto band = 0; band < bands(); band++) {
+        if (entry.Title != 0)     m_Buckets[bucketKey(false, band, entry.Title)].append(id);
+        if (entry.Paragraph != 0) m_Buckets[bucketKey(true,  band, entry.Paragraph)].append(id);
+    }
+}
+
+
+// バケットから削除
+void DuplicateIndex::removeBuckets(quint64 id, const ENTRY &entry)
+{
+    auto removeFrom = [this, id](quint64 key) {
+        auto it = m_Buckets.find(key);
+        if (it == m_Buckets.end()) return;
+
+        it->removeOne(id);
+        if (it->isEmpty()) m_Buckets.erase(it);
+    };
+
+    for (auto band = 0; band < bands(); band++) {
+        if (entry.Title != 0)     removeFrom(bucketKey(false, band, entry.Title));
+        if (entry.Paragraph != 0) removeFrom(bucketKey(true,  band, entry.Paragraph));
+    }
+}
+
+
+// ニュース記事を索引に登録
+void DuplicateIndex::add(const QString &title, const QString &paragraph, qint64 time)
+{
+    if (!m_Info.Enable) return;
+
+    ENTRY entry;
+    entry.Title     = simhash(title);
+    entry.Paragraph = simhash(paragraph);
+    entry.Time      = time;
+
+    if (entry.Title == 0 && entry.Paragraph == 0) return;
+
+    const auto id = m_NextId++;
+    m_Entries.insert(id, entry);
+    m_TimeIndex.insert(time, id);
+    insertBuckets(id, entry);
+}
+
+
+// 書き込み済みのニュース記事群から索引を再作成
+// 書き込んだ時刻はログファイルに無いため、ニュース記事の公開日を使用する
+void DuplicateIndex::rebuild(const QList<Article> &articles)
+{
+    m_Entries.clear();
+    m_Buckets.clear();
+    m_TimeIndex.clear();
+
+    if (!m_Info.Enable) return;
+
+    const auto now = QDateTime::currentSecsSinceEpoch();
+    for (const auto &article : articles) {
+        QString title, paragraph, date;
+        std::tie(title, paragraph, std::ignore, date) = article.getArticleData();
+
+        auto pubDate = QDateTime::fromString(date, "yyyy年M月d日 H時m分");
+        pubDate.setTimeZone(QTimeZone("Asia/Tokyo"));
+
+        add(title, paragraph, pubDate.isValid() ? pubDate.toSecsSinceEpoch() : now);
+    }
+
+    expire(now);
+}
+
+
+// 比較する期間を過ぎたニュース記事を削除
+void DuplicateIndex::expire(qint64 now)
+{
+    const auto since = now - static_cast<qint64>(m_Info.Hours) * 60 * 60;
+
+    auto it = m_TimeIndex.begin();
+    while (it != m_TimeIndex.end() && it.key() < since) {
+        auto entry = m_Entries.constFind(it.value());
+        if (entry != m_Entries.constEnd()) {
+            removeBuckets(it.value(), *entry);
+            m_Entries.erase(entry);
+        }
+
+        it = m_TimeIndex.erase(it);
+    }
+}
+
+
+// 指定時刻以降に登録した類似のフィンガープリントが存在するかどうか
+// フィンガープリントの各帯に対応するバケットのみを比較する
+bool DuplicateIndex::findNear(bool paragraph, quint64 fingerprint, qint64 since) const
+{
+    for (auto band = 0; band < bands(); band++) {
+        auto bucket = m_Buckets.constFind(bucketKey(paragraph, band, fingerprint));
+        if (bucket == m_Buckets.constEnd()) continue;
+
+        for (const auto &id : *bucket) {
+            auto entry = m_Entries.constFind(id);
+            if (entry == m_Entries.constEnd() || entry->Time < since) continue;
+
+            auto other = paragraph ? entry->Paragraph : entry->Title;
+            if (other != 0 && hammingDistance(fingerprint, other) <= m_Info.Distance) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+// 書き込み済みのニュース記事と類似しているかどうか
+// タイトル、または、本文 (指定した場合のみ) のいずれかが類似している場合は、類似と見なす
+// 比較する期間を過ぎたニュース記事は比較しない (索引からの削除は、expire()メソッドで行う)
+bool DuplicateIndex::isDuplicate(const QString &title, const QString &paragraph) const
+{
+    if (!m_Info.Enable || m_Entries.isEmpty()) return false;
+
+    const auto since = QDateTime::currentSecsSinceEpoch() - static_cast<qint64>(m_Info.Hours) * 60 * 60;
+
+    auto titleHash = simhash(title);
+    if (titleHash != 0 && findNear(false, titleHash, since)) return true;
+
+    auto paragraphHash = simhash(paragraph);
+    if (paragraphHash != 0 && findNear(true, paragraphHash, since)) return true;
+
+    return false;
+}
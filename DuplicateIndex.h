@@ -0,0 +1,62 @@
+#ifndef DUPLICATEINDEX_H
+#define DUPLICATEINDEX_H
+
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QMultiMap>
+#include <QDateTime>
+#include "Article.h"
+
+
+// 類似ニュース記事の検出に関する設定
+struct DEDUP_INFO {
+    bool    Enable      = true;     // 類似ニュース記事の検出の有効 / 無効
+    int     Hours       = 6;        // 書き込み済みのニュース記事と比較する期間 [時間]
+    int     Distance    = 3;        // 類似と見なすフィンガープリントのハミング距離の最大値 (0 - 7)
+};
+
+
+// 書き込み済みのニュース記事の類似度の索引
+// タイトルおよび本文をNFKC正規化 (全角 / 半角の統一) した後、文字bigramからSimHash (64ビット) を生成する
+// フィンガープリントを (許容するハミング距離 + 1) 個の帯に分割して、帯ごとの値をキーとするバケットに登録する
+// 鳩の巣原理により、ハミング距離が許容値以内のフィンガープリントは少なくとも1つの帯が一致するため、同じバケットのみを比較すればよい
+class DuplicateIndex
+{
+private:    // Variables
+    // 索引に登録したニュース記事
+    struct ENTRY {
+        quint64     Title       = 0;    // タイトルのフィンガープリント
+        quint64     Paragraph   = 0;    // 本文のフィンガープリント (本文が無い場合は0)
+        qint64      Time        = 0;    // 登録した時刻 (エポックタイム) [秒]
+    };
+
+    DEDUP_INFO                      m_Info;         // 類似ニュース記事の検出に関する設定
+    QHash<quint64, ENTRY>           m_Entries;      // 識別番号をキーとした登録済みのニュース記事
+    QHash<quint64, QList<quint64>>  m_Buckets;      // 帯の値をキーとしたバケット (値は識別番号群)
+    QMultiMap<qint64, quint64>      m_TimeIndex;    // 登録した時刻をキーとした索引 (値は識別番号)
+    quint64                         m_NextId;       // 次に登録するニュース記事の識別番号
+
+private:    // Methods
+    [[nodiscard]] int   bands() const;                                              // フィンガープリントの帯の数
+    [[nodiscard]] quint64 bucketKey(bool paragraph, int band, quint64 fingerprint) const;   // バケットのキー (種類、帯の番号、帯の値から生成)
+    void                insertBuckets(quint64 id, const ENTRY &entry);              // バケットに登録
+    void                removeBuckets(quint64 id, const ENTRY &entry);              // バケットから削除
+    bool                findNear(bool paragraph, quint64 fingerprint, qint64 since) const;  // 指定時刻以降に登録した類似のフィンガープリントが存在するかどうか
+
+public:     // Methods
+    DuplicateIndex();
+    ~DuplicateIndex() = default;
+
+    static QString      normalize(const QString &text);                             // NFKC正規化、大文字 / 小文字の統一、空白および記号の除去
+    static quint64      simhash(const QString &text);                               // 正規化した文字列の文字bigramからSimHashを生成 (2文字未満の場合は0)
+
+    void                setDedupInfo(const DEDUP_INFO &info);                       // 類似ニュース記事の検出に関する設定を指定
+    void                add(const QString &title, const QString &paragraph, qint64 time);   // ニュース記事を索引に登録
+    void                rebuild(const QList<Article> &articles);                    // 書き込み済みのニュース記事群から索引を再作成
+    void                expire(qint64 now);                                         // 比較する期間を過ぎたニュース記事を削除
+    [[nodiscard]] bool  isDuplicate(const QString &title, const QString &paragraph = QString()) const;  // 書き込み済みのニュース記事と類似しているかどうか
+};
+
+
+#endif // DUPLICATEINDEX_H
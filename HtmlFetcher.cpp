@@ -9,18 +9,27 @@
 #include <libxml/parser.h>
 #include <libxml/xpath.h>
 #include <iconv.h>
-#include <iostream>
+#include <QEventLoop>
+#include <QPointer>
 #include "HtmlFetcher.h"
+#include "Logger.h"
+#include "SourceHealth.h"
+#include "RateLimiter.h"
+#include "TlsSessionCache.h"
+#include "TextNormalizer.h"
+#include "ParserPool.h"
+#include "NetworkManager.h"
+#include "Trace.h"
 
 
-HtmlFetcher::HtmlFetcher(QObject *parent) : m_pManager(std::make_unique<QNetworkAccessManager>(this)), QObject{parent}
+HtmlFetcher::HtmlFetcher(QObject *parent) : m_pManager(std::make_unique<NetworkManager>(this)), QObject{parent}
 {
 
 }
 
 
 HtmlFetcher::HtmlFetcher(long long maxParagraph, QObject *parent) : m_MaxParagraph(maxParagraph),
-    m_pManager(std::make_unique<QNetworkAccessManager>(this)), QObject{parent}
+    m_pManager(std::make_unique<NetworkManager>(this)), QObject{parent}
 {
 
 }
@@ -32,7 +41,10 @@ HtmlFetcher::~HtmlFetcher() = default;
 // 指定されたURLが存在するかどうかを確認する
 bool HtmlFetcher::checkUrlExistence(const QUrl &url)
 {
-    QNetworkAccessManager manager;
+    TraceSpan span("html", "HtmlFetcher::checkUrlExistence");
+    if (span) span.setArg(url.toString());
+
+    NetworkManager manager;
 
     // HEADリクエストの作成
     QNetworkRequest request(url);
@@ -40,13 +52,18 @@ bool HtmlFetcher::checkUrlExistence(const QUrl &url)
     // リダイレクトの無効
     request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, false);
 
+    // 前回のTLSセッションチケットが存在する場合は、TLSセッションを再開する
+    TlsSessionCache::getInstance()->apply(request);
+
     // HEADを取得
+    RateLimiter::getInstance()->acquire(url);
     QNetworkReply *pReply = manager.get(request);
 
     // レスポンス待機
     QEventLoop loop;
     QObject::connect(pReply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
     loop.exec();
+    TlsSessionCache::getInstance()->store(pReply);
 
     // レスポンスの確認
     // 例: Webサーバのコンテンツが見つからない場合は、QNetworkReply::ContentNotFoundErrorが返る (HTTPエラー404と同様)
@@ -71,13 +88,16 @@ bool HtmlFetcher::checkUrlExistence(const QUrl &url)
 /// スレッド情報の取得に失敗した場合 : -1
 int HtmlFetcher::checkUrlExistence(const QUrl &url, const QString ExpiredElement, const QString ExpiredXPath, bool shiftjis)
 {
+    TraceSpan span("html", "HtmlFetcher::checkUrlExistence");
+    if (span) span.setArg(url.toString());
+
     // スレッドのURLが無い場合
     if (url.isEmpty()) {
         return 1;
     }
 
     // まず、Webページが存在するかどうかを確認する
-    QNetworkAccessManager manager;
+    NetworkManager manager;
 
     /// HEADリクエストの作成
     QNetworkRequest request(url);
@@ -85,13 +105,18 @@ int HtmlFetcher::checkUrlExistence(const QUrl &url, const QString ExpiredElement
     /// リダイレクトの無効
     request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, false);
 
+    /// 前回のTLSセッションチケットが存在する場合は、TLSセッションを再開する
+    TlsSessionCache::getInstance()->apply(request);
+
     /// HEADを取得
+    RateLimiter::getInstance()->acquire(url);
     QNetworkReply *pReply = manager.get(request);
 
     /// レスポンス待機
     QEventLoop loop;
     QObject::connect(pReply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
     loop.exec();
+    TlsSessionCache::getInstance()->store(pReply);
 
     /// レスポンスの確認
     /// 例: Webページが存在しない場合は、QNetworkReply::ContentNotFoundErrorが返る (HTTPエラー404と同様)
@@ -105,6 +130,8 @@ int HtmlFetcher::checkUrlExistence(const QUrl &url, const QString ExpiredElement
         }
     }
 
+    pReply->deleteLater();
+
     // 次に、Webページが存在する場合であっても落ちているスレッドのページが返る時がある
     // そのため、Webページから任意のタグの値 (デフォルトの設定では、スレッドのタイトル名) を取得および比較して、再度、スレッドの生存を確認する
     QString checkElement = "";  // Webページから取得するタグの値
@@ -115,12 +142,17 @@ int HtmlFetcher::checkUrlExistence(const QUrl &url, const QString ExpiredElement
     /// リダイレクトを有効
     request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, true);
 
+    /// 1回目のリクエストで更新したTLSセッションチケットを設定
+    TlsSessionCache::getInstance()->apply(request);
+
     /// レスポンスを取得
+    RateLimiter::getInstance()->acquire(url);
     pReply = manager.get(request);
 
     /// レスポンス待機
     QObject::connect(pReply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
     loop.exec();
+    TlsSessionCache::getInstance()->store(pReply);
 
     /// レスポンスの確認
     if (pReply->error() == QNetworkReply::NoError) {
@@ -140,26 +172,23 @@ int HtmlFetcher::checkUrlExistence(const QUrl &url, const QString ExpiredElement
             encodedData = pReply->readAll();
         }
 
-        xmlDocPtr doc = htmlReadDoc((const xmlChar*)encodedData.toStdString().c_str(), nullptr, "UTF-8", HTML_PARSE_RECOVER | HTML_PARSE_NOERROR | HTML_PARSE_NOWARNING);
+        pReply->deleteLater();
+
+        auto doc = ParserPool::getInstance()->parseHtml(encodedData);
         if (doc == nullptr) {
-            std::cerr << QString("HTMLドキュメントのパースに失敗").toStdString() << std::endl;
+            LOG_ERROR(QString("HTMLドキュメントのパースに失敗"));
             return -1;
         }
 
-        xmlXPathContext* xpathCtx = xmlXPathNewContext(doc);
+        XmlPtr::XPathContext xpathCtx(xmlXPathNewContext(doc.get()));
         if (xpathCtx == nullptr) {
-            std::cerr << QString("XPathコンテキストの作成に失敗").toStdString() << std::endl;
-            xmlFreeDoc(doc);
-
+            LOG_ERROR(QString("XPathコンテキストの作成に失敗"));
             return -1;
         }
 
-        xmlXPathObject* xpathObj = xmlXPathEvalExpression((const xmlChar*)ExpiredXPath.toStdString().c_str(), xpathCtx);
+        XmlPtr::XPathObject xpathObj(xmlXPathEvalExpression(XmlPtr::fromString(ExpiredXPath).get(), xpathCtx.get()));
         if (xpathObj == nullptr) {
-            std::cerr << QString("XPath式の評価に失敗").toStdString() << std::endl;
-            xmlXPathFreeContext(xpathCtx);
-            xmlFreeDoc(doc);
-
+            LOG_ERROR(QString("XPath式の評価に失敗"));
             return -1;
         }
 
@@ -182,24 +211,14 @@ int HtmlFetcher::checkUrlExistence(const QUrl &url, const QString ExpiredElement
                 // if (checkElement.compare(ExpiredElement, Qt::CaseSensitive) == 0) {
                 if (checkElement.compare(ExpiredElement, Qt::CaseSensitive) != 0) {
                     /// スレッドが落ちていると判断した場合
-                    xmlXPathFreeObject(xpathObj);
-                    xmlXPathFreeContext(xpathCtx);
-                    xmlFreeDoc(doc);
-
                     return 1;
                 }
             }
         }
-
-        xmlXPathFreeObject(xpathObj);
-        xmlXPathFreeContext(xpathCtx);
-        xmlFreeDoc(doc);
-
-        pReply->deleteLater();
     }
     else {
         /// レスポンスの取得に失敗した場合
-        std::cerr << QString("ネットワークエラー: %1").arg(pReply->errorString()).toStdString() << std::endl;
+        LOG_ERROR(QString("ネットワークエラー: %1").arg(pReply->errorString()));
         pReply->deleteLater();
 
         return -1;
@@ -212,6 +231,9 @@ int HtmlFetcher::checkUrlExistence(const QUrl &url, const QString ExpiredElement
 // ニュース記事のURLにアクセスして、本文を取得する
 int HtmlFetcher::fetch(const QUrl &url, bool redirect, const QString& _xpath)
 {
+    TraceSpan span("html", "HtmlFetcher::fetch");
+    if (span) span.setArg(url.toString());
+
     // リダイレクトを自動的にフォロー
     QNetworkRequest request(url);
 
@@ -219,23 +241,189 @@ int HtmlFetcher::fetch(const QUrl &url, bool redirect, const QString& _xpath)
         request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, true);
     }
 
-    auto pReply = m_pManager->get(request);
+    // 障害中のホストの場合は、リクエストを送信しない
+    auto pHealth = SourceHealth::getInstance();
+    if (!pHealth->isAvailable(url)) {
+        LOG_ERROR(QString("%1 は障害中のため、アクセスを省略します").arg(url.host()));
+        return -1;
+    }
 
-    // レスポンス待機
-    QEventLoop loop;
-    QObject::connect(pReply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    loop.exec();
+    // HTTPリクエストを1度だけ送信して、レスポンスを待機
+    auto pReply = getOnce(request);
+    if (pReply == nullptr) {
+        return -1;
+    }
 
     // 本文の一部を取得
     return fetchParagraph(pReply, _xpath);
 }
 
 
+// HTTPリクエストを1度だけ送信して、レスポンスを待機する
+// 同期的に取得するメソッドでは、再試行の待機 (バックオフ) の間もイベントループが入れ子になるため、再試行しない
+// 待機中に本ソフトウェアの終了等でイベントループが終了した場合はnullptrを返す (後から受信したレスポンスは破棄する)
+QNetworkReply* HtmlFetcher::getOnce(const QNetworkRequest &request)
+{
+    auto                 pResult = std::make_shared<QNetworkReply*>(nullptr);
+    QEventLoop           loop;
+    QPointer<QEventLoop> pLoop(&loop);
+
+    SourceHealth::getInstance()->getAsync(m_pManager.get(), request, [pResult, pLoop](QNetworkReply *reply) {
+        if (pLoop.isNull()) {
+            reply->deleteLater();
+            return;
+        }
+
+        *pResult = reply;
+        pLoop->quit();
+    }, false);
+
+    if (*pResult == nullptr) loop.exec();
+
+    return *pResult;
+}
+
+
+// 複数のニュース記事のURLに同時にアクセスして、それぞれの本文を取得する
+// XPathが空の場合は、ニュース記事の概要 (descriptionのmetaタグ) を取得する
+// 全てのHTTPリクエストを待機せずに送信して、完了時にdoneに結果 (引数のURLと同じ順番) を渡す
+void HtmlFetcher::fetchAll(const QList<QUrl> &urls, bool redirect, const QString &_xpath,
+                           const std::function<void(const QVector<FETCH_RESULT>&)> &done)
+{
+    const auto xpath        = _xpath.isEmpty() ? QString("//head/meta[@name='description']/@content") : _xpath;
+    const auto maxParagraph = m_MaxParagraph;
+
+    fetchPages(urls, redirect, [xpath, maxParagraph](xmlDocPtr doc, QString &paragraph) {
+        return extractParagraph(doc, xpath, maxParagraph, paragraph);
+    }, done);
+}
+
+
+// 複数のニュース記事のURLに同時にアクセスして、それぞれのXPathで指定した値を取得する
+// 全てのHTTPリクエストを待機せずに送信して、完了時にdoneに結果 (引数のURLと同じ順番) を渡す
+void HtmlFetcher::fetchAllElements(const QList<QUrl> &urls, bool redirect, const QString &_xpath, int elementType,
+                                   const std::function<void(const QVector<FETCH_RESULT>&)> &done)
+{
+    fetchPages(urls, redirect, [_xpath, elementType](xmlDocPtr doc, QString &element) {
+        return extractElement(doc, _xpath, elementType, element);
+    }, done);
+}
+
+
+// 複数のURLに同時にアクセスして、それぞれのHTMLドキュメントからextractで値を抽出する
+// 全てのHTTPリクエストを先に送信して、受信したレスポンスから順にワーカスレッドでパースおよび抽出する
+// ネットワークの待ち時間、パースおよび抽出は重なり、イベントループを入れ子にせずに全ての完了時にdoneを実行する
+// 取得に失敗したURLの結果は-1となる (本オブジェクトを完了の前に破棄した場合は、doneを実行しない)
+void HtmlFetcher::fetchPages(const QList<QUrl> &urls, bool redirect, const std::function<int(xmlDocPtr, QString&)> &extract,
+                             const std::function<void(const QVector<FETCH_RESULT>&)> &done)
+{
+    // 全てのURLの処理で共有する状態
+    struct STATE {
+        QVector<FETCH_RESULT>   Results;
+        int                     Pending = 0;
+        qint64                  Start   = -1;
+    };
+
+    // 1つのURLの抽出結果 (ワーカスレッドで書き込み、完了の通知の後にメインスレッドで読み込む)
+    struct PAGE {
+        bool            Parsed  = false;
+        FETCH_RESULT    Result;
+    };
+
+    auto pState     = std::make_shared<STATE>();
+    pState->Results = QVector<FETCH_RESULT>(urls.size());
+    pState->Start   = Trace::isEnabled() ? Trace::getInstance()->now() : qint64(-1);
+
+    // 1つのURLの処理 (本文の抽出、または、失敗) が完了した時
+    auto finish = [pState, done, count = urls.size()]() {
+        if (--pState->Pending > 0) return;
+
+        if (pState->Start >= 0) Trace::getInstance()->completeAsync("html", "HtmlFetcher::fetchAll", pState->Start, QString::number(count));
+
+        done(pState->Results);
+    };
+
+    auto pHealth = SourceHealth::getInstance();
+    QList<QNetworkRequest> requests;
+    QList<int>             indexes;
+
+    for (auto i = 0; i < urls.size(); i++) {
+        const auto &url = urls.at(i);
+
+        // 障害中のホストの場合は、リクエストを送信しない
+        if (!pHealth->isAvailable(url)) {
+            LOG_ERROR(QString("%1 は障害中のため、アクセスを省略します").arg(url.host()));
+            continue;
+        }
+
+        // リダイレクトを自動的にフォロー
+        QNetworkRequest request(url);
+
+        if (redirect) {
+            request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, true);
+        }
+
+        requests.append(request);
+        indexes.append(i);
+    }
+
+    // 送信するリクエストが無い場合
+    pState->Pending = static_cast<int>(requests.size());
+    if (requests.isEmpty()) {
+        done(pState->Results);
+        return;
+    }
+
+    for (auto j = 0; j < requests.size(); j++) {
+        const auto i = indexes.at(j);
+
+        // HTTPリクエストを送信 (一時的なエラーの場合は再試行)
+        pHealth->getAsync(m_pManager.get(), requests.at(j), [this, i, pState, extract, finish](QNetworkReply *reply) {
+            if (reply->error() != QNetworkReply::NoError) {
+                LOG_ERROR(reply->errorString());
+                reply->deleteLater();
+                finish();
+
+                return;
+            }
+
+            const QString htmlContent = reply->readAll();
+            const auto    url         = reply->request().url();
+            reply->deleteLater();
+
+            // 文字列からHTMLドキュメントをパースして、値を抽出 (ワーカスレッドで実行して、他のレスポンスの受信を継続する)
+            auto pPage = std::make_shared<PAGE>();
+            ParserPool::getInstance()->parseHtmlAsync(htmlContent, this, [pPage, extract](xmlDocPtr doc) {
+                if (doc == nullptr) return;
+
+                pPage->Parsed        = true;
+                pPage->Result.Result = extract(doc, pPage->Result.Paragraph);
+            },
+            [i, url, pState, pPage, finish]() {
+                if (!pPage->Parsed) {
+                    LOG_ERROR(QString("HTMLドキュメントのパースに失敗"));
+                    SourceHealth::getInstance()->recordFailure(url, SourceHealth::PARSE);
+                }
+                else {
+                    // HTMLドキュメントを取得できた場合は、ホストは正常と見なす
+                    SourceHealth::getInstance()->recordSuccess(url);
+
+                    if (pPage->Result.Result != 0) LOG_ERROR(QString("ノードの取得に失敗 (%1)").arg(url.toString()));
+                    pState->Results[i] = pPage->Result;
+                }
+
+                finish();
+            });
+        });
+    }
+}
+
+
 // ニュース記事の本文を取得する
 int HtmlFetcher::fetchParagraph(QNetworkReply *reply, const QString& _xpath)
 {
     if (reply->error() != QNetworkReply::NoError) {
-        std::cerr << "エラー : " << reply->errorString().toStdString();
+        LOG_ERROR(reply->errorString());
         reply->deleteLater();
 
         return -1;
@@ -243,28 +431,48 @@ int HtmlFetcher::fetchParagraph(QNetworkReply *reply, const QString& _xpath)
 
     QString htmlContent = reply->readAll();
 
-    // libxml2の初期化
-    xmlInitParser();
-    LIBXML_TEST_VERSION
-
-    // 文字列からHTMLドキュメントをパース
+    // 文字列からHTMLドキュメントをパース (ワーカスレッドでパースして、完了するまで他のイベントを処理する)
     // libxml2ではエンコーディングの自動判定において問題があるため、エンコーディングを明示的に指定する
-    xmlDocPtr doc = htmlReadDoc((const xmlChar*)htmlContent.toStdString().c_str(), nullptr, "UTF-8", HTML_PARSE_RECOVER | HTML_PARSE_NOERROR | HTML_PARSE_NOWARNING);
+    auto doc = ParserPool::getInstance()->parseHtml(htmlContent);
     if (doc == nullptr) {
-        std::cerr << "エラー : HTMLドキュメントのパースに失敗" << std::endl;
+        LOG_ERROR(QString("HTMLドキュメントのパースに失敗"));
+        SourceHealth::getInstance()->recordFailure(reply->request().url(), SourceHealth::PARSE);
         reply->deleteLater();
 
         return -1;
     }
 
+    // HTMLドキュメントを取得できた場合は、ホストは正常と見なす
+    SourceHealth::getInstance()->recordSuccess(reply->request().url());
+
+    reply->deleteLater();
+
+    return extractParagraph(doc.get(), _xpath);
+}
+
+
+// パース済みのHTMLドキュメントから、XPathで指定したニュース記事の本文を抽出する
+int HtmlFetcher::extractParagraph(xmlDocPtr doc, const QString &_xpath)
+{
+    const auto ret = extractParagraph(doc, _xpath, m_MaxParagraph, m_Paragraph);
+    if (ret != 0) {
+        LOG_ERROR(QString("ノードの取得に失敗"));
+    }
+
+    return ret;
+}
+
+
+// パース済みのHTMLドキュメントから、XPathで指定したニュース記事の本文を抽出する
+// 本オブジェクトのメンバ変数を参照しないため、ワーカスレッドから実行できる
+int HtmlFetcher::extractParagraph(xmlDocPtr doc, const QString &_xpath, long long maxParagraph, QString &paragraph)
+{
+    TraceSpan span("xpath", "HtmlFetcher::extractParagraph");
+    if (span) span.setArg(_xpath);
+
     // XPathで特定の要素を検索
-    auto *xpath = xmlStrdup((const xmlChar*)_xpath.toUtf8().constData());
-    xmlXPathObjectPtr result = getNodeset(doc, xpath);
+    auto result = getNodeset(doc, _xpath);
     if (result == nullptr) {
-        std::cerr << "エラー : ノードの取得に失敗" << std::endl;
-        xmlFreeDoc(doc);
-        reply->deleteLater();
-
         return -1;
     }
 
@@ -272,51 +480,70 @@ int HtmlFetcher::fetchParagraph(QNetworkReply *reply, const QString& _xpath)
     xmlNodeSetPtr nodeset = result->nodesetval;
     QString content = "";
 
-    for (auto i = 0; i < nodeset->nodeNr; ++i) {
+    // 不要な文字を削除 (\n, \t, 半角全角スペース等)
+    const TextNormalizer normalizer;
+
+    for (auto i = 0; i < nodeset->nodeNr && content.size() <= maxParagraph; ++i) {
         xmlNodePtr cur = nodeset->nodeTab[i]->xmlChildrenNode;
-        while (cur != nullptr) {
+        while (cur != nullptr && content.size() <= maxParagraph) {
             if (cur->type == XML_TEXT_NODE) {
-                auto buffer = QString(((const char*)cur->content));
-
-                // 不要な文字を削除 (\n, \t, 半角全角スペース等)
-                static QRegularExpression regex("[\\s]", QRegularExpression::CaseInsensitiveOption);
-                buffer = buffer.replace(regex, "");
-                buffer.replace(" ", "").replace("\u3000", "");
-
-                content.append(buffer);
+                content.append(normalizer.normalize(QString::fromUtf8((const char*)cur->content)));
             }
             cur = cur->next;
         }
     }
 
     // 本文が指定文字数以上の場合、指定文字数分のみを抽出
-    m_Paragraph = content.size() > m_MaxParagraph ? m_Paragraph = content.mid(0, static_cast<int>(m_MaxParagraph)) + QString("...") : content;
+    paragraph = TextNormalizer::truncate(content, maxParagraph);
 
-    xmlXPathFreeObject(result);
-    xmlFreeDoc(doc);
-    xmlCleanupParser();
+    return 0;
+}
 
-    reply->deleteLater();
+
+// パース済みのHTMLドキュメントから、XPathで指定したノード群の子ノードのうち、指定した種類のノードの値を抽出する
+// 各値の末尾には半角スペースを付加する (本オブジェクトのメンバ変数を参照しないため、ワーカスレッドから実行できる)
+int HtmlFetcher::extractElement(xmlDocPtr doc, const QString &_xpath, int elementType, QString &element)
+{
+    TraceSpan span("xpath", "HtmlFetcher::extractElement");
+    if (span) span.setArg(_xpath);
+
+    element.clear();
+
+    // XPathで特定の要素を検索
+    auto result = getNodeset(doc, _xpath);
+    if (result == nullptr) {
+        return -1;
+    }
+
+    // 結果のノードセットからテキストを取得
+    xmlNodeSetPtr nodeset = result->nodesetval;
+    for (auto i = 0; i < nodeset->nodeNr; ++i) {
+        xmlNodePtr cur = nodeset->nodeTab[i]->xmlChildrenNode;
+        while (cur != nullptr) {
+            if (cur->type == elementType) {
+                element.append(QString((const char*)cur->content) + QString(" "));
+            }
+            cur = cur->next;
+        }
+    }
 
     return 0;
 }
 
 
-xmlXPathObjectPtr HtmlFetcher::getNodeset(xmlDocPtr doc, const xmlChar *xpath)
+// XPathで指定したノードセットを取得する (ノードが存在しない場合はnullptr)
+XmlPtr::XPathObject HtmlFetcher::getNodeset(xmlDocPtr doc, const QString &xpath)
 {
-    xmlXPathContextPtr context = xmlXPathNewContext(doc);
-    if (context == nullptr) {
-        return nullptr;
-    }
+    TraceSpan span("xpath", "HtmlFetcher::getNodeset");
+    if (span) span.setArg(xpath);
 
-    xmlXPathObjectPtr result = xmlXPathEvalExpression(xpath, context);
-    xmlXPathFreeContext(context);
-    if (result == nullptr) {
+    XmlPtr::XPathContext context(xmlXPathNewContext(doc));
+    if (context == nullptr) {
         return nullptr;
     }
 
-    if (xmlXPathNodeSetIsEmpty(result->nodesetval)) {
-        xmlXPathFreeObject(result);
+    XmlPtr::XPathObject result(xmlXPathEvalExpression(XmlPtr::fromString(xpath).get(), context.get()));
+    if (result == nullptr || xmlXPathNodeSetIsEmpty(result->nodesetval)) {
         return nullptr;
     }
 
@@ -327,6 +554,9 @@ xmlXPathObjectPtr HtmlFetcher::getNodeset(xmlDocPtr doc, const xmlChar *xpath)
 // ニュース記事のURLにアクセスして、XPathで指定した値を取得する
 int HtmlFetcher::fetchElement(const QUrl &url, bool redirect, const QString &_xpath, int elementType)
 {
+    TraceSpan span("html", "HtmlFetcher::fetchElement");
+    if (span) span.setArg(url.toString());
+
     m_Element.clear();
 
     // リダイレクトを自動的にフォロー
@@ -336,16 +566,22 @@ int HtmlFetcher::fetchElement(const QUrl &url, bool redirect, const QString &_xp
         request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, true);
     }
 
-    auto pReply = m_pManager->get(request);
+    // 障害中のホストの場合は、リクエストを送信しない
+    auto pHealth = SourceHealth::getInstance();
+    if (!pHealth->isAvailable(url)) {
+        LOG_ERROR(QString("%1 は障害中のため、アクセスを省略します").arg(url.host()));
+        return -1;
+    }
 
-    // レスポンス待機
-    QEventLoop loop;
-    QObject::connect(pReply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    loop.exec();
+    // HTTPリクエストを1度だけ送信して、レスポンスを待機
+    auto pReply = getOnce(request);
+    if (pReply == nullptr) {
+        return -1;
+    }
 
     // レスポンスの取得
     if (pReply->error() != QNetworkReply::NoError) {
-        std::cerr << QString("エラー : %1").arg(pReply->errorString()).toStdString() << std::endl;
+        LOG_ERROR(QString("%1").arg(pReply->errorString()));
         pReply->deleteLater();
 
         return -1;
@@ -353,52 +589,28 @@ int HtmlFetcher::fetchElement(const QUrl &url, bool redirect, const QString &_xp
 
     QString htmlContent = pReply->readAll();
 
-    // libxml2の初期化
-    xmlInitParser();
-    LIBXML_TEST_VERSION
-
-    // 文字列からHTMLドキュメントをパース
+    // 文字列からHTMLドキュメントをパース (ワーカスレッドでパースして、完了するまで他のイベントを処理する)
     // libxml2ではエンコーディングの自動判定において問題があるため、エンコーディングを明示的に指定する
-    xmlDocPtr doc = htmlReadDoc((const xmlChar*)htmlContent.toStdString().c_str(), nullptr, "UTF-8", HTML_PARSE_RECOVER | HTML_PARSE_NOERROR | HTML_PARSE_NOWARNING);
+    auto doc = ParserPool::getInstance()->parseHtml(htmlContent);
     if (doc == nullptr) {
-        std::cerr << QString("エラー : HTMLドキュメントのパースに失敗").toStdString() << std::endl;
+        LOG_ERROR(QString("HTMLドキュメントのパースに失敗"));
+        pHealth->recordFailure(url, SourceHealth::PARSE);
         pReply->deleteLater();
 
         return -1;
     }
 
-    // XPathで特定の要素を検索
-    auto *xpath = xmlStrdup((const xmlChar*)_xpath.toUtf8().constData());
-    xmlXPathObjectPtr result = getNodeset(doc, xpath);
-    if (result == nullptr) {
-        std::cerr << QString("エラー : ノードの取得に失敗").toStdString() << std::endl;
-        xmlFreeDoc(doc);
-        pReply->deleteLater();
-
-        return -1;
-    }
-
-    // 結果のノードセットからテキストを取得
-    xmlNodeSetPtr nodeset = result->nodesetval;
-    for (auto i = 0; i < nodeset->nodeNr; ++i) {
-        xmlNodePtr cur = nodeset->nodeTab[i]->xmlChildrenNode;
-        while (cur != nullptr) {
-            if (cur->type == elementType) {
-                auto buffer = QString(((const char*)cur->content)) + QString(" ");
-                m_Element.append(buffer);
-            }
-            cur = cur->next;
-        }
-    }
+    // HTMLドキュメントを取得できた場合は、ホストは正常と見なす
+    pHealth->recordSuccess(url);
 
-    // libxml2オブジェクトの破棄
-    xmlXPathFreeObject(result);
-    xmlFreeDoc(doc);
+    pReply->deleteLater();
 
-    // libxml2のクリーンアップ
-    xmlCleanupParser();
+    // XPathで特定の要素を検索して、結果のノードセットからテキストを取得
+    if (extractElement(doc.get(), _xpath, elementType, m_Element)) {
+        LOG_ERROR(QString("ノードの取得に失敗"));
 
-    pReply->deleteLater();
+        return -1;
+    }
 
     return 0;
 }
@@ -406,6 +618,9 @@ int HtmlFetcher::fetchElement(const QUrl &url, bool redirect, const QString &_xp
 
 int HtmlFetcher::fetchElementJiJiFlashUrl(const QUrl &url, bool redirect, const QString &_xpath, int elementType)
 {
+    TraceSpan span("html", "HtmlFetcher::fetchElementJiJiFlashUrl");
+    if (span) span.setArg(url.toString());
+
     m_Element.clear();
 
     // リダイレクトを自動的にフォロー
@@ -415,16 +630,22 @@ int HtmlFetcher::fetchElementJiJiFlashUrl(const QUrl &url, bool redirect, const
         request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, true);
     }
 
-    auto pReply = m_pManager->get(request);
+    // 障害中のホストの場合は、リクエストを送信しない
+    auto pHealth = SourceHealth::getInstance();
+    if (!pHealth->isAvailable(url)) {
+        LOG_ERROR(QString("%1 は障害中のため、アクセスを省略します").arg(url.host()));
+        return -1;
+    }
 
-    // レスポンス待機
-    QEventLoop loop;
-    QObject::connect(pReply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    loop.exec();
+    // HTTPリクエストを1度だけ送信して、レスポンスを待機
+    auto pReply = getOnce(request);
+    if (pReply == nullptr) {
+        return -1;
+    }
 
     // レスポンスの取得
     if (pReply->error() != QNetworkReply::NoError) {
-        std::cerr << QString("エラー : %1").arg(pReply->errorString()).toStdString() << std::endl;
+        LOG_ERROR(QString("%1").arg(pReply->errorString()));
         pReply->deleteLater();
 
         return -1;
@@ -432,27 +653,23 @@ int HtmlFetcher::fetchElementJiJiFlashUrl(const QUrl &url, bool redirect, const
 
     QString htmlContent = pReply->readAll();
 
-    // libxml2の初期化
-    xmlInitParser();
-    LIBXML_TEST_VERSION
-
-    // 文字列からHTMLドキュメントをパース
+    // 文字列からHTMLドキュメントをパース (ワーカスレッドでパースして、完了するまで他のイベントを処理する)
     // libxml2ではエンコーディングの自動判定において問題があるため、エンコーディングを明示的に指定する
-    xmlDocPtr doc = htmlReadDoc((const xmlChar*)htmlContent.toStdString().c_str(), nullptr, "UTF-8", HTML_PARSE_RECOVER | HTML_PARSE_NOERROR | HTML_PARSE_NOWARNING);
+    auto doc = ParserPool::getInstance()->parseHtml(htmlContent);
     if (doc == nullptr) {
-        std::cerr << QString("エラー : HTMLドキュメントのパースに失敗").toStdString() << std::endl;
-        xmlCleanupParser();
+        LOG_ERROR(QString("HTMLドキュメントのパースに失敗"));
+        pHealth->recordFailure(url, SourceHealth::PARSE);
         pReply->deleteLater();
 
         return -1;
     }
 
+    // HTMLドキュメントを取得できた場合は、ホストは正常と見なす
+    pHealth->recordSuccess(url);
+
     // XPathで特定の要素を検索
-    auto *xpath = xmlStrdup((const xmlChar*)_xpath.toUtf8().constData());
-    xmlXPathObjectPtr result = getNodeset(doc, xpath);
+    auto result = getNodeset(doc.get(), _xpath);
     if (result == nullptr) {
-        xmlFreeDoc(doc);
-        xmlCleanupParser();
         pReply->deleteLater();
 
         return 0;
@@ -464,13 +681,6 @@ int HtmlFetcher::fetchElementJiJiFlashUrl(const QUrl &url, bool redirect, const
         ret = -1;
     }
 
-    // libxml2オブジェクトの破棄
-    xmlXPathFreeObject(result);
-    xmlFreeDoc(doc);
-
-    // libxml2のクリーンアップ
-    xmlCleanupParser();
-
     pReply->deleteLater();
 
     return ret;
@@ -501,6 +711,9 @@ bool HtmlFetcher::getUrl(const xmlNodeSetPtr nodeset, int elementType)
 // 共同通信の速報記事のURLにアクセスして、XPathで指定した本文を取得する
 int HtmlFetcher::fetchParagraphKyodoFlash(const QUrl &url, bool redirect, const QString &_xpath)
 {
+    TraceSpan span("html", "HtmlFetcher::fetchParagraphKyodoFlash");
+    if (span) span.setArg(url.toString());
+
     m_Element.clear();
 
     // リダイレクトを自動的にフォロー
@@ -510,16 +723,22 @@ int HtmlFetcher::fetchParagraphKyodoFlash(const QUrl &url, bool redirect, const
         request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, true);
     }
 
-    auto pReply = m_pManager->get(request);
+    // 障害中のホストの場合は、リクエストを送信しない
+    auto pHealth = SourceHealth::getInstance();
+    if (!pHealth->isAvailable(url)) {
+        LOG_ERROR(QString("%1 は障害中のため、アクセスを省略します").arg(url.host()));
+        return -1;
+    }
 
-    // レスポンス待機
-    QEventLoop loop;
-    QObject::connect(pReply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    loop.exec();
+    // HTTPリクエストを1度だけ送信して、レスポンスを待機
+    auto pReply = getOnce(request);
+    if (pReply == nullptr) {
+        return -1;
+    }
 
     // レスポンスの取得
     if (pReply->error() != QNetworkReply::NoError) {
-        std::cerr << QString("エラー : %1").arg(pReply->errorString()).toStdString() << std::endl;
+        LOG_ERROR(QString("%1").arg(pReply->errorString()));
         pReply->deleteLater();
 
         return -1;
@@ -527,36 +746,33 @@ int HtmlFetcher::fetchParagraphKyodoFlash(const QUrl &url, bool redirect, const
 
     QString htmlContent = pReply->readAll();
 
-    // libxml2の初期化
-    xmlInitParser();
-    LIBXML_TEST_VERSION
-
-    // 文字列からHTMLドキュメントをパース
+    // 文字列からHTMLドキュメントをパース (ワーカスレッドでパースして、完了するまで他のイベントを処理する)
     // libxml2ではエンコーディングの自動判定において問題があるため、エンコーディングを明示的に指定する
-    xmlDocPtr doc = htmlReadDoc((const xmlChar*)htmlContent.toStdString().c_str(), nullptr, "UTF-8", HTML_PARSE_RECOVER | HTML_PARSE_NOERROR | HTML_PARSE_NOWARNING);
+    auto doc = ParserPool::getInstance()->parseHtml(htmlContent);
     if (doc == nullptr) {
-        std::cerr << QString("エラー : HTMLドキュメントのパースに失敗").toStdString() << std::endl;
+        LOG_ERROR(QString("HTMLドキュメントのパースに失敗"));
+        pHealth->recordFailure(url, SourceHealth::PARSE);
         pReply->deleteLater();
 
         return -1;
     }
 
+    // HTMLドキュメントを取得できた場合は、ホストは正常と見なす
+    pHealth->recordSuccess(url);
+
     // XPathコンテキストの生成
-    xmlXPathContextPtr context = xmlXPathNewContext(doc);
+    XmlPtr::XPathContext context(xmlXPathNewContext(doc.get()));
     if (context == nullptr) {
-        std::cerr << "エラー : XPathコンテキストの生成に失敗" << std::endl;
-        xmlFreeDoc(doc);
+        LOG_ERROR(QString("XPathコンテキストの生成に失敗"));
         pReply->deleteLater();
 
         return -1;
     }
 
     // XPath評価
-    xmlXPathObjectPtr result = xmlXPathEvalExpression((const xmlChar*)_xpath.toUtf8().constData(), context);
+    XmlPtr::XPathObject result(xmlXPathEvalExpression(XmlPtr::fromString(_xpath).get(), context.get()));
     if (result == nullptr) {
-        std::cerr << "エラー : XPath評価に失敗" << std::endl;
-        xmlXPathFreeContext(context);
-        xmlFreeDoc(doc);
+        LOG_ERROR(QString("XPath評価に失敗"));
         pReply->deleteLater();
 
         return -1;
@@ -589,14 +805,6 @@ int HtmlFetcher::fetchParagraphKyodoFlash(const QUrl &url, bool redirect, const
         }
     }
 
-    // libxml2オブジェクトの破棄
-    xmlXPathFreeObject(result);
-    xmlXPathFreeContext(context);
-    xmlFreeDoc(doc);
-
-    // libxml2のクリーンアップ
-    xmlCleanupParser();
-
     pReply->deleteLater();
 
     return 0;
@@ -606,6 +814,9 @@ int HtmlFetcher::fetchParagraphKyodoFlash(const QUrl &url, bool redirect, const
 // 書き込むスレッドの最後尾のレス番号を取得する
 int HtmlFetcher::fetchLastThreadNum(const QUrl &url, bool redirect, const QString &_xpath, int elementType)
 {
+    TraceSpan span("html", "HtmlFetcher::fetchLastThreadNum");
+    if (span) span.setArg(url.toString());
+
     // リダイレクトを自動的にフォロー
     QNetworkRequest request(url);
 
@@ -613,16 +824,21 @@ int HtmlFetcher::fetchLastThreadNum(const QUrl &url, bool redirect, const QStrin
         request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, true);
     }
 
+    // 前回のTLSセッションチケットが存在する場合は、TLSセッションを再開する
+    TlsSessionCache::getInstance()->apply(request);
+
+    RateLimiter::getInstance()->acquire(url);
     auto pReply = m_pManager->get(request);
 
     // レスポンス待機
     QEventLoop loop;
     QObject::connect(pReply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
     loop.exec();
+    TlsSessionCache::getInstance()->store(pReply);
 
     // レスポンスの取得
     if (pReply->error() != QNetworkReply::NoError) {
-        std::cerr << QString("エラー : %1").arg(pReply->errorString()).toStdString() << std::endl;
+        LOG_ERROR(QString("%1").arg(pReply->errorString()));
         pReply->deleteLater();
 
         return -1;
@@ -630,26 +846,20 @@ int HtmlFetcher::fetchLastThreadNum(const QUrl &url, bool redirect, const QStrin
 
     QString htmlContent = pReply->readAll();
 
-    // libxml2の初期化
-    xmlInitParser();
-    LIBXML_TEST_VERSION
-
-    // 文字列からHTMLドキュメントをパース
+    // 文字列からHTMLドキュメントをパース (ワーカスレッドでパースして、完了するまで他のイベントを処理する)
     // libxml2ではエンコーディングの自動判定において問題があるため、エンコーディングを明示的に指定する
-    xmlDocPtr doc = htmlReadDoc((const xmlChar*)htmlContent.toStdString().c_str(), nullptr, "UTF-8", HTML_PARSE_RECOVER | HTML_PARSE_NOERROR | HTML_PARSE_NOWARNING);
+    auto doc = ParserPool::getInstance()->parseHtml(htmlContent);
     if (doc == nullptr) {
-        std::cerr << QString("エラー : HTMLドキュメントのパースに失敗").toStdString() << std::endl;
+        LOG_ERROR(QString("HTMLドキュメントのパースに失敗"));
         pReply->deleteLater();
 
         return -1;
     }
 
     // XPathで特定の要素を検索
-    auto *xpath = xmlStrdup((const xmlChar*)_xpath.toUtf8().constData());
-    xmlXPathObjectPtr result = getNodeset(doc, xpath);
+    auto result = getNodeset(doc.get(), _xpath);
     if (result == nullptr) {
-        std::cerr << QString("エラー : ノードの取得に失敗").toStdString() << std::endl;
-        xmlFreeDoc(doc);
+        LOG_ERROR(QString("ノードの取得に失敗"));
         pReply->deleteLater();
 
         return -1;
@@ -674,13 +884,6 @@ int HtmlFetcher::fetchLastThreadNum(const QUrl &url, bool redirect, const QStrin
         }
     }
 
-    // libxml2オブジェクトの破棄
-    xmlXPathFreeObject(result);
-    xmlFreeDoc(doc);
-
-    // libxml2のクリーンアップ
-    xmlCleanupParser();
-
     pReply->deleteLater();
 
     return 0;
@@ -690,23 +893,27 @@ int HtmlFetcher::fetchLastThreadNum(const QUrl &url, bool redirect, const QStrin
 // 新規作成したスレッドからスレッドのパスおよびスレッド番号を取得する
 int HtmlFetcher::extractThreadPath(const QString &htmlContent, const QString &bbs)
 {
+    TraceSpan span("xpath", "HtmlFetcher::extractThreadPath");
+
     // HTMLコンテンツをパース
-    htmlDocPtr doc = htmlReadDoc((const xmlChar*)htmlContent.toStdString().c_str(), nullptr, "UTF-8", HTML_PARSE_RECOVER | HTML_PARSE_NOERROR | HTML_PARSE_NOWARNING);
+    auto doc = ParserPool::getInstance()->parseHtml(htmlContent);
+    if (doc == nullptr) return -1;
 
     // XPathコンテキストを作成
-    xmlXPathContextPtr context = xmlXPathNewContext(doc);
+    XmlPtr::XPathContext context(xmlXPathNewContext(doc.get()));
+    if (context == nullptr) return -1;
 
     // http-equivが"Refresh"であるmetaタグを見つけるXPathクエリ
-    xmlXPathObjectPtr result = xmlXPathEvalExpression((xmlChar*)"//meta[@http-equiv='Refresh']", context);
+    XmlPtr::XPathObject result(xmlXPathEvalExpression(BAD_CAST "//meta[@http-equiv='Refresh']", context.get()));
 
     if(result != nullptr && result->nodesetval != nullptr) {
         for(int i = 0; i < result->nodesetval->nodeNr; i++) {
             xmlNodePtr node = result->nodesetval->nodeTab[i];
 
             // content属性を取得
-            xmlChar* content = xmlGetProp(node, (xmlChar*)"content");
-            std::string contentStr((char*)content);
-            xmlFree(content);
+            XmlPtr::Char content(xmlGetProp(node, BAD_CAST "content"));
+            if (content == nullptr) continue;
+            std::string contentStr(reinterpret_cast<const char*>(content.get()));
 
             // URLからスレッドパスを抽出
             /// まず、URLの部分を抽出
@@ -726,9 +933,7 @@ int HtmlFetcher::extractThreadPath(const QString &htmlContent, const QString &bb
             if (MatchThreadPath.hasMatch()) {
                 m_ThreadPath = MatchThreadPath.captured(1);
 
-#ifdef _DEBUG
-                std::cout << QString("スレッドのパス : %1").arg(m_ThreadPath).toStdString() << std::endl;
-#endif
+                LOG_DEBUG(QString("スレッドのパス : %1").arg(m_ThreadPath));
             }
 
             /// さらに、抽出したURLの部分からスレッド番号を抽出
@@ -737,9 +942,7 @@ int HtmlFetcher::extractThreadPath(const QString &htmlContent, const QString &bb
             if (MatchThreadNum.hasMatch()) {
                 m_ThreadNum = MatchThreadNum.captured(1);
 
-#ifdef _DEBUG
-                std::cout << "スレッド番号 : " << m_ThreadNum.toStdString() << std::endl;
-#endif
+                LOG_DEBUG(QString("スレッド番号 : %1").arg(m_ThreadNum));
             }
 
             /// さらに、抽出したURLの部分からスレッド番号を抽出 (C++標準ライブラリを使用する場合)
@@ -758,10 +961,6 @@ int HtmlFetcher::extractThreadPath(const QString &htmlContent, const QString &bb
         }
     }
 
-    xmlXPathFreeObject(result);
-    xmlXPathFreeContext(context);
-    xmlFreeDoc(doc);
-
     // スレッドのパスおよびスレッド番号の取得に失敗した場合はエラーとする
     if (m_ThreadPath.isEmpty() && m_ThreadNum.isEmpty()) return -1;
 
@@ -772,6 +971,9 @@ int HtmlFetcher::extractThreadPath(const QString &htmlContent, const QString &bb
 // 既存のスレッドからスレッドのタイトルを抽出する
 int HtmlFetcher::extractThreadTitle(const QUrl &url, bool redirect, const QString &_xpath, bool bShiftJIS)
 {
+    TraceSpan span("html", "HtmlFetcher::extractThreadTitle");
+    if (span) span.setArg(url.toString());
+
     // リダイレクトを自動的にフォロー
     QNetworkRequest request(url);
 
@@ -779,16 +981,21 @@ int HtmlFetcher::extractThreadTitle(const QUrl &url, bool redirect, const QStrin
         request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, true);
     }
 
+    // 前回のTLSセッションチケットが存在する場合は、TLSセッションを再開する
+    TlsSessionCache::getInstance()->apply(request);
+
+    RateLimiter::getInstance()->acquire(url);
     auto pReply = m_pManager->get(request);
 
     // レスポンス待機
     QEventLoop loop;
     QObject::connect(pReply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
     loop.exec();
+    TlsSessionCache::getInstance()->store(pReply);
 
     // レスポンスの取得
     if (pReply->error() != QNetworkReply::NoError) {
-        std::cerr << QString("エラー : %1").arg(pReply->errorString()).toStdString() << std::endl;
+        LOG_ERROR(QString("%1").arg(pReply->errorString()));
         pReply->deleteLater();
 
         return -1;
@@ -804,7 +1011,7 @@ int HtmlFetcher::extractThreadTitle(const QUrl &url, bool redirect, const QStrin
             return 1;
         }
 
-        std::cerr << QString("エラー : %1").arg(pReply->errorString()).toStdString();
+        LOG_ERROR(QString("%1").arg(pReply->errorString()));
         pReply->deleteLater();
 
         return -1;
@@ -825,26 +1032,20 @@ int HtmlFetcher::extractThreadTitle(const QUrl &url, bool redirect, const QStrin
         htmlContent = pReply->readAll();
     }
 
-    // libxml2の初期化
-    xmlInitParser();
-    LIBXML_TEST_VERSION
-
-    // 文字列からHTMLドキュメントをパース
+    // 文字列からHTMLドキュメントをパース (ワーカスレッドでパースして、完了するまで他のイベントを処理する)
     // libxml2ではエンコーディングの自動判定において問題があるため、エンコーディングを明示的に指定する
-    xmlDocPtr doc = htmlReadDoc((const xmlChar*)htmlContent.toStdString().c_str(), nullptr, "UTF-8", HTML_PARSE_RECOVER | HTML_PARSE_NOERROR | HTML_PARSE_NOWARNING);
+    auto doc = ParserPool::getInstance()->parseHtml(htmlContent);
     if (doc == nullptr) {
-        std::cerr << QString("エラー: スレッドURLからHTMLのパースに失敗しました").toStdString() << std::endl;
+        LOG_ERROR(QString("スレッドURLからHTMLのパースに失敗しました"));
         pReply->deleteLater();
 
         return -1;
     }
 
     // XPathで特定の要素を検索
-    auto *xpath = xmlStrdup((const xmlChar*)_xpath.toUtf8().constData());
-    xmlXPathObjectPtr result = getNodeset(doc, xpath);
+    auto result = getNodeset(doc.get(), _xpath);
     if (result == nullptr) {
-        std::cerr << QString("エラー: スレッドURLからノードの取得に失敗しました").toStdString() << std::endl;
-        xmlFreeDoc(doc);
+        LOG_ERROR(QString("スレッドURLからノードの取得に失敗しました"));
         pReply->deleteLater();
 
         return -1;
@@ -868,10 +1069,6 @@ int HtmlFetcher::extractThreadTitle(const QUrl &url, bool redirect, const QStrin
     // エレメントを取得
     m_Element = content;
 
-    xmlXPathFreeObject(result);
-    xmlFreeDoc(doc);
-    xmlCleanupParser();
-
     pReply->deleteLater();
 
     return 0;
@@ -6,9 +6,19 @@
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QRegularExpression>
+#include <QVector>
 #include <libxml/HTMLparser.h>
 #include <libxml/xpath.h>
 #include <memory>
+#include <functional>
+#include "XmlPtr.h"
+
+
+// 並行して取得したニュース記事の本文
+struct FETCH_RESULT {
+    int     Result  = -1;       // 取得結果 (0 : 成功、-1 : 失敗)
+    QString Paragraph;          // ニュース記事の本文の一部
+};
 
 
 class HtmlFetcher : public QObject
@@ -24,9 +34,13 @@ private:  // Variables
     QString                                 m_Element;                                  // XPathを使用して取得するエレメント
 
 private:  // Methods
+    QNetworkReply*      getOnce(const QNetworkRequest &request);                        // HTTPリクエストを1度だけ送信して、レスポンスを待機する (再試行しない)
     int                 fetchParagraph(QNetworkReply *reply, const QString& _xpath);    // ニュース記事の本文を取得する
-    xmlXPathObjectPtr   getNodeset(xmlDocPtr doc, const xmlChar *xpath);                // ニュース記事の本文を取得する
+    static XmlPtr::XPathObject getNodeset(xmlDocPtr doc, const QString &xpath);         // XPathで指定したノードセットを取得する (ノードが存在しない場合はnullptr)
     bool                getUrl(const xmlNodeSetPtr nodeset, int elementType);           // 時事ドットコムの速報記事の"<この速報の記事を読む>"の部分のリンクを取得する
+    void                fetchPages(const QList<QUrl> &urls, bool redirect,              // 複数のURLに同時にアクセスして、それぞれのHTMLドキュメントからextractで値を抽出する
+                                   const std::function<int(xmlDocPtr, QString&)> &extract,          // extractはワーカスレッドで実行する
+                                   const std::function<void(const QVector<FETCH_RESULT>&)> &done);  // 全ての完了時に、メインスレッドでdoneに結果を渡す
 
 public:   // Methods
     explicit HtmlFetcher(QObject *parent = nullptr);
@@ -37,6 +51,11 @@ public:   // Methods
                               const QString ExpiredXPath, bool shiftjis = true);
     int     fetch(const QUrl &url, bool redirect = false,                               // ニュース記事のURLにアクセスして、本文を取得する
                   const QString& _xpath = "//head/meta[@name='description']/@content");
+    void    fetchAll(const QList<QUrl> &urls, bool redirect, const QString &_xpath,     // 複数のニュース記事のURLに同時にアクセスして、それぞれの本文を取得する
+                     const std::function<void(const QVector<FETCH_RESULT>&)> &done);    // 待機せずに戻り、全ての完了時にdoneに結果を渡す (XPathが空の場合は記事の概要を取得)
+    void    fetchAllElements(const QList<QUrl> &urls, bool redirect,                    // 複数のニュース記事のURLに同時にアクセスして、それぞれのXPathで指定した値を取得する
+                             const QString &_xpath, int elementType,                    // 待機せずに戻り、全ての完了時にdoneに結果を渡す
+                             const std::function<void(const QVector<FETCH_RESULT>&)> &done);
     int     fetchElement(const QUrl &url, bool redirect, const QString &_xpath,         // ニュース記事のURLにアクセスして、XPathで指定した値を取得する
                          int elementType);
     int     fetchElementJiJiFlashUrl(const QUrl &url, bool redirect,                    // 時事ドットコムの速報記事のURLにアクセスして、XPathで指定した値を取得する
@@ -46,6 +65,11 @@ public:   // Methods
 
     int     fetchLastThreadNum(const QUrl &url, bool redirect, const QString &_xpath,   // 書き込むスレッドの最後尾のレス番号を取得する
                                int elementType);
+    int     extractParagraph(xmlDocPtr doc, const QString &_xpath);                     // パース済みのHTMLドキュメントから、XPathで指定したニュース記事の本文を抽出する
+    static int extractParagraph(xmlDocPtr doc, const QString &_xpath,                   // パース済みのHTMLドキュメントから、XPathで指定したニュース記事の本文を抽出する
+                                long long maxParagraph, QString &paragraph);            // (ワーカスレッドから実行できる)
+    static int extractElement(xmlDocPtr doc, const QString &_xpath,                     // パース済みのHTMLドキュメントから、XPathで指定した値を抽出する
+                              int elementType, QString &element);                       // (ワーカスレッドから実行できる)
     int     extractThreadPath(const QString &htmlContent, const QString &bbs);          // 新規作成したスレッドからスレッドのパスおよびスレッド番号を抽出する
     int     extractThreadTitle(const QUrl &url, bool redirect,                          // 既存のスレッドからスレッドのタイトルを抽出する
                                const QString &_xpath, bool bShiftJIS);
@@ -0,0 +1,201 @@
+#include <QMutexLocker>
+#include <QDir>
+#include <QFile>
+#include <QCryptographicHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <memory>
+#include "HttpReplay.h"
+#include "Logger.h"
+
+
+// 静的メンバの初期化
+HttpReplay* HttpReplay::m_instance = nullptr;
+QMutex      HttpReplay::m_mutex;
+
+
+HttpReplay::HttpReplay(QObject *parent) : QObject{parent}
+{
+}
+
+
+HttpReplay::~HttpReplay()
+{
+}
+
+
+// シングルトンインスタンスを取得するための静的メソッド
+HttpReplay* HttpReplay::getInstance()
+{
+    if (m_instance == nullptr) {
+        QMutexLocker locker(&m_mutex);
+
+        if (m_instance == nullptr) {
+            m_instance = new HttpReplay();
+        }
+    }
+
+    return m_instance;
+}
+
+
+// メソッドとURLから、コーパスのキーを生成
+// URLのフラグメントは、サーバに送信されないため除外する
+QString HttpReplay::key(const QString &method, const QUrl &url)
+{
+    const auto source = method.toUpper() + " " + url.adjusted(QUrl::RemoveFragment).toString(QUrl::FullyEncoded);
+
+    return QString::fromLatin1(QCryptographicHash::hash(source.toUtf8(), QCryptographicHash::Sha1).toHex().left(16));
+}
+
+
+// 操作の種類からメソッド名を取得
+QString HttpReplay::methodName(QNetworkAccessManager::Operation op, const QNetworkRequest &request)
+{
+    switch (op) {
+        case QNetworkAccessManager::HeadOperation:      return "HEAD";
+        case QNetworkAccessManager::GetOperation:       return "GET";
+        case QNetworkAccessManager::PutOperation:       return "PUT";
+        case QNetworkAccessManager::PostOperation:      return "POST";
+        case QNetworkAccessManager::DeleteOperation:    return "DELETE";
+        default:
+            return QString::fromLatin1(request.attribute(QNetworkRequest::CustomVerbAttribute).toByteArray());
+    }
+}
+
+
+// HTTP通信の記録 / 再生に関する設定を指定
+int HttpReplay::setReplayInfo(const REPLAY_INFO &info)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_Info = info;
+    m_Sequence.clear();
+
+    if (m_Info.Mode == "record") {
+        if (m_Info.Directory.isEmpty() || !QDir().mkpath(m_Info.Directory)) {
+            LOG_ERROR(QString("コーパスのディレクトリ %1 の作成に失敗").arg(m_Info.Directory));
+            m_Info.Mode = "off";
+
+            return -1;
+        }
+
+        LOG_INFO(QString("HTTP通信を %1 に記録します").arg(m_Info.Directory));
+    }
+    else if (m_Info.Mode == "replay") {
+        m_Server = QUrl(m_Info.Server);
+        if (!m_Server.isValid() || m_Server.host().isEmpty()) {
+            LOG_ERROR(QString("再生サーバのURL %1 が不正です").arg(m_Info.Server));
+            m_Info.Mode = "off";
+
+            return -1;
+        }
+
+        LOG_INFO(QString("全てのHTTPリクエストを %1 に送信します").arg(m_Info.Server));
+    }
+    else {
+        m_Info.Mode = "off";
+    }
+
+    return 0;
+}
+
+
+// 記録中かどうか
+bool HttpReplay::isRecording() const
+{
+    return m_Info.Mode == "record";
+}
+
+
+// 再生中かどうか
+bool HttpReplay::isReplaying() const
+{
+    return m_Info.Mode == "replay";
+}
+
+
+// リクエストの送信先を再生サーバに変更
+// パスおよびクエリは元のURLのまま (ログで判別しやすくするため) として、元のURLはヘッダで通知する
+QNetworkRequest HttpReplay::rewrite(const QNetworkRequest &request) const
+{
+    const auto original = request.url();
+
+    QUrl url(original);
+    url.setScheme(m_Server.scheme());
+    url.setHost(m_Server.host());
+    url.setPort(m_Server.port());
+    url.setUserInfo(QString());
+
+    QNetworkRequest replay(request);
+    replay.setUrl(url);
+    replay.setRawHeader(URL_HEADER, original.adjusted(QUrl::RemoveFragment).toString(QUrl::FullyEncoded).toUtf8());
+
+    return replay;
+}
+
+
+// レスポンスの受信完了時に、コーパスに保存する
+// 各クラスはfinishedシグナルの後にレスポンスを読み込むため、先に接続したこのスロットではpeek()メソッドで読み込む
+void HttpReplay::watch(QNetworkReply *reply, const QString &method, const QUrl &url)
+{
+    auto pTimer = std::make_shared<QElapsedTimer>();
+    pTimer->start();
+
+    connect(reply, &QNetworkReply::finished, this, [this, reply, method, url, pTimer]() {
+        save(reply, method, url, pTimer->elapsed());
+    });
+}
+
+
+// レスポンスをコーパスに保存
+// <キー>-<連番>.json にメタデータ (メソッド、URL、ステータスコード、ヘッダ、応答時間)、<キー>-<連番>.body にボディを保存する
+void HttpReplay::save(QNetworkReply *reply, const QString &method, const QUrl &url, qint64 elapsed)
+{
+    const auto status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status == 0) {
+        // 接続エラー等でレスポンスが存在しない場合は記録しない (再生サーバは未記録のURLに404を返す)
+        LOG_WARNING(QString("%1 のレスポンスが無いため記録しません (%2)").arg(url.toString(), reply->errorString()));
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    const auto base     = key(method, url);
+    const auto sequence = m_Sequence.value(base, 0);
+    m_Sequence.insert(base, sequence + 1);
+
+    const auto name = QString("%1-%2").arg(base).arg(sequence, 3, 10, QChar('0'));
+    QDir       dir(m_Info.Directory);
+
+    // ボディは展開済み (Content-Encodingの解除済み) のため、転送に関するヘッダは記録しない
+    static const QList<QByteArray> skipHeaders = {"content-length", "content-encoding", "transfer-encoding", "connection", "keep-alive"};
+
+    QJsonArray headers;
+    for (const auto &pair : reply->rawHeaderPairs()) {
+        if (skipHeaders.contains(pair.first.toLower())) continue;
+        headers.append(QJsonArray{QString::fromLatin1(pair.first), QString::fromLatin1(pair.second)});
+    }
+
+    QJsonObject meta;
+    meta["method"]  = method;
+    meta["url"]     = url.adjusted(QUrl::RemoveFragment).toString(QUrl::FullyEncoded);
+    meta["status"]  = status;
+    meta["reason"]  = reply->attribute(QNetworkRequest::HttpReasonPhraseAttribute).toString();
+    meta["elapsed"] = elapsed;
+    meta["headers"] = headers;
+    meta["body"]    = name + ".body";
+
+    QFile bodyFile(dir.filePath(name + ".body"));
+    QFile metaFile(dir.filePath(name + ".json"));
+    if (!bodyFile.open(QIODevice::WriteOnly | QIODevice::Truncate) || !metaFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        LOG_ERROR(QString("%1 の記録に失敗").arg(url.toString()));
+        return;
+    }
+
+    bodyFile.write(reply->peek(reply->bytesAvailable()));
+    metaFile.write(QJsonDocument(meta).toJson(QJsonDocument::Indented));
+
+    LOG_DEBUG(QString("HTTP通信を記録しました : %1 %2").arg(method, url.toString()), {{"file", name}});
+}
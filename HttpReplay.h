@@ -0,0 +1,62 @@
+#ifndef HTTPREPLAY_H
+#define HTTPREPLAY_H
+
+#include <QObject>
+#include <QMutex>
+#include <QHash>
+#include <QUrl>
+#include <QElapsedTimer>
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+
+
+// HTTP通信の記録 / 再生に関する設定
+struct REPLAY_INFO {
+    QString     Mode        = "off";    // 動作モード ("off" : 無効、"record" : 全てのHTTP通信をコーパスに記録、"replay" : 全てのHTTPリクエストを再生サーバに送信)
+    QString     Directory   = "";       // コーパス (記録したHTTP通信) を保存するディレクトリ ("record"の場合)
+    QString     Server      = "";       // 再生サーバのURL ("replay"の場合、例: http://127.0.0.1:18080)
+};
+
+
+// HTTP通信の記録 / 再生
+// "record"の場合は、全てのレスポンス (ステータスコード、ヘッダ、ボディ) を、メソッドとURLから生成したキーごとにコーパスディレクトリへ保存する
+// "replay"の場合は、ニュースサイトおよび掲示板へのリクエストを再生サーバに送信する (元のURLはX-Replay-Urlヘッダで通知する)
+// 各クラスのネットワークオブジェクト (NetworkManagerクラス) から呼ばれる
+class HttpReplay : public QObject
+{
+    Q_OBJECT
+
+public:     // Variables
+    static constexpr const char *URL_HEADER = "X-Replay-Url";       // 再生サーバに元のURLを通知するヘッダ
+
+private:    // Variables
+    static HttpReplay           *m_instance;    // 静的インスタンスポインタ
+    static QMutex               m_mutex;        // シングルトンとコーパスの操作用のミューテックス
+
+    REPLAY_INFO                 m_Info;         // HTTP通信の記録 / 再生に関する設定
+    QUrl                        m_Server;       // 再生サーバのURL
+    QHash<QString, int>         m_Sequence;     // キーごとに記録したレスポンスの数 (同じURLに複数回アクセスする場合)
+
+private:    // Methods
+    explicit HttpReplay(QObject *parent = nullptr);                         // プライベートコンストラクタ
+    ~HttpReplay() override;                                                 // プライベートデストラクタ
+
+    void            save(QNetworkReply *reply, const QString &method, const QUrl &url, qint64 elapsed);  // レスポンスをコーパスに保存
+
+public:     // Methods
+    HttpReplay(const HttpReplay&)             = delete;                     // コピーコンストラクタの禁止
+    HttpReplay& operator=(const HttpReplay&)  = delete;                     // 代入の禁止
+
+    static HttpReplay* getInstance();                                       // シングルトンインスタンスを取得するための静的メソッド
+    static QString  key(const QString &method, const QUrl &url);            // メソッドとURLから、コーパスのキーを生成
+    static QString  methodName(QNetworkAccessManager::Operation op, const QNetworkRequest &request);   // 操作の種類からメソッド名を取得
+    int             setReplayInfo(const REPLAY_INFO &info);                 // HTTP通信の記録 / 再生に関する設定を指定
+    [[nodiscard]] bool isRecording() const;                                 // 記録中かどうか
+    [[nodiscard]] bool isReplaying() const;                                 // 再生中かどうか
+    QNetworkRequest rewrite(const QNetworkRequest &request) const;          // リクエストの送信先を再生サーバに変更
+    void            watch(QNetworkReply *reply, const QString &method, const QUrl &url);   // レスポンスの受信完了時に、コーパスに保存する
+};
+
+
+#endif // HTTPREPLAY_H
@@ -0,0 +1,91 @@
+#include <QMutexLocker>
+#include <QDateTime>
+#include <algorithm>
+#include "IngestHub.h"
+#include "Logger.h"
+
+
+// 静的メンバの初期化
+IngestHub*  IngestHub::m_instance = nullptr;
+QMutex      IngestHub::m_mutex;
+
+
+IngestHub::IngestHub(QObject *parent) : QObject{parent}, m_Freshness(0), m_Fetches(0), m_Shared(0)
+{
+}
+
+
+IngestHub::~IngestHub()
+{
+}
+
+
+// シングルトンインスタンスを取得するための静的メソッド
+IngestHub* IngestHub::getInstance()
+{
+    if (m_instance == nullptr) {
+        QMutexLocker locker(&m_mutex);
+
+        if (m_instance == nullptr) {
+            m_instance = new IngestHub();
+        }
+    }
+
+    return m_instance;
+}
+
+
+// 取得結果を共有する期間 [ミリ秒] を指定
+void IngestHub::setFreshness(qint64 freshness)
+{
+    m_Freshness = std::max<qint64>(freshness, 0);
+}
+
+
+// ニュースサイトの取得の前に、取得済みまたは取得中かどうかを確認
+// 取得済みの場合は、共有する期間内のもののみ記事群を返す
+// それ以外の場合は、取得中として登録して、FETCHを返す
+IngestHub::STATE IngestHub::begin(const QString &key, QList<Article> &articles)
+{
+    auto &entry = m_Entries[key];
+
+    if (entry.Fetching) {
+        m_Shared++;
+        return PENDING;
+    }
+
+    const auto now = QDateTime::currentMSecsSinceEpoch();
+    if (m_Freshness > 0 && entry.Time > 0 && now - entry.Time < m_Freshness) {
+        articles = entry.Articles;
+        m_Shared++;
+
+        return CACHED;
+    }
+
+    entry.Fetching = true;
+    m_Fetches++;
+
+    return FETCH;
+}
+
+
+// 取得したニュース記事群を公開
+// 共有する期間が0の場合は、記事群を保持しない
+void IngestHub::publish(const QString &key, const QList<Article> &articles)
+{
+    auto &entry    = m_Entries[key];
+    entry.Fetching = false;
+    entry.Time     = QDateTime::currentMSecsSinceEpoch();
+    entry.Articles = m_Freshness > 0 ? articles : QList<Article>{};
+
+    emit published(key, articles);
+}
+
+
+// 取得および共有の回数を出力
+void IngestHub::printStatistics() const
+{
+    if (m_Shared == 0) return;
+
+    LOG_INFO(QString("ニュースサイトの取得 : %1回 (テナント間の共有 : %2回)").arg(m_Fetches).arg(m_Shared));
+}
@@ -0,0 +1,66 @@
+#ifndef INGESTHUB_H
+#define INGESTHUB_H
+
+#include <QObject>
+#include <QMutex>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include "Article.h"
+
+
+// 各ニュースサイトから取得したニュース記事群の共有 (マルチテナントモード)
+// 各テナント (Runnerクラス) は、ニュースサイトの取得の前にbegin()メソッドを実行して、他のテナントが取得済みまたは取得中かどうかを確認する
+// 取得したテナントはpublish()メソッドで記事群を公開して、同じニュースサイトを取得する全てのテナント (自身を含む) の候補プールへ追加する
+// これにより、各ニュースサイトのRSSおよびニュース記事のHTMLは、テナントの数に関わらず1回のみ取得およびパースする
+//
+// キーは、ニュースサイトおよび取得結果に影響する設定 (URL、本文の最大文字数等) から生成するため、設定が異なるテナントの間では共有しない
+// 全てのテナントはメインスレッドで動作するため、取得中の他のテナントの完了は待機せずに、publishedシグナルで受け取る
+class IngestHub : public QObject
+{
+    Q_OBJECT
+
+public:     // Variables
+    // 取得の前の確認の結果
+    enum STATE {
+        FETCH       = 0,    // 取得する (取得した後に、publish()メソッドを実行する)
+        CACHED,             // 他のテナントが取得済み (記事群を返す)
+        PENDING             // 他のテナントが取得中 (完了時にpublishedシグナルで受け取る)
+    };
+
+private:    // Variables
+    // ニュースサイトごとの取得結果
+    struct ENTRY {
+        qint64          Time        = 0;        // 取得した時刻 (エポックからの経過時間 [ミリ秒])
+        bool            Fetching    = false;    // 取得中かどうか
+        QList<Article>  Articles;               // 取得したニュース記事群
+    };
+
+    static IngestHub            *m_instance;    // 静的インスタンスポインタ
+    static QMutex               m_mutex;        // シングルトンの操作用のミューテックス
+
+    QHash<QString, ENTRY>       m_Entries;      // キーごとの取得結果
+    qint64                      m_Freshness;    // 取得結果を共有する期間 [ミリ秒] (0の場合は、取得中のもののみ共有する)
+    quint64                     m_Fetches;      // 取得した回数
+    quint64                     m_Shared;       // 取得を省略した回数 (取得済みまたは取得中の記事群を共有した回数)
+
+private:    // Methods
+    explicit IngestHub(QObject *parent = nullptr);                          // プライベートコンストラクタ
+    ~IngestHub() override;                                                  // プライベートデストラクタ
+
+public:     // Methods
+    IngestHub(const IngestHub&)             = delete;                       // コピーコンストラクタの禁止
+    IngestHub& operator=(const IngestHub&)  = delete;                       // 代入の禁止
+
+    static IngestHub*   getInstance();                                      // シングルトンインスタンスを取得するための静的メソッド
+    void                setFreshness(qint64 freshness);                     // 取得結果を共有する期間 [ミリ秒] を指定
+    STATE               begin(const QString &key, QList<Article> &articles);    // ニュースサイトの取得の前に、取得済みまたは取得中かどうかを確認
+    void                publish(const QString &key, const QList<Article> &articles);  // 取得したニュース記事群を公開 (取得に失敗した場合も空の記事群で実行する)
+    void                printStatistics() const;                            // 取得および共有の回数を出力
+
+signals:
+    void                published(const QString &key, const QList<Article> &articles);  // 取得したニュース記事群の公開
+};
+
+
+#endif // INGESTHUB_H
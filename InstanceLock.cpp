@@ -0,0 +1,77 @@
+#include <QFileInfo>
+#include <QDir>
+#include <QCoreApplication>
+#ifdef Q_OS_WIN
+    #include <io.h>
+    #include <windows.h>
+#else
+    #include <sys/file.h>
+#endif
+#include "InstanceLock.h"
+#include "Logger.h"
+
+
+InstanceLock::~InstanceLock()
+{
+    release();
+}
+
+
+// 指定したファイルの所有権を取得
+// ファイルと同じディレクトリに"<ベース名>.lock"を作成して排他ロックし、プロセスIDを書き込む
+// 同じロックファイルを既に所有している場合は何もしない
+int InstanceLock::acquire(const QString &target)
+{
+    QFileInfo targetInfo(target);
+    auto      path = QDir::cleanPath(targetInfo.absoluteDir().filePath(targetInfo.baseName() + ".lock"));
+
+    if (m_Paths.contains(path)) return 0;
+
+    auto file = std::make_unique<QFile>(path);
+    if (!file->open(QIODevice::ReadWrite)) {
+        LOG_ERROR(QString("ロックファイルのオープンに失敗  %1").arg(file->errorString()), {{"file", path}});
+        return -1;
+    }
+
+    if (!lockFile(*file)) {
+        auto owner = QString::fromUtf8(file->readAll()).trimmed();
+        LOG_ERROR(QString("他のプロセスがログファイルまたは設定ファイルを使用しています (プロセスID : %1)").arg(owner.isEmpty() ? "不明" : owner),
+                  {{"file", path}});
+        return -1;
+    }
+
+    // 所有しているプロセスのIDを書き込む (診断用)
+    file->resize(0);
+    file->write(QByteArray::number(QCoreApplication::applicationPid()) + "\n");
+    file->flush();
+
+    m_Paths.append(path);
+    m_Files.push_back(std::move(file));
+
+    return 0;
+}
+
+
+// 全ての所有権を解放
+// 他のプロセスがロックを待機している場合があるため、ロックファイルは削除しない
+void InstanceLock::release()
+{
+    for (auto &file : m_Files) file->close();
+
+    m_Files.clear();
+    m_Paths.clear();
+}
+
+
+// ファイルを排他ロック (待機しない)
+bool InstanceLock::lockFile(QFile &file)
+{
+#ifdef Q_OS_WIN
+    auto       handle     = reinterpret_cast<HANDLE>(::_get_osfhandle(file.handle()));
+    OVERLAPPED overlapped = {};
+
+    return ::LockFileEx(handle, LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY, 0, 1, 0, &overlapped) != 0;
+#else
+    return ::flock(file.handle(), LOCK_EX | LOCK_NB) == 0;
+#endif
+}
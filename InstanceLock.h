@@ -0,0 +1,34 @@
+#ifndef INSTANCELOCK_H
+#define INSTANCELOCK_H
+
+#include <QString>
+#include <QStringList>
+#include <QFile>
+#include <memory>
+#include <vector>
+
+
+// ログファイルおよび設定ファイルの所有権 (プロセス単位の排他ロック)
+// 起動時に1度だけ各ファイルと同じディレクトリの"<ベース名>.lock"を排他ロックして、本ソフトウェアの終了まで保持する
+// 他のプロセスがロックを保持している場合は、待機せずに直ちに失敗する
+// ロックはOSが管理するため (flock / LockFileEx)、異常終了した場合もロックは解放される
+// 以降のファイル操作は、プロセス内のミューテックスのみで排他する
+class InstanceLock
+{
+private:    // Variables
+    QStringList                             m_Paths;    // ロックしたファイルのパス
+    std::vector<std::unique_ptr<QFile>>     m_Files;    // ロックしたファイル (閉じるとロックを解放する)
+
+public:     // Methods
+    InstanceLock() = default;
+    ~InstanceLock();
+    InstanceLock(const InstanceLock&)               = delete;               // コピーコンストラクタの禁止
+    InstanceLock& operator=(const InstanceLock&)    = delete;               // 代入の禁止
+
+    int             acquire(const QString &target);                         // 指定したファイルの所有権を取得 (他のプロセスが所有している場合は-1を返す)
+    void            release();                                              // 全ての所有権を解放
+    static bool     lockFile(QFile &file);                                  // 開いているファイルを排他ロック (待機しない、ファイルを閉じるとロックを解放する)
+};
+
+
+#endif // INSTANCELOCK_H
@@ -1,8 +1,9 @@
 #include <libxml/parser.h>
 #include <libxml/tree.h>
-#include <iostream>
 #include "JiJiFlash.h"
+#include "Logger.h"
 #include "HtmlFetcher.h"
+#include "TextNormalizer.h"
 
 
 JiJiFlash::JiJiFlash(long long maxPara, JIJIFLASHINFO Info, QObject *parent) : m_MaxParagraph(maxPara), m_FlashInfo(Info), QObject{parent}
@@ -19,7 +20,7 @@ int JiJiFlash::FetchFlash()
 
     // 速報記事の一覧が記載されているURLにアクセスして速報記事のURLを取得
     if (fetcher.fetchElement(m_FlashInfo.FlashUrl, true, m_FlashInfo.FlashXPath, XML_TEXT_NODE)) {
-        std::cerr << QString("エラー : (時事ドットコム) 速報記事の取得に失敗").toStdString() << std::endl;
+        LOG_ERROR(QString("(時事ドットコム) 速報記事の取得に失敗"));
         return -1;
     }
 
@@ -34,7 +35,7 @@ int JiJiFlash::FetchFlash()
 
     // 速報記事のURLにアクセスして速報記事のタイトル名を取得
     if (fetcher.fetchElement(link, true, m_FlashInfo.TitleXPath, XML_TEXT_NODE)) {
-        std::cerr << QString("エラー : (時事ドットコム) 速報記事のタイトルの取得に失敗").toStdString() << std::endl;
+        LOG_ERROR(QString("(時事ドットコム) 速報記事のタイトルの取得に失敗"));
         return -1;
     }
 
@@ -46,7 +47,7 @@ int JiJiFlash::FetchFlash()
 
     // 速報記事のURLにアクセスして速報記事の本文を取得
     if (fetcher.fetchElement(link, true, m_FlashInfo.ParaXPath, XML_TEXT_NODE)) {
-        std::cerr << QString("エラー : (時事ドットコム) 速報記事の本文の取得に失敗").toStdString() << std::endl;
+        LOG_ERROR(QString("(時事ドットコム) 速報記事の本文の取得に失敗"));
         return -1;
     }
 
@@ -57,11 +58,11 @@ int JiJiFlash::FetchFlash()
     if (paragraph.endsWith(" ")) paragraph.chop(1);
 
     /// 本文が指定文字数以上の場合、指定文字数のみを抽出
-    paragraph = paragraph.size() > m_MaxParagraph ? paragraph.mid(0, static_cast<int>(m_MaxParagraph)) + QString("...") : paragraph;
+    paragraph = TextNormalizer::truncate(paragraph, m_MaxParagraph);
 
     // 速報記事のURLにアクセスして速報記事の公開日を取得
     if (fetcher.fetchElement(link, true, m_FlashInfo.PubDateXPath, XML_TEXT_NODE)) {
-        std::cerr << QString("エラー : (時事ドットコム) 速報記事の公開日の取得に失敗").toStdString() << std::endl;
+        LOG_ERROR(QString("(時事ドットコム) 速報記事の公開日の取得に失敗"));
         return -1;
     }
 
@@ -109,7 +110,7 @@ QString JiJiFlash::convertDate(QString &strDate)
     QString convertDate = "";
 
     if (!dateTime.isValid()) {
-        std::cerr << QString("(時事ドットコム) 日付の変換に失敗 : %1").arg(strDate).toStdString();
+        LOG_ERROR(QString("(時事ドットコム) 日付の変換に失敗 : %1").arg(strDate));
     }
     else {
         convertDate = dateTime.toString("yyyy年M月d日 H時m分");
@@ -1,8 +1,9 @@
 #include <libxml/parser.h>
 #include <libxml/tree.h>
-#include <iostream>
 #include "KyodoFlash.h"
+#include "Logger.h"
 #include "HtmlFetcher.h"
+#include "TextNormalizer.h"
 
 
 KyodoFlash::KyodoFlash(long long maxPara, KYODOFLASHINFO Info, QObject *parent) :
@@ -21,7 +22,7 @@ int KyodoFlash::FetchFlash()
 
     // 速報記事の一覧が記載されているURLにアクセスして速報記事のURLを取得
     if (fetcher.fetchElement(m_FlashInfo.FlashUrl, true, m_FlashInfo.FlashXPath, XML_TEXT_NODE)) {
-        std::cerr << QString("エラー : (共同通信) 速報記事の取得に失敗").toStdString() << std::endl;
+        LOG_ERROR(QString("(共同通信) 速報記事の取得に失敗"));
         return -1;
     }
 
@@ -36,7 +37,7 @@ int KyodoFlash::FetchFlash()
 
     // 速報記事のURLにアクセスして速報記事のタイトル名を取得
     if (fetcher.fetchElement(link, true, m_FlashInfo.TitleXPath, XML_TEXT_NODE)) {
-        std::cerr << QString("エラー : (共同通信) 速報記事のタイトルの取得に失敗").toStdString() << std::endl;
+        LOG_ERROR(QString("(共同通信) 速報記事のタイトルの取得に失敗"));
         return -1;
     }
 
@@ -49,7 +50,7 @@ int KyodoFlash::FetchFlash()
     // 速報記事のURLにアクセスして速報記事の本文を取得
     // 現在、速報記事の本文の取得に失敗した場合でもエラーとしない
     // if (fetcher.fetchParagraphKyodoFlash(link, true, m_FlashInfo.ParaXPath)) {
-    //     std::cerr << QString("エラー : (共同通信) 速報記事の本文の取得に失敗").toStdString() << std::endl;
+    //     LOG_ERROR(QString("(共同通信) 速報記事の本文の取得に失敗"));
     //     return -1;
     // }
 
@@ -66,18 +67,18 @@ int KyodoFlash::FetchFlash()
     if (paragraph.endsWith(" ")) paragraph.chop(1);
 
     /// 本文が指定文字数以上の場合、指定文字数のみを抽出
-    paragraph = paragraph.size() > m_MaxParagraph ? paragraph.mid(0, static_cast<int>(m_MaxParagraph)) + QString("...") : paragraph;
+    paragraph = TextNormalizer::truncate(paragraph, m_MaxParagraph);
 
     // 速報記事のURLにアクセスして速報記事の公開日を取得
     if (fetcher.fetchElement(link, true, m_FlashInfo.PubDateXPath, XML_TEXT_NODE)) {
-        std::cerr << QString("エラー : (共同通信) 速報記事の公開日の取得に失敗").toStdString() << std::endl;
+        LOG_ERROR(QString("(共同通信) 速報記事の公開日の取得に失敗"));
         return -1;
     }
 
     /// 速報記事の本文を取得
     auto date = fetcher.GetElement();
     if (date.isEmpty()) {
-        std::cerr << QString("エラー : (共同通信) 速報記事の公開日の取得に失敗").toStdString() << std::endl;
+        LOG_ERROR(QString("(共同通信) 速報記事の公開日の取得に失敗"));
         return -1;
     }
 
@@ -104,7 +105,7 @@ QString KyodoFlash::convertDate(QString &strDate)
     QString convertDate = "";
 
     if (!dateTime.isValid()) {
-        std::cerr << QString("日付の変換に失敗: %1").arg(strDate).toStdString();
+        LOG_ERROR(QString("日付の変換に失敗: %1").arg(strDate));
     }
     else {
         // "yyyy年M月d日 H時m分" 形式に変換
@@ -0,0 +1,259 @@
+#include <QMutexLocker>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <cstdio>
+#include "Logger.h"
+
+
+// 静的メンバの初期化
+Logger*             Logger::m_instance = nullptr;
+QMutex              Logger::m_mutex;
+std::atomic<int>    Logger::m_Level{Logger::LEVEL_INFO};
+
+
+Logger::Logger() : m_bJson(false), m_Capacity(0), m_Head(0), m_Tail(0), m_Dropped(0), m_bSleeping(false), m_bStop(false)
+{
+    allocate(LOGGING_INFO().Buffer);
+
+    m_pWriter.reset(QThread::create([this]() { writerLoop(); }));
+    m_pWriter->start(QThread::LowPriority);
+}
+
+
+Logger::~Logger()
+{
+    flush();
+
+    m_bStop.store(true);
+    {
+        QMutexLocker locker(&m_WakeMutex);
+        m_Wake.wakeAll();
+    }
+    m_pWriter->wait();
+}
+
+
+// シングルトンインスタンスを取得するための静的メソッド
+// 設定ファイルの読み込み前のログも出力できるように、初回の取得時に既定の設定で出力用スレッドを開始する
+Logger* Logger::getInstance()
+{
+    if (m_instance == nullptr) {
+        QMutexLocker locker(&m_mutex);
+
+        if (m_instance == nullptr) {
+            m_instance = new Logger();
+        }
+    }
+
+    return m_instance;
+}
+
+
+// リングバッファを確保
+// 各要素の通し番号を位置で初期化する (容量は2のべき乗に切り上げる)
+void Logger::allocate(int capacity)
+{
+    quint64 size = 64;
+    while (size < static_cast<quint64>(std::max(capacity, 64))) size <<= 1;
+
+    m_Records  = std::make_unique<RECORD[]>(size);
+    m_Capacity = size;
+    for (quint64 i = 0; i < size; i++) m_Records[i].Sequence.store(i, std::memory_order_relaxed);
+
+    m_Head.store(0);
+    m_Tail.store(0);
+}
+
+
+// ログの出力に関する設定を指定
+// リングバッファを確保し直すため、他のスレッドがログを出力する前に、メインスレッドから実行する
+void Logger::setLoggingInfo(const LOGGING_INFO &info)
+{
+    const auto level = info.Level.toLower();
+    if (level == "debug")           m_Level.store(LEVEL_DEBUG);
+    else if (level == "warning")    m_Level.store(LEVEL_WARNING);
+    else if (level == "error")      m_Level.store(LEVEL_ERROR);
+    else                            m_Level.store(LEVEL_INFO);
+
+    // 設定前のログを出力した後に、リングバッファを確保し直す
+    flush();
+
+    QMutexLocker locker(&m_WakeMutex);
+    m_bJson = info.Format.compare("json", Qt::CaseInsensitive) == 0;
+    if (static_cast<quint64>(info.Buffer) > m_Capacity) allocate(info.Buffer);
+}
+
+
+// ログをリングバッファに追加
+// 空いている要素の位置をアトミックに確保するため、複数のスレッドから同時に追加できる
+// リングバッファが満杯の場合は、ログを破棄する (呼び出し元のスレッドは待機しない)
+void Logger::log(LEVEL level, const QString &message, std::initializer_list<LOG_FIELD> fields)
+{
+    auto    position = m_Head.load(std::memory_order_relaxed);
+    RECORD  *record  = nullptr;
+
+    while (true) {
+        record           = &m_Records[position & (m_Capacity - 1)];
+        const auto seq   = record->Sequence.load(std::memory_order_acquire);
+        const auto diff  = static_cast<qint64>(seq - position);
+
+        if (diff == 0) {
+            if (m_Head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+        }
+        else if (diff < 0) {
+            // 満杯
+            m_Dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else {
+            position = m_Head.load(std::memory_order_relaxed);
+        }
+    }
+
+    record->Level   = level;
+    record->Time    = QDateTime::currentMSecsSinceEpoch();
+    record->Message = message;
+    record->Fields  = QList<LOG_FIELD>(fields);
+    record->Sequence.store(position + 1);
+
+    // 出力用スレッドが待機中の場合は起こす
+    // (出力用スレッドの待機前の確認と順序付けるため、通し番号の更新および待機中かどうかの確認は逐次一貫性のアトミック操作とする)
+    if (m_bSleeping.load()) {
+        QMutexLocker locker(&m_WakeMutex);
+        m_Wake.wakeOne();
+    }
+}
+
+
+// リングバッファのログが全て出力されるまで待機
+void Logger::flush()
+{
+    QMutexLocker locker(&m_WakeMutex);
+
+    while (m_Tail.load() != m_Head.load()) {
+        m_Wake.wakeOne();
+        if (!m_Drained.wait(&m_WakeMutex, 100) && (!m_pWriter || !m_pWriter->isRunning())) break;
+    }
+}
+
+
+// 出力用スレッドの処理
+// リングバッファが空の場合は、ログが追加されるまで待機する
+void Logger::writerLoop()
+{
+    while (true) {
+        QMutexLocker locker(&m_WakeMutex);
+
+        if (drain() > 0) continue;
+
+        m_Drained.wakeAll();
+        if (m_bStop.load()) break;
+
+        // 待機中にした後に追加されたログを取りこぼさないように、もう1度確認する
+        m_bSleeping.store(true);
+        const auto &next = m_Records[m_Tail.load() & (m_Capacity - 1)];
+        if (next.Sequence.load() != m_Tail.load() + 1) m_Wake.wait(&m_WakeMutex, 100);
+        m_bSleeping.store(false);
+    }
+}
+
+
+// リングバッファのログを全て出力
+// UTF-8への変換および書き込みはまとめて行い、書き込みの後に1度だけフラッシュする
+int Logger::drain()
+{
+    QByteArray  out,
+                err;
+    int         count = 0;
+
+    while (true) {
+        const auto tail = m_Tail.load(std::memory_order_relaxed);
+        auto &record    = m_Records[tail & (m_Capacity - 1)];
+        if (record.Sequence.load(std::memory_order_acquire) != tail + 1) break;
+
+        (record.Level >= LEVEL_WARNING || m_bJson ? err : out) += format(record);
+
+        record.Message.clear();
+        record.Fields.clear();
+        record.Sequence.store(tail + m_Capacity, std::memory_order_release);
+        m_Tail.store(tail + 1);
+        count++;
+    }
+
+    // 満杯のため破棄したログの数
+    if (const auto dropped = m_Dropped.exchange(0); dropped > 0) {
+        RECORD record;
+        record.Level   = LEVEL_WARNING;
+        record.Time    = QDateTime::currentMSecsSinceEpoch();
+        record.Message = QString("ログのバッファが満杯のため、%1件のログを破棄しました").arg(dropped);
+        err += format(record);
+    }
+
+    if (!out.isEmpty()) {
+        std::fwrite(out.constData(), 1, static_cast<size_t>(out.size()), stdout);
+        std::fflush(stdout);
+    }
+
+    if (!err.isEmpty()) {
+        std::fwrite(err.constData(), 1, static_cast<size_t>(err.size()), stderr);
+        std::fflush(stderr);
+    }
+
+    return count;
+}
+
+
+// ログを出力形式に変換
+// テキスト形式 : <レベルの接頭辞><メッセージ> [キー=値 ...]
+// JSON形式     : {"time": "...", "level": "...", "message": "...", "キー": "値", ...} (1行に1つ)
+QByteArray Logger::format(const RECORD &record) const
+{
+    if (m_bJson) {
+        QJsonObject object;
+        object["time"]    = QDateTime::fromMSecsSinceEpoch(record.Time).toString(Qt::ISODateWithMs);
+        object["level"]   = levelName(record.Level);
+        object["message"] = record.Message;
+        for (const auto &field : record.Fields) object[field.Key] = field.Value;
+
+        return QJsonDocument(object).toJson(QJsonDocument::Compact) + "\n";
+    }
+
+    auto line = QString(levelPrefix(record.Level)) + record.Message;
+    if (!record.Fields.isEmpty()) {
+        QStringList pairs;
+        for (const auto &field : record.Fields) pairs.append(QString("%1=%2").arg(field.Key, field.Value));
+        line += " [" + pairs.join(" ") + "]";
+    }
+
+    return line.toUtf8() + "\n";
+}
+
+
+// レベル名 (JSON形式)
+const char* Logger::levelName(LEVEL level)
+{
+    switch (level) {
+        case LEVEL_DEBUG:   return "debug";
+        case LEVEL_INFO:    return "info";
+        case LEVEL_WARNING: return "warning";
+        case LEVEL_ERROR:   return "error";
+    }
+
+    return "info";
+}
+
+
+// レベルの接頭辞 (テキスト形式)
+const char* Logger::levelPrefix(LEVEL level)
+{
+    switch (level) {
+        case LEVEL_DEBUG:   return "デバッグ : ";
+        case LEVEL_INFO:    return "情報 : ";
+        case LEVEL_WARNING: return "警告 : ";
+        case LEVEL_ERROR:   return "エラー : ";
+    }
+
+    return "";
+}
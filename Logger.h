@@ -0,0 +1,107 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <QString>
+#include <QList>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <initializer_list>
+
+
+// ログの出力に関する設定
+struct LOGGING_INFO {
+    QString     Level       = "info";   // 出力するログの最低レベル ("debug", "info", "warning", "error")
+    QString     Format      = "text";   // 出力形式 ("text" : テキスト, "json" : 1行ごとのJSON (journald等で使用する))
+    int         Buffer      = 8192;     // リングバッファに保持するログの最大数 (超えた場合は破棄する)
+};
+
+
+// ログのフィールド (キーおよび値の組)
+struct LOG_FIELD {
+    const char  *Key;                   // キー (文字列リテラルのみ)
+    QString     Value;                  // 値
+};
+
+
+// 非同期のログ出力
+// 各スレッドは、レベルを確認した後にログをリングバッファに追加するのみで、UTF-8への変換および標準出力 / 標準エラー出力への書き込みは出力用スレッドで行う
+// リングバッファは複数のスレッドから同時に追加できるロックフリーのキューであり、満杯の場合はログを破棄して、破棄した数を後から出力する
+// レベルの確認はマクロ内で行うため、無効のレベルのログはメッセージの生成 (QString::arg等) も行わない
+//
+// 使用例 : LOG_ERROR(QString("ファイルのオープンに失敗 %1").arg(file.errorString()), {{"file", file.fileName()}});
+class Logger
+{
+public:     // Variables
+    // ログのレベル
+    // Windowsのマクロ (ERROR) と衝突しないように、接頭辞を付ける
+    enum LEVEL {
+        LEVEL_DEBUG     = 0,            // デバッグ (各ニュース記事の詳細等)
+        LEVEL_INFO,                     // 情報
+        LEVEL_WARNING,                  // 警告
+        LEVEL_ERROR                     // エラー
+    };
+
+private:    // Variables
+    // リングバッファの要素
+    struct RECORD {
+        std::atomic<quint64>    Sequence{0};    // 要素の状態を表す通し番号 (書き込み可能 : 位置, 読み込み可能 : 位置 + 1)
+        LEVEL                   Level = LEVEL_INFO;
+        qint64                  Time  = 0;      // 時刻 (エポックからの経過時間 [ミリ秒])
+        QString                 Message;        // メッセージ
+        QList<LOG_FIELD>        Fields;         // フィールド
+    };
+
+    static Logger               *m_instance;    // 静的インスタンスポインタ
+    static QMutex               m_mutex;        // シングルトンの操作用のミューテックス
+    static std::atomic<int>     m_Level;        // 出力するログの最低レベル
+
+    bool                        m_bJson;        // JSON形式で出力するかどうか
+    std::unique_ptr<RECORD[]>   m_Records;      // リングバッファ
+    quint64                     m_Capacity;     // リングバッファの容量 (2のべき乗)
+    std::atomic<quint64>        m_Head;         // 次に追加する位置
+    std::atomic<quint64>        m_Tail;         // 次に出力する位置 (出力用スレッドのみで更新する)
+    std::atomic<quint64>        m_Dropped;      // 満杯のため破棄したログの数
+    std::atomic<bool>           m_bSleeping;    // 出力用スレッドが待機中かどうか
+    std::atomic<bool>           m_bStop;        // 出力用スレッドの終了要求
+    QMutex                      m_WakeMutex;    // 出力用スレッドの待機用のミューテックス
+    QWaitCondition              m_Wake;         // 出力用スレッドの待機条件
+    QWaitCondition              m_Drained;      // リングバッファが空になったことの通知
+    std::unique_ptr<QThread>    m_pWriter;      // 出力用スレッド
+
+private:    // Methods
+    Logger();                                                                   // プライベートコンストラクタ
+    ~Logger();                                                                  // プライベートデストラクタ
+
+    void                allocate(int capacity);                                 // リングバッファを確保
+    void                writerLoop();                                           // 出力用スレッドの処理
+    int                 drain();                                                // リングバッファのログを全て出力 (出力した数を返す)
+    QByteArray          format(const RECORD &record) const;                     // ログを出力形式に変換
+    static const char*  levelName(LEVEL level);                                 // レベル名 (JSON形式)
+    static const char*  levelPrefix(LEVEL level);                               // レベルの接頭辞 (テキスト形式)
+
+public:     // Methods
+    Logger(const Logger&)               = delete;                               // コピーコンストラクタの禁止
+    Logger& operator=(const Logger&)    = delete;                               // 代入の禁止
+
+    static Logger*      getInstance();                                          // シングルトンインスタンスを取得するための静的メソッド
+    static bool         isEnabled(LEVEL level) { return level >= m_Level.load(std::memory_order_relaxed); }  // 指定したレベルのログを出力するかどうか
+    void                setLoggingInfo(const LOGGING_INFO &info);               // ログの出力に関する設定を指定 (メインスレッドから他の処理の開始前に実行する)
+    void                log(LEVEL level, const QString &message,                // ログをリングバッファに追加 (LOG_XXXマクロから使用する)
+                            std::initializer_list<LOG_FIELD> fields = {});
+    void                flush();                                                // リングバッファのログが全て出力されるまで待機
+};
+
+
+// レベルを確認した後に、ログをリングバッファに追加する
+// 引数はメッセージおよびフィールド (省略可)
+#define QNF_LOG(level, ...)     do { if (Logger::isEnabled(level)) Logger::getInstance()->log(level, __VA_ARGS__); } while (false)
+#define LOG_DEBUG(...)          QNF_LOG(Logger::LEVEL_DEBUG,   __VA_ARGS__)
+#define LOG_INFO(...)           QNF_LOG(Logger::LEVEL_INFO,    __VA_ARGS__)
+#define LOG_WARNING(...)        QNF_LOG(Logger::LEVEL_WARNING, __VA_ARGS__)
+#define LOG_ERROR(...)          QNF_LOG(Logger::LEVEL_ERROR,   __VA_ARGS__)
+
+
+#endif // LOGGER_H
@@ -0,0 +1,359 @@
+#include <QMutexLocker>
+#include <QHostAddress>
+#include <QTcpSocket>
+#include <QLocalSocket>
+#include <algorithm>
+#include "Metrics.h"
+#include "Logger.h"
+
+
+// 静的メンバの初期化
+Metrics*        Metrics::m_instance = nullptr;
+QMutex          Metrics::m_mutex;
+
+// ヒストグラムのバケットの上限 [秒]
+// HTTPリクエストの応答時間 (数十ミリ秒から数十秒) およびパース時間 (1ミリ秒未満から数百ミリ秒) の両方を分解できる範囲とする
+const double    Metrics::BOUNDS[Metrics::BUCKETS] = {0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0};
+
+
+Metrics::Metrics(QObject *parent) : m_bEnabled(false), QObject{parent}
+{
+    for (auto &size : m_Sizes) size.store(0);
+
+    m_Clock.start();
+}
+
+
+Metrics::~Metrics()
+{
+}
+
+
+// シングルトンインスタンスを取得するための静的メソッド
+Metrics* Metrics::getInstance()
+{
+    if (m_instance == nullptr) {
+        QMutexLocker locker(&m_mutex);
+
+        if (m_instance == nullptr) {
+            m_instance = new Metrics();
+        }
+    }
+
+    return m_instance;
+}
+
+
+// メトリクス名
+const char* Metrics::familyName(FAMILY family)
+{
+    switch (family) {
+        case FETCH_REQUESTS:        return "qnewsflash_fetch_requests_total";
+        case FETCH_BYTES:           return "qnewsflash_fetch_bytes_total";
+        case FETCH_DURATION:        return "qnewsflash_fetch_duration_seconds";
+        case PARSE_DURATION:        return "qnewsflash_parse_duration_seconds";
+        case CANDIDATES_PRODUCED:   return "qnewsflash_candidates_produced_total";
+        case CANDIDATES_FILTERED:   return "qnewsflash_candidates_filtered_total";
+        case SELECTION:             return "qnewsflash_selection_total";
+        case POST_REQUESTS:         return "qnewsflash_post_requests_total";
+        case POST_DURATION:         return "qnewsflash_post_duration_seconds";
+        case TIMER_LAG:             return "qnewsflash_timer_lag_seconds";
+        case LOOP_LAG:              return "qnewsflash_event_loop_lag_seconds";
+        case LOOP_STALLS:           return "qnewsflash_event_loop_stalls_total";
+        default:                    return "";
+    }
+}
+
+
+// メトリクスの説明
+const char* Metrics::familyHelp(FAMILY family)
+{
+    switch (family) {
+        case FETCH_REQUESTS:        return "HTTP requests sent to news sites (including retries) by response status.";
+        case FETCH_BYTES:           return "Response body bytes received from news sites.";
+        case FETCH_DURATION:        return "Latency of each HTTP request to news sites.";
+        case PARSE_DURATION:        return "Time spent parsing RSS and HTML documents on the worker threads.";
+        case CANDIDATES_PRODUCED:   return "Articles extracted from each news site before filtering.";
+        case CANDIDATES_FILTERED:   return "Articles not added to or removed from the candidate pool by reason.";
+        case SELECTION:             return "Outcome of selecting an article from the candidate pool.";
+        case POST_REQUESTS:         return "Posts sent to the board by result.";
+        case POST_DURATION:         return "Latency of each post to the board.";
+        case TIMER_LAG:             return "Delay between the scheduled and the actual firing time of each timer.";
+        case LOOP_LAG:              return "Delay of the main event loop heartbeat.";
+        case LOOP_STALLS:           return "Main event loop stalls longer than the watchdog threshold by the operation running at detection.";
+        default:                    return "";
+    }
+}
+
+
+// ヒストグラムかどうか
+bool Metrics::isHistogram(FAMILY family)
+{
+    return family == FETCH_DURATION || family == PARSE_DURATION || family == POST_DURATION || family == TIMER_LAG || family == LOOP_LAG;
+}
+
+
+// ラベル名
+QStringList Metrics::familyLabels(FAMILY family)
+{
+    switch (family) {
+        case FETCH_REQUESTS:        return {"source", "status"};
+        case FETCH_BYTES:           return {"source"};
+        case FETCH_DURATION:        return {"source"};
+        case PARSE_DURATION:        return {"type"};
+        case CANDIDATES_PRODUCED:   return {"source"};
+        case CANDIDATES_FILTERED:   return {"reason"};
+        case SELECTION:             return {"result", "source"};
+        case POST_REQUESTS:         return {"type", "result"};
+        case POST_DURATION:         return {"type"};
+        case TIMER_LAG:             return {"timer"};
+        case LOOP_LAG:              return {};
+        case LOOP_STALLS:           return {"operation"};
+        default:                    return {};
+    }
+}
+
+
+// ラベルの値をエスケープ (バックスラッシュ、ダブルクォーテーション、改行)
+QString Metrics::escapeLabel(const QString &value)
+{
+    auto escaped = value;
+    escaped.replace("\\", "\\\\").replace("\"", "\\\"").replace("\n", "\\n");
+
+    return escaped;
+}
+
+
+// メトリクスの公開に関する設定を指定
+// 有効の場合は、TCPまたはUNIXドメインソケットで待ち受けを開始する
+int Metrics::setMetricsInfo(const METRICS_INFO &info)
+{
+    m_Info = info;
+    m_pTcpServer.reset();
+    m_pLocalServer.reset();
+
+    m_bEnabled.store(m_Info.Enable, std::memory_order_relaxed);
+    if (!m_Info.Enable) return 0;
+
+    if (!m_Info.Socket.isEmpty()) {
+        // 前回の異常終了で残ったソケットファイルを削除
+        QLocalServer::removeServer(m_Info.Socket);
+
+        m_pLocalServer = std::make_unique<QLocalServer>();
+        if (!m_pLocalServer->listen(m_Info.Socket)) {
+            LOG_ERROR(QString("メトリクスの待ち受けに失敗 (%1) : %2").arg(m_Info.Socket, m_pLocalServer->errorString()));
+            m_pLocalServer.reset();
+
+            return -1;
+        }
+
+        connect(m_pLocalServer.get(), &QLocalServer::newConnection, this, [this]() {
+            while (auto pSocket = m_pLocalServer->nextPendingConnection()) {
+                connect(pSocket, &QLocalSocket::readyRead, this, [this, pSocket]() { serve(pSocket, [pSocket]() { pSocket->disconnectFromServer(); }); });
+                connect(pSocket, &QLocalSocket::disconnected, pSocket, &QLocalSocket::deleteLater);
+            }
+        });
+    }
+    else {
+        m_pTcpServer = std::make_unique<QTcpServer>();
+        if (!m_pTcpServer->listen(QHostAddress(m_Info.Address), static_cast<quint16>(m_Info.Port))) {
+            LOG_ERROR(QString("メトリクスの待ち受けに失敗 (%1:%2) : %3").arg(m_Info.Address).arg(m_Info.Port).arg(m_pTcpServer->errorString()));
+            m_pTcpServer.reset();
+
+            return -1;
+        }
+
+        connect(m_pTcpServer.get(), &QTcpServer::newConnection, this, [this]() {
+            while (auto pSocket = m_pTcpServer->nextPendingConnection()) {
+                connect(pSocket, &QTcpSocket::readyRead, this, [this, pSocket]() { serve(pSocket, [pSocket]() { pSocket->disconnectFromHost(); }); });
+                connect(pSocket, &QTcpSocket::disconnected, pSocket, &QTcpSocket::deleteLater);
+            }
+        });
+    }
+
+    LOG_INFO(QString("メトリクスを公開します (%1)")
+             .arg(m_Info.Socket.isEmpty() ? QString("http://%1:%2/metrics").arg(m_Info.Address).arg(m_Info.Port) : m_Info.Socket));
+
+    return 0;
+}
+
+
+// 系列を取得
+// 登録済みの系列は、登録数をacquireで読み込んだ後に走査するため、ロックは不要
+// 存在しない場合のみ、ミューテックスを取得して登録する
+Metrics::SERIES* Metrics::series(FAMILY family, const QStringList &values)
+{
+    auto size = m_Sizes[family].load(std::memory_order_acquire);
+    for (auto i = 0; i < size; i++) {
+        if (m_Series[family][i].Values == values) return &m_Series[family][i];
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    // 他のスレッドが登録した可能性があるため、再度確認
+    size = m_Sizes[family].load(std::memory_order_relaxed);
+    for (auto i = 0; i < size; i++) {
+        if (m_Series[family][i].Values == values) return &m_Series[family][i];
+    }
+
+    if (size >= MAX_SERIES) return nullptr;
+
+    m_Series[family][size].Values = values;
+    m_Sizes[family].store(size + 1, std::memory_order_release);
+
+    return &m_Series[family][size];
+}
+
+
+// カウンタに加算
+void Metrics::count(FAMILY family, const QStringList &values, quint64 n)
+{
+    if (!m_bEnabled.load(std::memory_order_relaxed)) return;
+
+    if (auto pSeries = series(family, values)) {
+        pSeries->Count.fetch_add(n, std::memory_order_relaxed);
+    }
+}
+
+
+// ヒストグラムに観測値 [マイクロ秒] を記録
+void Metrics::observe(FAMILY family, const QStringList &values, qint64 usec)
+{
+    if (!m_bEnabled.load(std::memory_order_relaxed)) return;
+
+    auto pSeries = series(family, values);
+    if (pSeries == nullptr) return;
+
+    usec = std::max<qint64>(usec, 0);
+
+    // +Infのバケットは観測数から算出する
+    const auto seconds = static_cast<double>(usec) / 1e6;
+    for (auto i = 0; i < BUCKETS; i++) {
+        if (seconds <= BOUNDS[i]) {
+            pSeries->Buckets[i].fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+    }
+
+    pSeries->Sum.fetch_add(static_cast<quint64>(usec), std::memory_order_relaxed);
+    pSeries->Count.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+// タイマの開始 (または、間隔の変更) を記録
+void Metrics::armTimer(const QString &timer, qint64 interval)
+{
+    if (!m_bEnabled.load(std::memory_order_relaxed)) return;
+
+    QMutexLocker locker(&m_mutex);
+    m_Timers[timer] = {m_Clock.elapsed(), interval};
+}
+
+
+// タイマの発火を記録して、予定時刻からの遅延をヒストグラムに記録
+// 繰り返しのタイマは発火した時刻から次の間隔を計測するため、発火した時刻を次の基準とする
+void Metrics::timerFired(const QString &timer)
+{
+    if (!m_bEnabled.load(std::memory_order_relaxed)) return;
+
+    qint64 lag = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+
+        auto it = m_Timers.find(timer);
+        if (it == m_Timers.end()) return;
+
+        const auto now = m_Clock.elapsed();
+        lag          = now - (it->ArmedAt + it->Interval);
+        it->ArmedAt  = now;
+    }
+
+    observe(TIMER_LAG, {timer}, lag * 1000);
+}
+
+
+// 全てのメトリクスをPrometheusのテキスト形式 (version 0.0.4) で出力
+QByteArray Metrics::render()
+{
+    QByteArray text;
+
+    for (auto f = 0; f < FAMILY_COUNT; f++) {
+        const auto family = static_cast<FAMILY>(f);
+        const auto name   = QByteArray(familyName(family));
+        const auto labels = familyLabels(family);
+        const auto size   = m_Sizes[family].load(std::memory_order_acquire);
+
+        text += "# HELP " + name + " " + familyHelp(family) + "\n";
+        text += "# TYPE " + name + (isHistogram(family) ? " histogram\n" : " counter\n");
+
+        for (auto i = 0; i < size; i++) {
+            const auto &series = m_Series[family][i];
+
+            QStringList pairs;
+            for (auto l = 0; l < labels.size(); l++) {
+                pairs.append(QString("%1=\"%2\"").arg(labels.at(l), escapeLabel(series.Values.value(l))));
+            }
+            const auto labelText = pairs.join(",").toUtf8();
+            const auto labelSet  = labelText.isEmpty() ? QByteArray() : "{" + labelText + "}";
+
+            if (!isHistogram(family)) {
+                text += name + labelSet + " " + QByteArray::number(series.Count.load(std::memory_order_relaxed)) + "\n";
+                continue;
+            }
+
+            // 各バケットは累積値で出力する
+            // 記録中に読み込む場合があるため、+Infのバケットは各バケットの合計と観測数の大きい方とする
+            quint64 cumulative = 0;
+            for (auto b = 0; b < BUCKETS; b++) {
+                cumulative += series.Buckets[b].load(std::memory_order_relaxed);
+                text += name + "_bucket{" + labelText + (labelText.isEmpty() ? "" : ",") + "le=\"" + QByteArray::number(BOUNDS[b]) + "\"} "
+                        + QByteArray::number(cumulative) + "\n";
+            }
+
+            const auto count = std::max(cumulative, series.Count.load(std::memory_order_relaxed));
+            text += name + "_bucket{" + labelText + (labelText.isEmpty() ? "" : ",") + "le=\"+Inf\"} " + QByteArray::number(count) + "\n";
+            text += name + "_sum" + labelSet + " "
+                    + QByteArray::number(static_cast<double>(series.Sum.load(std::memory_order_relaxed)) / 1e6, 'f', 6) + "\n";
+            text += name + "_count" + labelSet + " " + QByteArray::number(count) + "\n";
+        }
+    }
+
+    return text;
+}
+
+
+// HTTPリクエストを受信して、メトリクスを応答
+// リクエストヘッダを全て受信した後に、1回のみ応答して接続を閉じる
+void Metrics::serve(QIODevice *device, const std::function<void()> &close)
+{
+    if (device->property("responded").toBool()) {
+        device->readAll();
+        return;
+    }
+
+    auto buffer = device->property("buffer").toByteArray() + device->readAll();
+    if (buffer.indexOf("\r\n\r\n") < 0 && buffer.size() < 8192) {
+        device->setProperty("buffer", buffer);
+        return;
+    }
+
+    device->setProperty("responded", true);
+
+    // リクエストライン (例: GET /metrics HTTP/1.1)
+    const auto requestLine = buffer.left(buffer.indexOf("\r\n")).split(' ');
+    const auto method      = requestLine.value(0);
+    const auto path        = requestLine.value(1);
+
+    QByteArray response;
+    if (method == "GET" && (path == "/metrics" || path == "/")) {
+        const auto body = render();
+        response = "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: "
+                   + QByteArray::number(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+    }
+    else {
+        response = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    }
+
+    device->write(response);
+    close();
+}
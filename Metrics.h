@@ -0,0 +1,109 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QObject>
+#include <QMutex>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <QTcpServer>
+#include <QLocalServer>
+#include <atomic>
+#include <memory>
+#include <functional>
+
+
+// メトリクス (Prometheusのテキスト形式) の公開に関する設定
+struct METRICS_INFO {
+    bool        Enable      = false;        // メトリクスの公開の有効 / 無効
+    QString     Address     = "127.0.0.1";  // 待ち受けるアドレス
+    int         Port        = 9464;         // 待ち受けるポート番号
+    QString     Socket      = "";           // UNIXドメインソケットのパス (指定した場合は、TCPの代わりに使用する)
+};
+
+
+// 各ニュースサイトの取得、パース、候補プール、書き込み、タイマの遅延を計測して、Prometheusのテキスト形式で公開する
+// 計測値は、系列 (ラベルの値の組) ごとのアトミックなカウンタおよび固定バケットのヒストグラムに記録するため、記録時にロックは不要
+// 新しい系列を登録する場合のみミューテックスを使用する (系列の数は、ニュースサイトの数等に比例する程度)
+// GET /metrics に応答する (TCPまたはUNIXドメインソケット)
+class Metrics : public QObject
+{
+    Q_OBJECT
+
+public:     // Variables
+    // メトリクスの種類
+    enum FAMILY {
+        FETCH_REQUESTS      = 0,    // ニュースサイトへのリクエスト数 (ラベル : source, status)
+        FETCH_BYTES,                // ニュースサイトから受信したボディのサイズ [バイト] (ラベル : source)
+        FETCH_DURATION,             // ニュースサイトへのリクエストの応答時間 (ラベル : source)
+        PARSE_DURATION,             // RSS / HTMLのパース時間 (ラベル : type)
+        CANDIDATES_PRODUCED,        // 各ニュースサイトから取得したニュース記事の数 (ラベル : source)
+        CANDIDATES_FILTERED,        // 候補プールに追加しなかった、または、候補プールから削除したニュース記事の数 (ラベル : reason)
+        SELECTION,                  // 候補プールからの選択の結果 (ラベル : result, source)
+        POST_REQUESTS,              // 掲示板への書き込みの数 (ラベル : type, result)
+        POST_DURATION,              // 掲示板への書き込みの応答時間 (ラベル : type)
+        TIMER_LAG,                  // タイマの発火の遅延 (ラベル : timer)
+        LOOP_LAG,                   // メインスレッドのイベントループの遅延 (ラベル無し)
+        LOOP_STALLS,                // メインスレッドのイベントループの停止の回数 (ラベル : operation)
+        FAMILY_COUNT
+    };
+
+private:    // Variables
+    static constexpr int    MAX_SERIES  = 64;       // 1種類あたりの系列の最大数 (超えた場合は記録しない)
+    static constexpr int    BUCKETS     = 14;       // ヒストグラムのバケットの数 (+Infを除く)
+    static const double     BOUNDS[BUCKETS];        // ヒストグラムのバケットの上限 [秒]
+
+    // 系列 (ラベルの値の組ごとの計測値)
+    struct SERIES {
+        QStringList             Values;             // ラベルの値 (登録後は変更しない)
+        std::atomic<quint64>    Count{0};           // カウンタの値 (ヒストグラムの場合は観測数)
+        std::atomic<quint64>    Sum{0};             // ヒストグラムの観測値の合計 [マイクロ秒]
+        std::atomic<quint64>    Buckets[BUCKETS]{}; // ヒストグラムのバケットごとの観測数 (累積ではない)
+    };
+
+    // タイマの発火の予定
+    struct TIMER {
+        qint64      ArmedAt     = 0;                // タイマを開始 (または、前回発火) した時刻 [ミリ秒]
+        qint64      Interval    = 0;                // タイマの間隔 [ミリ秒]
+    };
+
+    static Metrics              *m_instance;        // 静的インスタンスポインタ
+    static QMutex               m_mutex;            // シングルトン、系列の登録、タイマの操作用のミューテックス
+
+    METRICS_INFO                m_Info;             // メトリクスの公開に関する設定
+    std::atomic<bool>           m_bEnabled;         // 記録の有効 / 無効 (無効の場合は、記録のメソッドは何もしない)
+    SERIES                      m_Series[FAMILY_COUNT][MAX_SERIES];     // 種類ごとの系列
+    std::atomic<int>            m_Sizes[FAMILY_COUNT];                  // 種類ごとの登録済みの系列の数
+    QHash<QString, TIMER>       m_Timers;           // タイマ名をキーとした発火の予定
+    QElapsedTimer               m_Clock;            // タイマの遅延の計測に使用する単調増加の時計
+    std::unique_ptr<QTcpServer>   m_pTcpServer;     // メトリクスを公開するTCPサーバ
+    std::unique_ptr<QLocalServer> m_pLocalServer;   // メトリクスを公開するUNIXドメインソケットのサーバ
+
+private:    // Methods
+    explicit Metrics(QObject *parent = nullptr);                                                // プライベートコンストラクタ
+    ~Metrics() override;                                                                        // プライベートデストラクタ
+
+    static const char*  familyName(FAMILY family);                                              // メトリクス名
+    static const char*  familyHelp(FAMILY family);                                              // メトリクスの説明
+    static bool         isHistogram(FAMILY family);                                             // ヒストグラムかどうか
+    static QStringList  familyLabels(FAMILY family);                                            // ラベル名
+    static QString      escapeLabel(const QString &value);                                      // ラベルの値をエスケープ
+    SERIES*             series(FAMILY family, const QStringList &values);                       // 系列を取得 (存在しない場合は登録、上限に達した場合はnullptr)
+    QByteArray          render();                                                               // 全てのメトリクスをPrometheusのテキスト形式で出力
+    void                serve(QIODevice *device, const std::function<void()> &close);           // HTTPリクエストを受信して、メトリクスを応答
+
+public:     // Methods
+    Metrics(const Metrics&)             = delete;                                               // コピーコンストラクタの禁止
+    Metrics& operator=(const Metrics&)  = delete;                                               // 代入の禁止
+
+    static Metrics*     getInstance();                                                          // シングルトンインスタンスを取得するための静的メソッド
+    int                 setMetricsInfo(const METRICS_INFO &info);                               // メトリクスの公開に関する設定を指定 (有効の場合は待ち受けを開始)
+    void                count(FAMILY family, const QStringList &values, quint64 n = 1);         // カウンタに加算
+    void                observe(FAMILY family, const QStringList &values, qint64 usec);         // ヒストグラムに観測値 [マイクロ秒] を記録
+    void                armTimer(const QString &timer, qint64 interval);                        // タイマの開始 (または、間隔の変更) を記録
+    void                timerFired(const QString &timer);                                       // タイマの発火を記録して、予定時刻からの遅延をヒストグラムに記録
+};
+
+
+#endif // METRICS_H
@@ -0,0 +1,27 @@
+#include "NetworkManager.h"
+#include "HttpReplay.h"
+
+
+NetworkManager::NetworkManager(QObject *parent) : QNetworkAccessManager{parent}
+{
+}
+
+
+// リクエストを送信
+// 再生中の場合は送信先を再生サーバに変更して、記録中の場合はレスポンスの受信完了時にコーパスに保存する
+QNetworkReply* NetworkManager::createRequest(Operation op, const QNetworkRequest &request, QIODevice *outgoingData)
+{
+    auto pReplay = HttpReplay::getInstance();
+
+    if (pReplay->isReplaying()) {
+        return QNetworkAccessManager::createRequest(op, pReplay->rewrite(request), outgoingData);
+    }
+
+    auto pReply = QNetworkAccessManager::createRequest(op, request, outgoingData);
+
+    if (pReplay->isRecording()) {
+        pReplay->watch(pReply, HttpReplay::methodName(op, request), request.url());
+    }
+
+    return pReply;
+}
@@ -0,0 +1,24 @@
+#ifndef NETWORKMANAGER_H
+#define NETWORKMANAGER_H
+
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+
+
+// 各クラスがニュースサイトおよび掲示板にアクセスするためのネットワークオブジェクト
+// 全てのリクエストはcreateRequest()メソッドを経由するため、HTTP通信の記録 / 再生 (HttpReplayクラス) をここで行う
+class NetworkManager : public QNetworkAccessManager
+{
+    Q_OBJECT
+
+protected:  // Methods
+    QNetworkReply*  createRequest(Operation op, const QNetworkRequest &request, QIODevice *outgoingData = nullptr) override;
+
+public:     // Methods
+    explicit NetworkManager(QObject *parent = nullptr);
+    ~NetworkManager() override = default;
+};
+
+
+#endif // NETWORKMANAGER_H
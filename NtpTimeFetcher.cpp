@@ -1,7 +1,8 @@
 #include <QTimeZone>
 #include <QHostInfo>
-#include <iostream>
 #include "NtpTimeFetcher.h"
+#include "Logger.h"
+#include "DnsCache.h"
 
 
 NtpTimeFetcher::NtpTimeFetcher(QObject *parent) 
@@ -30,42 +31,50 @@ void NtpTimeFetcher::fetchTime(const QString &server)
     QByteArray requestData(48, 0);
     requestData[0] = 0b00100011;  // LI=0, Version=4, Mode=3 (client)
     
-    std::cerr << "NTPサーバーに接続中: " << server.toStdString() << std::endl;
+    LOG_DEBUG(QString("NTPサーバーに接続中"), {{"server", server}});
     
     // UDPなのでwriteDatagramを使用（これが重要！）
     qint64 bytesWritten = m_pSocket->writeDatagram(requestData, QHostAddress(server), 123);
     
+    if (bytesWritten == -1) {
+        // ホスト名の場合、DNSキャッシュに名前解決の結果が存在する場合はそれを使用
+        auto addresses = DnsCache::getInstance()->lookup(server);
+        if (!addresses.isEmpty()) {
+            bytesWritten = m_pSocket->writeDatagram(requestData, addresses.first(), 123);
+        }
+    }
+
     if (bytesWritten == -1) {
         // ホスト名の場合は名前解決が必要
         QHostInfo::lookupHost(server, this, [this, requestData](const QHostInfo &host) {
             if (host.error() != QHostInfo::NoError) {
-                std::cerr << "ホスト名の解決に失敗: " << host.errorString().toStdString() << std::endl;
+                LOG_ERROR(QString("ホスト名の解決に失敗: %1").arg(host.errorString()));
                 emit error("ホスト名の解決に失敗: " + host.errorString());
                 emit finished();
                 return;
             }
             
             if (host.addresses().isEmpty()) {
-                std::cerr << "ホストのアドレスが見つかりません" << std::endl;
+                LOG_ERROR(QString("ホストのアドレスが見つかりません"));
                 emit error("ホストのアドレスが見つかりません");
                 emit finished();
                 return;
             }
             
             QHostAddress ntpAddress = host.addresses().first();
-            std::cerr << "解決されたアドレス: " << ntpAddress.toString().toStdString() << std::endl;
+            LOG_DEBUG(QString("解決されたアドレス"), {{"address", ntpAddress.toString()}});
             
             qint64 bytes = m_pSocket->writeDatagram(requestData, ntpAddress, 123);
             if (bytes == -1) {
-                std::cerr << "データ送信に失敗" << std::endl;
+                LOG_ERROR(QString("データ送信に失敗"));
                 emit error("データ送信に失敗");
                 emit finished();
             } else {
-                std::cerr << "NTPリクエスト送信: " << bytes << " バイト" << std::endl;
+                LOG_DEBUG(QString("NTPリクエスト送信"), {{"bytes", QString::number(bytes)}});
             }
         });
     } else {
-        std::cerr << "NTPリクエスト送信: " << bytesWritten << " バイト" << std::endl;
+        LOG_DEBUG(QString("NTPリクエスト送信"), {{"bytes", QString::number(bytesWritten)}});
     }
     
     // タイムアウトタイマを開始（5秒）
@@ -85,11 +94,10 @@ void NtpTimeFetcher::readNtpReply()
         quint16 senderPort;
         m_pSocket->readDatagram(replyData.data(), replyData.size(), &sender, &senderPort);
         
-        std::cerr << "NTP応答受信: " << replyData.size() << " バイト from " 
-                  << sender.toString().toStdString() << std::endl;
+        LOG_DEBUG(QString("NTP応答受信"), {{"bytes", QString::number(replyData.size())}, {"sender", sender.toString()}});
         
         if (replyData.size() < 48) {
-            std::cerr << "NTP応答が短すぎます" << std::endl;
+            LOG_ERROR(QString("NTP応答が短すぎます"));
             emit error("NTP応答が短すぎます");
             emit finished();
             return;
@@ -110,7 +118,7 @@ void NtpTimeFetcher::readNtpReply()
         // 日本時間に変換
         m_japanDateTime = utcDateTime.toTimeZone(QTimeZone("Asia/Tokyo"));
         
-        std::cerr << "取得した時刻: " << m_japanDateTime.toString(Qt::ISODate).toStdString() << std::endl;
+        LOG_DEBUG(QString("取得した時刻"), {{"time", m_japanDateTime.toString(Qt::ISODate)}});
     }
     
     emit finished();
@@ -137,7 +145,7 @@ QDateTime NtpTimeFetcher::getDateTime() const
 
 void NtpTimeFetcher::onTimeout()
 {
-    std::cerr << "NTP要求がタイムアウトしました" << std::endl;
+    LOG_ERROR(QString("NTP要求がタイムアウトしました"));
     m_pSocket->abort();
     emit error("NTP要求がタイムアウトしました");
     emit finished();
@@ -147,6 +155,6 @@ void NtpTimeFetcher::onTimeout()
 void NtpTimeFetcher::onError(QAbstractSocket::SocketError socketError)
 {
     Q_UNUSED(socketError);
-    std::cerr << "ソケットエラー: " << m_pSocket->errorString().toStdString() << std::endl;
+    LOG_ERROR(QString("ソケットエラー: %1").arg(m_pSocket->errorString()));
     emit error(m_pSocket->errorString());
 }
@@ -0,0 +1,297 @@
+#include <QCoreApplication>
+#include <QThread>
+#include <QEventLoop>
+#include <QMutexLocker>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <algorithm>
+#include <libxml/catalog.h>
+#include "ParserPool.h"
+#include "Logger.h"
+#include "XmlArena.h"
+#include "Metrics.h"
+#include "Trace.h"
+
+
+// 静的メンバの初期化
+ParserPool* ParserPool::m_instance = nullptr;
+QMutex      ParserPool::m_mutex;
+
+
+ParserPool::ParserPool(QObject *parent) : QObject{parent}, m_bInitialized(false)
+{
+    // libxml2の初期化は、メモリアリーナの設定が確定した後 (最初のパース時、または、設定の指定時) に行う
+    m_Pool.setMaxThreadCount(std::max(QThread::idealThreadCount(), 1));
+}
+
+
+ParserPool::~ParserPool()
+{
+}
+
+
+// シングルトンインスタンスを取得するための静的メソッド
+ParserPool* ParserPool::getInstance()
+{
+    if (m_instance == nullptr) {
+        QMutexLocker locker(&m_mutex);
+
+        if (m_instance == nullptr) {
+            m_instance = new ParserPool();
+        }
+    }
+
+    return m_instance;
+}
+
+
+// HTMLおよびXMLのパース処理に関する設定を指定
+// ワーカスレッドの最大数が0の場合は、CPUのコア数とする
+void ParserPool::setParserInfo(const PARSER_INFO &info)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+
+        // libxml2のメモリ関数は、初期化前にのみ登録できる
+        if (info.Arena && m_bInitialized && !XmlArena::isInstalled()) {
+            LOG_WARNING(QString("libxml2の初期化後はメモリアリーナを有効にできません"));
+            m_Info.Arena = false;
+        }
+        else {
+            m_Info.Arena = info.Arena;
+        }
+
+        m_Info.Threads = info.Threads;
+    }
+
+    m_Pool.setMaxThreadCount(m_Info.Threads > 0 ? m_Info.Threads : std::max(QThread::idealThreadCount(), 1));
+
+    initialize();
+}
+
+
+// libxml2を初期化
+// 複数のスレッドからlibxml2を使用する場合は、事前にメインスレッドで初期化する必要がある
+// メモリアリーナが有効の場合は、libxml2のメモリ関数を先に登録して、libxml2内部の大域的な領域はアリーナ外に確保する
+void ParserPool::initialize()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_bInitialized) return;
+
+    if (m_Info.Arena && !XmlArena::install()) {
+        LOG_WARNING(QString("libxml2のメモリ関数の登録に失敗したため、メモリアリーナを無効にします"));
+        m_Info.Arena = false;
+    }
+
+    xmlInitParser();
+    LIBXML_TEST_VERSION
+
+#ifdef LIBXML_CATALOG_ENABLED
+    // カタログはパース中に遅延して初期化される場合があるため、アリーナ内に確保されないように事前に初期化する
+    xmlInitializeCatalog();
+#endif
+
+    m_bInitialized = true;
+}
+
+
+// メモリアリーナの統計情報を取得
+ParserPool::ARENA_STATS ParserPool::arenaStats()
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_ArenaStats;
+}
+
+
+// ワーカスレッドで処理を実行して、完了するまでイベントループを処理しながら待機
+// メインスレッド以外から呼ばれた場合は、呼び出し元のスレッドで実行する
+void ParserPool::execute(const std::function<void()> &job)
+{
+    initialize();
+
+    if (QCoreApplication::instance() == nullptr || QThread::currentThread() != QCoreApplication::instance()->thread()) {
+        job();
+        return;
+    }
+
+    QEventLoop loop;
+    m_Pool.start([&job, &loop]() {
+        job();
+
+        // 完了の通知は、キュー接続でメインスレッドのイベントループに送る
+        QMetaObject::invokeMethod(&loop, "quit", Qt::QueuedConnection);
+    });
+    loop.exec();
+}
+
+
+// メモリアリーナ内でパースおよび走査 (ワーカスレッドで実行)
+// パースおよび走査中にlibxml2が確保する領域 (ノード、文字列、辞書、パーサコンテキスト、XPathの評価結果) は全てアリーナ内に確保して、
+// 走査の完了後に、ドキュメントを含めてアリーナごと一括で解放する (xmlFreeDoc()関数は呼ばない)
+// アリーナを無効にした後にドキュメントを操作すると、アリーナ外の領域がドキュメントから参照されて解放されないため、ドキュメントはこのメソッドの外に渡さない
+void ParserPool::walkInArena(const std::function<xmlDocPtr()> &parse, const std::function<void(xmlDocPtr)> &walk)
+{
+    // スレッドごとのエラー情報の文字列がアリーナ内を参照しないように、パースの前および走査の後でエラー情報を消去する
+    xmlResetLastError();
+
+    XmlArena arena;
+    arena.activate();
+    walk(parse());
+    xmlResetLastError();
+    arena.deactivate();
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        m_ArenaStats.Documents++;
+        m_ArenaStats.TotalBytes += static_cast<qint64>(arena.bytes());
+        m_ArenaStats.LastBytes   = static_cast<qint64>(arena.bytes());
+        m_ArenaStats.PeakBytes   = std::max(m_ArenaStats.PeakBytes, static_cast<qint64>(arena.reserved()));
+    }
+
+    LOG_DEBUG(QString("メモリアリーナ : %1[バイト]を要求、%2[バイト]を確保").arg(arena.bytes()).arg(arena.reserved()));
+}
+
+
+// XML (RSS) をパース
+// 戻り値のドキュメントは、スコープを抜ける時に解放される
+// ドキュメントはメインスレッドで走査するため、メモリアリーナは使用しない
+XmlPtr::Doc ParserPool::parseXml(const QByteArray &data)
+{
+    TraceSpan span("parse", "ParserPool::parseXml");
+
+    xmlDocPtr doc = nullptr;
+
+    execute([&doc, &data]() {
+        TraceSpan workerSpan("parse", "xmlReadMemory");
+
+        QElapsedTimer elapsed;
+        elapsed.start();
+
+        doc = xmlReadMemory(data.constData(), static_cast<int>(data.size()), "noname.xml", nullptr, 0);
+
+        Metrics::getInstance()->observe(Metrics::PARSE_DURATION, {"xml"}, elapsed.nsecsElapsed() / 1000);
+    });
+
+    LOG_DEBUG(QString("XMLのパース : %1[バイト]").arg(data.size()), {{"result", doc != nullptr ? "parsed" : "failed"}});
+
+    return XmlPtr::Doc(doc);
+}
+
+
+// HTMLをパース (ワーカスレッドで実行)
+// libxml2ではエンコーディングの自動判定において問題があるため、エンコーディングを明示的に指定する
+htmlDocPtr ParserPool::readHtml(const QString &html)
+{
+    TraceSpan workerSpan("parse", "htmlReadDoc");
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    const auto utf8 = html.toUtf8();
+    auto doc = htmlReadDoc(reinterpret_cast<const xmlChar*>(utf8.constData()), nullptr, "UTF-8",
+                           HTML_PARSE_RECOVER | HTML_PARSE_NOERROR | HTML_PARSE_NOWARNING);
+
+    Metrics::getInstance()->observe(Metrics::PARSE_DURATION, {"html"}, elapsed.nsecsElapsed() / 1000);
+
+    LOG_DEBUG(QString("HTMLのパース : %1[文字]").arg(html.size()), {{"result", doc != nullptr ? "parsed" : "failed"}});
+
+    return doc;
+}
+
+
+// HTMLをパース
+// 戻り値のドキュメントは、スコープを抜ける時に解放される
+// ドキュメントはメインスレッドで走査するため、メモリアリーナは使用しない
+XmlPtr::Doc ParserPool::parseHtml(const QString &html)
+{
+    TraceSpan span("parse", "ParserPool::parseHtml");
+
+    htmlDocPtr doc = nullptr;
+
+    execute([this, &doc, &html]() {
+        doc = readHtml(html);
+    });
+
+    return XmlPtr::Doc(doc);
+}
+
+
+// ワーカスレッドでパースおよび走査して、待機せずに戻る
+// ドキュメントは、走査の後にワーカスレッドで解放する (contextが先に破棄された場合も、ドキュメントは必ず解放される)
+// メモリアリーナが有効の場合は、パースおよび走査をアリーナ内で実行して、走査の後にアリーナごと解放する
+// 完了の通知はキュー接続で本オブジェクト (メインスレッド) に送り、contextが破棄されていない場合のみdoneを実行する
+void ParserPool::parseAsync(const std::function<xmlDocPtr()> &parse, QObject *context,
+                            const std::function<void(xmlDocPtr)> &walk, const std::function<void()> &done)
+{
+    initialize();
+
+    // contextの破棄を検出するためのポインタ、および、メモリアリーナの有効 / 無効は、呼び出し元のスレッドで取得する
+    QPointer<QObject> guard(context);
+
+    bool bArena = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        bArena = m_Info.Arena;
+    }
+
+    m_Pool.start([this, parse, walk, done, guard, bArena]() {
+        if (bArena) {
+            walkInArena(parse, walk);
+        }
+        else {
+            XmlPtr::Doc doc(parse());
+            walk(doc.get());
+        }
+
+        QMetaObject::invokeMethod(this, [done, guard]() {
+            if (!guard.isNull()) done();
+        }, Qt::QueuedConnection);
+    });
+}
+
+
+// XML (RSS) をワーカスレッドでパースして、待機せずに戻る
+// パースしたドキュメントはワーカスレッドでwalkに渡して走査して、完了時にメインスレッドでdoneを実行する
+// 走査の結果は、walkおよびdoneで共有する領域 (std::shared_ptr等) を介して受け渡す
+void ParserPool::parseXmlAsync(const QByteArray &data, QObject *context,
+                               const std::function<void(xmlDocPtr)> &walk, const std::function<void()> &done)
+{
+    parseAsync([data]() {
+        TraceSpan workerSpan("parse", "xmlReadMemory");
+
+        QElapsedTimer elapsed;
+        elapsed.start();
+
+        auto doc = xmlReadMemory(data.constData(), static_cast<int>(data.size()), "noname.xml", nullptr, 0);
+
+        Metrics::getInstance()->observe(Metrics::PARSE_DURATION, {"xml"}, elapsed.nsecsElapsed() / 1000);
+
+        LOG_DEBUG(QString("XMLのパース : %1[バイト]").arg(data.size()), {{"result", doc != nullptr ? "parsed" : "failed"}});
+
+        return doc;
+    }, context, walk, done);
+}
+
+
+// HTMLをワーカスレッドでパースして、待機せずに戻る
+// 走査および完了の通知は、parseXmlAsync()メソッドと同様
+// 複数のHTTPレスポンスのパースおよび本文の抽出を同時に実行するために使用する
+void ParserPool::parseHtmlAsync(const QString &html, QObject *context,
+                                const std::function<void(xmlDocPtr)> &walk, const std::function<void()> &done)
+{
+    parseAsync([this, html]() {
+        return readHtml(html);
+    }, context, walk, done);
+}
+
+
+// 全てのパース処理の完了を待機して、libxml2をクリーンアップ
+// xmlCleanupParser()関数は、他のスレッドがlibxml2を使用していない時に1度だけ呼ぶ必要があるため、終了時のみに実行する
+void ParserPool::shutdown()
+{
+    m_Pool.waitForDone();
+    if (m_bInitialized) xmlCleanupParser();
+}
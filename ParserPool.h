@@ -0,0 +1,84 @@
+#ifndef PARSERPOOL_H
+#define PARSERPOOL_H
+
+#include <QObject>
+#include <QMutex>
+#include <QThreadPool>
+#include <QByteArray>
+#include <QString>
+#include <functional>
+#include <libxml/parser.h>
+#include <libxml/HTMLparser.h>
+#include "XmlPtr.h"
+
+
+// HTMLおよびXMLのパース処理に関する設定
+struct PARSER_INFO {
+    int     Threads = 0;        // ワーカスレッドの最大数 (0の場合はCPUのコア数)
+    bool    Arena   = false;    // ドキュメントごとのメモリアリーナの有効 / 無効
+};
+
+
+// HTMLおよびXMLのパース処理を実行するワーカスレッド群
+// メインスレッドはHTTPレスポンスの受信のみを行い、受信したデータをワーカスレッドに渡してパースする
+// parseXmlAsync()メソッドおよびparseHtmlAsync()メソッドは、パース、走査 (XPathによる抽出等)、ドキュメントの解放までをワーカスレッドで実行して、
+// 完了の通知のみをキュー接続 (Qt::QueuedConnection) でメインスレッドに返す (走査の結果は、呼び出し元が値として受け渡す)
+// parseXml()メソッドおよびparseHtml()メソッドは、パースが完了するまでイベントループを入れ子にして待機する (速報記事等、同期的に取得する処理で使用する)
+// メモリアリーナ (PARSER_INFO::Arena) は、parseXmlAsync()メソッドおよびparseHtmlAsync()メソッドのパースおよび走査の間のみ使用する
+// (parseXml()メソッドおよびparseHtml()メソッドが返すドキュメントは、アリーナ外に確保してxmlFreeDoc()関数で解放する)
+class ParserPool : public QObject
+{
+    Q_OBJECT
+
+public:     // Variables
+    // メモリアリーナの統計情報
+    struct ARENA_STATS {
+        qint64      Documents   = 0;    // アリーナを使用してパースしたドキュメントの数
+        qint64      TotalBytes  = 0;    // 確保を要求された合計サイズ [バイト]
+        qint64      LastBytes   = 0;    // 直前のドキュメントで確保を要求されたサイズ [バイト]
+        qint64      PeakBytes   = 0;    // 1つのドキュメントで確保したチャンク群の合計サイズの最大値 [バイト]
+    };
+
+private:    // Variables
+    static ParserPool           *m_instance;    // 静的インスタンスポインタ
+    static QMutex               m_mutex;        // シングルトンの操作用のミューテックス
+
+    QThreadPool                 m_Pool;         // パース処理を実行するワーカスレッド群
+    PARSER_INFO                 m_Info;         // HTMLおよびXMLのパース処理に関する設定
+    bool                        m_bInitialized; // libxml2を初期化したかどうか
+    ARENA_STATS                 m_ArenaStats;   // メモリアリーナの統計情報
+
+private:    // Methods
+    explicit ParserPool(QObject *parent = nullptr);                         // プライベートコンストラクタ
+    ~ParserPool() override;                                                 // プライベートデストラクタ
+
+    void            initialize();                                           // libxml2を初期化 (メモリアリーナが有効の場合は、先にメモリ関数を登録)
+    void            execute(const std::function<void()> &job);              // ワーカスレッドで処理を実行して、完了するまでイベントループを処理しながら待機
+    void            walkInArena(const std::function<xmlDocPtr()> &parse,    // メモリアリーナ内でパースおよび走査して、アリーナごと解放 (ワーカスレッドで実行)
+                                const std::function<void(xmlDocPtr)> &walk);
+    htmlDocPtr      readHtml(const QString &html);                          // HTMLをパース (ワーカスレッドで実行)
+    void            parseAsync(const std::function<xmlDocPtr()> &parse,     // ワーカスレッドでパースおよび走査して、待機せずに戻る
+                               QObject *context,
+                               const std::function<void(xmlDocPtr)> &walk,
+                               const std::function<void()> &done);
+
+public:     // Methods
+    ParserPool(const ParserPool&)             = delete;                     // コピーコンストラクタの禁止
+    ParserPool& operator=(const ParserPool&)  = delete;                     // 代入の禁止
+
+    static ParserPool* getInstance();                                       // シングルトンインスタンスを取得するための静的メソッド
+    void            setParserInfo(const PARSER_INFO &info);                 // HTMLおよびXMLのパース処理に関する設定を指定
+    ARENA_STATS     arenaStats();                                           // メモリアリーナの統計情報を取得
+    XmlPtr::Doc     parseXml(const QByteArray &data);                       // XML (RSS) をパース (失敗した場合はnullptr)
+    XmlPtr::Doc     parseHtml(const QString &html);                         // HTMLをパース (失敗した場合はnullptr)
+    void            parseXmlAsync(const QByteArray &data, QObject *context, // XML (RSS) をワーカスレッドでパースして、待機せずに戻る
+                                  const std::function<void(xmlDocPtr)> &walk,   // ワーカスレッドでwalkにドキュメント (失敗した場合はnullptr) を渡して走査した後に解放する
+                                  const std::function<void()> &done);           // 完了時に、メインスレッドでdoneを実行する (contextが破棄されている場合は実行しない)
+    void            parseHtmlAsync(const QString &html, QObject *context,   // HTMLをワーカスレッドでパースして、待機せずに戻る
+                                   const std::function<void(xmlDocPtr)> &walk,  // walkおよびdoneは、parseXmlAsync()メソッドと同様
+                                   const std::function<void()> &done);
+    void            shutdown();                                             // 全てのパース処理の完了を待機して、libxml2をクリーンアップ
+};
+
+
+#endif // PARSERPOOL_H
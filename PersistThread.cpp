@@ -0,0 +1,151 @@
+#include <QMutexLocker>
+#include <QDeadlineTimer>
+#include <utility>
+#include "PersistThread.h"
+#include "Trace.h"
+
+
+PersistThread::PersistThread(LOGHANDLER logHandler, DATEHANDLER dateHandler, QObject *parent) : QThread(parent),
+    m_LogHandler(std::move(logHandler)), m_DateHandler(std::move(dateHandler)), m_Next(0), m_Completed(0), m_bStop(false)
+{
+}
+
+
+PersistThread::~PersistThread()
+{
+    stop();
+}
+
+
+// 書き込みに関する設定を指定
+void PersistThread::setPersistInfo(const PERSIST_INFO &info)
+{
+    QMutexLocker locker(&m_Mutex);
+    m_Info = info;
+}
+
+
+// コマンドをキューに追加
+// 待機する場合は、キュー内の先行するコマンドおよび当該コマンドの完了まで待機して、結果を返す
+int PersistThread::submit(COMMAND command, bool wait)
+{
+    QMutexLocker locker(&m_Mutex);
+
+    if (!isRunning()) {
+        m_bStop = false;
+        start(QThread::LowPriority);
+    }
+
+    // 未処理の"update"キーの更新は、最新の値で置き換える
+    if (command.Kind == UPDATE_DATE && !wait) {
+        for (auto &queued : m_Queue) {
+            if (queued.Kind == UPDATE_DATE && !m_Awaited.contains(queued.Sequence)) {
+                queued.Value = command.Value;
+                return 0;
+            }
+        }
+    }
+
+    command.Sequence = ++m_Next;
+    const auto sequence = command.Sequence;
+
+    if (wait) m_Awaited.insert(sequence);
+    m_Queue.append(std::move(command));
+    m_Wake.wakeAll();
+
+    if (!wait) return 0;
+
+    while (m_Completed < sequence) m_Done.wait(&m_Mutex);
+
+    return m_Results.take(sequence);
+}
+
+
+// キュー内の書き込みの後に処理を実行して、結果を返す
+int PersistThread::call(std::function<int()> task)
+{
+    COMMAND command;
+    command.Kind = TASK;
+    command.Task = std::move(task);
+
+    return submit(std::move(command), true);
+}
+
+
+// キュー内の全てのコマンドの完了を待機
+void PersistThread::flush()
+{
+    QMutexLocker locker(&m_Mutex);
+
+    while (isRunning() && m_Completed < m_Next) m_Done.wait(&m_Mutex, 100);
+}
+
+
+// キュー内の全てのコマンドを実行した後に、スレッドを終了
+void PersistThread::stop()
+{
+    {
+        QMutexLocker locker(&m_Mutex);
+        m_bStop = true;
+        m_Wake.wakeAll();
+    }
+
+    wait();
+}
+
+
+// キューのコマンドを順に実行
+// キュー内のコマンドをまとめて取り出して、連続したログファイルへの書き込み (APPEND_LOG, MARK_BOTTOM) は1回の書き込みにまとめる
+void PersistThread::run()
+{
+    QMutexLocker locker(&m_Mutex);
+
+    while (true) {
+        while (m_Queue.isEmpty() && !m_bStop) m_Wake.wait(&m_Mutex);
+        if (m_Queue.isEmpty()) break;
+
+        // 後続の書き込みをまとめるために待機 (完了を待機しているコマンドが存在する場合は待機しない)
+        if (m_Info.Window > 0 && !m_bStop && m_Awaited.isEmpty()) {
+            QDeadlineTimer deadline(m_Info.Window);
+            while (!m_bStop && m_Awaited.isEmpty() && m_Wake.wait(&m_Mutex, deadline)) {}
+        }
+
+        auto batch = std::exchange(m_Queue, {});
+        locker.unlock();
+
+        QList<std::pair<const COMMAND*, int>> results;
+        for (auto i = 0; i < batch.size();) {
+            const auto &command = batch.at(i);
+
+            if (command.Kind == APPEND_LOG || command.Kind == MARK_BOTTOM) {
+                auto last = i;
+                while (last < batch.size() && (batch.at(last).Kind == APPEND_LOG || batch.at(last).Kind == MARK_BOTTOM)) last++;
+
+                TraceSpan span("file", "PersistThread::commit");
+                if (span) span.setArg(QString("%1 commands").arg(last - i));
+
+                const auto result = m_LogHandler(batch.mid(i, last - i));
+                for (; i < last; i++) results.append({&batch.at(i), result});
+            }
+            else if (command.Kind == UPDATE_DATE) {
+                results.append({&command, m_DateHandler(command.Value)});
+                i++;
+            }
+            else {
+                results.append({&command, command.Task ? command.Task() : 0});
+                i++;
+            }
+        }
+
+        for (const auto &[command, result] : std::as_const(results)) {
+            emit completed(command->Kind, command->Sequence, result);
+        }
+
+        locker.relock();
+        for (const auto &[command, result] : std::as_const(results)) {
+            if (m_Awaited.remove(command->Sequence)) m_Results.insert(command->Sequence, result);
+        }
+        m_Completed = batch.last().Sequence;
+        m_Done.wakeAll();
+    }
+}
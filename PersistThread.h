@@ -0,0 +1,87 @@
+#ifndef PERSISTTHREAD_H
+#define PERSISTTHREAD_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QJsonObject>
+#include <QList>
+#include <QHash>
+#include <QSet>
+#include <functional>
+
+
+// ログファイルおよび設定ファイルへの書き込み (永続化) に関する設定
+struct PERSIST_INFO {
+    bool        Wait        = false;    // 書き込みの完了を待機するかどうか (falseの場合は、書き込みを依頼した後に処理を続ける)
+    bool        Fsync       = false;    // 書き込みの後に、ファイルの内容をディスクに同期するかどうか (fsync)
+    int         Window      = 0;        // 後続の書き込みをまとめるために待機する時間 [ミリ秒] (0の場合は、待機中の書き込みのみをまとめる)
+};
+
+
+// ログファイルおよび設定ファイルへの書き込み専用のスレッド
+// 各スレッドは、書き込みの内容をコマンドとしてキューに追加して、書き込みの完了を待たずに処理を続ける (完了はcompletedシグナルで通知する)
+// キューに連続して追加されたログファイルへの書き込みは、1回のロックの取得およびファイルの書き換えにまとめる (グループコミット)
+// 設定ファイルの"update"キーの更新は、キュー内の未処理のものを最新の値で置き換える
+// 読み込み等の結果が必要な処理は、キュー内の書き込みの後に実行して、完了まで待機する
+class PersistThread : public QThread
+{
+    Q_OBJECT
+
+public:     // Variables
+    // コマンドの種類
+    enum KIND {
+        APPEND_LOG      = 0,    // ログファイルに書き込み済みのニュース記事を追加
+        MARK_BOTTOM,            // ログファイルの該当スレッドの"bottom"キーをtrueに更新
+        UPDATE_DATE,            // 設定ファイルの"update"キーを更新
+        TASK                    // 任意の処理 (ログファイルの読み込み等)
+    };
+
+    // コマンド
+    struct COMMAND {
+        KIND                    Kind        = TASK;
+        quint64                 Sequence    = 0;        // 通し番号 (キューに追加した時に割り当てる)
+        QJsonObject             Entry;                  // 追加するログ (APPEND_LOG)
+        QString                 Value;                  // スレッドのURL (MARK_BOTTOM)、日付 (UPDATE_DATE)
+        std::function<int()>    Task;                   // 実行する処理 (TASK)
+    };
+
+    using LOGHANDLER    = std::function<int(const QList<COMMAND> &commands)>;   // ログファイルへの連続した書き込みをまとめて実行する処理
+    using DATEHANDLER   = std::function<int(const QString &date)>;              // 設定ファイルの"update"キーを更新する処理
+
+private:    // Variables
+    PERSIST_INFO        m_Info;             // 書き込みに関する設定
+    LOGHANDLER          m_LogHandler;       // ログファイルへの書き込み
+    DATEHANDLER         m_DateHandler;      // 設定ファイルの"update"キーの更新
+    QMutex              m_Mutex;            // キューの操作用のミューテックス
+    QWaitCondition      m_Wake;             // コマンドの追加の通知
+    QWaitCondition      m_Done;             // コマンドの完了の通知
+    QList<COMMAND>      m_Queue;            // 未処理のコマンド
+    quint64             m_Next;             // 次に割り当てる通し番号
+    quint64             m_Completed;        // 完了したコマンドの最大の通し番号
+    QSet<quint64>       m_Awaited;          // 完了を待機しているコマンドの通し番号
+    QHash<quint64, int> m_Results;          // 完了を待機しているコマンドの結果
+    bool                m_bStop;            // 終了要求
+
+protected:  // Methods
+    void            run() override;                                         // キューのコマンドを順に実行
+
+public:     // Methods
+    PersistThread(LOGHANDLER logHandler, DATEHANDLER dateHandler, QObject *parent = nullptr);
+    ~PersistThread() override;
+    PersistThread(const PersistThread&)             = delete;               // コピーコンストラクタの禁止
+    PersistThread& operator=(const PersistThread&)  = delete;               // 代入の禁止
+
+    void            setPersistInfo(const PERSIST_INFO &info);               // 書き込みに関する設定を指定
+    PERSIST_INFO    getPersistInfo() const { return m_Info; }               // 書き込みに関する設定を取得
+    int             submit(COMMAND command, bool wait);                     // コマンドをキューに追加 (待機する場合は結果、待機しない場合は0を返す)
+    int             call(std::function<int()> task);                        // キュー内の書き込みの後に処理を実行して、結果を返す
+    void            flush();                                                // キュー内の全てのコマンドの完了を待機
+    void            stop();                                                 // キュー内の全てのコマンドを実行した後に、スレッドを終了
+
+signals:
+    void            completed(int kind, quint64 sequence, int result);      // コマンドの完了 (書き込み用スレッドから通知する)
+};
+
+
+#endif // PERSISTTHREAD_H
@@ -0,0 +1,215 @@
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
+#include <cstring>
+#include <algorithm>
+#include "PostedUrlFilter.h"
+#include "InstanceLock.h"
+#include "Logger.h"
+
+
+PostedUrlFilter::PostedUrlFilter() : m_pData(nullptr), m_Segments(0)
+{
+}
+
+
+PostedUrlFilter::~PostedUrlFilter()
+{
+    close();
+}
+
+
+// 書き込み済みのURLの長期間の記録に関する設定を指定
+void PostedUrlFilter::setPostedFilterInfo(const POSTEDFILTER_INFO &info)
+{
+    m_Info     = info;
+    m_Segments = static_cast<quint32>(std::max(m_Info.Horizon, 1)) + 1;
+}
+
+
+// ファイル全体のサイズ
+qint64 PostedUrlFilter::fileSize() const
+{
+    return HEADER_SIZE + static_cast<qint64>(m_Segments) * (8 + SEGMENT_BITS / 8);
+}
+
+
+// 各セグメントの日付の配列
+qint64* PostedUrlFilter::segmentDays() const
+{
+    return reinterpret_cast<qint64*>(m_pData + HEADER_SIZE);
+}
+
+
+// 指定したセグメントのビット配列
+uchar* PostedUrlFilter::segmentBits(quint32 segment) const
+{
+    return m_pData + HEADER_SIZE + static_cast<qint64>(m_Segments) * 8 + static_cast<qint64>(segment) * (SEGMENT_BITS / 8);
+}
+
+
+// ヘッダを書き込み、全てのセグメントを初期化
+void PostedUrlFilter::initialize()
+{
+    std::memset(m_pData, 0, static_cast<size_t>(fileSize()));
+
+    quint32 header[4] = {MAGIC, VERSION, m_Segments, SEGMENT_BITS};
+    std::memcpy(m_pData, header, sizeof(header));
+}
+
+
+// ファイルをメモリマップする
+// ファイルが無い場合、または、セグメント数等が設定と異なる場合は、ファイルを作成し直す
+int PostedUrlFilter::open()
+{
+    close();
+
+    if (!m_Info.Enable) return 0;
+
+    if (!m_Info.File.isEmpty()) {
+        m_File.setFileName(m_Info.File);
+        if (!m_File.open(QIODevice::ReadWrite)) {
+            LOG_WARNING(QString("書き込み済みのURLの記録ファイルを使用できません (%1)").arg(m_File.errorString()));
+        }
+        else if (!InstanceLock::lockFile(m_File)) {
+            // 他のプロセスが同じファイルを使用している場合は、ファイルを使用しない
+            // (異なる掲示板の書き込み済みのURLが混在する、および、セグメント数等が異なる場合に他のプロセスのファイルを初期化してしまうため)
+            m_File.close();
+            LOG_WARNING(QString("書き込み済みのURLの記録ファイルは、他のプロセスが使用しています"), {{"file", m_Info.File}});
+        }
+        else {
+            auto bRecreate = m_File.size() != fileSize();
+            if (!bRecreate) {
+                quint32 header[4] = {};
+                m_File.read(reinterpret_cast<char*>(header), sizeof(header));
+                bRecreate = header[0] != MAGIC || header[1] != VERSION || header[2] != m_Segments || header[3] != SEGMENT_BITS;
+            }
+
+            if (!bRecreate || m_File.resize(fileSize())) {
+                m_pData = m_File.map(0, fileSize());
+            }
+
+            if (m_pData != nullptr) {
+                if (bRecreate) initialize();
+
+                return 0;
+            }
+
+            LOG_WARNING(QString("書き込み済みのURLの記録ファイルを使用できません (%1)").arg(m_File.errorString()));
+            m_File.close();
+        }
+
+        LOG_WARNING(QString("書き込み済みのURLは、本ソフトウェアの終了まで記録されます"));
+    }
+
+    // ファイルを使用できない場合は、メモリ上に記録する
+    m_Memory.fill('\0', fileSize());
+    m_pData = reinterpret_cast<uchar*>(m_Memory.data());
+    initialize();
+
+    return 0;
+}
+
+
+// メモリマップを解除する
+void PostedUrlFilter::close()
+{
+    if (m_File.isOpen()) {
+        if (m_pData != nullptr) m_File.unmap(m_pData);
+        m_File.close();
+    }
+
+    m_Memory.clear();
+    m_pData = nullptr;
+}
+
+
+// 今日の日付 (日本時間のエポックからの日数)
+qint64 PostedUrlFilter::today()
+{
+    return (QDateTime::currentSecsSinceEpoch() + 9 * 60 * 60) / (24 * 60 * 60);
+}
+
+
+// URLから2つのハッシュ値を生成
+// ファイルに記録するため、プロセスごとにシード値が変わるqHash()関数は使用しない (FNV-1a 64ビット)
+void PostedUrlFilter::hashUrl(const QString &url, quint64 &h1, quint64 &h2)
+{
+    const auto bytes = url.toUtf8();
+
+    quint64 hash = 0xCBF29CE484222325ULL;
+    for (const auto byte : bytes) {
+        hash ^= static_cast<uchar>(byte);
+        hash *= 0x100000001B3ULL;
+    }
+
+    // 2つ目のハッシュ値はSplitMix64の最終段で撹拌した値 (奇数にして、全てのビット位置を巡回できるようにする)
+    auto mixed = hash;
+    mixed ^= mixed >> 30;
+    mixed *= 0xBF58476D1CE4E5B9ULL;
+    mixed ^= mixed >> 27;
+    mixed *= 0x94D049BB133111EBULL;
+    mixed ^= mixed >> 31;
+
+    h1 = hash;
+    h2 = mixed | 1;
+}
+
+
+// 記録する期間内に書き込んだURLかどうか
+// ブルームフィルタのため、書き込んでいないURLを書き込み済みと判定する場合がある (1日あたり1000件の場合、約0.001[%])
+bool PostedUrlFilter::contains(const QString &url) const
+{
+    if (m_pData == nullptr || url.isEmpty()) return false;
+
+    quint64 h1 = 0, h2 = 0;
+    hashUrl(url, h1, h2);
+
+    const auto now  = today();
+    const auto days = segmentDays();
+
+    for (quint32 segment = 0; segment < m_Segments; segment++) {
+        // 使用していないセグメント、および、記録する期間を過ぎたセグメントは無視
+        if (days[segment] <= 0 || days[segment] <= now - static_cast<qint64>(m_Segments) || days[segment] > now) continue;
+
+        const auto bits = segmentBits(segment);
+        auto bFound = true;
+        for (auto i = 0; i < HASHES; i++) {
+            const auto bit = (h1 + static_cast<quint64>(i) * h2) % SEGMENT_BITS;
+            if ((bits[bit / 8] & (1U << (bit % 8))) == 0) {
+                bFound = false;
+                break;
+            }
+        }
+
+        if (bFound) return true;
+    }
+
+    return false;
+}
+
+
+// 書き込んだURLを今日のセグメントに記録
+// 今日のセグメントが以前の日付の場合は、初期化して再利用する
+void PostedUrlFilter::add(const QString &url)
+{
+    if (m_pData == nullptr || url.isEmpty()) return;
+
+    quint64 h1 = 0, h2 = 0;
+    hashUrl(url, h1, h2);
+
+    const auto now     = today();
+    const auto segment = static_cast<quint32>(now % m_Segments);
+    const auto days    = segmentDays();
+    const auto bits    = segmentBits(segment);
+
+    if (days[segment] != now) {
+        std::memset(bits, 0, SEGMENT_BITS / 8);
+        days[segment] = now;
+    }
+
+    for (auto i = 0; i < HASHES; i++) {
+        const auto bit = (h1 + static_cast<quint64>(i) * h2) % SEGMENT_BITS;
+        bits[bit / 8] |= static_cast<uchar>(1U << (bit % 8));
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef POSTEDURLFILTER_H
+#define POSTEDURLFILTER_H
+
+#include <QString>
+#include <QFile>
+#include <QByteArray>
+
+
+// 書き込み済みのURLの長期間の記録に関する設定
+struct POSTEDFILTER_INFO {
+    bool        Enable  = true;     // 書き込み済みのURLを長期間記録するかどうか
+    QString     File    = "";       // 記録するファイルのパス
+    int         Horizon = 30;       // 記録する期間 [日]
+};
+
+
+// 書き込み済みのURLを長期間記録するブルームフィルタ
+// ログファイルは今日と昨日の書き込み済みのニュース記事のみを保持するため、それより前に書き込んだニュース記事 (ランキングに長期間残るニュース記事等) を判定する
+// 1日ごとのセグメント (8[KB]) に分割して、記録する期間を過ぎたセグメントから順に再利用する
+// ファイルはメモリマップして使用するため、起動時にファイルを読み込む必要は無い
+// ファイルは使用している間は排他ロックして、他のプロセスと共有しない (他のプロセスが使用している場合は、メモリ上に記録する)
+//
+// ファイルの構造
+//     ヘッダ (マジックナンバー、バージョン、セグメント数、セグメントのビット数) : 16[バイト]
+//     各セグメントの日付 (エポックからの日数) : 8[バイト] × セグメント数
+//     各セグメントのビット配列 : (セグメントのビット数 / 8)[バイト] × セグメント数
+class PostedUrlFilter
+{
+private:    // Variables
+    static constexpr quint32    MAGIC           = 0x464E5051;   // マジックナンバー ("QPNF")
+    static constexpr quint32    VERSION         = 1;            // ファイルのバージョン
+    static constexpr quint32    SEGMENT_BITS    = 1U << 16;     // 1つのセグメントのビット数 (8[KB])
+    static constexpr int        HASHES          = 7;            // 1つのURLにつき設定するビット数
+    static constexpr qint64     HEADER_SIZE     = 16;           // ヘッダのサイズ [バイト]
+
+    POSTEDFILTER_INFO   m_Info;         // 書き込み済みのURLの長期間の記録に関する設定
+    QFile               m_File;         // メモリマップするファイル
+    uchar               *m_pData;       // メモリマップした領域 (ファイルを使用できない場合は、メンバ変数m_Memoryの領域)
+    QByteArray          m_Memory;       // ファイルを使用できない場合に使用するメモリ領域 (終了時に破棄される)
+    quint32             m_Segments;     // セグメント数 (記録する期間 + 1)
+
+private:    // Methods
+    [[nodiscard]] qint64    fileSize() const;                           // ファイル全体のサイズ [バイト]
+    void                    initialize();                               // ヘッダを書き込み、全てのセグメントを初期化
+    [[nodiscard]] qint64    *segmentDays() const;                       // 各セグメントの日付の配列
+    [[nodiscard]] uchar     *segmentBits(quint32 segment) const;        // 指定したセグメントのビット配列
+    static qint64           today();                                    // 今日の日付 (日本時間のエポックからの日数)
+    static void             hashUrl(const QString &url, quint64 &h1, quint64 &h2);  // URLから2つのハッシュ値を生成
+
+public:     // Methods
+    PostedUrlFilter();
+    ~PostedUrlFilter();
+    PostedUrlFilter(const PostedUrlFilter&)             = delete;       // コピーコンストラクタの禁止
+    PostedUrlFilter& operator=(const PostedUrlFilter&)  = delete;       // 代入の禁止
+
+    void                setPostedFilterInfo(const POSTEDFILTER_INFO &info);     // 書き込み済みのURLの長期間の記録に関する設定を指定
+    int                 open();                                                 // ファイルをメモリマップする (ファイルが無い場合は作成する)
+    void                close();                                                // メモリマップを解除する
+    [[nodiscard]] bool  contains(const QString &url) const;                     // 記録する期間内に書き込んだURLかどうか (誤って書き込み済みと判定する場合がある)
+    void                add(const QString &url);                                // 書き込んだURLを記録
+};
+
+
+#endif // POSTEDURLFILTER_H
@@ -6,12 +6,18 @@
     #include <QTextCodec>
 #endif
 
-#include <iostream>
+#include <QElapsedTimer>
 #include "Poster.h"
+#include "Logger.h"
 #include "HtmlFetcher.h"
+#include "RateLimiter.h"
+#include "TlsSessionCache.h"
+#include "NetworkManager.h"
+#include "Metrics.h"
+#include "Trace.h"
 
 
-Poster::Poster(QObject *parent) : m_pManager(std::make_unique<QNetworkAccessManager>(this)), QObject{parent}
+Poster::Poster(QObject *parent) : m_pManager(std::make_unique<NetworkManager>(this)), QObject{parent}
 {
 
 }
@@ -20,17 +26,24 @@ Poster::Poster(QObject *parent) : m_pManager(std::make_unique<QNetworkAccessMana
 // 掲示板のクッキーを取得する
 int Poster::fetchCookies(const QUrl &url)
 {
+    TraceSpan span("board", "Poster::fetchCookies");
+    if (span) span.setArg(url.toString());
+
     // レスポンス待機の設定
     QEventLoop loop;
     connect(m_pManager.get(), &QNetworkAccessManager::finished, &loop, &QEventLoop::quit);
 
     // クッキーの取得
     QNetworkRequest request(url);
+    TlsSessionCache::getInstance()->apply(request);
+    RateLimiter::getInstance()->acquire(url);
     auto pReply = m_pManager->get(request);
 
     // レスポンス待機
     loop.exec();
 
+    TlsSessionCache::getInstance()->store(pReply);
+
     return replyCookieFinished(pReply);
 }
 
@@ -46,7 +59,7 @@ int Poster::replyCookieFinished(QNetworkReply *reply)
     }
     else {
         // クッキーの取得に失敗した場合
-        std::cerr << QString("エラー : クッキーの取得に失敗").toStdString() << std::endl;
+        LOG_ERROR(QString("クッキーの取得に失敗"));
         reply->deleteLater();
 
         return -1;
@@ -61,6 +74,9 @@ int Poster::replyCookieFinished(QNetworkReply *reply)
 // 特定のスレッドに書き込む
 int Poster::PostforWriteThread(const QUrl &url, THREAD_INFO &ThreadInfo)
 {
+    TraceSpan span("board", "Poster::PostforWriteThread");
+    if (span) span.setArg(url.toString());
+
     // リクエストの作成
     QNetworkRequest request(url);
 
@@ -123,20 +139,39 @@ int Poster::PostforWriteThread(const QUrl &url, THREAD_INFO &ThreadInfo)
     QEventLoop loop;
     connect(m_pManager.get(), &QNetworkAccessManager::finished, &loop, &QEventLoop::quit);
 
+    // 前回のTLSセッションチケットが存在する場合は、TLSセッションを再開する
+    TlsSessionCache::getInstance()->apply(request);
+
+    // 掲示板のリクエスト数の制限を超えないように待機
+    RateLimiter::getInstance()->acquire(url);
+
     // HTTPリクエストの送信
+    QElapsedTimer elapsed;
+    elapsed.start();
+
     auto pReply = m_pManager->post(request, encodedPostData);
 
     // レスポンス待機
     loop.exec();
 
+    Metrics::getInstance()->observe(Metrics::POST_DURATION, {"write"}, elapsed.nsecsElapsed() / 1000);
+
+    TlsSessionCache::getInstance()->store(pReply);
+
     // レスポンス情報の取得
-    return replyPostFinished(pReply, ThreadInfo);
+    auto iRet = replyPostFinished(pReply, ThreadInfo);
+    Metrics::getInstance()->count(Metrics::POST_REQUESTS, {"write", iRet == 0 ? "ok" : "error"});
+
+    return iRet;
 }
 
 
 // 新規スレッドを作成する
 int Poster::PostforCreateThread(const QUrl &url, THREAD_INFO &ThreadInfo)
 {
+    TraceSpan span("board", "Poster::PostforCreateThread");
+    if (span) span.setArg(url.toString());
+
     // リクエストの作成
     QNetworkRequest request(url);
 
@@ -198,14 +233,30 @@ int Poster::PostforCreateThread(const QUrl &url, THREAD_INFO &ThreadInfo)
     QEventLoop loop;
     connect(m_pManager.get(), &QNetworkAccessManager::finished, &loop, &QEventLoop::quit);
 
+    // 前回のTLSセッションチケットが存在する場合は、TLSセッションを再開する
+    TlsSessionCache::getInstance()->apply(request);
+
+    // 掲示板のリクエスト数の制限を超えないように待機
+    RateLimiter::getInstance()->acquire(url);
+
     // HTTPリクエストの送信
+    QElapsedTimer elapsed;
+    elapsed.start();
+
     auto pReply = m_pManager->post(request, encodedPostData);
 
     // レスポンス待機
     loop.exec();
 
+    Metrics::getInstance()->observe(Metrics::POST_DURATION, {"create"}, elapsed.nsecsElapsed() / 1000);
+
+    TlsSessionCache::getInstance()->store(pReply);
+
     // レスポンス情報の取得
-    return replyPostFinished(pReply, url, ThreadInfo);
+    auto iRet = replyPostFinished(pReply, url, ThreadInfo);
+    Metrics::getInstance()->count(Metrics::POST_REQUESTS, {"create", iRet == 0 ? "ok" : "error"});
+
+    return iRet;
 }
 
 
@@ -213,7 +264,7 @@ int Poster::PostforCreateThread(const QUrl &url, THREAD_INFO &ThreadInfo)
 int Poster::replyPostFinished(QNetworkReply *reply, THREAD_INFO &ThreadInfo)
 {
     if (reply->error()) {
-        std::cerr << QString("書き込みエラー : %1").arg(reply->errorString()).toStdString() << std::endl;
+        LOG_ERROR(QString("書き込みエラー : %1").arg(reply->errorString()));
         reply->deleteLater();
 
         return -1;
@@ -236,15 +287,13 @@ int Poster::replyPostFinished(QNetworkReply *reply, THREAD_INFO &ThreadInfo)
             replyData = reply->readAll();
         }
 
-#ifdef _DEBUG
-        std::cout << replyData.toStdString() << std::endl;
-#endif
+        LOG_DEBUG(replyData);
 
         // 書き込んだスレッドのパスと番号を取得
         HtmlFetcher fetcher(nullptr);
         if (fetcher.extractThreadPath(replyData, ThreadInfo.bbs)) {
-            std::cerr << QString("エラー : スレッドのURLとスレッド番号の取得に失敗").toStdString() << std::endl;
-            std::cerr << QString("スレッドの書き込みに失敗した可能性があります").toStdString() << std::endl;
+            LOG_ERROR(QString("スレッドのURLとスレッド番号の取得に失敗"));
+            LOG_ERROR(QString("スレッドの書き込みに失敗した可能性があります"));
             reply->deleteLater();
 
             return -1;
@@ -253,8 +302,8 @@ int Poster::replyPostFinished(QNetworkReply *reply, THREAD_INFO &ThreadInfo)
         // 書き込みに成功した場合、レスポンス内容にスレッドのパスと番号が含まれている
         // それらの情報が無ければ書き込みは失敗したと考えられる
         if (fetcher.GetThreadPath().isEmpty() || fetcher.GetThreadNum().isEmpty()) {
-            std::cerr << QString("エラー : スレッドのURLまたはスレッド番号がありません").toStdString() << std::endl;
-            std::cerr << QString("スレッドの書き込みに失敗した可能性があります").toStdString() << std::endl;
+            LOG_ERROR(QString("スレッドのURLまたはスレッド番号がありません"));
+            LOG_ERROR(QString("スレッドの書き込みに失敗した可能性があります"));
             reply->deleteLater();
 
             return -1;
@@ -271,7 +320,7 @@ int Poster::replyPostFinished(QNetworkReply *reply, THREAD_INFO &ThreadInfo)
 int Poster::replyPostFinished(QNetworkReply *reply, const QUrl &url, const THREAD_INFO &ThreadInfo)
 {
     if (reply->error()) {
-        std::cerr << QString("書き込みエラー : %1").arg(reply->errorString()).toStdString() << std::endl;
+        LOG_ERROR(QString("書き込みエラー : %1").arg(reply->errorString()));
         reply->deleteLater();
 
         return -1;
@@ -294,23 +343,21 @@ int Poster::replyPostFinished(QNetworkReply *reply, const QUrl &url, const THREA
             replyData = reply->readAll();
         }
 
-#ifdef _DEBUG
-        std::cout << replyData.toStdString() << std::endl;
-#endif
+        LOG_DEBUG(replyData);
 
         // 新規作成したスレッドのURLのパスを取得
         HtmlFetcher fetcher(nullptr);
         if (fetcher.extractThreadPath(replyData, ThreadInfo.bbs)) {
-            std::cerr << QString("エラー : 新規作成したスレッドのURLとスレッド番号の取得に失敗").toStdString() << std::endl;
-            std::cerr << QString("スレッドの新規作成に失敗した可能性があります").toStdString() << std::endl;
+            LOG_ERROR(QString("新規作成したスレッドのURLとスレッド番号の取得に失敗"));
+            LOG_ERROR(QString("スレッドの新規作成に失敗した可能性があります"));
             reply->deleteLater();
 
             return -1;
         }
 
         if (fetcher.GetThreadPath().isEmpty() || fetcher.GetThreadNum().isEmpty()) {
-            std::cerr << QString("エラー : 新規作成したスレッドのURLまたはスレッド番号がありません").toStdString() << std::endl;
-            std::cerr << QString("スレッドの新規作成に失敗した可能性があります").toStdString() << std::endl;
+            LOG_ERROR(QString("新規作成したスレッドのURLまたはスレッド番号がありません"));
+            LOG_ERROR(QString("スレッドの新規作成に失敗した可能性があります"));
             reply->deleteLater();
 
             return -1;
@@ -331,7 +378,7 @@ int Poster::replyPostFinished(QNetworkReply *reply, const QUrl &url, const THREA
             m_NewThreadTitle = fetcher.GetElement();
         }
         else {
-            std::cerr << QString("スレッドタイトルの抽出に失敗しました").toStdString() << std::endl;
+            LOG_ERROR(QString("スレッドタイトルの抽出に失敗しました"));
             reply->deleteLater();
 
             return -1;
@@ -48,6 +48,8 @@ class Poster : public QObject
 {
     Q_OBJECT
 
+    friend class CoreBench;     // ベンチマーク (bench/CoreBench.cpp) から非公開メソッドを計測するため
+
 private:
     std::unique_ptr<QNetworkAccessManager> m_pManager;          // 掲示板にアクセスするためのネットワークオブジェクト
     QList<QNetworkCookie>                  m_Cookies;           // クッキーを保存
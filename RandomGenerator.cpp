@@ -5,8 +5,8 @@
     #include <fstream>
 #endif
 
-#include <iostream>
 #include "RandomGenerator.h"
+#include "Logger.h"
 
 
 RandomGenerator::RandomGenerator() = default;
@@ -44,7 +44,7 @@ unsigned long long RandomGenerator::csprng()
     std::ifstream urandom("/dev/urandom", std::ios::in | std::ios::binary);
     if (!urandom) {
         // /dev/urandomのオープンに失敗した場合のフォールバック処理
-        std::cerr << QString("警告 : /dev/urandomのオープンに失敗").toStdString() << std::endl;
+        LOG_WARNING(QString("/dev/urandomのオープンに失敗"));
 
         // 代替手段として、高解像度クロックの現在時刻を使用
         // std::chrono::high_resolution_clockの現在の時刻を取得
@@ -126,3 +126,43 @@ int RandomGenerator::Generate(int maxValue)
 
     return randomValue;
 }
+
+
+// SplitMix64アルゴリズム
+// 1つのシード値から、Xorshift128+の内部状態 (全てが0にならない値) を生成するために使用する
+uint64_t RandomGenerator::splitmix64(uint64_t &x)
+{
+    uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+    return z ^ (z >> 31);
+}
+
+
+// Xorshift128+の内部状態をシード値で初期化する
+// 同じシード値を指定した場合は、同じ乱数列を再現できる
+// シード値に0を指定した場合は、Generate()メソッドと同様に、TSCまたは/dev/urandomの値から生成する
+void RandomGenerator::Seed(uint64_t seed)
+{
+    if (seed == 0) {
+        seed = hashTSC(getTSC());
+    }
+
+    m_state[0] = splitmix64(seed);
+    m_state[1] = splitmix64(seed);
+}
+
+
+// 0以上1未満の範囲で一様分布の乱数を生成する
+// Generate()メソッドとは異なり、呼び出しごとにシード値を取得しないため、繰り返し使用する場合に高速である
+// 内部状態が初期化されていない場合のみ、最初の呼び出し時にシード値を取得する
+double RandomGenerator::GenerateReal()
+{
+    if (m_state[0] == 0 && m_state[1] == 0) {
+        Seed(0);
+    }
+
+    // 上位53ビットを倍精度浮動小数点数の仮数部として使用
+    return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+}
@@ -40,10 +40,14 @@ private:  // Methods
     static unsigned long long hashTSC(unsigned long long tsc);  // CPUのタイムスタンプカウンタ(TSC)の値にハッシュ処理を施す
     uint64_t           next();                                  // シード用Xorshift
 
+    static uint64_t    splitmix64(uint64_t &x);                 // シード値から内部状態を生成するためのSplitMix64
+
 public:   // Methods
     explicit RandomGenerator();
     virtual  ~RandomGenerator();
     int      Generate(int maxValue);                            // 乱数の生成 (一様分布)
+    void     Seed(uint64_t seed);                               // 内部状態をシード値で初期化 (0の場合はTSCまたは/dev/urandomから取得)
+    double   GenerateReal();                                    // 0以上1未満の乱数の生成 (一様分布、内部状態を継続して使用)
 };
 
 #endif // RANDOMGENERATOR_H
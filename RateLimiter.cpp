@@ -0,0 +1,110 @@
+#include <QMutexLocker>
+#include <QEventLoop>
+#include <QTimer>
+#include <algorithm>
+#include <cmath>
+#include "RateLimiter.h"
+#include "Logger.h"
+
+
+// 静的メンバの初期化
+RateLimiter*    RateLimiter::m_instance = nullptr;
+QMutex          RateLimiter::m_mutex;
+
+
+RateLimiter::RateLimiter(QObject *parent) : QObject{parent}
+{
+    m_Clock.start();
+}
+
+
+RateLimiter::~RateLimiter()
+{
+}
+
+
+// シングルトンインスタンスを取得するための静的メソッド
+RateLimiter* RateLimiter::getInstance()
+{
+    if (m_instance == nullptr) {
+        QMutexLocker locker(&m_mutex);
+
+        if (m_instance == nullptr) {
+            m_instance = new RateLimiter();
+        }
+    }
+
+    return m_instance;
+}
+
+
+// リクエスト数の制限に関する設定を指定
+// 設定を変更した場合、既存のトークンバケットは破棄する
+void RateLimiter::setRateLimitInfo(const RATELIMIT_INFO &info)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_Info = info;
+    m_Buckets.clear();
+}
+
+
+// 掲示板のbbs.cgiへのリクエストかどうかを確認
+bool RateLimiter::isBoard(const QUrl &url)
+{
+    return url.path().endsWith("bbs.cgi", Qt::CaseInsensitive);
+}
+
+
+// トークンを1つ予約して、送信可能になるまでの待機時間 [ミリ秒] を取得する
+// トークンが不足している場合でも予約は行い (トークン数は負になる)、補充されるまでの時間を返す
+// これにより、同じホストへの複数のリクエストは補充速度の間隔で順番に送信される
+qint64 RateLimiter::reserve(const QUrl &url)
+{
+    QMutexLocker locker(&m_mutex);
+
+    const auto board = isBoard(url);
+    const auto rate  = board ? m_Info.BoardRate  : m_Info.NewsRate;
+    const auto burst = board ? m_Info.BoardBurst : m_Info.NewsBurst;
+
+    // 補充速度が0以下の場合は無制限
+    if (rate <= 0.0) return 0;
+
+    const auto key = board ? url.host() + url.path() : url.host();
+    const auto now = m_Clock.elapsed();
+
+    auto it = m_Buckets.find(key);
+    if (it == m_Buckets.end()) {
+        BUCKET bucket;
+        bucket.Tokens     = burst;
+        bucket.LastRefill = now;
+        bucket.Rate       = rate;
+        bucket.Burst      = std::max(burst, 1);
+
+        it = m_Buckets.insert(key, bucket);
+    }
+
+    // 経過時間分のトークンを補充 (最大数を超えない)
+    it->Tokens     = std::min(static_cast<double>(it->Burst), it->Tokens + (now - it->LastRefill) * it->Rate / 1000.0);
+    it->LastRefill = now;
+
+    // トークンを1つ消費
+    it->Tokens -= 1.0;
+    if (it->Tokens >= 0.0) return 0;
+
+    return static_cast<qint64>(std::ceil(-it->Tokens / it->Rate * 1000.0));
+}
+
+
+// 指定されたURLのホストへリクエストを送信できるまで待機する
+void RateLimiter::acquire(const QUrl &url)
+{
+    auto wait = reserve(url);
+    if (wait <= 0) return;
+
+    LOG_DEBUG(QString("%1 へのリクエストを%2[ミリ秒]待機します").arg(url.host()).arg(wait));
+
+    QEventLoop loop;
+    QTimer::singleShot(static_cast<int>(wait), &loop, &QEventLoop::quit);
+    loop.exec();
+}
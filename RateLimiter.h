@@ -0,0 +1,58 @@
+#ifndef RATELIMITER_H
+#define RATELIMITER_H
+
+#include <QObject>
+#include <QMutex>
+#include <QMap>
+#include <QUrl>
+#include <QElapsedTimer>
+
+
+// ホストごとのリクエスト数の制限 (トークンバケット) に関する設定
+struct RATELIMIT_INFO {
+    double  NewsRate    = 2.0;      // ニュースサイト (掲示板の書き込み以外) へのリクエストの補充速度 [回 / 秒] (0の場合は無制限)
+    int     NewsBurst   = 4;        // ニュースサイトへ連続して送信できるリクエストの最大数
+    double  BoardRate   = 0.1;      // 掲示板のbbs.cgi (書き込みおよびクッキーの取得) へのリクエストの補充速度 [回 / 秒] (0の場合は無制限)
+    int     BoardBurst  = 2;        // 掲示板のbbs.cgiへ連続して送信できるリクエストの最大数
+};
+
+
+class RateLimiter : public QObject
+{
+    Q_OBJECT
+
+private:    // Variables
+    // トークンバケット
+    struct BUCKET {
+        double  Tokens      = 0.0;  // 残りのトークン数 (予約済みの場合は負の値になる)
+        qint64  LastRefill  = 0;    // 最後にトークンを補充した時刻 [ミリ秒]
+        double  Rate        = 0.0;  // トークンの補充速度 [個 / 秒]
+        int     Burst       = 1;    // トークンの最大数
+    };
+
+    static RateLimiter          *m_instance;    // 静的インスタンスポインタ
+    static QMutex               m_mutex;        // シングルトンとバケットの操作用のミューテックス
+
+    RATELIMIT_INFO              m_Info;         // リクエスト数の制限に関する設定
+    QMap<QString, BUCKET>       m_Buckets;      // ホスト名 (掲示板のbbs.cgiの場合は、ホスト名 + パス) をキーとしたトークンバケット
+    QElapsedTimer               m_Clock;        // トークンの補充に使用する単調増加の時計
+
+private:    // Methods
+    explicit RateLimiter(QObject *parent = nullptr);                        // プライベートコンストラクタ
+    ~RateLimiter() override;                                                // プライベートデストラクタ
+
+    static bool     isBoard(const QUrl &url);                               // 掲示板のbbs.cgiへのリクエストかどうかを確認
+
+public:     // Methods
+    RateLimiter(const RateLimiter&)             = delete;                   // コピーコンストラクタの禁止
+    RateLimiter& operator=(const RateLimiter&)  = delete;                   // 代入の禁止
+
+    static RateLimiter* getInstance();                                      // シングルトンインスタンスを取得するための静的メソッド
+    void            setRateLimitInfo(const RATELIMIT_INFO &info);           // リクエスト数の制限に関する設定を指定
+    void            acquire(const QUrl &url);                               // 指定されたURLのホストへリクエストを送信できるまで待機
+                                                                            // 待機中もイベントループは動作する
+    qint64          reserve(const QUrl &url);                               // トークンを1つ予約して、送信可能になるまでの待機時間 [ミリ秒] を取得
+};
+
+
+#endif // RATELIMITER_H
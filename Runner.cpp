@@ -1,5 +1,4 @@
 #include <QCoreApplication>
-#include <QRegularExpression>
 #include <QUrl>
 #include <QUrlQuery>
 #include <QFile>
@@ -9,29 +8,39 @@
 #include <QJsonArray>
 #include <QTimeZone>
 #include <QXmlStreamReader>
-#include <QLockFile>
 #include <QException>
 #include <iostream>
 #include <utility>
+#include <algorithm>
 #include "Runner.h"
+#include "Logger.h"
 #include "HtmlFetcher.h"
-#include "RandomGenerator.h"
+#include "TextNormalizer.h"
+#include "DescriptionSanitizer.h"
+#include "ParserPool.h"
+#include "XmlPtr.h"
+#include "NetworkManager.h"
+#include "HttpReplay.h"
 #include "CommandLineParser.h"
+#include "Trace.h"
+#include "IngestHub.h"
 
 
 // メイン処理のコンストラクタ
 #ifdef Q_OS_LINUX
 Runner::Runner(QStringList _args, QString user, QObject *parent) : m_args(std::move(_args)), m_User(std::move(user)), m_SysConfFile(""), m_interval(30 * 60 * 1000),
+    m_IngestInterval(0), m_IngestIndex(0), m_bIngesting(false), m_PoolExpire(3 * 60 * 60 * 1000), m_TenantFreshness(60 * 1000), m_pPrimary(nullptr),
     m_pNotifier(std::make_unique<QSocketNotifier>(fileno(stdin), QSocketNotifier::Read, this)), m_stopRequested(false),
-    manager(std::make_unique<QNetworkAccessManager>(this)),
+    manager(std::make_unique<NetworkManager>(this)),
     QObject{parent}
 {
     connect(m_pNotifier.get(), &QSocketNotifier::activated, this, &Runner::onReadyRead);        // キーボードシーケンスの有効化
 }
 #elif Q_OS_WIN
 Runner::Runner(QStringList _args, QObject *parent) : m_args(std::move(_args)), m_SysConfFile(""), m_interval(30 * 60 * 1000),
+    m_IngestInterval(0), m_IngestIndex(0), m_bIngesting(false), m_PoolExpire(3 * 60 * 60 * 1000), m_TenantFreshness(60 * 1000), m_pPrimary(nullptr),
     m_pNotifier(std::make_unique<QWinEventNotifier>(fileno(stdin), QWinEventNotifier::Read, this)), m_stopRequested(false),
-    manager(std::make_unique<QNetworkAccessManager>(this)),
+    manager(std::make_unique<NetworkManager>(this)),
     QObject{parent}
 {
     connect(m_pNotifier.get(), &QWinEventNotifier::activated, this, &Runner::onReadyRead);      // キーボードシーケンスの有効化
@@ -39,11 +48,11 @@ Runner::Runner(QStringList _args, QObject *parent) : m_args(std::move(_args)), m
 #endif
 
 
-// このソフトウェアを最初に実行する時にのみ実行するメイン処理
-void Runner::run()
+// コマンドラインオプションの確認
+// --sysconfオプションの場合は、設定ファイルを読み込む
+// 本ソフトウェアを終了する場合 (--version、--helpオプション、および、エラーの場合) は-1を返す
+int Runner::parseArguments()
 {
-    // メイン処理
-
     // コマンドラインオプションの確認
     // 設定ファイルおよびバージョン情報
     m_args.removeFirst();   // プログラムのパスを削除
@@ -57,6 +66,12 @@ void Runner::run()
                                      "confFilePath");
     parser.addOption(sysconfOption);
 
+    // --trace オプションを追加 (--sysconfオプションと併用する)
+    QCommandLineOption traceOption(QStringList() << "trace",
+                                   "処理時間のトレースを有効にして、終了時に指定したファイルへ出力します (Chrome trace event形式)",
+                                   "traceFilePath");
+    parser.addOption(traceOption);
+
     // --version / -v オプションを追加
     QCommandLineOption versionOption(QStringList() << "version" << "v", "バージョン情報を表示します");
     parser.addOption(versionOption);
@@ -73,9 +88,9 @@ void Runner::run()
 
     // 未知のオプションをチェック
     if (!parser.unknownOptionNames().isEmpty()) {
-        std::cerr << QString("エラー : 不明なオプション %1").arg(parser.unknownOptionNames().join(", ")).toStdString() << std::endl;
+        LOG_ERROR(QString("不明なオプション %1").arg(parser.unknownOptionNames().join(", ")));
         QCoreApplication::exit();
-        return;
+        return -1;
     }
 
     // 指定されたオプションの数をカウント
@@ -104,14 +119,14 @@ void Runner::run()
     }
 
     if (optionCount > 1) {
-        std::cerr << QString("エラー : 指定できるオプションは1つのみです").toStdString() << std::endl;
+        LOG_ERROR(QString("指定できるオプションは1つのみです"));
         QCoreApplication::exit();
-        return;
+        return -1;
     }
     else if (optionCount == 0) {
-        std::cerr << QString("エラー : オプションがありません").toStdString() << std::endl;
+        LOG_ERROR(QString("オプションがありません"));
         QCoreApplication::exit();
-        return;
+        return -1;
     }
 
     if (parser.isSet(versionOption)) {
@@ -123,17 +138,18 @@ void Runner::run()
         std::cout << version.toStdString() << std::endl;
 
         QCoreApplication::exit();
-        return;
+        return -1;
     }
     else if (parser.isSet(helpOption)) {
         // --help / -h オプション
         auto help = QString("使用法 : qNewsFlash [オプション]\n\n")
                     + QString("\t--sysconf=<qNewsFlash.jsonファイルのパス>\t設定ファイルのパスを指定する\n")
+                    + QString("\t--trace=<出力するファイルのパス>\t\t処理時間のトレースを出力する (--sysconfオプションと併用する)\n")
                     + QString("\t-v, --version\t\t\t\tバージョン情報を表示する\n\n");
         std::cout << help.toStdString() << std::endl;
 
         QCoreApplication::exit();
-        return;
+        return -1;
     }
     else if (parser.isSet(sysconfOption)) {
         // --sysconfオプションの値を取得
@@ -145,24 +161,165 @@ void Runner::run()
         }
 
         if (option.isEmpty()) {
-            std::cerr << QString("エラー : 設定ファイルのパスが不明です").toStdString() << std::endl;
+            LOG_ERROR(QString("設定ファイルのパスが不明です"));
 
             QCoreApplication::exit();
-            return;
+            return -1;
         }
 
         m_SysConfFile = option;
 
         if (getConfiguration(m_SysConfFile)) {
             QCoreApplication::exit();
-            return;
+            return -1;
+        }
+
+        // --traceオプションが指定されている場合は、設定ファイルのtraceキーより優先する
+        if (parser.isTraceSet() && !parser.value(traceOption).isEmpty()) {
+            m_TraceInfo.Enable = true;
+            m_TraceInfo.File   = parser.value(traceOption);
         }
     }
     else {
-        std::cerr << QString("エラー : 不明なオプションです - %1").arg(parser.isSet(specifiedOption)).toStdString() << std::endl;
+        LOG_ERROR(QString("不明なオプションです - %1").arg(parser.isSet(specifiedOption)));
 
         QCoreApplication::exit();
-        return;
+        return -1;
+    }
+
+    return 0;
+}
+
+
+// 有効なニュースサイト (RSS、速報ニュース) および掲示板のホストを取得
+// 無効なニュースサイトのURLは設定ファイルに記述されていても名前解決しない
+QStringList Runner::configuredHosts() const
+{
+    QStringList urls;
+    for (auto source : enabledSources()) {
+        urls.append(feedUrl(source).toString());
+
+        if (source == HANJ)     urls.append(m_HanJTopURL);
+        if (source == TOKYONP)  urls.append(m_TokyoNPTopURL);
+    }
+
+    if (m_bJiJiFlash)   urls << m_JiJiFlashInfo.BasisURL << m_JiJiFlashInfo.FlashUrl;
+    if (m_bKyodoFlash)  urls << m_KyodoFlashInfo.BasisURL << m_KyodoFlashInfo.FlashUrl;
+
+    urls << m_WriteInfo.RequestURL << m_WriteInfo.ThreadURL;
+
+    QStringList hosts;
+    for (const auto &url : std::as_const(urls)) {
+        auto host = QUrl(url).host();
+        if (!host.isEmpty() && !hosts.contains(host)) hosts.append(host);
+    }
+
+    return hosts;
+}
+
+
+// プロセス全体の設定 (プライマリのみ実行する)
+// 処理時間のトレース、TLSセッションの再開、HTTP通信の記録 / 再生、DNSキャッシュ、パース処理、障害検知、リクエスト数の制限、メトリクス、イベントループの停止の検出
+// マルチテナントモードの場合、各テナントの設定ファイルのこれらの設定は使用しない
+int Runner::setupProcess()
+{
+    // 処理時間のトレースの設定
+    // トレースは、本ソフトウェアの終了時にファイルへ出力する
+    if (m_TraceInfo.Enable && m_TraceInfo.File.isEmpty()) {
+        /// 出力先が未指定の場合は、ログファイルと同じディレクトリに出力
+        m_TraceInfo.File = QFileInfo(m_LogFile).dir().filePath("qNewsFlash_trace.json");
+    }
+
+    Trace::getInstance()->setTraceInfo(m_TraceInfo);
+    if (m_TraceInfo.Enable) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, []() {
+            Trace::getInstance()->dump();
+        });
+    }
+
+    // 前回終了時に保存したTLSセッションチケットを読み込む
+    // TLSセッションチケットは、本ソフトウェアの終了時に保存する
+    if (m_TlsSessionInfo.Enable && m_TlsSessionInfo.File.isEmpty()) {
+        /// 保存先が未指定の場合は、ログファイルと同じディレクトリに保存
+        m_TlsSessionInfo.File = QFileInfo(m_LogFile).dir().filePath("qNewsFlash_tls.json");
+    }
+
+    auto pTlsSessionCache = TlsSessionCache::getInstance();
+    pTlsSessionCache->setTlsSessionInfo(m_TlsSessionInfo);
+    pTlsSessionCache->load();
+
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, [pTlsSessionCache]() {
+        pTlsSessionCache->printStatistics();
+        pTlsSessionCache->save();
+    });
+
+    // HTTP通信の記録 / 再生の設定
+    // 再生中は全てのリクエストを再生サーバに送信するため、ニュースサイトおよび掲示板のホストは名前解決しない
+    if (HttpReplay::getInstance()->setReplayInfo(m_ReplayInfo)) {
+        return -1;
+    }
+
+    if (HttpReplay::getInstance()->isReplaying()) m_DnsCacheInfo.Enable = false;
+
+    // 有効なニュースサイトおよび掲示板のホスト、設定ファイルに記述されているホスト (NTPサーバ等) を事前に名前解決
+    // 以降は、Qt内部のキャッシュの期限切れに合わせてバックグラウンドで名前解決を更新する (QtからはDNSのTTLを取得できないため)
+    for (const auto &host : configuredHosts()) {
+        if (!m_DnsCacheInfo.Hosts.contains(host)) m_DnsCacheInfo.Hosts.append(host);
+    }
+
+    DnsCache::getInstance()->setDnsCacheInfo(m_DnsCacheInfo);
+
+    // HTMLおよびXMLのパース処理の設定 (ワーカスレッドの最大数およびメモリアリーナ)
+    ParserPool::getInstance()->setParserInfo(m_ParserInfo);
+
+    // 各ニュースサイトの障害検知および再試行の設定
+    SourceHealth::getInstance()->setHealthInfo(m_HealthInfo);
+
+    // ホストごとのリクエスト数の制限の設定
+    RateLimiter::getInstance()->setRateLimitInfo(m_RateLimitInfo);
+
+    // メトリクスの公開 (有効の場合は、TCPまたはUNIXドメインソケットで待ち受けを開始)
+    if (Metrics::getInstance()->setMetricsInfo(m_MetricsInfo)) {
+        return -1;
+    }
+
+    // テナント間のニュース記事群の共有 (マルチテナントモードの場合のみ、取得済みの記事群を共有する)
+    IngestHub::getInstance()->setFreshness(m_TenantFiles.isEmpty() ? 0 : m_TenantFreshness);
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, []() {
+        IngestHub::getInstance()->printStatistics();
+    });
+
+    // イベントループの停止の検出 (有効の場合は、ハートビートおよび監視用スレッドを開始)
+    m_Watchdog.setWatchdogInfo(m_WatchdogInfo);
+    m_Watchdog.startWatchdog();
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, [this]() {
+        m_Watchdog.stopWatchdog();
+    });
+
+    return 0;
+}
+
+
+// このソフトウェアを最初に実行する時にのみ実行するメイン処理
+// マルチテナントモードの場合は、各テナントも実行する
+void Runner::run()
+{
+    // メイン処理
+
+    if (m_pPrimary == nullptr) {
+        // コマンドラインオプションの確認 (設定ファイルの読み込みを含む)
+        if (parseArguments()) return;
+
+        // ログの出力の設定 (レベルおよび出力形式)
+        Logger::getInstance()->setLoggingInfo(m_LoggingInfo);
+    }
+    else {
+        // マルチテナントモードのテナントの場合は、コマンドラインオプションを解析せずに、指定された設定ファイルを読み込む
+        // ログの出力等のプロセス全体の設定は、プライマリ (--sysconfオプションの設定ファイル) のものを使用する
+        if (getConfiguration(m_SysConfFile)) {
+            QCoreApplication::exit();
+            return;
+        }
     }
 
     // ログファイルの設定
@@ -171,10 +328,60 @@ void Runner::run()
         return;
     }
 
-    m_pWriteMode = WriteMode::getInstance();
+    // マルチテナントモードのテナントの場合は、テナントごとの書き込み用オブジェクトを使用する
+    m_pWriteMode = m_pPrimary == nullptr ? WriteMode::getInstance() : WriteMode::createInstance(this);
     m_pWriteMode->setSysConfFile(m_SysConfFile);    // qNewsFlashの設定ファイルを指定
     m_pWriteMode->setLogFile(m_LogFile);            // スレッドに書き込み済みのニュース記事を保存するJSONファイルのパスを指定
 
+    // ログファイルおよび設定ファイルの所有権を取得
+    // 他のqNewsFlashが同じファイルを使用している場合は、直ちに終了する
+    if (m_pWriteMode->acquireOwnership()) {
+        QCoreApplication::exit();
+        return;
+    }
+
+    // 書き込み済みのURLを記録するファイルをメモリマップ (テナントごと)
+    if (m_PostedFilterInfo.Enable && m_PostedFilterInfo.File.isEmpty()) {
+        /// 保存先が未指定の場合は、ログファイルと同じディレクトリに"<ログファイルのベース名>.posted.bloom"として保存
+        /// (ログファイルはプロセスおよびテナントごとに異なるため、記録ファイルも異なる)
+        QFileInfo logFileInfo(m_LogFile);
+        m_PostedFilterInfo.File = logFileInfo.dir().filePath(logFileInfo.completeBaseName() + ".posted.bloom");
+    }
+
+    m_PostedFilter.setPostedFilterInfo(m_PostedFilterInfo);
+    m_PostedFilter.open();
+
+    // 複数のプロセス間で共有する書き込み済みのニュース記事の索引に接続
+    m_SharedIndex.setSharedIndexInfo(m_SharedIndexInfo);
+    m_SharedIndex.open();
+
+    if (m_pPrimary == nullptr) {
+        // プロセス全体の設定
+        if (setupProcess()) {
+            QCoreApplication::exit();
+            return;
+        }
+    }
+    else {
+        // テナントの設定ファイルに記述されているホストを名前解決 (DNSキャッシュの設定はプライマリのものを使用する)
+        DnsCache::getInstance()->prefetch(configuredHosts());
+    }
+
+    m_pSourceHealth = SourceHealth::getInstance();
+
+    m_pWriteMode->setPersistInfo(m_PersistInfo);    // ログファイルおよび設定ファイルへの書き込みの設定 (書き込み用スレッドの待機およびfsync)
+
+    // 書き込み用スレッドで設定ファイルの更新に失敗した場合は、本ソフトウェアを終了する
+    // (書き込み用スレッドで失敗した場合、更新の失敗を呼び出し元に返すことができないため)
+    connect(m_pWriteMode, &WriteMode::persistCompleted, this, [](int kind, quint64, int result) {
+        if (kind == PersistThread::UPDATE_DATE && result != 0) QCoreApplication::exit();
+    });
+
+    // 本ソフトウェアの終了時は、書き込み用スレッドに依頼した全ての書き込みの完了を待機する
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, [this]() {
+        m_pWriteMode->flush();
+    });
+
     // ログファイルから、昨日以前(昨日も含む)の書き込み済みのニュース記事を削除
     if (m_pWriteMode->deleteLogNotToday()) {
         QCoreApplication::exit();
@@ -185,17 +392,27 @@ void Runner::run()
     // また、取得した記事群のデータは、メンバ変数m_WrittenArticlesに保存
     try {
         m_WrittenArticles = m_pWriteMode->getDatafromWrittenLog();
+
+        // 書き込み済みのニュース記事群から、類似ニュース記事の索引を再作成
+        m_DuplicateIndex.rebuild(m_WrittenArticles);
+
+        // ログファイルの書き込み済みのURLを長期間記録 (ログファイルから削除された後も判定できるようにする)
+        for (const auto &writtenArticle : std::as_const(m_WrittenArticles)) {
+            QString url = "";
+            std::tie(std::ignore, std::ignore, url, std::ignore) = writtenArticle.getArticleData();
+            m_PostedFilter.add(url);
+        }
     }
     catch (const std::runtime_error &e) {
         // ログファイルのオープンや読み込みに失敗した場合
-        std::cerr << QString("%1").arg(e.what()).toStdString();
+        LOG_ERROR(QString(e.what()));
 
         QCoreApplication::exit();
         return;
     }
     catch (const std::exception &e) {
         // その他の例外をキャッチ
-        std::cerr << QString("%1").arg(e.what()).toStdString();
+        LOG_ERROR(QString(e.what()));
 
         QCoreApplication::exit();
         return;
@@ -218,33 +435,61 @@ void Runner::run()
 #endif
 
     if (m_AutoFetch) {
-        // ニュース記事の自動取得タイマの開始
-        connect(&m_timer, &QTimer::timeout, this, &Runner::fetchNonBreakingNews);
-        m_timer.start(static_cast<int>(m_interval));
+        // ニュース記事の書き込みタイマの開始
+        // 書き込み時は候補プールから選択するのみで、各ニュースサイトからの取得は行わない
+        // 各タイマは、発火の遅延をメトリクスに記録した後にスロットを実行する
+        connect(&m_timer, &QTimer::timeout, this, []() { Metrics::getInstance()->timerFired("post"); });
+        connect(&m_timer, &QTimer::timeout, this, &Runner::postFromPool);
+        armTimer(m_timer, "post", static_cast<qint64>(m_interval));
+
+        // 各ニュースサイトからニュース記事を取得するタイマの開始
+        // 全てのニュースサイトを1巡する時間を有効なニュースサイトの数で分割して、1つずつ順番に取得する
+        // これにより、ネットワークの負荷を書き込み間隔の全体に分散する
+        auto sources = enabledSources();
+        if (!sources.isEmpty()) {
+            auto cycle = m_IngestInterval == 0 ? m_interval : m_IngestInterval;
+            auto tick  = std::max<unsigned long long>(cycle / static_cast<unsigned long long>(sources.size()), 10 * 1000);
+
+            connect(&m_IngestTimer, &QTimer::timeout, this, &Runner::ingestNext);
+            m_IngestTimer.start(static_cast<int>(tick));
+        }
 
         // (時事ドットコム) 速報記事の自動取得タイマの開始
         if (m_bJiJiFlash) {
+            connect(&m_JiJiTimer, &QTimer::timeout, this, []() { Metrics::getInstance()->timerFired("jijiflash"); });
             connect(&m_JiJiTimer, &QTimer::timeout, this, &Runner::JiJiFlashfetch);
-            m_JiJiTimer.start(static_cast<int>(m_JiJiinterval));
+            armTimer(m_JiJiTimer, "jijiflash", static_cast<qint64>(m_JiJiinterval));
         }
 
         // (共同通信) 速報記事の自動取得タイマの開始
         if (m_bKyodoFlash) {
+            connect(&m_KyodoTimer, &QTimer::timeout, this, []() { Metrics::getInstance()->timerFired("kyodoflash"); });
             connect(&m_KyodoTimer, &QTimer::timeout, this, &Runner::KyodoFlashfetch);
-            m_KyodoTimer.start(static_cast<int>(m_Kyodointerval));
+            armTimer(m_KyodoTimer, "kyodoflash", static_cast<qint64>(m_Kyodointerval));
         }
 
         // !bottomコマンドの書き込みタイマの開始
         if (m_WriteInfo.BottomThread) {
+            connect(&m_BottomTimer, &QTimer::timeout, this, []() { Metrics::getInstance()->timerFired("bottom"); });
             connect(&m_BottomTimer, &QTimer::timeout, this, &Runner::bottomThread);
-            m_BottomTimer.start(static_cast<int>(m_Bottominterval));
+            armTimer(m_BottomTimer, "bottom", static_cast<qint64>(m_Bottominterval));
         }
     }
 
+    // 他のテナントが取得したニュース記事群を、候補プールへ追加する
+    connect(IngestHub::getInstance(), &IngestHub::published, this, &Runner::onIngestPublished);
+
     // 本ソフトウェア開始直後に各ニュース記事を読み込む場合は、コメントを解除して、fetchNonBreakingNews()メソッドを実行する
     // コメントアウトしている場合、かつ、通常実行またはSystemdサービスで実行する場合、最初に各ニュース記事を読み込むタイミングは、タイマの指定時間後となる
+    // 取得はHTTPレスポンスを待機せずに戻り、取得および書き込みの完了後にfinishStartup()メソッドを実行する
+    // (速報記事の取得、マルチテナントモードの各テナントの開始、ワンショットの場合の終了処理は、finishStartup()メソッドで行う)
     fetchNonBreakingNews();
+}
+
 
+// 起動直後のニュース記事の取得および書き込みの完了後に実行する
+void Runner::finishStartup()
+{
     // 本ソフトウェア開始直後に時事ドットコムから速報記事を読み込む場合は、コメントを解除して、JiJiFlashfetch()メソッドを実行する
     // コメントアウトしている場合、かつ、通常実行またはSystemdサービスで実行する場合、最初に速報記事を読み込むタイミングは、タイマの指定時間後となる
     JiJiFlashfetch();
@@ -253,9 +498,28 @@ void Runner::run()
     // コメントアウトしている場合、かつ、通常実行またはSystemdサービスで実行する場合、最初に速報記事を読み込むタイミングは、タイマの指定時間後となる
     KyodoFlashfetch();
 
+    // マルチテナントモードの場合は、各テナントを開始する
+    // プライマリが取得したニュース記事群は、共有する期間内であれば各テナントも使用する
+    // (全てのテナントの起動直後の処理の完了後に、finishRun()メソッドを実行する)
+    if (m_pPrimary == nullptr) {
+        startTenants();
+        return;
+    }
+
+    finishRun();
+}
+
+
+// 起動直後の処理の完了を通知する
+// ワンショットの場合は、本ソフトウェアを終了する
+void Runner::finishRun()
+{
+    emit finished();
+
     // ソフトウェアの自動起動が無効の場合
     // Cronを使用する場合、または、ワンショットで動作させる場合の処理
-    if (!m_AutoFetch) {
+    // (テナントの場合は、全てのテナントの処理の後にプライマリが終了する)
+    if (!m_AutoFetch && m_pPrimary == nullptr) {
         // 既に[q]キーまたは[Q]キーが押下されている場合は再度終了処理を行わない
         if (!m_stopRequested.load()) {
             // ソフトウェアを終了する
@@ -266,8 +530,94 @@ void Runner::run()
 }
 
 
-// 速報ニュース以外のニュース記事の取得する
+// 速報ニュース以外のニュース記事の取得および書き込み
+// 本ソフトウェアの起動直後、および、ワンショットで実行する場合に使用する
+// 全てのニュースサイトからニュース記事を取得して候補プールへ追加した後、候補プールからニュース記事を1つ書き込む
+// HTTPレスポンスは待機せずに戻り、書き込みの完了後にfinishStartup()メソッドを実行する
 void Runner::fetchNonBreakingNews()
+{
+    const auto start = Trace::isEnabled() ? Trace::getInstance()->now() : qint64(-1);
+
+    // 日付が変わっているかどうかを確認
+    if (checkDateChange()) return;
+
+    // 有効な全てのニュースサイトからニュース記事を取得
+    m_bIngesting = true;
+    ingestSources(enabledSources(), [this, start]() {
+        m_bIngesting = false;
+
+        // [q]キーまたは[Q]キー ==> [Enter]キーが押下されている場合は終了
+        if (m_stopRequested.load()) return;
+
+        // 候補プールからニュース記事を1つ選択して書き込む
+        writeFromPool();
+
+        if (start >= 0) Trace::getInstance()->completeAsync("cycle", "Runner::fetchNonBreakingNews", start);
+
+        finishStartup();
+    });
+}
+
+
+// 指定したニュースサイト群から順番にニュース記事を取得して、候補プールへ追加
+// 全てのニュースサイトの取得の完了後 (または、終了が要求された場合) にdoneを実行する
+void Runner::ingestSources(QList<int> sources, const std::function<void()> &done)
+{
+    // [q]キーまたは[Q]キー ==> [Enter]キーが押下されている場合は終了
+    if (sources.isEmpty() || m_stopRequested.load()) {
+        done();
+        return;
+    }
+
+    const auto source = sources.takeFirst();
+    ingestSource(source, [this, sources, done]() {
+        ingestSources(sources, done);
+    });
+}
+
+
+// 候補プールからニュース記事を1つ選択して書き込む (書き込みタイマから実行)
+// ニュースサイトからの取得は行わないため、タイマの発火から書き込みまでの時間は取得するニュースサイトの数に依存しない
+void Runner::postFromPool()
+{
+    // [q]キーまたは[Q]キー ==> [Enter]キーが押下されている場合は終了
+    if (m_stopRequested.load()) return;
+
+    // 日付が変わっているかどうかを確認
+    if (checkDateChange()) return;
+
+    // 候補プールからニュース記事を1つ選択して書き込む
+    writeFromPool();
+}
+
+
+// 次のニュースサイトからニュース記事を取得して、候補プールへ追加 (取得タイマから実行)
+// 各ニュースサイトは、取得タイマが発火するごとに1つずつ順番に取得する
+void Runner::ingestNext()
+{
+    // [q]キーまたは[Q]キー ==> [Enter]キーが押下されている場合は終了
+    if (m_stopRequested.load()) return;
+
+    // 取得中 (HTTPレスポンスの待機中) に再度タイマが発火した場合は、重複して取得しない
+    if (m_bIngesting) return;
+
+    auto sources = enabledSources();
+    if (sources.isEmpty()) return;
+
+    m_bIngesting  = true;
+    m_IngestIndex = m_IngestIndex % sources.size();
+    const auto source = sources.at(m_IngestIndex);
+    m_IngestIndex = (m_IngestIndex + 1) % sources.size();
+
+    ingestSource(source, [this]() {
+        m_bIngesting = false;
+    });
+}
+
+
+// 日付が変わっているかどうかを確認
+// 日付が変わっている場合は、書き込み済みのニュース記事群をログファイルから再度取得する
+int Runner::checkDateChange()
 {
     // 現在の日時を取得して日付が変わっているかどうかを確認
     /// 日本のタイムゾーンを設定
@@ -288,249 +638,415 @@ void Runner::fetchNonBreakingNews()
         /// ログファイルから、2日以上前の書き込み済みニュース記事を削除
         if (m_pWriteMode->deleteLogNotToday()) {
             QCoreApplication::exit();
-            return;
+            return -1;
         }
 
         /// ログファイルから、今日と昨日の書き込み済みのニュース記事を取得
         /// また、取得した記事群のデータはメンバ変数m_WrittenArticlesに格納
         try {
             m_WrittenArticles = m_pWriteMode->getDatafromWrittenLog();
+
+            /// 書き込み済みのニュース記事群から、類似ニュース記事の索引を再作成
+            m_DuplicateIndex.rebuild(m_WrittenArticles);
         }
         catch (const std::runtime_error &e) {
             // ログファイルのオープンや読み込みに失敗した場合
-            std::cerr << QString("%1").arg(e.what()).toStdString();
+            LOG_ERROR(QString(e.what()));
 
             QCoreApplication::exit();
-            return;
+            return -1;
         }
         catch (const std::exception &e) {
             // その他の例外をキャッチ
-            std::cerr << QString("%1").arg(e.what()).toStdString();
+            LOG_ERROR(QString(e.what()));
 
             QCoreApplication::exit();
-            return;
+            return -1;
         }
     }
 
     // 設定ファイルの"update"キーを更新
     if (m_pWriteMode->updateDateJson(m_LastUpdate)) {
         QCoreApplication::exit();
-        return;
+        return -1;
     }
 
-    // 前回取得した書き込み前の記事群(選定前)を初期化
-    m_BeforeWritingArticles.clear();
+    return 0;
+}
 
-    if (m_stopRequested.load()) return;
 
-    // News APIの日本国内の記事を取得
-    // ただし、無料版のNews APIの記事は24時間遅れであるため、News APIを使用する場合は有料版を推奨する
-    if (m_bNewsAPI) {
-        QUrl url(m_NewsAPIRSS.append(m_API));
+// 有効なニュースサイトの一覧を取得
+QList<int> Runner::enabledSources() const
+{
+    QList<int> sources;
+
+    if (m_bNewsAPI)     sources.append(NEWSAPI);
+    if (m_bJiJi)        sources.append(JIJI);
+    if (m_bKyodo)       sources.append(KYODO);
+    if (m_bAsahi)       sources.append(ASAHI);
+    if (m_bMainichi)    sources.append(MAINICHI);
+    if (m_bCNet)        sources.append(CNET);
+    if (m_bHanJ)        sources.append(HANJ);
+    if (m_bReuters)     sources.append(REUTERS);
+    if (m_bTokyoNP)     sources.append(TOKYONP);
+
+    return sources;
+}
 
-        /// HTTPリクエストを作成して、ヘッダを設定
-        QNetworkRequest request(url);
 
-        /// HTTPリクエストを送信
-        m_pReply = manager->get(request);
+// ニュースサイト名を取得
+QString Runner::sourceName(int source)
+{
+    switch (source) {
+        case NEWSAPI:       return QString("News API");
+        case JIJI:          return QString("時事ドットコム");
+        case KYODO:         return QString("共同通信");
+        case ASAHI:         return QString("朝日新聞デジタル");
+        case MAINICHI:      return QString("毎日新聞");
+        case CNET:          return QString("CNET Japan");
+        case HANJ:          return QString("ハンギョレジャパン");
+        case REUTERS:       return QString("ロイター通信");
+        case TOKYONP:       return QString("東京新聞");
+        default:            return QString("不明");
+    }
+}
 
-        /// HTTPレスポンスを受信した後、Runner::fetchNewsAPI()メソッドを実行
-        QObject::connect(m_pReply, &QNetworkReply::finished, this, &Runner::fetchNewsAPI);
 
-        /// レスポンス待機
-        QEventLoop loop;
-        QObject::connect(this, &Runner::NewAPIfinished, &loop, &QEventLoop::quit);
-        loop.exec();
+// ニュースサイトの設定名 (設定ファイルのキー名) を取得
+QString Runner::sourceKey(int source)
+{
+    switch (source) {
+        case NEWSAPI:       return QString("newsapi");
+        case JIJI:          return QString("jiji");
+        case KYODO:         return QString("kyodo");
+        case ASAHI:         return QString("asahi");
+        case MAINICHI:      return QString("mainichi");
+        case CNET:          return QString("cnet");
+        case HANJ:          return QString("hanj");
+        case REUTERS:       return QString("reuters");
+        case TOKYONP:       return QString("tokyonp");
+        default:            return QString("");
     }
+}
 
-    // [q]キーまたは[Q]キー ==> [Enter]キーが押下されているかどうかを確認
-    if (m_stopRequested.load()) return;
 
-    // 時事ドットコムの記事を取得
-    if (m_bJiJi) {
-        // 時事ドットコムのRSSフィードのURLを指定
-        QUrl urlJiJi(m_JiJiRSS);
+// 指定したニュースサイトからニュース記事を取得して、候補プールへ追加
+// マルチテナントモードの場合、他のテナントが取得済み (共有する期間内) または取得中の場合は取得しない
+// HTTPレスポンスは待機せずに戻り、候補プールへの追加 (または、取得の省略) の完了時にdoneを実行する
+void Runner::ingestSource(int source, const std::function<void()> &done)
+{
+    const auto     key  = ingestKey(source);
+    auto           pHub = IngestHub::getInstance();
+    QList<Article> sharedArticles;
+
+    switch (pHub->begin(key, sharedArticles)) {
+        case IngestHub::CACHED:
+            /// 他のテナントが取得済みの記事群を使用
+            addCandidates(source, sharedArticles);
+            done();
+            return;
+        case IngestHub::PENDING: {
+            /// 他のテナントが取得中の場合は、取得の完了時に候補プールへ追加される (追加の後にdoneを実行する)
+            auto pConnection = std::make_shared<QMetaObject::Connection>();
+            *pConnection = connect(pHub, &IngestHub::published, this, [pConnection, key, done](const QString &publishedKey) {
+                if (publishedKey != key) return;
+
+                QObject::disconnect(*pConnection);
+                done();
+            });
+            return;
+        }
+        default:
+            break;
+    }
 
-        /// HTTPリクエストを作成して、ヘッダを設定
-        QNetworkRequest requestJiJi(urlJiJi);
+    // 取得したニュース記事群を公開して、このニュースサイトを取得する全てのテナント (自身を含む) の候補プールへ追加
+    const auto start   = Trace::isEnabled() ? Trace::getInstance()->now() : qint64(-1);
+    auto       publish = [this, source, key, start, done]() {
+        IngestHub::getInstance()->publish(key, std::exchange(m_BeforeWritingArticles, {}));
 
-        /// HTTPリクエストを送信
-        m_pReplyJiJi = manager->get(requestJiJi);
+        if (start >= 0) Trace::getInstance()->completeAsync("fetch", "Runner::ingestSource", start, sourceKey(source));
 
-        /// HTTPレスポンスを受信した後、Runner::fetchJiJiRSS()メソッドを実行
-        QObject::connect(m_pReplyJiJi, &QNetworkReply::finished, this, &Runner::fetchJiJiRSS);
+        done();
+    };
 
-        /// レスポンス待機
-        QEventLoop loop;
-        QObject::connect(this, &Runner::JiJifinished, &loop, &QEventLoop::quit);
-        loop.exec();
-    }
+    // 前回取得した書き込み前の記事群(選定前)を初期化
+    m_BeforeWritingArticles.clear();
 
-    // [q]キーまたは[Q]キー ==> [Enter]キーが押下されているかどうかを確認
-    if (m_stopRequested.load()) return;
+    // 各ニュースサイトのRSSフィード (News APIの場合はJSON、東京新聞の場合はニュース記事を取得するページ) のURLを指定
+    // ただし、無料版のNews APIの記事は24時間遅れであるため、News APIを使用する場合は有料版を推奨する
+    const auto url = feedUrl(source);
 
-    // 共同通信の記事を取得
-    if (m_bKyodo) {
-        // 共同通信のRSSフィードのURLを指定
-        QUrl urlKyodo(m_KyodoRSS);
+    /// 障害中 (サーキットが開いている状態) の場合は、クールダウンが終わるまで取得しない
+    if (!m_pSourceHealth->isAvailable(url)) {
+        LOG_WARNING(QString("%1は障害中のため、取得を省略します (%2)").arg(sourceName(source), url.host()));
+        publish();
+        return;
+    }
 
-        /// HTTPリクエストを作成して、ヘッダを設定
-        QNetworkRequest requestKyodo(urlKyodo);
+    /// 東京新聞のページはリダイレクトを自動的にフォロー
+    QNetworkRequest request(url);
+    if (source == TOKYONP) {
+        request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, true);
+    }
 
-        /// HTTPリクエストを送信
-        m_pReplyKyodo = manager->get(requestKyodo);
+    /// HTTPリクエストを送信して、待機せずに戻る
+    /// 一時的なエラーの場合は、ジッタ付きの指数バックオフで再試行する (再試行の待機中も他のイベントを処理する)
+    /// HTTPレスポンスを受信した後、各ニュースサイトのRSSを処理するメソッドを実行 (パースおよび本文の取得の完了後に公開する)
+    m_pSourceHealth->getAsync(manager.get(), request, [this, source, publish](QNetworkReply *reply) {
+        switch (source) {
+            case NEWSAPI:
+                fetchNewsAPI(reply);
+                publish();
+                break;
+            case TOKYONP:
+                fetchTokyoNP(reply, publish);
+                break;
+            default:
+                fetchRSS(source, reply, publish);
+                break;
+        }
+    });
+}
 
-        /// HTTPレスポンスを受信した後、Runner::fetchJiJiRSS()メソッドを実行
-        QObject::connect(m_pReplyKyodo, &QNetworkReply::finished, this, &Runner::fetchKyodoRSS);
 
-        /// レスポンス待機
-        QEventLoop loop;
-        QObject::connect(this, &Runner::Kyodofinished, &loop, &QEventLoop::quit);
-        loop.exec();
+// 各ニュースサイトのRSSフィード (News APIの場合はJSON) のURLを取得
+QUrl Runner::feedUrl(int source) const
+{
+    switch (source) {
+        case NEWSAPI:       return QUrl(m_NewsAPIRSS + m_API);
+        case JIJI:          return QUrl(m_JiJiRSS);
+        case KYODO:         return QUrl(m_KyodoRSS);
+        case ASAHI:         return QUrl(m_AsahiRSS);
+        case MAINICHI:      return QUrl(m_MainichiRSS);
+        case CNET:          return QUrl(m_CNETRSS);
+        case HANJ:          return QUrl(m_HanJRSS);
+        case REUTERS:       return QUrl(m_ReutersRSS);
+        case TOKYONP:       return QUrl(m_TokyoNPFetchURL);
+        default:            return QUrl();
     }
+}
 
-    // [q]キーまたは[Q]キー ==> [Enter]キーが押下されている場合は終了
-    if (m_stopRequested.load()) return;
 
-    // 朝日新聞デジタルの記事を取得
-    if (m_bAsahi) {
-        // 朝日新聞デジタルのRSSフィードのURLを指定
-        QUrl urlAsahi(m_AsahiRSS);
+// 取得したニュース記事群を候補プールへ追加
+// 既に候補プールに存在するニュース記事 (同じURL) は追加しない
+void Runner::addCandidates(int source, const QList<Article> &articles)
+{
+    const auto now      = QDateTime::currentMSecsSinceEpoch();
+    auto       added    = 0;
+    auto       pMetrics = Metrics::getInstance();
+    pMetrics->count(Metrics::CANDIDATES_PRODUCED, {sourceKey(source)}, static_cast<quint64>(articles.size()));
 
-        /// HTTPリクエストを作成して、ヘッダを設定
-        QNetworkRequest requestAsahi(urlAsahi);
+    for (const auto &article : articles) {
+        // 書き込み済みのニュース記事と類似している場合 (本文も比較する) は追加しない
+        QString title, paragraph, url;
+        std::tie(title, paragraph, url, std::ignore) = article.getArticleData();
+        if (m_DuplicateIndex.isDuplicate(title, paragraph)) {
+            pMetrics->count(Metrics::CANDIDATES_FILTERED, {"duplicate"});
+            continue;
+        }
 
-        /// HTTPリクエストを送信
-        m_pReplyAsahi = manager->get(requestAsahi);
+        // 他のプロセスが書き込んだニュース記事 (同じURLまたはタイトル) は追加しない
+        if (m_SharedIndex.contains(url, title)) {
+            pMetrics->count(Metrics::CANDIDATES_FILTERED, {"shared"});
+            continue;
+        }
 
-        /// HTTPレスポンスを受信した後、Runner::fetchCNetRSS()メソッドを実行
-        QObject::connect(m_pReplyAsahi, &QNetworkReply::finished, this, &Runner::fetchAsahiRSS);
+        // 書き込み済みのニュース記事は追加しない (他のテナントが取得した記事群の場合)
+        if (isWritten(url)) {
+            pMetrics->count(Metrics::CANDIDATES_FILTERED, {"written"});
+            continue;
+        }
 
-        /// レスポンス待機
-        QEventLoop loop;
-        QObject::connect(this, &Runner::Asahifinished, &loop, &QEventLoop::quit);
-        loop.exec();
+        if (m_CandidatePool.add(article, sourceKey(source), now)) added++;
+        else                                                      pMetrics->count(Metrics::CANDIDATES_FILTERED, {"pooled"});
     }
 
-    // [q]キーまたは[Q]キー ==> [Enter]キーが押下されている場合は終了
-    if (m_stopRequested.load()) return;
+    LOG_DEBUG(QString("%1 : 候補プールへ%2件追加").arg(sourceName(source)).arg(added), {{"pool", QString::number(m_CandidatePool.size())}});
+}
 
-    // 毎日新聞の記事を取得
-    if (m_bMainichi) {
-        // 毎日新聞のRSSフィードのURLを指定
-        QUrl urlMainichi(m_MainichiRSS);
 
-        /// HTTPリクエストを作成して、ヘッダを設定
-        QNetworkRequest requestMainichi(urlMainichi);
+// 他のテナント (または自身) が取得したニュース記事群の公開 (IngestHubクラスから通知)
+// このテナントで有効かつ取得の設定が同じニュースサイトの場合のみ、候補プールへ追加する
+void Runner::onIngestPublished(const QString &key, const QList<Article> &articles)
+{
+    for (auto source : enabledSources()) {
+        if (ingestKey(source) == key) addCandidates(source, articles);
+    }
+}
+
+
+// ニュースサイトの取得結果を共有するためのキーを取得
+// 取得結果に影響する設定 (URL、XPath式、本文の最大文字数、公開日の範囲等) が同じテナントの間のみ共有する
+QString Runner::ingestKey(int source) const
+{
+    QStringList settings{sourceKey(source), QString::number(m_MaxParagraph), QString::number(m_WithinHours)};
+
+    switch (source) {
+        case NEWSAPI:   settings << m_NewsAPIRSS + m_API << m_ExcludeMedia;                                         break;
+        case JIJI:      settings << m_JiJiRSS;                                                                      break;
+        case KYODO:     settings << m_KyodoRSS << QString::number(m_KyodoNewsOnly);                                 break;
+        case ASAHI:     settings << m_AsahiRSS;                                                                     break;
+        case MAINICHI:  settings << m_MainichiRSS << m_MainichiParaXPath;                                           break;
+        case CNET:      settings << m_CNETRSS << m_CNETParaXPath;                                                   break;
+        case HANJ:      settings << m_HanJRSS << m_HanJTopURL;                                                      break;
+        case REUTERS:   settings << m_ReutersRSS << m_ReutersParaXPath;                                             break;
+        case TOKYONP:   settings << m_TokyoNPTopURL << m_TokyoNPFetchURL << m_TokyoNPThumb << m_TokyoNPNews << m_TokyoNPJSON;  break;
+        default:                                                                                                    break;
+    }
+
+    return settings.join('\n');
+}
 
-        /// HTTPリクエストを送信
-        m_pReplyMainichi = manager->get(requestMainichi);
 
-        /// HTTPレスポンスを受信した後、Runner::fetchMainichiRSS()メソッドを実行
-        QObject::connect(m_pReplyMainichi, &QNetworkReply::finished, this, &Runner::fetchMainichiRSS);
+// 取得時に省略する書き込み済みのニュース記事かどうかを確認
+// マルチテナントモードの場合、取得したニュース記事群は全てのテナントで共有するため、全てのテナントで書き込み済みの場合のみ省略する
+bool Runner::isWrittenForAll(const QString &url) const
+{
+    const auto *pPrimary = m_pPrimary != nullptr ? m_pPrimary : this;
+    if (!pPrimary->isWritten(url)) return false;
 
-        /// レスポンス待機
-        QEventLoop loop;
-        QObject::connect(this, &Runner::Mainichifinished, &loop, &QEventLoop::quit);
-        loop.exec();
+    for (const auto &tenant : pPrimary->m_Tenants) {
+        if (!tenant->isWritten(url)) return false;
     }
 
-    // [q]キーまたは[Q]キー ==> [Enter]キーが押下されている場合は終了
-    if (m_stopRequested.load()) return;
+    return true;
+}
 
-    // CNET Japanの記事を取得
-    if (m_bCNet) {
-        // CNET JapanのRSSフィードのURLを指定
-        QUrl urlCNet(m_CNETRSS);
 
-        /// HTTPリクエストを作成して、ヘッダを設定
-        QNetworkRequest requestCNet(urlCNet);
+// 取得時に省略する類似ニュース記事かどうかを確認 (タイトルのみで比較する)
+// マルチテナントモードの場合は、全てのテナントで書き込み済みのニュース記事と類似している場合のみ省略する
+bool Runner::isDuplicateForAll(const QString &title) const
+{
+    const auto *pPrimary = m_pPrimary != nullptr ? m_pPrimary : this;
+    if (!pPrimary->m_DuplicateIndex.isDuplicate(title)) return false;
 
-        /// HTTPリクエストを送信
-        m_pReplyCNet = manager->get(requestCNet);
+    for (const auto &tenant : pPrimary->m_Tenants) {
+        if (!tenant->m_DuplicateIndex.isDuplicate(title)) return false;
+    }
 
-        /// HTTPレスポンスを受信した後、Runner::fetchCNetRSS()メソッドを実行
-        QObject::connect(m_pReplyCNet, &QNetworkReply::finished, this, &Runner::fetchCNetRSS);
+    return true;
+}
 
-        /// レスポンス待機
-        QEventLoop loop;
-        QObject::connect(this, &Runner::CNetfinished, &loop, &QEventLoop::quit);
-        loop.exec();
+
+// マルチテナントモードの各テナントを開始
+// 各テナントは、tenantsキーに指定した設定ファイルごとに、スレッド、掲示板、書き込みモード、取得するニュースサイトを持つ
+// ニュースサイトの取得およびパースは、IngestHubクラスを介して全てのテナントで共有する
+// 各テナントは順番に開始して (前のテナントの起動直後の処理の完了後に次のテナントを開始する)、全てのテナントの完了後にfinishRun()メソッドを実行する
+void Runner::startTenants()
+{
+    // 全てのテナントを開始した場合、または、[q]キーまたは[Q]キー ==> [Enter]キーが押下されている場合
+    if (m_Tenants.size() >= static_cast<size_t>(m_TenantFiles.size()) || m_stopRequested.load()) {
+        finishRun();
+        return;
     }
 
-    // [q]キーまたは[Q]キー ==> [Enter]キーが押下されている場合は終了
-    if (m_stopRequested.load()) return;
+    const auto &file = m_TenantFiles.at(static_cast<int>(m_Tenants.size()));
+
+#ifdef Q_OS_LINUX
+    auto tenant = std::make_unique<Runner>(QStringList{}, m_User);
+#elif Q_OS_WIN
+    auto tenant = std::make_unique<Runner>(QStringList{});
+#endif
+    tenant->m_pPrimary    = this;
+    tenant->m_SysConfFile = file;
+    tenant->m_pNotifier->setEnabled(false);     // キーボードの終了シーケンスは、プライマリのみで受け付ける
 
-    // ハンギョレジャパンの記事を取得
-    if (m_bHanJ) {
-        // ハンギョレジャパンのRSSフィードのURLを指定
-        QUrl urlHanJ(m_HanJRSS);
+    LOG_INFO(QString("テナントを開始します"), {{"sysconf", file}});
 
-        /// HTTPリクエストを作成して、ヘッダを設定
-        QNetworkRequest requestHanJ(urlHanJ);
+    // テナントの起動直後の処理が完了した後に、次のテナントを開始する
+    connect(tenant.get(), &Runner::finished, this, &Runner::startTenants);
+
+    m_Tenants.push_back(std::move(tenant));
+    m_Tenants.back()->run();
+}
 
-        /// HTTPリクエストを送信
-        m_pReplyHanJ = manager->get(requestHanJ);
 
-        /// HTTPレスポンスを受信した後、Runner::fetchJiJiRSS()メソッドを実行
-        QObject::connect(m_pReplyHanJ, &QNetworkReply::finished, this, &Runner::fetchHanJRSS);
+// 候補プールから、書き込み対象外となったニュース記事群を削除
+// 有効期限切れ、公開日が対象外 (日付の変更、または、指定時間の経過)、書き込み済みのニュース記事が対象となる
+void Runner::expireCandidates()
+{
+    auto pMetrics = Metrics::getInstance();
 
-        /// レスポンス待機
-        QEventLoop loop;
-        QObject::connect(this, &Runner::HanJfinished, &loop, &QEventLoop::quit);
-        loop.exec();
+    // 有効期限切れのニュース記事を削除
+    if (m_PoolExpire > 0) {
+        auto expired = m_CandidatePool.expire(QDateTime::currentMSecsSinceEpoch() - m_PoolExpire);
+        if (expired > 0) pMetrics->count(Metrics::CANDIDATES_FILTERED, {"expired"}, static_cast<quint64>(expired));
     }
 
-    // [q]キーまたは[Q]キー ==> [Enter]キーが押下されている場合は終了
-    if (m_stopRequested.load()) return;
+    // 類似ニュース記事の索引から、比較する期間を過ぎたニュース記事を削除
+    m_DuplicateIndex.expire(QDateTime::currentSecsSinceEpoch());
 
-    // ロイター通信の記事を取得
-    if (m_bReuters) {
-        // ロイター通信のRSSフィードのURLを指定
-        QUrl urlReuters(m_ReutersRSS);
+    // 公開日が対象外のニュース記事、書き込み済みのニュース記事、書き込み済みのニュース記事と類似しているニュース記事、および、他のプロセスが書き込んだニュース記事を削除
+    // 候補プールに追加した後に、他のニュースサイトの同じ話題が書き込まれた場合も削除される
+    m_CandidatePool.removeIf([this, pMetrics](const CandidatePool::CANDIDATE &candidate) {
+        auto isCheckDate = m_WithinHours == 0 ? isToday(candidate.Date) : isHoursAgo(candidate.Date);
+        if (!isCheckDate) {
+            pMetrics->count(Metrics::CANDIDATES_FILTERED, {"date"});
+            return true;
+        }
 
-        /// HTTPリクエストを作成して、ヘッダを設定
-        QNetworkRequest requestReuters(urlReuters);
+        if (isWritten(candidate.URL)) {
+            pMetrics->count(Metrics::CANDIDATES_FILTERED, {"written"});
+            return true;
+        }
 
-        /// HTTPリクエストを送信
-        m_pReplyReuters = manager->get(requestReuters);
+        if (m_DuplicateIndex.isDuplicate(candidate.Title, candidate.Paragraph)) {
+            pMetrics->count(Metrics::CANDIDATES_FILTERED, {"duplicate"});
+            return true;
+        }
 
-        /// HTTPレスポンスを受信した後、Runner::fetchJiJiRSS()メソッドを実行
-        QObject::connect(m_pReplyReuters, &QNetworkReply::finished, this, &Runner::fetchReutersRSS);
+        if (m_SharedIndex.contains(candidate.URL, candidate.Title)) {
+            pMetrics->count(Metrics::CANDIDATES_FILTERED, {"shared"});
+            return true;
+        }
 
-        /// レスポンス待機
-        QEventLoop loop;
-        QObject::connect(this, &Runner::Reutersfinished, &loop, &QEventLoop::quit);
-        loop.exec();
-    }
+        return false;
+    });
+}
 
-    // [q]キーまたは[Q]キー ==> [Enter]キーが押下されている場合は終了
-    if (m_stopRequested.load()) return;
 
-    // 東京新聞の記事を取得
-    if (m_bTokyoNP) {
-        fetchTokyoNP();
+// 指定したURLのニュース記事が書き込み済みかどうかを確認
+bool Runner::isWritten(const QString &url) const
+{
+    for (const auto &writtenArticle : m_WrittenArticles) {
+        QString writtenUrl = "";
+        std::tie(std::ignore, std::ignore, writtenUrl, std::ignore) = writtenArticle.getArticleData();
+
+        if (writtenUrl.compare(url, Qt::CaseSensitive) == 0) {
+            return true;
+        }
     }
 
-    // [q]キーまたは[Q]キー ==> [Enter]キーが押下されている場合は終了
-    if (m_stopRequested.load()) return;
+    // ログファイルに無い (2日以上前に書き込んだ) ニュース記事、または、他のプロセスが書き込んだニュース記事の場合
+    return m_PostedFilter.contains(url) || m_SharedIndex.contains(url);
+}
+
+
+// タイマを開始して、発火の遅延の計測を開始
+void Runner::armTimer(QTimer &timer, const QString &name, qint64 interval)
+{
+    timer.start(static_cast<int>(interval));
+    Metrics::getInstance()->armTimer(name, interval);
+}
+
+
+// 候補プールからニュース記事を1つ選択して書き込む
+void Runner::writeFromPool()
+{
+    TraceSpan span("post", "Runner::writeFromPool");
 
-    // 取得したニュース記事群を操作
-    if (!m_BeforeWritingArticles.empty()) {
-        // 取得したニュース記事群が存在する場合
-
-        // ニュース記事が複数存在する場合、ランダムで決定する (乱数生成により配列のインデックスを決める)
-        /// 乱数生成の方法
-        /// x86 / x64版 : CPUのタイムスタンプカウンタ(TSC)の値をハッシュ化したものをXorshiftする (それをシード値とする)
-        ///               メルセンヌ・ツイスターにそのシード値を入力して、一様分布したものをインデックス値としている
-        /// ARM / AArch64版 : /dev/urandom (CSPRNG) の値をハッシュ化したものをXorshiftする (それをシード値とする)
-        ///                   もし、/dev/urandomの値の取得に失敗した場合は、std::chrono::high_resolution_clockを使用して現在の精密な時刻を取得する
-        ///                   メルセンヌ・ツイスターにそのシード値を入力して、一様分布したものをインデックス値としている
-        ///
-        /// 備考 : ARM / AArch64において、CPUのタイムスタンプカウンタ(TSC)と似た値 (CNTPCTレジスタの値) を取得することもできるが、
-        ///       一部のARM / AArch64ベースのデバイスでは、セキュリティや安定性の観点からユーザモードのプロセスが低レベルのハードウェアリソースにアクセスすることを制限しており、
-        ///       特権モード (カーネルモード) での実行が必要になる場合がある
-        ///       また、CNTPCTレジスタにアクセスするライブラリのライセンスがGPLであるため現在は使用していない
+    // 候補プールから、書き込み対象外となったニュース記事群を削除
+    expireCandidates();
+
+    // 候補プールのニュース記事群を操作
+    if (!m_CandidatePool.isEmpty()) {
+        // 書き込み候補が存在する場合
+
+        // ニュース記事が複数存在する場合、スコアに基づいて1つを選択する
+        /// 各ニュース記事は、公開日からの経過時間、ニュースサイトの重み、直近に書き込んだニュース記事とのタイトルの類似度、本文の有無でスコア化される
+        /// 選択方法は、設定ファイルのselectionキーで指定する (スコアに比例した確率で選択、スコアの上位k件から選択、一様に選択)
+        /// 乱数生成器は起動時に1度だけ初期化して、以降は同じ内部状態を継続して使用する (シード値を指定した場合は、選択の順序を再現できる)
         auto article = selectArticle();
 
         // 書き込みモードの設定
@@ -563,7 +1079,7 @@ void Runner::fetchNonBreakingNews()
             }
         }
         else {
-            std::cerr << QString("エラー : 不明な書き込みモード \"%1\"").arg(m_WriteMode).toStdString() << std::endl;
+            LOG_ERROR(QString("不明な書き込みモード \"%1\"").arg(m_WriteMode));
             QCoreApplication::exit();
             return;
         }
@@ -577,31 +1093,60 @@ void Runner::fetchNonBreakingNews()
         // 書き込み済みの記事を履歴として登録 (同じ記事を1日に2回以上書き込まないようにする)
         // ただし、2日前以上の書き込み済み記事の履歴は削除する
         m_WrittenArticles.append(article);
+
+        QString title, paragraph, url;
+        std::tie(title, paragraph, url, std::ignore) = article.getArticleData();
+
+        // 類似ニュース記事の索引に登録 (他のニュースサイトの同じ話題を書き込まないようにする)
+        m_DuplicateIndex.add(title, paragraph, QDateTime::currentSecsSinceEpoch());
+
+        // 書き込み済みのURLを長期間記録
+        m_PostedFilter.add(url);
+
+        // 他のプロセスと共有する索引に記録
+        m_SharedIndex.add(url, title);
+
+        // 書き込み済みのニュース記事を候補プールから削除
+        m_CandidatePool.remove(url);
     }
-#if (QNEWSFLASH_VERSION_MAJOR == 0 && QNEWSFLASH_VERSION_MINOR < 1)
-    // qNewsFlash 0.1.0未満の機能
     else {
+        // 書き込み候補が存在しない場合
+        Metrics::getInstance()->count(Metrics::SELECTION, {"empty", ""});
 
+#if (QNEWSFLASH_VERSION_MAJOR == 0 && QNEWSFLASH_VERSION_MINOR < 1)
+        // qNewsFlash 0.1.0未満の機能
         // スレッド書き込み用のJSONファイルの内容を空にする
         if (m_pWriteMode->truncateJSON()) {
             QCoreApplication::exit();
             return;
         }
-    }
 #endif
-
-    // [q]キーまたは[Q]キー ==> [Enter]キーが押下されている場合は終了
-    if (m_stopRequested.load()) return;
+    }
 }
 
 
 // News APIからニュース記事の取得後に実行する
-void Runner::fetchNewsAPI()
+void Runner::fetchNewsAPI(QNetworkReply *reply)
 {
-    if (m_pReply->error() == QNetworkReply::NoError) {
+    TraceSpan span("parse", "Runner::fetchNewsAPI");
+
+    if (reply->error() == QNetworkReply::NoError) {
         // 正常にレスポンスを取得した場合
-        QByteArray    response  = m_pReply->readAll();
+        QByteArray    response  = reply->readAll();
         QJsonDocument jsonDoc   = QJsonDocument::fromJson(response);
+        if (jsonDoc.isNull()) {
+            // JSONのパースに失敗した場合
+            LOG_ERROR(QString("News APIのJSONのパースに失敗"));
+            m_pSourceHealth->recordFailure(reply->request().url(), SourceHealth::PARSE);
+            reply->deleteLater();
+            emit NewAPIfinished();
+
+            return;
+        }
+
+        // JSONを取得できた場合は、ホストは正常と見なす
+        m_pSourceHealth->recordSuccess(reply->request().url());
+
         QJsonObject   jsonObj   = jsonDoc.object();
         QJsonArray    articles  = jsonObj["articles"].toArray();
 
@@ -630,235 +1175,246 @@ void Runner::fetchNewsAPI()
 
             // 書き込み済みの記事が存在する場合は無視
             // 書き込み済みの記事かどうかを判断する方法として、同一のURLかどうかを確認している
-            bool bWritten = false;
-            for (auto &writtenArticle : m_WrittenArticles) {
-                QString url = "";
-                std::tie(std::ignore, std::ignore, url, std::ignore) = writtenArticle.getArticleData();
-
-                if (url.compare(article["url"].toString(), Qt::CaseSensitive)) {
-                    bWritten = true;
-                    break;
-                }
-            }
-            if (bWritten) continue;
+            if (isWrittenForAll(article["url"].toString())) continue;
 
             // 本文が指定文字数以上の場合、指定文字数のみを抽出
             auto paragraph = article["description"].toString();
-            paragraph = paragraph.size() > m_MaxParagraph ? paragraph.mid(0, static_cast<int>(m_MaxParagraph)) + QString("...") : paragraph;
+            paragraph = TextNormalizer::truncate(paragraph, m_MaxParagraph);
 
             // 書き込む前の記事群
             Article articleObj(article["title"].toString(), paragraph, article["url"].toString(), convDate);
             m_BeforeWritingArticles.append(articleObj);
 
-#ifdef _DEBUG
-            qDebug() << "Title : " << article["title"].toString();
-            qDebug() << "Paragraph : " << paragraph;
-            qDebug() << "URL : " << article["url"].toString();
-            qDebug() << "Date : " << convDate;
-            qDebug() << "";
-#endif
+            LOG_DEBUG(QString("ニュース記事 : %1").arg(article["title"].toString()),
+                      {{"paragraph", paragraph}, {"url", article["url"].toString()}, {"date", convDate}});
         }
     }
     else {
         // レスポンスの取得に失敗した場合
-        std::cerr << m_pReply->errorString().toStdString() << std::endl;
+        LOG_ERROR(reply->errorString());
     }
 
-    m_pReply->deleteLater();
+    reply->deleteLater();
 
     emit NewAPIfinished();
 }
 
 
-// 時事ドットコムからニュース記事の取得後に実行する
-void Runner::fetchJiJiRSS()
+// 各ニュースサイトからRSSの取得後に実行する
+// RSSのパースおよび各itemタグの走査はワーカスレッドで実行して、メインスレッドは走査の結果 (値) のみを受け取る
+// 書き込み対象の選別 (類似、公開日、書き込み済み) はメインスレッドで実行して、
+// RSSに本文が含まれないニュースサイトの場合は、選別したニュース記事の本文を同時に取得した後にdoneを実行する
+void Runner::fetchRSS(int source, QNetworkReply *reply, const std::function<void()> &done)
 {
-    auto byteArray  = m_pReplyJiJi->readAll();
-    auto xmlContent = byteArray.constData();
+    auto url    = reply->request().url();
+    auto finish = [this, source, done]() {
+        emitFinished(source);
+        done();
+    };
 
-    // libxml2の初期化
-    xmlInitParser();
-    LIBXML_TEST_VERSION
-
-    // メモリバッファからXMLをパース
-    auto *doc = xmlReadMemory(xmlContent, byteArray.size(), "noname.xml", nullptr, 0);
-    if (doc == nullptr) {
-        std::cerr << "Failed to parse XML from memory" << std::endl;
-        emit JiJifinished();
+    if (reply->error() != QNetworkReply::NoError) {
+        // レスポンスの取得に失敗した場合
+        LOG_ERROR(QString("%1のRSSの取得に失敗 (%2)").arg(sourceName(source), reply->errorString()));
+        reply->deleteLater();
+        finish();
 
         return;
     }
 
-    // ルート要素を取得
-    auto *root_element = xmlDocGetRootElement(doc);
+    auto byteArray  = reply->readAll();
+    reply->deleteLater();
+
+    // 走査の結果 (ワーカスレッドで書き込み、完了の通知の後にメインスレッドで読み込む)
+    struct FEED {
+        bool                Parsed  = false;
+        QList<FEED_ITEM>    Items;
+    };
+
+    auto pFeed          = std::make_shared<FEED>();
+    auto maxParagraph   = m_MaxParagraph;
+    auto newsOnly       = m_KyodoNewsOnly;
+    auto hanJTopUrl     = m_HanJTopURL;
+
+    // メモリバッファからXMLをパースして、各itemタグを走査 (ワーカスレッドで実行して、待機せずに戻る)
+    ParserPool::getInstance()->parseXmlAsync(byteArray, this, [source, pFeed, maxParagraph, newsOnly, hanJTopUrl](xmlDocPtr doc) {
+        if (doc == nullptr) return;
+
+        TraceSpan span("parse", "Runner::fetchRSS");
+        if (span) span.setArg(sourceKey(source));
+
+        pFeed->Parsed = true;
+
+        // ルート要素を取得
+        auto *root_element = xmlDocGetRootElement(doc);
+
+        // 各itemタグを処理
+        switch (source) {
+            case JIJI:      itemTagsforJiJi(root_element, pFeed->Items);                                break;
+            case KYODO:     itemTagsforKyodo(root_element, maxParagraph, newsOnly, pFeed->Items);       break;
+            case ASAHI:     itemTagsforAsahi(root_element, pFeed->Items);                               break;
+            case MAINICHI:  itemTagsforMainichi(root_element, pFeed->Items);                            break;
+            case CNET:      itemTagsforCNet(root_element, pFeed->Items);                                break;
+            case HANJ:      itemTagsforHanJ(root_element, maxParagraph, hanJTopUrl, pFeed->Items);      break;
+            case REUTERS:   itemTagsforReuters(root_element, pFeed->Items);                             break;
+            default:                                                                                    break;
+        }
+    },
+    [this, source, url, pFeed, finish]() {
+        if (!pFeed->Parsed) {
+            LOG_ERROR(QString("Failed to parse XML from memory"));
+            m_pSourceHealth->recordFailure(url, SourceHealth::PARSE);
+            finish();
+
+            return;
+        }
+
+        // RSSを取得できた場合は、ホストは正常と見なす
+        m_pSourceHealth->recordSuccess(url);
+
+        // 書き込み対象外のニュース記事を除外
+        const auto items = filterItems(pFeed->Items);
+
+        // RSSに本文が含まれないニュースサイトの場合は、各ニュース記事の本文を同時に取得
+        switch (source) {
+            case JIJI:
+            case ASAHI:     fetchPendingArticles(items, QString(), false, finish);              return;
+            case MAINICHI:  fetchPendingArticles(items, m_MainichiParaXPath, true, finish);     return;
+            case CNET:      fetchPendingArticles(items, m_CNETParaXPath, false, finish);        return;
+            case REUTERS:   fetchPendingArticles(items, m_ReutersParaXPath, false, finish);     return;
+            default:                                                                            break;
+        }
+
+        for (const auto &item : items) {
+            // 書き込む前の記事群
+            Article article(item.Title, item.Paragraph, item.Link, item.Date);
+            m_BeforeWritingArticles.append(article);
+
+            LOG_DEBUG(QString("ニュース記事 : %1").arg(item.Title),
+                      {{"paragraph", item.Paragraph}, {"url", item.Link}, {"date", item.Date}});
+        }
+
+        finish();
+    });
+}
+
+
+// 指定したニュースサイトからニュース記事の取得の終了を知らせるシグナルを送信
+void Runner::emitFinished(int source)
+{
+    switch (source) {
+        case NEWSAPI:       emit NewAPIfinished();      break;
+        case JIJI:          emit JiJifinished();        break;
+        case KYODO:         emit Kyodofinished();       break;
+        case ASAHI:         emit Asahifinished();       break;
+        case MAINICHI:      emit Mainichifinished();    break;
+        case CNET:          emit CNetfinished();        break;
+        case HANJ:          emit HanJfinished();        break;
+        case REUTERS:       emit Reutersfinished();     break;
+        case TOKYONP:       emit TokyoNPfinished();     break;
+        default:                                        break;
+    }
+}
+
+
+// RSSから取得したニュース記事群から、書き込み対象外のニュース記事を除外する
+// 書き込み済みのニュース記事群を参照するため、メインスレッドで実行する
+QList<Runner::FEED_ITEM> Runner::filterItems(const QList<FEED_ITEM> &items) const
+{
+    QList<FEED_ITEM> filtered;
+
+    for (const auto &item : items) {
+        // 書き込み済みのニュース記事と類似している場合 (他のニュースサイトの同じ話題等) は、本文を取得せずに無視
+        if (isDuplicateForAll(item.Title)) continue;
 
-    // 各itemタグを処理
-    itemTagsforJiJi(root_element);
+        // 今日のニュース記事ではない場合、または、指定時間以内のニュース記事ではない場合は無視
+        if (item.HasDate) {
+            auto isCheckDate = m_WithinHours == 0 ? isToday(item.Date) : isHoursAgo(item.Date);
+            if (!isCheckDate) continue;
+        }
 
-    // ドキュメントを解放
-    xmlFreeDoc(doc);
+        // 既に書き込み済みの記事の場合は無視
+        if (isWrittenForAll(item.Link)) continue;
 
-    // libxml2をクリーンアップ
-    xmlCleanupParser();
+        // ロイター通信等のRSSでは、1つのRSSに同じ記事が複数存在する場合がある
+        // そのため、同じ記事が存在するかどうか確認して、存在する場合は無視する
+        auto bIdenticalArticle = std::any_of(filtered.cbegin(), filtered.cend(), [&item](const FEED_ITEM &other) {
+            return other.Link.compare(item.Link, Qt::CaseSensitive) == 0;
+        });
+        if (bIdenticalArticle) continue;
 
-    m_pReplyJiJi->deleteLater();
+        filtered.append(item);
+    }
 
-    emit JiJifinished();
+    return filtered;
 }
 
 
 // 時事ドットコムのニュース記事(RSS)を分解して取得する
-void Runner::itemTagsforJiJi(xmlNode *a_node)
+// ワーカスレッドで実行するため、本オブジェクトのメンバ変数を参照しない
+void Runner::itemTagsforJiJi(xmlNode *a_node, QList<FEED_ITEM> &items)
 {
     for (auto cur_node = a_node; cur_node; cur_node = cur_node->next) {
         if (cur_node->type == XML_ELEMENT_NODE && xmlStrcmp(cur_node->name, BAD_CAST "item") == 0) {
-            xmlNode *itemChild = cur_node->children;
-            QString title       = "",
-                    paragraph   = "",
-                    link        = "",
-                    date        = "";
-            bool    bSkipNews   = false;
+            xmlNode  *itemChild = cur_node->children;
+            FEED_ITEM item;
 
             while (itemChild) {
                 if (itemChild->type == XML_ELEMENT_NODE) {
                     if (xmlStrcmp(itemChild->name, BAD_CAST "title") == 0) {
-                        title = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
+                        item.Title = XmlPtr::content(itemChild);
                     }
                     else if (xmlStrcmp(itemChild->name, BAD_CAST "link") == 0) {
-                        link = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
-
-                        // 記事の本文から指定文字数分のみ取得
-                        QUrl url(link);
-                        HtmlFetcher fetcher(m_MaxParagraph, this);
-
-                        if (fetcher.fetch(url, true)) {
-                            // 本文の取得に失敗した場合
-                            bSkipNews = true;
-                            break;
-                        }
-
-                        paragraph = fetcher.getParagraph();
+                        // 記事の本文は、書き込み対象の選別の後に指定文字数分のみ取得
+                        QUrl url(XmlPtr::content(itemChild));
+                        item.BodyUrl = url;
 
                         // URLのクエリ部分を操作
                         QUrlQuery query(url);
-                        auto convURL = url.adjusted(QUrl::RemoveQuery).toString() + QString("?k=") + query.queryItemValue("k");
-
-                        link = convURL;
+                        item.Link = url.adjusted(QUrl::RemoveQuery).toString() + QString("?k=") + query.queryItemValue("k");
                     }
                     else if (xmlStrcmp(itemChild->name, BAD_CAST "date") == 0) {
-                        date = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
+                        auto date = XmlPtr::content(itemChild);
 
                         // 日付のフォーマットをISO 8601形式("yyyy-MM-ddThh:mm:ssZ")から"yyyy年M月d日 h時m分"へ変更
-                        date = convertDate(date);
-
-                        // ニュースの公開日を確認
-                        auto isCheckDate = m_WithinHours == 0 ? isToday(date) : isHoursAgo(date);
-                        if (!isCheckDate) {
-                            bSkipNews = true;
-                            break;
-                        }
+                        item.Date    = convertDate(date);
+                        item.HasDate = true;
                     }
                 }
                 itemChild = itemChild->next;
             }
 
-            // 今日のニュース記事ではない場合、または、指定時間以内のニュース記事ではない場合は無視
-            if (bSkipNews) continue;
-
-            // 既に書き込み済みの記事の場合は無視
-            bool bWritten = false;
-            for (auto &writtenArticle : m_WrittenArticles) {
-                QString url = "";
-                std::tie(std::ignore, std::ignore, url, std::ignore) = writtenArticle.getArticleData();
-
-                if (url.compare(link, Qt::CaseSensitive) == 0) {
-                    bWritten = true;
-                    break;
-                }
-            }
-            if (bWritten) continue;
-
-            // 書き込む前の記事群
-            Article article(title, paragraph, link, date);
-            m_BeforeWritingArticles.append(article);
-
-#ifdef _DEBUG
-            qDebug() << "Title : " << title;
-            qDebug() << "Paragraph : " << paragraph;
-            qDebug() << "URL : " << link;
-            qDebug() << "Date : " << date;
-            qDebug() << "";
-#endif
+            // 本文を取得する前のニュース記事群
+            items.append(item);
         }
-        itemTagsforJiJi(cur_node->children);
+        itemTagsforJiJi(cur_node->children, items);
     }
 }
 
 
-// 共同通信からニュース記事の取得後に実行する
-void Runner::fetchKyodoRSS()
-{
-    auto byteArray  = m_pReplyKyodo->readAll();
-    auto xmlContent = byteArray.constData();
-
-    // libxml2の初期化
-    xmlInitParser();
-    LIBXML_TEST_VERSION
-
-    // メモリバッファからXMLをパース
-    auto *doc = xmlReadMemory(xmlContent, byteArray.size(), "noname.xml", nullptr, 0);
-    if (doc == nullptr) {
-        std::cerr << "Failed to parse XML from memory" << std::endl;
-        emit Kyodofinished();
-
-        return;
-    }
-
-    // ルート要素を取得
-    auto *root_element = xmlDocGetRootElement(doc);
-
-    // 各itemタグを処理
-    itemTagsforKyodo(root_element);
-
-    // ドキュメントを解放
-    xmlFreeDoc(doc);
-
-    // libxml2をクリーンアップ
-    xmlCleanupParser();
-
-    m_pReplyKyodo->deleteLater();
-
-    emit Kyodofinished();
-}
-
-
 // 共同通信のニュース記事(RSS)を分解して取得する
-void Runner::itemTagsforKyodo(xmlNode *a_node)
+// ワーカスレッドで実行するため、本オブジェクトのメンバ変数を参照しない
+void Runner::itemTagsforKyodo(xmlNode *a_node, long long maxParagraph, bool newsOnly, QList<FEED_ITEM> &items)
 {
     for (auto cur_node = a_node; cur_node; cur_node = cur_node->next) {
         if (cur_node->type == XML_ELEMENT_NODE && xmlStrcmp(cur_node->name, BAD_CAST "item") == 0) {
-            xmlNode *itemChild = cur_node->children;
-            QString title       = "",
-                    paragraph   = "",
-                    link        = "",
-                    date        = "";
-            bool    bSkipNews   = false;
+            xmlNode  *itemChild = cur_node->children;
+            FEED_ITEM item;
+            bool      bSkipNews = false;
 
             while (itemChild) {
                 if (itemChild->type == XML_ELEMENT_NODE) {
                     if (xmlStrcmp(itemChild->name, BAD_CAST "title") == 0) {
-                        title = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
+                        item.Title = XmlPtr::content(itemChild);
                     }
                     else if (xmlStrcmp(itemChild->name, BAD_CAST "description") == 0) {
-                        paragraph = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
+                        auto paragraph = XmlPtr::content(itemChild);
 
                         // 本文の先頭にあるyyyy年M月d日=<文字数> (全角数字と全角カンマを含む) を削除
-                        static QRegularExpression re2("^[0-9０-９]{4}年[0-9０-９]{1,2}月[0-9０-９]{1,2}日[=＝][0-9０-９,，]+");
-                        paragraph.remove(re2);
+                        paragraph = DescriptionSanitizer::stripDateline(paragraph);
 
-                        // 不要な文字を削除 (スペース等)
-                        static QRegularExpression re1("[\\s]", QRegularExpression::CaseInsensitiveOption);
-                        paragraph = paragraph.replace(re1, "").replace(" ", "").replace(" ", "").replace("\u3000", "");
+                        // 不要な文字を削除 (半角 / 全角スペース、ノーブレークスペース等)
+                        static const TextNormalizer normalizer(TextNormalizer::REMOVE, QString(QChar(0x00A0)));
+                        paragraph = normalizer.normalize(paragraph);
 
                         // 先頭に"＊"がある場合は削除
                         if (paragraph.startsWith("＊")) {
@@ -883,534 +1439,207 @@ void Runner::itemTagsforKyodo(xmlNode *a_node)
                         paragraph = result.trimmed();
 
                         // 本文が指定文字数以上の場合、指定文字数分のみを抽出
-                        paragraph = paragraph.size() > m_MaxParagraph ? paragraph.mid(0, static_cast<int>(m_MaxParagraph)) + QString("...") : paragraph;
+                        item.Paragraph = TextNormalizer::truncate(paragraph, maxParagraph);
                     }
                     else if (xmlStrcmp(itemChild->name, BAD_CAST "link") == 0) {
-                        link = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
+                        item.Link = XmlPtr::content(itemChild);
 
-                        if (m_KyodoNewsOnly) {
+                        if (newsOnly) {
                             // ニュース記事の枠ではない場合は該当記事を無視
-                            if (!link.startsWith("https://www.kyodo.co.jp/news/")) {
+                            if (!item.Link.startsWith("https://www.kyodo.co.jp/news/")) {
                                 bSkipNews = true;
-                                break;
-                            }
-                        }
-                    }
-                    else if (xmlStrcmp(itemChild->name, BAD_CAST "pubDate") == 0) {
-                        date = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
-
-                        // 日付のフォーマットをUTCから日本時間の"yyyy年M月d日 h時m分"形式へ変更
-                        date = convertJPDateforKyodo(date);
-
-                        // ニュースの公開日を確認
-                        auto isCheckDate = m_WithinHours == 0 ? isToday(date) : isHoursAgo(date);
-                        if (!isCheckDate) {
-                            bSkipNews = true;
-                            break;
-                        }
-                    }
-                }
-                itemChild = itemChild->next;
-            }
-
-            // 今日のニュース記事ではない場合、または、指定時間以内のニュース記事ではない場合は無視
-            if (bSkipNews) continue;
-
-            // 既に書き込み済みの記事の場合は無視
-            bool bWritten = false;
-            for (auto &writtenArticle : m_WrittenArticles) {
-                QString url = "";
-                std::tie(std::ignore, std::ignore, url, std::ignore) = writtenArticle.getArticleData();
-
-                if (url.compare(link, Qt::CaseSensitive) == 0) {
-                    bWritten = true;
-                    break;
-                }
-            }
-            if (bWritten) continue;
-
-            // 書き込む前の記事群
-            Article article(title, paragraph, link, date);
-            m_BeforeWritingArticles.append(article);
-
-#ifdef _DEBUG
-            qDebug() << "Title : " << title;
-            qDebug() << "Paragraph : " << paragraph;
-            qDebug() << "URL : " << link;
-            qDebug() << "Date : " << date;
-            qDebug() << "";
-#endif
-        }
-        itemTagsforKyodo(cur_node->children);
-    }
-}
-
-
-// 朝日新聞デジタルからニュース記事の取得後に実行する
-void Runner::fetchAsahiRSS()
-{
-    auto byteArray  = m_pReplyAsahi->readAll();
-    auto xmlContent = byteArray.constData();
-
-    // libxml2の初期化
-    xmlInitParser();
-    LIBXML_TEST_VERSION
-
-    // メモリバッファからXMLをパース
-    auto *doc = xmlReadMemory(xmlContent, byteArray.size(), "noname.xml", nullptr, 0);
-    if (doc == nullptr) {
-        std::cerr << "Failed to parse XML from memory" << std::endl;
-        emit Asahifinished();
-
-        return;
-    }
-
-    // ルート要素を取得
-    auto *root_element = xmlDocGetRootElement(doc);
-
-    // 各itemタグを処理
-    itemTagsforAsahi(root_element);
-
-    // ドキュメントを解放
-    xmlFreeDoc(doc);
+                                break;
+                            }
+                        }
+                    }
+                    else if (xmlStrcmp(itemChild->name, BAD_CAST "pubDate") == 0) {
+                        auto date = XmlPtr::content(itemChild);
 
-    // libxml2をクリーンアップ
-    xmlCleanupParser();
+                        // 日付のフォーマットをUTCから日本時間の"yyyy年M月d日 h時m分"形式へ変更
+                        item.Date    = convertJPDateforKyodo(date);
+                        item.HasDate = true;
+                    }
+                }
+                itemChild = itemChild->next;
+            }
 
-    m_pReplyAsahi->deleteLater();
+            // ニュース記事の枠ではない場合は無視
+            if (bSkipNews) continue;
 
-    emit Asahifinished();
+            // 書き込む前の記事群
+            items.append(item);
+        }
+        itemTagsforKyodo(cur_node->children, maxParagraph, newsOnly, items);
+    }
 }
 
 
 // 朝日新聞デジタルのニュース記事(RSS)を分解して取得する
-void Runner::itemTagsforAsahi(xmlNode *a_node)
+// ワーカスレッドで実行するため、本オブジェクトのメンバ変数を参照しない
+void Runner::itemTagsforAsahi(xmlNode *a_node, QList<FEED_ITEM> &items)
 {
     for (auto cur_node = a_node; cur_node; cur_node = cur_node->next) {
         if (cur_node->type == XML_ELEMENT_NODE && xmlStrcmp(cur_node->name, BAD_CAST "item") == 0) {
-            xmlNode *itemChild = cur_node->children;
-            QString title       = "",
-                    paragraph   = "",
-                    link        = "",
-                    date        = "";
-            bool    bSkipNews   = false;
+            xmlNode  *itemChild = cur_node->children;
+            FEED_ITEM item;
 
             while (itemChild) {
                 if (itemChild->type == XML_ELEMENT_NODE) {
                     if (xmlStrcmp(itemChild->name, BAD_CAST "title") == 0) {
-                        title = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
+                        item.Title = XmlPtr::content(itemChild);
                     }
                     else if (xmlStrcmp(itemChild->name, BAD_CAST "link") == 0) {
-                        link = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
-
                         // refクエリパラメータを削除
-                        QUrl url(link);
+                        QUrl url(XmlPtr::content(itemChild));
                         QUrlQuery query(url.query());
 
                         query.removeQueryItem("ref");
                         url.setQuery(query);
 
-                        link = url.toString();
-
-                        // 記事の本文から指定文字数分のみ取得
-                        HtmlFetcher fetcher(m_MaxParagraph, this);
+                        item.Link = url.toString();
 
-                        if (fetcher.fetch(link, true)) {
-                            // 本文の取得に失敗した場合
-                            bSkipNews = true;
-                            break;
-                        }
-
-                        paragraph = fetcher.getParagraph();
+                        // 記事の本文は、書き込み対象の選別の後に指定文字数分のみ取得
+                        item.BodyUrl = QUrl(item.Link);
                     }
                     else if (xmlStrcmp(itemChild->name, BAD_CAST "date") == 0) {
-                        date = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
+                        auto date = XmlPtr::content(itemChild);
 
                         // 日付のフォーマットを"yyyy-MM-ddThh:mm+09:00"から"yyyy年M月d日 h時m分"へ変更
-                        date = convertDate(date);
-
-                        // ニュースの公開日を確認
-                        auto isCheckDate = m_WithinHours == 0 ? isToday(date) : isHoursAgo(date);
-                        if (!isCheckDate) {
-                            bSkipNews = true;
-                            break;
-                        }
+                        item.Date    = convertDate(date);
+                        item.HasDate = true;
                     }
                 }
                 itemChild = itemChild->next;
             }
 
-            // 今日のニュース記事ではない場合、または、指定時間以内のニュース記事ではない場合は無視
-            if (bSkipNews) continue;
-
-            // 既に書き込み済みの記事の場合は無視
-            bool bWritten = false;
-            for (auto &writtenArticle : m_WrittenArticles) {
-                QString url = "";
-                std::tie(std::ignore, std::ignore, url, std::ignore) = writtenArticle.getArticleData();
-
-                if (url.compare(link, Qt::CaseSensitive) == 0) {
-                    bWritten = true;
-                    break;
-                }
-            }
-            if (bWritten) continue;
-
-            // 書き込む前の記事群
-            Article article(title, paragraph, link, date);
-            m_BeforeWritingArticles.append(article);
-
-#ifdef _DEBUG
-            qDebug() << "Title : " << title;
-            qDebug() << "Paragraph : " << paragraph;
-            qDebug() << "URL : " << link;
-            qDebug() << "Date : " << date;
-            qDebug() << "";
-#endif
+            // 本文を取得する前のニュース記事群
+            items.append(item);
         }
-        itemTagsforAsahi(cur_node->children);
+        itemTagsforAsahi(cur_node->children, items);
     }
 }
 
 
-// 毎日新聞からニュース記事の取得後に実行する
-void Runner::fetchMainichiRSS()
-{
-    auto byteArray  = m_pReplyMainichi->readAll();
-    auto xmlContent = byteArray.constData();
-
-    // libxml2の初期化
-    xmlInitParser();
-    LIBXML_TEST_VERSION
-
-    // メモリバッファからXMLをパース
-    auto *doc = xmlReadMemory(xmlContent, byteArray.size(), "noname.xml", nullptr, 0);
-    if (doc == nullptr) {
-        std::cerr << "Failed to parse XML from memory" << std::endl;
-        emit Mainichifinished();
-
-        return;
-    }
-
-    // ルート要素を取得
-    auto *root_element = xmlDocGetRootElement(doc);
-
-    // 各itemタグを処理
-    itemTagsforMainichi(root_element);
-
-    // ドキュメントを解放
-    xmlFreeDoc(doc);
-
-    // libxml2をクリーンアップ
-    xmlCleanupParser();
-
-    m_pReplyMainichi->deleteLater();
-
-    emit Mainichifinished();
-}
-
-
 // 毎日新聞のニュース記事(RSS)を分解して取得する
-void Runner::itemTagsforMainichi(xmlNode *a_node)
+// ワーカスレッドで実行するため、本オブジェクトのメンバ変数を参照しない
+void Runner::itemTagsforMainichi(xmlNode *a_node, QList<FEED_ITEM> &items)
 {
     for (auto cur_node = a_node; cur_node; cur_node = cur_node->next) {
         if (cur_node->type == XML_ELEMENT_NODE && xmlStrcmp(cur_node->name, BAD_CAST "item") == 0) {
-            xmlNode *itemChild = cur_node->children;
-            QString title       = "",
-                    paragraph   = "",
-                    link        = "",
-                    date        = "";
-            bool    bSkipNews   = false;
+            xmlNode  *itemChild = cur_node->children;
+            FEED_ITEM item;
 
             while (itemChild) {
                 if (itemChild->type == XML_ELEMENT_NODE) {
                     if (xmlStrcmp(itemChild->name, BAD_CAST "title") == 0) {
-                        title = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
+                        item.Title = XmlPtr::content(itemChild);
                     }
                     else if (xmlStrcmp(itemChild->name, BAD_CAST "link") == 0) {
                         // ニュース記事のURLを取得
-                        link = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
-
-                        // ニュース記事のURLからHTMLタグを解析した後、記事の概要を取得して指定文字数分のみ取得
-                        QUrl url(link);
-                        HtmlFetcher fetcher(m_MaxParagraph, this);
+                        item.Link = XmlPtr::content(itemChild);
 
-                        if (fetcher.fetch(url, true, m_MainichiParaXPath)) {
-                            // 本文の取得に失敗した場合
-                            bSkipNews = true;
-                            break;
-                        }
-
-                        // ニュース記事の概要を取得
-                        // 本文の先頭および最後尾に空白が入ることがあるため消去
-                        paragraph = fetcher.getParagraph().trimmed();
+                        // ニュース記事の概要は、書き込み対象の選別の後にHTMLタグを解析して指定文字数分のみ取得
+                        // (本文の先頭および最後尾に空白が入ることがあるため消去する)
+                        item.BodyUrl = QUrl(item.Link);
                     }
                     else if (xmlStrcmp(itemChild->name, BAD_CAST "date") == 0) {
-                        date = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
+                        auto date = XmlPtr::content(itemChild);
 
                         // 日付のフォーマットをISO 8601形式から"yyyy年M月d日 h時m分"へ変更
-                        date = convertDate(date);
-
-                        // ニュースの公開日を確認
-                        auto isCheckDate = m_WithinHours == 0 ? isToday(date) : isHoursAgo(date);
-                        if (!isCheckDate) {
-                            bSkipNews = true;
-                            break;
-                        }
+                        item.Date    = convertDate(date);
+                        item.HasDate = true;
                     }
                 }
                 itemChild = itemChild->next;
             }
 
-            // 今日のニュース記事ではない場合、または、指定時間以内のニュース記事ではない場合は無視
-            if (bSkipNews) continue;
-
-            // 既に書き込み済みの記事の場合は無視
-            bool bWritten = false;
-            for (auto &writtenArticle : m_WrittenArticles) {
-                QString url = "";
-                std::tie(std::ignore, std::ignore, url, std::ignore) = writtenArticle.getArticleData();
-
-                if (url.compare(link, Qt::CaseSensitive) == 0) {
-                    bWritten = true;
-                    break;
-                }
-            }
-            if (bWritten) continue;
-
-            // 書き込む前の記事群
-            Article article(title, paragraph, link, date);
-            m_BeforeWritingArticles.append(article);
-
-#ifdef _DEBUG
-            qDebug() << "Title : " << title;
-            qDebug() << "Paragraph : " << paragraph;
-            qDebug() << "URL : " << link;
-            qDebug() << "Date : " << date;
-            qDebug() << "";
-#endif
+            // 本文を取得する前のニュース記事群
+            items.append(item);
         }
-        itemTagsforMainichi(cur_node->children);
+        itemTagsforMainichi(cur_node->children, items);
     }
 }
 
 
-// CNET Japanからニュース記事の取得後に実行する
-void Runner::fetchCNetRSS()
-{
-    auto byteArray  = m_pReplyCNet->readAll();
-    auto xmlContent = byteArray.constData();
-
-    // libxml2の初期化
-    xmlInitParser();
-    LIBXML_TEST_VERSION
-
-    // メモリバッファからXMLをパース
-    auto *doc = xmlReadMemory(xmlContent, byteArray.size(), "noname.xml", nullptr, 0);
-    if (doc == nullptr) {
-        std::cerr << "Failed to parse XML from memory" << std::endl;
-        emit CNetfinished();
-
-        return;
-    }
-
-    // ルート要素を取得
-    auto *root_element = xmlDocGetRootElement(doc);
-
-    // 各itemタグを処理
-    itemTagsforCNet(root_element);
-
-    // ドキュメントを解放
-    xmlFreeDoc(doc);
-
-    // libxml2をクリーンアップ
-    xmlCleanupParser();
-
-    m_pReplyCNet->deleteLater();
-
-    emit CNetfinished();
-}
-
-
 // CNET Japanのニュース記事(RSS)を分解して取得する
-void Runner::itemTagsforCNet(xmlNode *a_node)
+// ワーカスレッドで実行するため、本オブジェクトのメンバ変数を参照しない
+void Runner::itemTagsforCNet(xmlNode *a_node, QList<FEED_ITEM> &items)
 {
     for (auto cur_node = a_node; cur_node; cur_node = cur_node->next) {
         if (cur_node->type == XML_ELEMENT_NODE && xmlStrcmp(cur_node->name, BAD_CAST "item") == 0) {
-            xmlNode *itemChild = cur_node->children;
-            QString title       = "",
-                    paragraph   = "",
-                    link        = "",
-                    date        = "";
-            bool    bSkipNews   = false;
+            xmlNode  *itemChild = cur_node->children;
+            FEED_ITEM item;
 
             while (itemChild) {
                 if (itemChild->type == XML_ELEMENT_NODE) {
                     if (xmlStrcmp(itemChild->name, BAD_CAST "title") == 0) {
-                        title = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
+                        item.Title = XmlPtr::content(itemChild);
                     }
                     else if (xmlStrcmp(itemChild->name, BAD_CAST "description") == 0) {
                         // 現在、RSSからニュース記事の概要を取得しない
                         // 該当するニュース記事のURLにアクセスして、記事の概要を抽出する
-                        // paragraph = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
-
-                        // // 不要なhtmlタグを除去
-                        // static QRegularExpression re2("<br .*</a>", QRegularExpression::DotMatchesEverythingOption);
-                        // paragraph.remove(re2);
+                        // paragraph = XmlPtr::content(itemChild);
 
-                        // // 不要な文字を削除 (\n, \t)
-                        // static QRegularExpression re1("[\t\n]", QRegularExpression::CaseInsensitiveOption);
-                        // paragraph = paragraph.replace(re1, "");
+                        // // 不要なhtmlタグ (brタグ、および、aタグとその内容) を除去
+                        // paragraph = DescriptionSanitizer::sanitize(paragraph, DescriptionSanitizer::DROP_BR | DescriptionSanitizer::DROP_LINK);
 
-                        // // 不要な文字を削除 (スペース等)
-                        // static QRegularExpression re3("[\\s]", QRegularExpression::CaseInsensitiveOption);
-                        // paragraph = paragraph.replace(re3, "").replace(" ", "").replace("\u3000", "");
-
-                        // // 本文が指定文字数以上の場合、指定文字数分のみを抽出
-                        // paragraph = paragraph.size() > m_MaxParagraph ? paragraph.mid(0, static_cast<int>(m_MaxParagraph)) + QString("...") : paragraph;
+                        // // 不要な文字を削除 (\n, \t, 半角 / 全角スペース等) し、本文が指定文字数以上の場合、指定文字数分のみを抽出
+                        // static const TextNormalizer normalizer;
+                        // paragraph = normalizer.normalize(paragraph, maxParagraph);
                     }
                     else if (xmlStrcmp(itemChild->name, BAD_CAST "link") == 0) {
                         // ニュース記事のURLを取得
-                        link = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
-
-                        // ニュース記事のURLからHTMLタグを解析した後、記事の概要を取得して指定文字数分のみ取得
-                        QUrl url(link);
-                        HtmlFetcher fetcher(m_MaxParagraph, this);
-
-                        if (fetcher.fetch(url, true, QString(m_CNETParaXPath))) {
-                            // ニュース記事の概要の取得に失敗した場合
-                            bSkipNews = true;
-                            break;
-                        }
+                        item.Link = XmlPtr::content(itemChild);
 
-                        // ニュース記事の概要を取得
-                        paragraph = fetcher.getParagraph();
+                        // ニュース記事の概要は、書き込み対象の選別の後にHTMLタグを解析して指定文字数分のみ取得
+                        item.BodyUrl = QUrl(item.Link);
                     }
                     else if (xmlStrcmp(itemChild->name, BAD_CAST "date") == 0) {
-                        date = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
+                        auto date = XmlPtr::content(itemChild);
 
                         // 日付のフォーマットを"yyyy-MM-ddThh:mm+09:00"から"yyyy年M月d日 h時m分"へ変更
-                        date = convertDate(date);
-
-                        // ニュースの公開日を確認
-                        auto isCheckDate = m_WithinHours == 0 ? isToday(date) : isHoursAgo(date);
-                        if (!isCheckDate) {
-                            bSkipNews = true;
-                            break;
-                        }
+                        item.Date    = convertDate(date);
+                        item.HasDate = true;
                     }
                 }
                 itemChild = itemChild->next;
             }
 
-            // 今日のニュース記事ではない場合、または、指定時間以内のニュース記事ではない場合は無視
-            if (bSkipNews) continue;
-
-            // 既に書き込み済みの記事の場合は無視
-            bool bWritten = false;
-            for (auto &writtenArticle : m_WrittenArticles) {
-                QString url = "";
-                std::tie(std::ignore, std::ignore, url, std::ignore) = writtenArticle.getArticleData();
-
-                if (url.compare(link, Qt::CaseSensitive) == 0) {
-                    bWritten = true;
-                    break;
-                }
-            }
-            if (bWritten) continue;
-
-            // 書き込む前の記事群
-            Article article(title, paragraph, link, date);
-            m_BeforeWritingArticles.append(article);
-
-#ifdef _DEBUG
-            qDebug() << "Title : " << title;
-            qDebug() << "Paragraph : " << paragraph;
-            qDebug() << "URL : " << link;
-            qDebug() << "Date : " << date;
-            qDebug() << "";
-#endif
+            // 本文を取得する前のニュース記事群
+            items.append(item);
         }
-        itemTagsforCNet(cur_node->children);
-    }
-}
-
-
-// ハンギョレジャパンからニュース記事の取得後に実行する
-void Runner::fetchHanJRSS()
-{
-    auto byteArray  = m_pReplyHanJ->readAll();
-    auto xmlContent = byteArray.constData();
-
-    // libxml2の初期化
-    xmlInitParser();
-    LIBXML_TEST_VERSION
-
-    // メモリバッファからXMLをパース
-    auto *doc = xmlReadMemory(xmlContent, byteArray.size(), "noname.xml", nullptr, 0);
-    if (doc == nullptr) {
-        std::cerr << "Failed to parse XML from memory" << std::endl;
-        emit HanJfinished();
-
-        return;
+        itemTagsforCNet(cur_node->children, items);
     }
-
-    // ルート要素を取得
-    auto *root_element = xmlDocGetRootElement(doc);
-
-    // 各itemタグを処理
-    itemTagsforHanJ(root_element);
-
-    // ドキュメントを解放
-    xmlFreeDoc(doc);
-
-    // libxml2をクリーンアップ
-    xmlCleanupParser();
-
-    m_pReplyHanJ->deleteLater();
-
-    emit HanJfinished();
 }
 
 
 // ハンギョレジャパンのニュース記事(RSS)を分解して取得する
-void Runner::itemTagsforHanJ(xmlNode *a_node)
+// ワーカスレッドで実行するため、本オブジェクトのメンバ変数を参照しない
+void Runner::itemTagsforHanJ(xmlNode *a_node, long long maxParagraph, const QString &topUrl, QList<FEED_ITEM> &items)
 {
     for (auto cur_node = a_node; cur_node; cur_node = cur_node->next) {
         if (cur_node->type == XML_ELEMENT_NODE && xmlStrcmp(cur_node->name, BAD_CAST "item") == 0) {
-            xmlNode *itemChild = cur_node->children;
-            QString title       = "",
-                    paragraph   = "",
-                    link        = "",
-                    date        = "";
-            bool    bSkipNews   = false;
+            xmlNode  *itemChild = cur_node->children;
+            FEED_ITEM item;
 
             while (itemChild) {
                 if (itemChild->type == XML_ELEMENT_NODE) {
                     if (xmlStrcmp(itemChild->name, BAD_CAST "title") == 0) {
-                        title = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
+                        item.Title = XmlPtr::content(itemChild);
                     }
                     else if (xmlStrcmp(itemChild->name, BAD_CAST "description") == 0) {
-                        paragraph = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
-
-                        // 不要な文字を削除 (\n, \t) (ハンギョレジャパンのRSSの"description"には、不要な文字が含まれているため)
-                        static QRegularExpression re1("[\t\n]", QRegularExpression::CaseInsensitiveOption);
-                        paragraph = paragraph.replace(re1, "");
+                        auto paragraph = XmlPtr::content(itemChild);
 
                         // tableタグを除去 (ハンギョレジャパンのRSSの"description"には、不要なHTMLタグが含まれているため)
-                        static QRegularExpression re2("<table.*>.*</table>", QRegularExpression::DotMatchesEverythingOption);
-                        paragraph.remove(re2);
+                        paragraph = DescriptionSanitizer::sanitize(paragraph, DescriptionSanitizer::DROP_TABLE);
 
-                        // 不要な文字を削除 (半角 / 全角スペース等)
-                        static QRegularExpression re3("[\\s]", QRegularExpression::CaseInsensitiveOption);
-                        paragraph = paragraph.replace(re3, "").replace(" ", "").replace("\u3000", "");
-
-                        // 本文が指定文字数以上の場合、指定文字数分のみを抽出
-                        paragraph = paragraph.size() > m_MaxParagraph ? paragraph.mid(0, static_cast<int>(m_MaxParagraph)) + QString("...") : paragraph;
+                        // 不要な文字を削除 (\n, \t, 半角 / 全角スペース等) し、本文が指定文字数以上の場合、指定文字数分のみを抽出
+                        // (ハンギョレジャパンのRSSの"description"には、不要な文字が含まれているため)
+                        static const TextNormalizer normalizer;
+                        item.Paragraph = normalizer.normalize(paragraph, maxParagraph);
                     }
                     else if (xmlStrcmp(itemChild->name, BAD_CAST "link") == 0) {
-                        link = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
-                        link = m_HanJTopURL + link;
+                        item.Link = topUrl + XmlPtr::content(itemChild);
 
                         // ニュース記事のURLからHTMLタグを解析した後、本文を取得して指定文字数分のみ取得 (現在は使用しない)
                         // QUrl url(link);
@@ -1425,387 +1654,312 @@ void Runner::itemTagsforHanJ(xmlNode *a_node)
                         // paragraph = fetcher.getParagraph();
                     }
                     else if (xmlStrcmp(itemChild->name, BAD_CAST "pubDate") == 0) {
-                        date = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
+                        auto date = XmlPtr::content(itemChild);
 
                         // 日付のフォーマットをRFC 2822形式から"yyyy年M月d日 h時m分"へ変更
-                        date = convertDateHanJ(date);
-
-                        // ニュースの公開日を確認
-                        auto isCheckDate = m_WithinHours == 0 ? isToday(date) : isHoursAgo(date);
-                        if (!isCheckDate) {
-                            bSkipNews = true;
-                            break;
-                        }
+                        item.Date    = convertDateHanJ(date);
+                        item.HasDate = true;
                     }
                 }
                 itemChild = itemChild->next;
             }
 
-            // 今日のニュース記事ではない場合、または、指定時間以内のニュース記事ではない場合は無視
-            if (bSkipNews) continue;
-
-            // 既に書き込み済みの記事の場合は無視
-            bool bWritten = false;
-            for (auto &writtenArticle : m_WrittenArticles) {
-                QString url = "";
-                std::tie(std::ignore, std::ignore, url, std::ignore) = writtenArticle.getArticleData();
-
-                if (url.compare(link, Qt::CaseSensitive) == 0) {
-                    bWritten = true;
-                    break;
-                }
-            }
-            if (bWritten) continue;
-
             // 書き込む前の記事群
-            Article article(title, paragraph, link, date);
-            m_BeforeWritingArticles.append(article);
-
-#ifdef _DEBUG
-            qDebug() << "Title : " << title;
-            qDebug() << "Paragraph : " << paragraph;
-            qDebug() << "URL : " << link;
-            qDebug() << "Date : " << date;
-            qDebug() << "";
-#endif
+            items.append(item);
         }
-        itemTagsforHanJ(cur_node->children);
-    }
-}
-
-
-// ロイター通信からニュース記事の取得後に実行する
-void Runner::fetchReutersRSS()
-{
-    auto byteArray  = m_pReplyReuters->readAll();
-    auto xmlContent = byteArray.constData();
-
-    // libxml2の初期化
-    xmlInitParser();
-    LIBXML_TEST_VERSION
-
-    // メモリバッファからXMLをパース
-    auto *doc = xmlReadMemory(xmlContent, byteArray.size(), "noname.xml", nullptr, 0);
-    if (doc == nullptr) {
-        std::cerr << "Failed to parse XML from memory" << std::endl;
-        emit Reutersfinished();
-
-        return;
+        itemTagsforHanJ(cur_node->children, maxParagraph, topUrl, items);
     }
-
-    // ルート要素を取得
-    auto *root_element = xmlDocGetRootElement(doc);
-
-    // 各itemタグを処理
-    itemTagsforReuters(root_element);
-
-    // ドキュメントを解放
-    xmlFreeDoc(doc);
-
-    // libxml2をクリーンアップ
-    xmlCleanupParser();
-
-    m_pReplyReuters->deleteLater();
-
-    emit Reutersfinished();
 }
 
 
 // ロイター通信のニュース記事(RSS)を分解して取得
-void Runner::itemTagsforReuters(xmlNode *a_node)
+// ワーカスレッドで実行するため、本オブジェクトのメンバ変数を参照しない
+// (1つのRSSに存在する同じ記事は、書き込み対象の選別時に除外する)
+void Runner::itemTagsforReuters(xmlNode *a_node, QList<FEED_ITEM> &items)
 {
     for (auto cur_node = a_node; cur_node; cur_node = cur_node->next) {
         if (cur_node->type == XML_ELEMENT_NODE && xmlStrcmp(cur_node->name, BAD_CAST "item") == 0) {
-            xmlNode *itemChild = cur_node->children;
-            QString title       = "",
-                paragraph   = "",
-                link        = "",
-                date        = "";
-            bool    bSkipNews   = false;
+            xmlNode  *itemChild = cur_node->children;
+            FEED_ITEM item;
 
             while (itemChild) {
                 if (itemChild->type == XML_ELEMENT_NODE) {
                     if (xmlStrcmp(itemChild->name, BAD_CAST "title") == 0) {
-                        title = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
+                        item.Title = XmlPtr::content(itemChild);
                     }
                     else if (xmlStrcmp(itemChild->name, BAD_CAST "link") == 0) {
                         // ニュース記事のURLを取得
-                        link = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
+                        item.Link = XmlPtr::content(itemChild);
 
-                        // ニュース記事のURLからHTMLタグを解析した後、記事の概要を取得して指定文字数分のみ取得
-                        QUrl url(link);
-                        HtmlFetcher fetcher(m_MaxParagraph, this);
-
-                        if (fetcher.fetch(url, true, m_ReutersParaXPath)) {
-                            // 本文の取得に失敗した場合
-                            bSkipNews = true;
-                            break;
-                        }
-
-                        // ニュース記事の概要を取得
-                        paragraph = fetcher.getParagraph();
+                        // ニュース記事の概要は、書き込み対象の選別の後にHTMLタグを解析して指定文字数分のみ取得
+                        item.BodyUrl = QUrl(item.Link);
                     }
                     else if (xmlStrcmp(itemChild->name, BAD_CAST "date") == 0) {
-                        date = QString::fromUtf8(reinterpret_cast<const char*>(xmlNodeGetContent(itemChild)));
+                        auto date = XmlPtr::content(itemChild);
 
                         // 日付のフォーマットをISO 8601形式から"yyyy年M月d日 h時m分"へ変更
-                        date = convertDate(date);
-
-                        // ニュースの公開日を確認
-                        auto isCheckDate = m_WithinHours == 0 ? isToday(date) : isHoursAgo(date);
-                        if (!isCheckDate) {
-                            bSkipNews = true;
-                            break;
-                        }
+                        item.Date    = convertDate(date);
+                        item.HasDate = true;
                     }
                 }
                 itemChild = itemChild->next;
             }
 
-            // 今日のニュース記事ではない場合、または、指定時間以内のニュース記事ではない場合は無視
-            if (bSkipNews) continue;
+            // 本文を取得する前のニュース記事群
+            items.append(item);
+        }
+        itemTagsforReuters(cur_node->children, items);
+    }
+}
 
-            // 既に書き込み済みの記事の場合は無視
-            bool bWritten = false;
-            for (auto &writtenArticle : m_WrittenArticles) {
-                QString url = "";
-                std::tie(std::ignore, std::ignore, url, std::ignore) = writtenArticle.getArticleData();
 
-                if (url.compare(link, Qt::CaseSensitive) == 0) {
-                    bWritten = true;
-                    break;
-                }
-            }
-            if (bWritten) continue;
-
-            // ロイター通信のRSSでは、1つのRSSに同じ記事が複数存在する場合がある
-            // そのため、同じ記事が存在するかどうか確認して、存在する場合は無視する
-            bool bIdenticalArticle = false;
-            for (auto &beforeArticle : m_BeforeWritingArticles) {
-                QString url = "";
-                std::tie(std::ignore, std::ignore, url, std::ignore) = beforeArticle.getArticleData();
-
-                if (url.compare(link, Qt::CaseSensitive) == 0) {
-                    bIdenticalArticle = true;
-                    break;
-                }
-            }
-            if (bIdenticalArticle) continue;
+// 本文を取得する前のニュース記事群の本文を同時に取得して、書き込む前のニュース記事群に追加する
+// 各ニュース記事の本文の取得、パースおよび抽出は重ねて実行して、待機せずに戻る (全ての完了後にdoneを実行する)
+// 本文の取得に失敗したニュース記事は無視する
+void Runner::fetchPendingArticles(const QList<FEED_ITEM> &items, const QString &xpath, bool bTrim, const std::function<void()> &done)
+{
+    if (items.isEmpty()) {
+        done();
+        return;
+    }
+
+    QList<QUrl> urls;
+    for (const auto &item : items) {
+        urls.append(item.BodyUrl);
+    }
+
+    // 全ての取得が完了するまで破棄しないため、完了時に破棄する
+    auto pFetcher = new HtmlFetcher(m_MaxParagraph, this);
+    pFetcher->fetchAll(urls, true, xpath, [this, pFetcher, items, bTrim, done](const QVector<FETCH_RESULT> &results) {
+        pFetcher->deleteLater();
+
+        for (auto i = 0; i < items.size(); i++) {
+            // 本文の取得に失敗した場合
+            if (results.at(i).Result != 0) continue;
+
+            const auto &item = items.at(i);
+
+            // 本文の先頭および最後尾に空白が入るニュースサイトの場合は消去
+            const auto paragraph = bTrim ? results.at(i).Paragraph.trimmed() : results.at(i).Paragraph;
 
             // 書き込む前の記事群
-            Article article(title, paragraph, link, date);
+            Article article(item.Title, paragraph, item.Link, item.Date);
             m_BeforeWritingArticles.append(article);
 
-#ifdef _DEBUG
-            qDebug() << "Title : " << title;
-            qDebug() << "Paragraph : " << paragraph;
-            qDebug() << "URL : " << link;
-            qDebug() << "Date : " << date;
-            qDebug() << "";
-#endif
+            LOG_DEBUG(QString("ニュース記事 : %1").arg(item.Title),
+                      {{"paragraph", paragraph}, {"url", item.Link}, {"date", item.Date}});
         }
-        itemTagsforReuters(cur_node->children);
-    }
+
+        done();
+    });
 }
 
 
-// 東京新聞からニュース記事の取得後に実行する
-void Runner::fetchTokyoNP()
+// 東京新聞からニュース記事を取得するページの取得後に実行する
+// ページのパースおよび各ニュース記事のURLの抽出はワーカスレッドで実行して、メインスレッドは抽出した値のみを受け取る
+void Runner::fetchTokyoNP(QNetworkReply *reply, const std::function<void()> &done)
 {
-    HtmlFetcher fetcher(m_MaxParagraph, this);
-
-    // 東京新聞の総合ニュースからトップ記事を取得
-    // 総合ニュースからニュース記事を取得しない場合は、設定ファイルの"topxpath"キーを空欄にすること
-    if (!m_TokyoNPThumb.isEmpty()) {
-        if (fetcher.fetchElement(QUrl(m_TokyoNPFetchURL), true, m_TokyoNPThumb, XML_TEXT_NODE)) {
-            /// ヘッドラインニュースの記事の取得に失敗した場合
-            std::cerr << QString("エラー : 東京新聞のヘッドラインニュース記事のURL取得に失敗").toStdString() << std::endl;
-            return;
-        }
+    auto url    = reply->request().url();
+    auto finish = [this, done]() {
+        emitFinished(TOKYONP);
+        done();
+    };
 
-        auto element = fetcher.GetElement();
+    if (reply->error() != QNetworkReply::NoError) {
+        // レスポンスの取得に失敗した場合
+        LOG_ERROR(QString("東京新聞のニュース記事のURL取得に失敗 (%1)").arg(reply->errorString()));
+        reply->deleteLater();
+        finish();
 
-        /// 末尾の半角スペースを削除
-        if (element.endsWith(" ")) element.chop(1);
+        return;
+    }
 
-        auto link = m_TokyoNPTopURL + element;
+    const QString htmlContent = reply->readAll();
+    reply->deleteLater();
 
-        /// クエリパラメータを除去したURLを生成
-        QUrl url(link);
-        url.setQuery(QUrlQuery());
-        link = url.toString();
+    // 抽出の結果 (ワーカスレッドで書き込み、完了の通知の後にメインスレッドで読み込む)
+    struct PAGE {
+        bool    Parsed          = false;
+        int     HeadlineResult  = -1;   // ヘッドラインニュースの記事のURLの抽出結果
+        QString Headline;               // ヘッドラインニュースの記事のURL
+        int     NewsResult      = -1;   // その他ニュース記事のURL群の抽出結果
+        QString News;                   // その他ニュース記事のURL群 (半角スペース区切り)
+    };
 
-        if (fetcher.fetchElement(QUrl(link), true, m_TokyoNPJSON, XML_CDATA_SECTION_NODE)) {
-            /// ヘッドラインニュースの記事内容の取得に失敗した場合
-            std::cerr << QString("エラー : 東京新聞のヘッドラインニュース記事内容の取得に失敗").toStdString() << std::endl;
-            return;
-        }
+    auto pPage      = std::make_shared<PAGE>();
+    auto thumbXPath = m_TokyoNPThumb;
+    auto newsXPath  = m_TokyoNPNews;
 
-        element = fetcher.GetElement();
+    // 文字列からHTMLドキュメントをパースして、各ニュース記事のURLを抽出 (ワーカスレッドで実行して、待機せずに戻る)
+    ParserPool::getInstance()->parseHtmlAsync(htmlContent, this, [pPage, thumbXPath, newsXPath](xmlDocPtr doc) {
+        if (doc == nullptr) return;
 
-        /// 末尾の半角スペースを削除
-        if (element.endsWith(" ")) element.chop(1);
+        pPage->Parsed = true;
 
-        auto jsonData = element;
-        QJsonDocument document = QJsonDocument::fromJson(jsonData.toUtf8());
-        if(document.isNull()){
-            std::cerr << QString("エラー : 東京新聞のヘッドラインニュース記事内容のJSONオブジェクト生成に失敗").toStdString() << std::endl;
-            return;
+        // 総合ニュースからトップ記事を取得
+        // 総合ニュースからニュース記事を取得しない場合は、設定ファイルの"topxpath"キーを空欄にすること
+        if (!thumbXPath.isEmpty()) {
+            pPage->HeadlineResult = HtmlFetcher::extractElement(doc, thumbXPath, XML_TEXT_NODE, pPage->Headline);
         }
 
-        if(!document.isObject()){
-            std::cerr << QString("エラー : 東京新聞のヘッドラインニュース記事内容のJSONオブジェクトに異常があります").toStdString() << std::endl;
+        // その他ニュース記事のURL群を取得
+        pPage->NewsResult = HtmlFetcher::extractElement(doc, newsXPath, XML_TEXT_NODE, pPage->News);
+    },
+    [this, url, pPage, finish]() {
+        if (!pPage->Parsed) {
+            LOG_ERROR(QString("HTMLドキュメントのパースに失敗"));
+            m_pSourceHealth->recordFailure(url, SourceHealth::PARSE);
+            finish();
+
             return;
         }
 
-        QJsonObject jsonObject = document.object();
-        auto title      = jsonObject.value("headline").toString();
+        // HTMLドキュメントを取得できた場合は、ホストは正常と見なす
+        m_pSourceHealth->recordSuccess(url);
 
-        auto paragraph  = jsonObject.value("description").toString();
-        if (paragraph.endsWith("...")) {
-            paragraph = (paragraph.size() - 3) > m_MaxParagraph ? paragraph.mid(0, static_cast<int>(m_MaxParagraph)) + QString("...") : paragraph;
-        }
-        else {
-            paragraph = paragraph.size() > m_MaxParagraph ? paragraph.mid(0, static_cast<int>(m_MaxParagraph)) + QString("...") : paragraph;
-        }
+        // 抽出した値からクエリパラメータを除去したニュース記事のURLを生成
+        auto articleUrl = [this](const QString &element) {
+            QUrl link(m_TokyoNPTopURL + element);
+            link.setQuery(QUrlQuery());
 
-        auto date       = jsonObject.value("datePublished").toString();
+            return QUrl(link.toString());
+        };
 
-        /// 日付のフォーマットをISO 8601形式から"yyyy年M月d日 h時m分"へ変更
-        date            = convertDate(date);
+        QList<QUrl> urls;
+        bool        bHeadline = false;
 
-        /// ニュースの公開日を確認
-        auto isCheckDate = m_WithinHours == 0 ? isToday(date) : isHoursAgo(date);
-        if (isCheckDate) {
-            /// 既に書き込み済みの記事の場合は無視
-            bool bWritten = false;
-            for (auto &writtenArticle : m_WrittenArticles) {
-                QString url = "";
-                std::tie(std::ignore, std::ignore, url, std::ignore) = writtenArticle.getArticleData();
-
-                if (url.compare(link, Qt::CaseSensitive) == 0) {
-                    bWritten = true;
-                    break;
-                }
+        if (!m_TokyoNPThumb.isEmpty()) {
+            if (pPage->HeadlineResult != 0) {
+                /// ヘッドラインニュースの記事の取得に失敗した場合
+                LOG_ERROR(QString("東京新聞のヘッドラインニュース記事のURL取得に失敗"));
+                finish();
+
+                return;
             }
 
-            if (!bWritten) {
-                /// 書き込む前の記事群
-                Article article(title, paragraph, link, date);
-                m_BeforeWritingArticles.append(article);
-
-#ifdef _DEBUG
-                qDebug() << "Title : " << title;
-                qDebug() << "Paragraph : " << paragraph;
-                qDebug() << "URL : " << link;
-                qDebug() << "Date : " << date;
-                qDebug() << "";
-#endif
+            auto element = pPage->Headline;
+
+            /// 末尾の半角スペースを削除
+            if (element.endsWith(" ")) element.chop(1);
+
+            urls.append(articleUrl(element));
+            bHeadline = true;
+        }
+
+        if (pPage->NewsResult != 0) {
+            // その他ニュース記事のURL取得に失敗した場合 (ヘッドラインニュースの記事のみを取得)
+            LOG_ERROR(QString("東京新聞のニュース記事のURL取得に失敗"));
+        }
+        else {
+            auto element = pPage->News;
+
+            /// 末尾の半角スペースを削除
+            if (element.endsWith(" ")) element.chop(1);
+
+            /// リンク群からその他の各ニュース記事を取得
+            const auto elements = element.split(" ");
+            for (const auto &item : elements) {
+                urls.append(articleUrl(item));
             }
         }
-    }
 
-    // 東京新聞のその他ニュース記事の取得
-    if (fetcher.fetchElement(QUrl(m_TokyoNPFetchURL), true, m_TokyoNPNews, XML_TEXT_NODE)) {
-        // その他ニュース記事のURL取得に失敗した場合
-        std::cerr << QString("エラー : 東京新聞のニュース記事のURL取得に失敗").toStdString() << std::endl;
+        fetchTokyoNPArticles(urls, bHeadline, finish);
+    });
+}
+
+
+// 東京新聞の各ニュース記事のURLに同時にアクセスして、JSONオブジェクトの情報を取得する
+// JSONオブジェクトの情報からニュース記事のタイトル、本文の一部、公開日を取得して、書き込む前のニュース記事群に追加する
+// 取得に失敗したニュース記事は無視して、全ての完了後にdoneを実行する
+void Runner::fetchTokyoNPArticles(const QList<QUrl> &urls, bool bHeadline, const std::function<void()> &done)
+{
+    if (urls.isEmpty()) {
+        done();
         return;
     }
 
-    auto element = fetcher.GetElement();
+    // 全ての取得が完了するまで破棄しないため、完了時に破棄する
+    auto pFetcher = new HtmlFetcher(m_MaxParagraph, this);
+    pFetcher->fetchAllElements(urls, true, m_TokyoNPJSON, XML_CDATA_SECTION_NODE,
+                               [this, pFetcher, urls, bHeadline, done](const QVector<FETCH_RESULT> &results) {
+        pFetcher->deleteLater();
 
-    /// 末尾の半角スペースを削除
-    if (element.endsWith(" ")) element.chop(1);
+        for (auto i = 0; i < urls.size(); i++) {
+            const auto isHeadline = bHeadline && i == 0;
+            const auto link       = urls.at(i).toString();
 
-    /// リンク群からその他の各ニュース記事を取得
-    auto elements = element.split(" ");
-    foreach (const QString &item, elements) {
-        auto link = m_TokyoNPTopURL + item;
+            if (results.at(i).Result != 0) {
+                /// ニュース記事の内容の取得に失敗した場合
+                if (isHeadline) LOG_ERROR(QString("東京新聞のヘッドラインニュース記事内容の取得に失敗"));
+                else            LOG_ERROR(QString("東京新聞のニュース記事内容の取得に失敗 %1").arg(link));
 
-        /// クエリパラメータを除去したURLを生成
-        QUrl url(link);
-        url.setQuery(QUrlQuery());
-        link = url.toString();
+                continue;
+            }
 
-        /// その他の各ニュース記事のURLにアクセスして、JSONオブジェクトの情報を取得
-        if (fetcher.fetchElement(QUrl(link), true, m_TokyoNPJSON, XML_CDATA_SECTION_NODE)) {
-            /// ヘッドラインニュースの記事の取得に失敗した場合
-            std::cerr << QString("エラー : 東京新聞のニュース記事内容の取得に失敗 %1").arg(link).toStdString() << std::endl;
-            return;
-        }
+            auto element = results.at(i).Paragraph;
 
-        element = fetcher.GetElement();
+            /// 末尾の半角スペースを削除
+            if (element.endsWith(" ")) element.chop(1);
 
-        /// 末尾の半角スペースを削除
-        if (element.endsWith(" ")) element.chop(1);
+            /// JSONオブジェクトの情報からニュース記事のタイトル、本文の一部、公開日を取得
+            auto document = QJsonDocument::fromJson(element.toUtf8());
+            if (document.isNull()) {
+                if (isHeadline) LOG_ERROR(QString("東京新聞のヘッドラインニュース記事内容のJSONオブジェクト生成に失敗"));
+                else            LOG_ERROR(QString("東京新聞のニュース記事のJSONオブジェクト生成に失敗"));
 
-        /// JSONオブジェクトの情報からニュース記事のタイトル、本文の一部、公開日を取得
-        auto jsonData = element;
-        auto document = QJsonDocument::fromJson(jsonData.toUtf8());
-        if(document.isNull()){
-            std::cerr << QString("エラー : 東京新聞のニュース記事のJSONオブジェクト生成に失敗").toStdString() << std::endl;
-            return;
-        }
+                continue;
+            }
 
-        if(!document.isObject()){
-            std::cerr << QString("エラー : 東京新聞のニュース記事のJSONオブジェクトに異常があります").toStdString() << std::endl;
-            return;
-        }
+            if (!document.isObject()) {
+                if (isHeadline) LOG_ERROR(QString("東京新聞のヘッドラインニュース記事内容のJSONオブジェクトに異常があります"));
+                else            LOG_ERROR(QString("東京新聞のニュース記事のJSONオブジェクトに異常があります"));
 
-        auto jsonObject = document.object();
-        auto title      = jsonObject.value("headline").toString();
+                continue;
+            }
 
-        auto paragraph  = jsonObject.value("description").toString();
-        if (paragraph.endsWith("...")) {
-            paragraph = (paragraph.size() - 3) >= m_MaxParagraph ? paragraph.mid(0, static_cast<int>(m_MaxParagraph)) + QString("...") : paragraph;
-        }
-        else {
-            paragraph = paragraph.size() > m_MaxParagraph ? paragraph.mid(0, static_cast<int>(m_MaxParagraph)) + QString("...") : paragraph;
-        }
+            auto jsonObject = document.object();
+            auto title      = jsonObject.value("headline").toString();
 
-        auto date       = jsonObject.value("datePublished").toString();
+            auto paragraph  = jsonObject.value("description").toString();
+            if (paragraph.endsWith("...")) {
+                /// ヘッドラインニュースの記事は、指定文字数と同じ長さの場合は省略しない
+                auto bExceeded = isHeadline ? (paragraph.size() - 3) > m_MaxParagraph : (paragraph.size() - 3) >= m_MaxParagraph;
+                paragraph = bExceeded ? paragraph.mid(0, static_cast<int>(m_MaxParagraph)) + QString("...") : paragraph;
+            }
+            else {
+                paragraph = TextNormalizer::truncate(paragraph, m_MaxParagraph);
+            }
+
+            auto date       = jsonObject.value("datePublished").toString();
 
-        /// 日付のフォーマットをISO 8601形式から"yyyy年M月d日 h時m分"へ変更
-        date            = convertDate(date);
+            /// 日付のフォーマットをISO 8601形式から"yyyy年M月d日 h時m分"へ変更
+            date            = convertDate(date);
+
+            /// ニュースの公開日を確認
+            auto isCheckDate = m_WithinHours == 0 ? isToday(date) : isHoursAgo(date);
+            if (!isCheckDate) continue;
 
-        /// ニュースの公開日を確認
-        auto isCheckDate = m_WithinHours == 0 ? isToday(date) : isHoursAgo(date);
-        if (isCheckDate) {
             /// 既に書き込み済みの記事の場合は無視
-            bool bWritten = false;
-            for (auto &writtenArticle : m_WrittenArticles) {
-                QString url = "";
-                std::tie(std::ignore, std::ignore, url, std::ignore) = writtenArticle.getArticleData();
-
-                if (url.compare(link, Qt::CaseSensitive) == 0) {
-                    bWritten = true;
-                    break;
-                }
-            }
+            if (isWrittenForAll(link)) continue;
 
-            if (!bWritten) {
-                /// 書き込む前の記事群
-                Article article(title, paragraph, link, date);
-                m_BeforeWritingArticles.append(article);
-
-#ifdef _DEBUG
-                qDebug() << "Title : " << title;
-                qDebug() << "Paragraph : " << paragraph;
-                qDebug() << "URL : " << link;
-                qDebug() << "Date : " << date;
-                qDebug() << "";
-#endif
-            }
+            /// 書き込む前の記事群
+            Article article(title, paragraph, link, date);
+            m_BeforeWritingArticles.append(article);
+
+            LOG_DEBUG(QString("ニュース記事 : %1").arg(title),
+                      {{"paragraph", paragraph}, {"url", link}, {"date", date}});
         }
-    }
 
-    return;
+        done();
+    });
 }
 
 
 // 時事ドットコムから速報記事の取得する
 void Runner::JiJiFlashfetch()
 {
+    TraceSpan span("fetch", "Runner::JiJiFlashfetch");
+
     // 時事ドットコムの速報記事を取得するかどうかを確認
     if (!m_bJiJiFlash) {
         return;
@@ -1837,17 +1991,20 @@ void Runner::JiJiFlashfetch()
         /// また、取得した記事群のデータはメンバ変数m_WrittenArticlesに格納
         try {
             m_WrittenArticles = m_pWriteMode->getDatafromWrittenLog();
+
+            /// 書き込み済みのニュース記事群から、類似ニュース記事の索引を再作成
+            m_DuplicateIndex.rebuild(m_WrittenArticles);
         }
         catch (const std::runtime_error &e) {
             // ログファイルのオープンや読み込みに失敗した場合
-            std::cerr << QString("%1").arg(e.what()).toStdString();
+            LOG_ERROR(QString(e.what()));
 
             QCoreApplication::exit();
             return;
         }
         catch (const std::exception &e) {
             // その他の例外をキャッチ
-            std::cerr << QString("%1").arg(e.what()).toStdString();
+            LOG_ERROR(QString(e.what()));
 
             QCoreApplication::exit();
             return;
@@ -1895,13 +2052,13 @@ void Runner::JiJiFlashfetch()
         }
     }
 
-#ifdef _DEBUG
-    qDebug() << "書き込む速報記事";
-    qDebug() << "Title : " << title;
-    qDebug() << "URL : " << link;
-    qDebug() << "Date : " << pubDate;
-    qDebug() << "";
-#endif
+    // 2日以上前に書き込み済みの記事の場合
+    if (m_PostedFilter.contains(link)) return;
+
+    // 他のプロセスが書き込み済みの記事の場合
+    if (m_SharedIndex.contains(link, title)) return;
+
+    LOG_DEBUG(QString("書き込む速報記事 : %1").arg(title), {{"url", link}, {"date", pubDate}});
 
     // 書き込みモードの設定
     m_pWriteMode->setArticle(title, "", link, pubDate);     // 書き込むニュース記事を指定
@@ -1932,7 +2089,7 @@ void Runner::JiJiFlashfetch()
         }
     }
     else {
-        std::cerr << QString("エラー : 不明な書き込みモード \"%1\"").arg(m_WriteMode).toStdString() << std::endl;
+        LOG_ERROR(QString("不明な書き込みモード \"%1\"").arg(m_WriteMode));
         QCoreApplication::exit();
         return;
     }
@@ -1948,6 +2105,15 @@ void Runner::JiJiFlashfetch()
     Article article(title, paragraph, link, pubDate);
     m_WrittenArticles.append(article);
 
+    // 類似ニュース記事の索引に登録 (他のニュースサイトの同じ話題を書き込まないようにする)
+    m_DuplicateIndex.add(title, paragraph, QDateTime::currentSecsSinceEpoch());
+
+    // 書き込み済みのURLを長期間記録
+    m_PostedFilter.add(link);
+
+    // 他のプロセスと共有する索引に記録
+    m_SharedIndex.add(link, title);
+
     // [q]キーまたは[Q]キー ==> [Enter]キーが押下されている場合は終了
     if (m_stopRequested.load()) return;
 
@@ -1958,6 +2124,8 @@ void Runner::JiJiFlashfetch()
 // 共同通信から速報記事の取得するスロット
 void Runner::KyodoFlashfetch()
 {
+    TraceSpan span("fetch", "Runner::KyodoFlashfetch");
+
     // 時事ドットコムの速報記事を取得するかどうかを確認
     if (!m_bKyodoFlash) {
         return;
@@ -1989,17 +2157,20 @@ void Runner::KyodoFlashfetch()
         /// また、取得した記事群のデータはメンバ変数m_WrittenArticlesに格納
         try {
             m_WrittenArticles = m_pWriteMode->getDatafromWrittenLog();
+
+            /// 書き込み済みのニュース記事群から、類似ニュース記事の索引を再作成
+            m_DuplicateIndex.rebuild(m_WrittenArticles);
         }
         catch (const std::runtime_error &e) {
             // ログファイルのオープンや読み込みに失敗した場合
-            std::cerr << QString("%1").arg(e.what()).toStdString();
+            LOG_ERROR(QString(e.what()));
 
             QCoreApplication::exit();
             return;
         }
         catch (const std::exception &e) {
             // その他の例外をキャッチ
-            std::cerr << QString("%1").arg(e.what()).toStdString();
+            LOG_ERROR(QString(e.what()));
 
             QCoreApplication::exit();
             return;
@@ -2047,14 +2218,13 @@ void Runner::KyodoFlashfetch()
         }
     }
 
-#ifdef _DEBUG
-    qDebug() << "書き込む速報記事";
-    qDebug() << "Title : "      << title;
-    qDebug() << "Paragraph : "  << paragraph;
-    qDebug() << "URL : "        << link;
-    qDebug() << "Date : "       << pubDate;
-    qDebug() << "";
-#endif
+    // 2日以上前に書き込み済みの記事の場合
+    if (m_PostedFilter.contains(link)) return;
+
+    // 他のプロセスが書き込み済みの記事の場合
+    if (m_SharedIndex.contains(link, title)) return;
+
+    LOG_DEBUG(QString("書き込む速報記事 : %1").arg(title), {{"paragraph", paragraph}, {"url", link}, {"date", pubDate}});
 
     // 書き込みモードの設定
     m_pWriteMode->setArticle(title, paragraph.isEmpty() ? "" : paragraph, link, pubDate);  // 書き込むニュース記事を指定
@@ -2085,7 +2255,7 @@ void Runner::KyodoFlashfetch()
         }
     }
     else {
-        std::cerr << QString("エラー : 不明な書き込みモード \"%1\"").arg(m_WriteMode).toStdString() << std::endl;
+        LOG_ERROR(QString("不明な書き込みモード \"%1\"").arg(m_WriteMode));
         QCoreApplication::exit();
         return;
     }
@@ -2101,6 +2271,15 @@ void Runner::KyodoFlashfetch()
     Article article(title, paragraph, link, pubDate);
     m_WrittenArticles.append(article);
 
+    // 類似ニュース記事の索引に登録 (他のニュースサイトの同じ話題を書き込まないようにする)
+    m_DuplicateIndex.add(title, paragraph, QDateTime::currentSecsSinceEpoch());
+
+    // 書き込み済みのURLを長期間記録
+    m_PostedFilter.add(link);
+
+    // 他のプロセスと共有する索引に記録
+    m_SharedIndex.add(link, title);
+
     // [q]キーまたは[Q]キー ==> [Enter]キーが押下されている場合は終了
     if (m_stopRequested.load()) return;
 
@@ -2127,7 +2306,7 @@ QString Runner::convertJPDate(QString &strDate)
     QDateTime japanDateTime = utcDateTime.toTimeZone(japanTimeZone);
 
     if (!japanDateTime.isValid()) {
-        std::cerr << QString("日付の変換に失敗 (News API) : %1").arg(strDate).toStdString();
+        LOG_ERROR(QString("日付の変換に失敗 (News API) : %1").arg(strDate));
     }
     else {
         formattedDateString = japanDateTime.toString("yyyy年M月d日 H時m分");
@@ -2162,7 +2341,7 @@ QString Runner::convertJPDateforKyodo(QString &strDate)
         formattedDateString = japanDateTime.toString("yyyy年M月d日 H時m分");
     }
     else {
-        std::cerr << QString("日付の変換に失敗 (News API) : %1").arg(strDate).toStdString();
+        LOG_ERROR(QString("日付の変換に失敗 (News API) : %1").arg(strDate));
     }
 
     return formattedDateString;
@@ -2177,7 +2356,7 @@ QString Runner::convertDate(QString &strDate)
     QString convertDate = "";
 
     if (!dateTime.isValid()) {
-        std::cerr << QString("日付の変換に失敗 (時事ドットコム) : %1").arg(strDate).toStdString();
+        LOG_ERROR(QString("日付の変換に失敗 (時事ドットコム) : %1").arg(strDate));
     }
     else {
         convertDate = dateTime.toString("yyyy年M月d日 H時m分");
@@ -2195,7 +2374,7 @@ QString Runner::convertDateHanJ(QString &strDate)
     QString convertDate = "";
 
     if (!dateTime.isValid()) {
-        std::cerr << QString("日付の変換に失敗 (ハンギョレジャパン) : %1").arg(strDate).toStdString();
+        LOG_ERROR(QString("日付の変換に失敗 (ハンギョレジャパン) : %1").arg(strDate));
     }
     else {
         // "yyyy年M月d日 H時m分"へ変換
@@ -2217,7 +2396,7 @@ bool Runner::isToday(const QString &dateString)
 
     // 入力日付の変換が成功したかどうかを確認
     if (!inputDate.isValid()) {
-        std::cerr << "入力された日付が無効です" << std::endl;
+        LOG_ERROR(QString("入力された日付が無効です"));
 
         return false;
     }
@@ -2243,7 +2422,7 @@ bool Runner::isHoursAgo(const QString &pubDate) const
 
     // 入力日付の変換が成功したかどうかを確認
     if (!convertPubDate.isValid()) {
-        std::cerr << "入力された日付が無効です" << std::endl;
+        LOG_ERROR(QString("入力された日付が無効です"));
 
         return false;
     }
@@ -2267,22 +2446,16 @@ int Runner::getConfiguration(QString &filepath)
 {
     // 設定ファイルのパスが空の場合
     if(filepath.isEmpty()) {
-        std::cerr << QString("エラー : オプションが不明です").toStdString() + QString("\n").toStdString() +
-                     QString("使用可能なオプションは次の通りです : --sysconf=<qNewsFlash.jsonのパス>").toStdString() << std::endl;
+        LOG_ERROR(QString("オプションが不明です\n使用可能なオプションは次の通りです : --sysconf=<qNewsFlash.jsonのパス>"));
         return -1;
     }
 
     // 指定された設定ファイルが存在しない場合
     if(!QFile::exists(filepath)) {
-        std::cerr << QString("エラー : 設定ファイルが存在しません (%1)").arg(filepath).toStdString() << std::endl;
+        LOG_ERROR(QString("設定ファイルが存在しません (%1)").arg(filepath));
         return -1;
     }
 
-    // ロックファイルの生成
-    QFileInfo configFileInfo(filepath);
-    QString   lockFilePath = configFileInfo.dir().filePath(configFileInfo.baseName() + ".lock");
-    QLockFile lockFile(lockFilePath);
-
     // 設定ファイルを読み込む
     QFile File(filepath);
 
@@ -2329,18 +2502,18 @@ int Runner::getConfiguration(QString &filepath)
             bool ok;
             m_JiJiinterval = jijiInterval.toULongLong(&ok);
             if (!ok) {
-                std::cerr << QString("警告 : 設定ファイルのjijiflash:intervalキーの値が不正です").toStdString() << std::endl;
-                std::cerr << QString("更新時間の間隔は、自動的に10分に設定されます").toStdString() << std::endl;
+                LOG_WARNING(QString("設定ファイルのjijiflash:intervalキーの値が不正です"));
+                LOG_WARNING(QString("更新時間の間隔は、自動的に10分に設定されます"));
 
                 m_JiJiinterval = 10 * 60 * 1000;
             }
             else {
                 if (m_JiJiinterval == 0) {
-                    std::cerr << "インターバルの値が未指定もしくは0のため、10[分]に設定されます" << std::endl;
+                    LOG_WARNING(QString("インターバルの値が未指定もしくは0のため、10[分]に設定されます"));
                     m_JiJiinterval = 10 * 60 * 1000;
                 }
                 else if (m_JiJiinterval < (1 * 60)) {
-                    std::cerr << "インターバルの値が1[分]未満のため、1[分]に設定されます" << std::endl;
+                    LOG_WARNING(QString("インターバルの値が1[分]未満のため、1[分]に設定されます"));
                     m_JiJiinterval = 1 * 60 * 1000;
                 }
                 else if (m_JiJiinterval < 0) {
@@ -2390,18 +2563,18 @@ int Runner::getConfiguration(QString &filepath)
             bool ok;
             m_Kyodointerval = kyodoInterval.toULongLong(&ok);
             if (!ok) {
-                std::cerr << QString("警告 : 設定ファイルのkyodoflash:intervalキーの値が不正です").toStdString() << std::endl;
-                std::cerr << QString("更新時間の間隔は、自動的に10分に設定されます").toStdString() << std::endl;
+                LOG_WARNING(QString("設定ファイルのkyodoflash:intervalキーの値が不正です"));
+                LOG_WARNING(QString("更新時間の間隔は、自動的に10分に設定されます"));
 
                 m_Kyodointerval = 10 * 60 * 1000;
             }
             else {
                 if (m_Kyodointerval == 0) {
-                    std::cerr << "インターバルの値が未指定もしくは0のため、10[分]に設定されます" << std::endl;
+                    LOG_WARNING(QString("インターバルの値が未指定もしくは0のため、10[分]に設定されます"));
                     m_Kyodointerval = 10 * 60 * 1000;
                 }
                 else if (m_Kyodointerval < (1 * 60)) {
-                    std::cerr << "インターバルの値が1[分]未満のため、1[分]に設定されます" << std::endl;
+                    LOG_WARNING(QString("インターバルの値が1[分]未満のため、1[分]に設定されます"));
                     m_Kyodointerval = 1 * 60 * 1000;
                 }
                 else if (m_Kyodointerval < 0) {
@@ -2442,7 +2615,7 @@ int Runner::getConfiguration(QString &filepath)
         m_MainichiRSS        = MainichiObject["rss"].toString("");        /// 毎日新聞からニュース記事を取得するためのRSS (URL)
         m_MainichiParaXPath  = MainichiObject["paraxpath"].toString("");  /// 毎日新聞からニュース記事の概要を取得するためのXPath式
         if (m_bMainichi && (m_MainichiRSS.isEmpty() || m_MainichiParaXPath.isEmpty())) {
-            std::cerr << QString("エラー : 毎日新聞が有効になっていますが、\"rss\"もしくは\"paraxpath\"の値が設定されていません").toStdString() << std::endl;
+            LOG_ERROR(QString("毎日新聞が有効になっていますが、\"rss\"もしくは\"paraxpath\"の値が設定されていません"));
         }
 
         // ハンギョレジャパンのニュース記事
@@ -2452,7 +2625,7 @@ int Runner::getConfiguration(QString &filepath)
         m_HanJTopURL        = HanJObject["toppage"].toString("");     /// ハンギョレジャパンのトップページのURL
                                                                       /// ハンギョレジャパンでは、現在、トップページを基準にニュース記事のURLが存在する
         if (m_bHanJ && (m_HanJRSS.isEmpty() || m_HanJTopURL.isEmpty())) {
-            std::cerr << QString("エラー : ハンギョレジャパンが有効になっていますが、\"rss\"もしくは\"toppage\"の値が設定されていません").toStdString() << std::endl;
+            LOG_ERROR(QString("ハンギョレジャパンが有効になっていますが、\"rss\"もしくは\"toppage\"の値が設定されていません"));
         }
 
         // ロイター通信のニュース記事
@@ -2461,7 +2634,7 @@ int Runner::getConfiguration(QString &filepath)
         m_ReutersRSS        = ReutersObject["rss"].toString("");        /// ロイター通信からニュース記事を取得するためのRSS (URL)
         m_ReutersParaXPath  = ReutersObject["paraxpath"].toString("");  /// ロイター通信からニュース記事の概要を取得するためのXPath式
         if (m_bReuters && (m_ReutersRSS.isEmpty() || m_ReutersParaXPath.isEmpty())) {
-            std::cerr << QString("エラー : ロイター通信が有効になっていますが、\"rss\"もしくは\"paraxpath\"の値が設定されていません").toStdString() << std::endl;
+            LOG_ERROR(QString("ロイター通信が有効になっていますが、\"rss\"もしくは\"paraxpath\"の値が設定されていません"));
         }
 
         // CNET Japanのニュース記事
@@ -2470,7 +2643,7 @@ int Runner::getConfiguration(QString &filepath)
         m_CNETRSS           = CNETObject["rss"].toString("");          /// CNET Japanからニュース記事を取得するためのRSS (URL)
         m_CNETParaXPath     = CNETObject["paraxpath"].toString("");    /// CNET Japanからニュース記事の概要を取得するためのXPath式
         if (m_bCNet && (m_CNETRSS.isEmpty() || m_CNETParaXPath.isEmpty())) {
-            std::cerr << QString("エラー : CNET Japanが有効になっていますが、\"rss\"もしくは\"paraxpath\"の値が設定されていません").toStdString() << std::endl;
+            LOG_ERROR(QString("CNET Japanが有効になっていますが、\"rss\"もしくは\"paraxpath\"の値が設定されていません"));
         }
 
         // 東京新聞のニュースオブジェクトの取得
@@ -2504,22 +2677,22 @@ int Runner::getConfiguration(QString &filepath)
         bool ok;
         m_interval = interval.toULongLong(&ok);
         if (!ok) {
-            std::cerr << QString("警告 : 設定ファイルのintervalキーの値が不正です").toStdString() << std::endl;
-            std::cerr << QString("更新時間の間隔は、自動的に30分に設定されます").toStdString() << std::endl;
+            LOG_WARNING(QString("設定ファイルのintervalキーの値が不正です"));
+            LOG_WARNING(QString("更新時間の間隔は、自動的に30分に設定されます"));
 
             m_interval = 30 * 60 * 1000;
         }
         else {
             if (m_interval == 0) {
-                std::cerr << "インターバルの値が未指定もしくは0のため、30[分]に設定されます" << std::endl;
+                LOG_WARNING(QString("インターバルの値が未指定もしくは0のため、30[分]に設定されます"));
                 m_interval = 60 * 1000 * 30;
             }
             else if (m_interval < (3 * 60)) {
-                std::cerr << "インターバルの値が3[分]未満のため、3[分]に設定されます" << std::endl;
+                LOG_WARNING(QString("インターバルの値が3[分]未満のため、3[分]に設定されます"));
                 m_interval = 3 * 60 * 1000;
             }
             else if (m_interval < 0) {
-                std::cerr << "インターバルの値が不正です" << std::endl;
+                LOG_ERROR(QString("インターバルの値が不正です"));
                 return -1;
             }
             else {
@@ -2531,8 +2704,8 @@ int Runner::getConfiguration(QString &filepath)
         auto maxParagraph  = JsonObject["maxpara"].toString("100");
         m_MaxParagraph = maxParagraph.toLongLong(&ok);
         if (!ok) {
-            std::cerr << QString("警告 : 設定ファイルのmaxparaキーの値が不正です").toStdString() << std::endl;
-            std::cerr << QString("本文の一部を抜粋する場合の最大文字数は、自動的に100文字に設定されます").toStdString() << std::endl;
+            LOG_WARNING(QString("設定ファイルのmaxparaキーの値が不正です"));
+            LOG_WARNING(QString("本文の一部を抜粋する場合の最大文字数は、自動的に100文字に設定されます"));
 
             m_MaxParagraph = 100;
         }
@@ -2587,8 +2760,8 @@ int Runner::getConfiguration(QString &filepath)
         /// 設定ファイル内のスレッドのURLは、書き込みモード 1 および 書き込みモード 3の速報ニュースのみで使用
         m_WriteInfo.ThreadURL        = threadObject["threadurl"].toString("");
         if (m_WriteInfo.ThreadURL.isEmpty()) {
-            if      (WriteMode == 1)                                    std::cout << QString("スレッドのURLが空欄のため、専用スレッドを新規作成します").toStdString() << std::endl;
-            else if (WriteMode == 3 && (m_bJiJiFlash || m_bKyodoFlash)) std::cout << QString("スレッドのURLが空欄のため、速報ニュースは専用スレッドを新規作成します").toStdString() << std::endl;
+            if      (WriteMode == 1)                                    LOG_INFO(QString("スレッドのURLが空欄のため、専用スレッドを新規作成します"));
+            else if (WriteMode == 3 && (m_bJiJiFlash || m_bKyodoFlash)) LOG_INFO(QString("スレッドのURLが空欄のため、速報ニュースは専用スレッドを新規作成します"));
         }
 
         /// 書き込み済みのスレッドのタイトル
@@ -2657,18 +2830,18 @@ int Runner::getConfiguration(QString &filepath)
             bool ok;
             m_Bottominterval = bottomInterval.toULongLong(&ok);
             if (!ok) {
-                std::cerr << QString("警告 : 設定ファイルのthreadcommand:bottom:intervalキーの値が不正です").toStdString() << std::endl;
-                std::cerr << QString("更新時間の間隔は、自動的に180分に設定されます").toStdString() << std::endl;
+                LOG_WARNING(QString("設定ファイルのthreadcommand:bottom:intervalキーの値が不正です"));
+                LOG_WARNING(QString("更新時間の間隔は、自動的に180分に設定されます"));
 
                 m_Bottominterval = 180 * 60 * 1000;
             }
             else {
                 if (m_Bottominterval == 0) {
-                    std::cerr << "!bottomコマンドのインターバルの値が未指定もしくは0のため、180[分]に設定されます" << std::endl;
+                    LOG_WARNING(QString("!bottomコマンドのインターバルの値が未指定もしくは0のため、180[分]に設定されます"));
                     m_Bottominterval = 180 * 60 * 1000;
                 }
                 else if (m_Bottominterval > 1440) {
-                    std::cerr << "!bottomコマンドのインターバルの値が1440[分]を超えるため、180[分]に設定されます" << std::endl;
+                    LOG_WARNING(QString("!bottomコマンドのインターバルの値が1440[分]を超えるため、180[分]に設定されます"));
                     m_Bottominterval = 180 * 60 * 1000;
                 }
                 else if (m_Bottominterval < 0) {
@@ -2699,13 +2872,157 @@ int Runner::getConfiguration(QString &filepath)
         /// ディレクトリの存在を確認
         QDir dir(dirPath);
         if (!dir.exists()) {
-            std::cerr << QString("エラー : 書き込み用JSONファイルを保存するディレクトリが存在しません %1").arg(dirPath).toStdString() << std::endl;
+            LOG_ERROR(QString("書き込み用JSONファイルを保存するディレクトリが存在しません %1").arg(dirPath));
             return -1;
         }
 
         m_WriteFile = writeFile;
 #endif
 
+        // 各ニュースサイトの障害検知および再試行の設定
+        // 一時的なエラー (名前解決、HTTP 5xx、タイムアウト、接続エラー) の場合は、ジッタ付きの指数バックオフで再試行する
+        // また、連続して失敗したニュースサイトは、クールダウンの間は取得を省略して、その後、試行リクエストを1つ送信する
+        auto healthObject           = JsonObject["health"].toObject();
+        m_HealthInfo.MaxRetry       = std::clamp(healthObject["retry"].toInt(2), 0, 10);            /// 再試行回数
+        m_HealthInfo.BaseBackoff    = std::max(healthObject["backoff"].toInt(1000), 0);             /// 再試行までの基準の待機時間 [ミリ秒]
+        m_HealthInfo.MaxBackoff     = std::max(healthObject["maxbackoff"].toInt(8000), m_HealthInfo.BaseBackoff);  /// 再試行までの最大の待機時間 [ミリ秒]
+        m_HealthInfo.Threshold      = std::max(healthObject["threshold"].toInt(3), 1);              /// サーキットを開くまでの連続失敗回数
+        m_HealthInfo.CoolDown       = std::max(healthObject["cooldown"].toInt(600), 0);             /// サーキットを開いている時間 [秒]
+        m_HealthInfo.Timeout        = std::max(healthObject["timeout"].toInt(30), 0);               /// 1回のHTTPリクエストのタイムアウト [秒]
+
+        // ホストごとのリクエスト数の制限 (トークンバケット) の設定
+        // ニュースサイトと掲示板のbbs.cgi (書き込み) は、それぞれ別の制限を使用する
+        // 補充速度 (rateキー) に0を指定する場合は無制限
+        auto rateLimitObject        = JsonObject["ratelimit"].toObject();
+        auto newsLimitObject        = rateLimitObject["news"].toObject();
+        auto boardLimitObject       = rateLimitObject["board"].toObject();
+        m_RateLimitInfo.NewsRate    = std::max(newsLimitObject["rate"].toDouble(2.0), 0.0);     /// ニュースサイトへのリクエストの補充速度 [回 / 秒]
+        m_RateLimitInfo.NewsBurst   = std::max(newsLimitObject["burst"].toInt(4), 1);           /// ニュースサイトへ連続して送信できるリクエストの最大数
+        m_RateLimitInfo.BoardRate   = std::max(boardLimitObject["rate"].toDouble(0.1), 0.0);    /// 掲示板のbbs.cgiへのリクエストの補充速度 [回 / 秒]
+        m_RateLimitInfo.BoardBurst  = std::max(boardLimitObject["burst"].toInt(2), 1);          /// 掲示板のbbs.cgiへ連続して送信できるリクエストの最大数
+
+        // TLSセッションの再開 (セッションチケット) の設定
+        // 前回終了時のTLSセッションチケットを使用して、起動直後のTLSハンドシェイクを短縮する
+        auto tlsSessionObject       = JsonObject["tlssession"].toObject();
+        m_TlsSessionInfo.Enable     = tlsSessionObject["enable"].toBool(true);                              /// TLSセッションチケットの保存の有効 / 無効
+        m_TlsSessionInfo.File       = tlsSessionObject["file"].toString("");                                /// TLSセッションチケットを保存するファイルのパス (空欄の場合は、ログファイルと同じディレクトリ)
+        m_TlsSessionInfo.Expire     = std::max(tlsSessionObject["expire"].toInt(3600), 0);                  /// サーバがチケットの有効期限を通知しない場合の有効期限 [秒]
+
+        // DNSキャッシュの設定
+        // 設定ファイルに記述されているURLのホストに加えて、hostsキーのホスト (NTPサーバ等) も起動時に名前解決する
+        auto dnsCacheObject         = JsonObject["dnscache"].toObject();
+        m_DnsCacheInfo.Enable       = dnsCacheObject["enable"].toBool(true);                                /// DNSキャッシュの有効 / 無効
+        auto dnsHosts               = dnsCacheObject["hosts"].toArray(QJsonArray{"ntp.nict.jp"});           /// 起動時に名前解決するホスト名
+        for (const auto &dnsHost : std::as_const(dnsHosts)) {
+            if (!dnsHost.toString().isEmpty()) m_DnsCacheInfo.Hosts.append(dnsHost.toString());
+        }
+
+        // HTMLおよびXMLのパース処理の設定
+        // 各ニュースサイトのRSSおよびニュース記事のHTMLは、ワーカスレッドでパースする
+        auto parserObject           = JsonObject["parser"].toObject();
+        m_ParserInfo.Threads        = std::clamp(parserObject["threads"].toInt(0), 0, 64);          /// ワーカスレッドの最大数 (0の場合はCPUのコア数)
+        m_ParserInfo.Arena          = parserObject["arena"].toBool(false);                          /// ドキュメントごとのメモリアリーナの有効 / 無効
+
+        // ログファイルおよび設定ファイルへの書き込みの設定
+        // ログファイルへの書き込みおよび設定ファイルの"update"キーの更新は、書き込み用スレッドで実行する
+        auto persistObject          = JsonObject["persist"].toObject();
+        m_PersistInfo.Wait          = persistObject["wait"].toBool(false);                          /// 書き込みの完了を待機するかどうか
+        m_PersistInfo.Fsync         = persistObject["fsync"].toBool(false);                         /// 書き込みの後に、ファイルの内容をディスクに同期するかどうか
+        m_PersistInfo.Window        = std::clamp(persistObject["window"].toInt(0), 0, 10000);       /// 後続の書き込みをまとめるために待機する時間 [ミリ秒]
+
+        // HTTP通信の記録 / 再生の設定
+        // オフライン環境で1周期分の処理を再現するため、"record"で記録したコーパスを再生サーバから配信して、全てのリクエストをそこに送信する
+        auto replayObject           = JsonObject["replay"].toObject();
+        m_ReplayInfo.Mode           = replayObject["mode"].toString("off").toLower();               /// 動作モード ("off", "record", "replay")
+        m_ReplayInfo.Directory      = replayObject["directory"].toString("");                       /// コーパスを保存するディレクトリ
+        m_ReplayInfo.Server         = replayObject["server"].toString("");                          /// 再生サーバのURL
+
+        // メトリクスの公開の設定
+        // 各ニュースサイトの取得、パース、候補プール、書き込み、タイマの遅延を、Prometheusのテキスト形式で公開する
+        auto metricsObject          = JsonObject["metrics"].toObject();
+        m_MetricsInfo.Enable        = metricsObject["enable"].toBool(false);                        /// メトリクスの公開の有効 / 無効
+        m_MetricsInfo.Address       = metricsObject["address"].toString("127.0.0.1");               /// 待ち受けるアドレス
+        m_MetricsInfo.Port          = std::clamp(metricsObject["port"].toInt(9464), 1, 65535);      /// 待ち受けるポート番号
+        m_MetricsInfo.Socket        = metricsObject["socket"].toString("");                         /// UNIXドメインソケットのパス (指定した場合は、TCPの代わりに使用する)
+
+        // 処理時間のトレースの設定
+        // 各ニュースサイトの取得およびパース、HTMLの取得、書き込み、ログファイルの操作の処理時間を、Chrome trace event形式で出力する
+        auto traceObject            = JsonObject["trace"].toObject();
+        m_TraceInfo.Enable          = traceObject["enable"].toBool(false);                          /// トレースの有効 / 無効
+        m_TraceInfo.File            = traceObject["file"].toString("");                             /// トレースを出力するファイルのパス (空欄の場合は、ログファイルと同じディレクトリ)
+        m_TraceInfo.Capacity        = std::clamp(traceObject["capacity"].toInt(65536), 1024, 4194304);  /// リングバッファに保持するスパンの最大数
+
+        // イベントループの停止の検出の設定
+        // メインスレッドでイベントループに戻らない処理 (ファイルのロック、パース等) が閾値を超えた場合に、停止時間および処理名をログに出力する
+        auto watchdogObject         = JsonObject["watchdog"].toObject();
+        m_WatchdogInfo.Enable       = watchdogObject["enable"].toBool(false);                       /// イベントループの停止の検出の有効 / 無効
+        m_WatchdogInfo.Interval     = std::clamp(watchdogObject["interval"].toInt(100), 10, 10000); /// ハートビートの間隔 [ミリ秒]
+        m_WatchdogInfo.Threshold    = std::clamp(watchdogObject["threshold"].toInt(1000), 50, 600000);  /// 停止と見なすハートビートの遅延 [ミリ秒]
+
+        // 各ニュースサイトからのニュース記事の取得 (候補プール) の設定
+        // 各ニュースサイトは、intervalキーの時間を有効なニュースサイトの数で分割した間隔で、1つずつ順番に取得する
+        auto ingestObject           = JsonObject["ingest"].toObject();
+        m_IngestInterval            = static_cast<unsigned long long>(std::max(ingestObject["interval"].toInt(0), 0)) * 1000;  /// 全てのニュースサイトを1巡する時間 [秒] (0の場合は、ニュース記事を書き込む間隔と同じ)
+        m_PoolExpire                = static_cast<qint64>(std::max(ingestObject["expire"].toInt(10800), 0)) * 1000;          /// 候補プールにニュース記事を保持する時間 [秒] (0の場合は無期限)
+
+        // マルチテナントモードの設定
+        // 各テナントの設定ファイルは、本ファイルと同じ形式で、スレッド、掲示板、書き込みモード、取得するニュースサイト等を記述する
+        auto tenantsObject          = JsonObject["tenants"].toObject();
+        auto tenantFiles            = tenantsObject["files"].toArray();                             /// テナントの設定ファイルのパス群
+        for (const auto &tenantFile : std::as_const(tenantFiles)) {
+            if (!tenantFile.toString().isEmpty()) m_TenantFiles.append(tenantFile.toString());
+        }
+        m_TenantFreshness           = static_cast<qint64>(std::clamp(tenantsObject["freshness"].toInt(60), 0, 3600)) * 1000;  /// 取得したニュース記事群をテナント間で共有する期間 [秒]
+
+        // 書き込み済みのURLの長期間の記録の設定
+        // ログファイルは今日と昨日の書き込み済みのニュース記事のみを保持するため、それより前に書き込んだURLはブルームフィルタで判定する
+        auto postedObject           = JsonObject["posted"].toObject();
+        m_PostedFilterInfo.Enable   = postedObject["enable"].toBool(true);                          /// 書き込み済みのURLの長期間の記録の有効 / 無効
+        m_PostedFilterInfo.File     = postedObject["file"].toString("");                            /// 記録するファイルのパス (空欄の場合は、ログファイルと同じディレクトリ)
+        m_PostedFilterInfo.Horizon  = std::clamp(postedObject["horizon"].toInt(30), 1, 365);        /// 記録する期間 [日]
+
+        // 複数のプロセス間で共有する書き込み済みのニュース記事の索引の設定
+        // 同じキーを指定した他のqNewsFlashが書き込んだニュース記事 (同じURLまたはタイトル) は書き込まない
+        auto sharedIndexObject      = JsonObject["sharedindex"].toObject();
+        m_SharedIndexInfo.Enable    = sharedIndexObject["enable"].toBool(false);                    /// 共有メモリの索引の有効 / 無効
+        m_SharedIndexInfo.Key       = sharedIndexObject["key"].toString("qNewsFlash_posted");       /// 共有メモリのキー
+        m_SharedIndexInfo.Slots     = std::clamp(sharedIndexObject["slots"].toInt(65536), 1024, 1048576);   /// スロット数 (2の累乗に切り上げる)
+        m_SharedIndexInfo.Hours     = std::clamp(sharedIndexObject["hours"].toInt(48), 1, 720);     /// 書き込み済みと見なす期間 [時間]
+        m_SharedIndexInfo.Group     = sharedIndexObject["group"].toString("");                      /// 共有メモリを作成する場合のグループ名 (空欄の場合は変更しない)
+        if (m_SharedIndexInfo.Key.isEmpty()) m_SharedIndexInfo.Key = "qNewsFlash_posted";
+
+        /// 共有メモリを作成する場合のアクセス権 (8進数の文字列)
+        bool bModeOk = false;
+        auto sharedIndexMode        = sharedIndexObject["mode"].toString("0660").toInt(&bModeOk, 8);
+        m_SharedIndexInfo.Mode      = bModeOk ? std::clamp(sharedIndexMode, 0, 0777) : 0660;
+
+        // 類似ニュース記事の検出の設定
+        // 書き込み済みのニュース記事とタイトルまたは本文が類似しているニュース記事 (他のニュースサイトの同じ話題等) は書き込まない
+        auto dedupObject            = JsonObject["dedup"].toObject();
+        m_DedupInfo.Enable          = dedupObject["enable"].toBool(true);                           /// 類似ニュース記事の検出の有効 / 無効
+        m_DedupInfo.Hours           = std::clamp(dedupObject["hours"].toInt(6), 1, 48);             /// 書き込み済みのニュース記事と比較する期間 [時間]
+        m_DedupInfo.Distance        = std::clamp(dedupObject["distance"].toInt(3), 0, 7);           /// 類似と見なすフィンガープリントのハミング距離の最大値
+        m_DuplicateIndex.setDedupInfo(m_DedupInfo);
+
+        // 書き込むニュース記事の選択方法の設定
+        // 候補プールの各ニュース記事をスコア化して、スコアに比例した確率 (weighted)、または、スコアの上位k件 (top) から選択する
+        auto selectionObject            = JsonObject["selection"].toObject();
+        m_SelectionInfo.Mode            = selectionObject["mode"].toString("weighted").toLower();                       /// 選択方法 ("weighted" / "top" / "uniform")
+        if (m_SelectionInfo.Mode != "weighted" && m_SelectionInfo.Mode != "top" && m_SelectionInfo.Mode != "uniform") {
+            LOG_WARNING(QString("設定ファイルのselectionキーのmodeキーの値が不正のため、weightedに設定されます"));
+            m_SelectionInfo.Mode = "weighted";
+        }
+        m_SelectionInfo.TopK            = std::clamp(selectionObject["topk"].toInt(3), 1, 100);                         /// "top"の場合に、候補とするスコアの上位の件数
+        m_SelectionInfo.HalfLife        = std::max(selectionObject["halflife"].toDouble(3.0), 0.0);                     /// 経過時間によるスコアの半減期 [時間] (0の場合は経過時間を考慮しない)
+        m_SelectionInfo.NoParagraph     = std::clamp(selectionObject["noparagraph"].toDouble(0.5), 0.0, 1.0);           /// 本文が無いニュース記事のスコアの倍率
+        m_SelectionInfo.History         = std::clamp(selectionObject["history"].toInt(50), 0, 1000);                    /// タイトルの類似度を比較する書き込み済みのニュース記事の件数
+        m_SelectionInfo.Seed            = static_cast<quint64>(std::max(selectionObject["seed"].toDouble(0), 0.0));     /// 乱数のシード値 (0の場合は起動ごとに異なる値)
+        auto weightsObject              = selectionObject["weights"].toObject();                                        /// ニュースサイトごとのスコアの倍率
+        for (auto it = weightsObject.constBegin(); it != weightsObject.constEnd(); ++it) {
+            m_SelectionInfo.Weights.insert(it.key().toLower(), std::max(it.value().toDouble(1.0), 0.0));
+        }
+        m_Selector.setSelectionInfo(m_SelectionInfo);
+
         // 公開日がn時間前以内のニュース記事を取得する設定
         // 0 : 無効
         // 1 - 24 : 公開日がn時間以内のニュース記事を取得
@@ -2713,8 +3030,8 @@ int Runner::getConfiguration(QString &filepath)
         auto withinhours = JsonObject["withinhours"].toString("0");
         m_WithinHours = withinhours.toInt(&ok);
         if (!ok || m_WithinHours < 0 || m_WithinHours > 24) {
-            std::cerr << QString("警告 : 設定ファイルのwithinhoursキーの値が不正です").toStdString() << std::endl;
-            std::cerr << QString("公開日が本日付けのみのニュース記事を取得します").toStdString() << std::endl;
+            LOG_WARNING(QString("設定ファイルのwithinhoursキーの値が不正です"));
+            LOG_WARNING(QString("公開日が本日付けのみのニュース記事を取得します"));
 
             m_WithinHours = 0;
         }
@@ -2723,6 +3040,13 @@ int Runner::getConfiguration(QString &filepath)
         auto logFile = JsonObject["logfile"].toString("/var/log/qNewsFlash_log.json");
         m_LogFile    = logFile;
 
+        // ログの出力の設定
+        // ログは出力用スレッドで非同期に出力するため、debugレベル (各ニュース記事の詳細等) を有効にしても各処理は待機しない
+        auto loggingObject          = JsonObject["logging"].toObject();
+        m_LoggingInfo.Level         = loggingObject["level"].toString("info");                     /// 出力するログの最低レベル ("debug", "info", "warning", "error")
+        m_LoggingInfo.Format        = loggingObject["format"].toString("text");                    /// 出力形式 ("text", "json")
+        m_LoggingInfo.Buffer        = std::clamp(loggingObject["buffer"].toInt(8192), 256, 1048576);  /// リングバッファに保持するログの最大数
+
         // 最後にニュース記事群を取得した日付
         auto update     = JsonObject["update"].toString("");
 
@@ -2742,15 +3066,13 @@ int Runner::getConfiguration(QString &filepath)
     }
     catch (const std::runtime_error &e) {
         if (File.isOpen())          File.close();
-        if (lockFile.isLocked())    lockFile.unlock();
-        std::cerr << QString("エラー: %1").arg(e.what()).toStdString() << std::endl;
+        LOG_ERROR(QString("%1").arg(e.what()));
 
         return -1;
     }
     catch (const std::exception &e) {
         if (File.isOpen())          File.close();
-        if (lockFile.isLocked())    lockFile.unlock();
-        std::cerr << QString("エラー: %1").arg(e.what()).toStdString() << std::endl;
+        LOG_ERROR(QString("%1").arg(e.what()));
 
         return -1;
     }
@@ -2758,28 +3080,31 @@ int Runner::getConfiguration(QString &filepath)
     // ファイルを閉じる
     File.close();
 
-    // ロックファイルを削除
-    lockFile.unlock();
-
     return 0;
 }
 
 
-// 取得したニュース記事群からランダムで1つを選択
+// 候補プールのニュース記事群からスコアに基づいて1つを選択
 Article Runner::selectArticle()
 {
-    // CPUのタイムスタンプカウンタ(TSC)をハッシュ化した数値をXorshiftしてシード値を生成
-    // 生成したシード値を使用して乱数を生成 (一様分布)
-    // 乱数は、0〜(取得した記事の数 -1)までの値をとる
-    RandomGenerator randomObj;
-    int randomValue = randomObj.Generate(m_BeforeWritingArticles.size());
-
-#ifdef _DEBUG
-    // 生成された乱数を出力
-    std::cout << QString("生成された乱数 : この値を取得したニュース記事群の配列のインデックス値とする : %1").arg(randomValue).toStdString() << std::endl << std::endl;
-#endif
+    auto candidates = m_CandidatePool.candidates();
+
+    // タイトルの類似度を比較するため、直近に書き込んだニュース記事のタイトル群を取得 (新しい順)
+    QStringList recentTitles;
+    for (auto i = static_cast<int>(m_WrittenArticles.size()) - 1; i >= 0 && recentTitles.size() < m_SelectionInfo.History; i--) {
+        QString title = "";
+        std::tie(title, std::ignore, std::ignore, std::ignore) = m_WrittenArticles.at(i).getArticleData();
+        recentTitles.append(title);
+    }
+
+    auto index = m_Selector.select(candidates, recentTitles);
+
+    Metrics::getInstance()->count(Metrics::SELECTION, {"selected", candidates.at(index).Source});
+
+    // 選択されたインデックスを出力
+    LOG_DEBUG(QString("選択されたニュース記事 : 候補プールのインデックス値 : %1").arg(index), {{"source", candidates.at(index).Source}});
 
-    return m_BeforeWritingArticles.at(randomValue);
+    return CandidatePool::toArticle(candidates.at(index));
 }
 
 
@@ -2796,10 +3121,10 @@ int Runner::checkLogFile(QString &filepath)
     QDir logDir(dirPath);
     if (!logDir.exists()) {
         // ディレクトリが存在しない場合は作成
-        std::cout << QString("ログディレクトリが存在しないため作成します %1").arg(logDir.absolutePath()).toStdString() << std::endl;
+        LOG_INFO(QString("ログディレクトリが存在しないため作成します %1").arg(logDir.absolutePath()));
 
         if (!logDir.mkpath(".")) {
-            std::cerr << QString("エラー : ログディレクトリの作成に失敗 %1").arg(logDir.absolutePath()).toStdString() << std::endl;
+            LOG_ERROR(QString("ログディレクトリの作成に失敗 %1").arg(logDir.absolutePath()));
             return -1;
         }
     }
@@ -2807,13 +3132,13 @@ int Runner::checkLogFile(QString &filepath)
     // 書き込み済み(ログ用)のJSONファイルが存在しない場合は空のログファイルを作成
     QFile File(filepath);
     if (!File.exists()) {
-        std::cout << QString("ログファイルが存在しないため作成します %1").arg(filepath).toStdString() << std::endl;
+        LOG_INFO(QString("ログファイルが存在しないため作成します %1").arg(filepath));
 
         if (File.open(QIODevice::WriteOnly)) {
             File.close();
         }
         else {
-            std::cerr << QString("エラー : ログファイルを作成に失敗 %1").arg(File.errorString()).toStdString() << std::endl;
+            LOG_ERROR(QString("ログファイルを作成に失敗 %1").arg(File.errorString()));
             return -1;
         }
     }
@@ -2846,7 +3171,7 @@ int Runner::checkLogFile()
     if (!dir.exists()) {
         // ディレクトリが存在しない場合は作成
         if (!dir.mkpath(".")) {
-            std::cerr << QString("エラー : ログディレクトリの作成に失敗 %1").arg(logDir).toStdString() << std::endl;
+            LOG_ERROR(QString("ログディレクトリの作成に失敗 %1").arg(logDir));
             return -1;
         }
     }
@@ -2858,7 +3183,7 @@ int Runner::checkLogFile()
             File.close();
         }
         else {
-            std::cerr << QString("エラー : ログファイルを作成に失敗 %1").arg(File.errorString()).toStdString() << std::endl;
+            LOG_ERROR(QString("ログファイルを作成に失敗 %1").arg(File.errorString()));
             return -1;
         }
     }
@@ -2885,22 +3210,22 @@ void Runner::bottomThread()
             if (!date.isEmpty()) {
                 // 書き込み済みのスレッドにレスが無い場合は、該当スレッドに!bottomコマンドを書き込む
                 if (m_pWriteMode->writeBottom()) {
-                    std::cerr << QString("エラー: !bottomコマンドの書き込みに失敗").toStdString() << std::endl;
+                    LOG_ERROR(QString("!bottomコマンドの書き込みに失敗"));
                 }
 
                 // !bottomコマンドを書き込む予定のスレッドに対して、次回のインターバルを指定
                 auto nextDate = m_pWriteMode->getOldestWriteLogDate();
                 if (nextDate.isEmpty()) {
-                    m_BottomTimer.start(static_cast<int>(m_Bottominterval));
+                    armTimer(m_BottomTimer, "bottom", static_cast<qint64>(m_Bottominterval));
                     return;
                 }
 
                 /// QDateTimeに変換
                 QDateTime nextDateTime = QDateTime::fromString(nextDate, "yyyy年M月d日 h時m分");
                 if (!nextDateTime.isValid()) {
-                    std::cerr << QString("エラー: !bottomコマンド機能で使用する次回の時刻が無効です").toStdString() << std::endl;
-                    std::cerr << QString("設定ファイルのインターバル %1[分] を使用します").arg(m_Bottominterval / 60 / 1000).toStdString() << std::endl;
-                    m_BottomTimer.start(static_cast<int>(m_Bottominterval));
+                    LOG_ERROR(QString("!bottomコマンド機能で使用する次回の時刻が無効です"));
+                    LOG_ERROR(QString("設定ファイルのインターバル %1[分] を使用します").arg(m_Bottominterval / 60 / 1000));
+                    armTimer(m_BottomTimer, "bottom", static_cast<qint64>(m_Bottominterval));
 
                     return;
                 }
@@ -2929,17 +3254,17 @@ void Runner::bottomThread()
                 // タイマを再開 (開始時刻を更新)
                 if (nextInterval > 0) {
                     // 差分が1[mS]以上の時
-                    m_BottomTimer.start(static_cast<int>(nextInterval));
+                    armTimer(m_BottomTimer, "bottom", nextInterval);
                 }
                 else {
                     // 差分が0[mS]以下の時
-                    m_BottomTimer.start(0);
+                    armTimer(m_BottomTimer, "bottom", 0);
                 }
             }
             else {
                 // 書き込み済みのログファイル内にオブジェクトが存在しない場合
                 // タイマを再開 (開始時刻を更新)
-                m_BottomTimer.start(static_cast<int>(m_Bottominterval));
+                armTimer(m_BottomTimer, "bottom", static_cast<qint64>(m_Bottominterval));
                 return;
             }
         }
@@ -17,18 +17,49 @@
 #include <libxml/parser.h>
 #include <libxml/tree.h>
 #include <memory>
+#include <vector>
+#include <functional>
 #include "JiJiFlash.h"
 #include "KyodoFlash.h"
 #include "Article.h"
 #include "WriteMode.h"
 #include "Poster.h"
+#include "SourceHealth.h"
+#include "RateLimiter.h"
+#include "TlsSessionCache.h"
+#include "DnsCache.h"
+#include "CandidatePool.h"
+#include "ArticleSelector.h"
+#include "DuplicateIndex.h"
+#include "PostedUrlFilter.h"
+#include "SharedPostedIndex.h"
+#include "ParserPool.h"
+#include "HttpReplay.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include "StallWatchdog.h"
+#include "Logger.h"
+#include "IngestHub.h"
 
 
 class Runner : public QObject
 {
     Q_OBJECT
 
+    friend class CoreBench;     // ベンチマーク (bench/CoreBench.cpp) から非公開メソッドを計測するため
+
 private:  // Variables
+    // RSSから取得したニュース記事 (ワーカスレッドでRSSを走査して、メインスレッドで書き込み対象を選別する)
+    // RSSに本文が含まれないニュースサイトの場合は、選別の後に各ニュース記事の本文を同時に取得する
+    struct FEED_ITEM {
+        QString Title;          // ニュース記事のタイトル
+        QString Paragraph;      // ニュース記事の本文の一部 (RSSに含まれる場合のみ)
+        QString Link;           // ニュース記事のURL (書き込むURL)
+        QString Date;           // ニュース記事の公開日
+        bool    HasDate = false;    // RSSに公開日が存在するかどうか (存在しない場合は公開日を確認しない)
+        QUrl    BodyUrl;        // 本文を取得するURL
+    };
+
     // 共通
     QStringList                             m_args;             // コマンドラインオプション
     QString                                 m_User;             // このソフトウェアを実行しているユーザ名
@@ -62,6 +93,13 @@ private:  // Variables
     unsigned long long                      m_Kyodointerval;    // 共同通信から速報ニュースを取得する時間間隔
     unsigned long long                      m_Bottominterval;   // スレッドに!bottomコマンドを書き込む時間間隔
 
+    // 各ニュースサイトからのニュース記事の取得 (候補プールへの追加)
+    // ニュース記事の書き込みとは独立して、各ニュースサイトを1つずつ順番に取得する
+    QTimer                                  m_IngestTimer;      // 各ニュースサイトからニュース記事を取得するためのタイマ
+    unsigned long long                      m_IngestInterval;   // 全てのニュースサイトを1巡する時間 (0の場合は、メンバ変数m_intervalの値を使用)
+    int                                     m_IngestIndex;      // 次に取得するニュースサイトのインデックス
+    bool                                    m_bIngesting;       // ニュースサイトから取得中かどうか
+
     // News API (ニュースサイト)
     bool                                    m_bNewsAPI;         // News APIからニュース記事を取得するかどうか
     QString                                 m_API;              // News APIからニュース記事を取得するためのキー
@@ -128,18 +166,42 @@ private:  // Variables
 
     // 各ニュースサイトからニュース記事を取得するためのネットワークオブジェクト
     std::unique_ptr<QNetworkAccessManager>  manager;            // ニュース記事を取得するためのネットワークオブジェクト
-    QNetworkReply                           *m_pReply;          // News API用HTTPレスポンスのオブジェクト
-    QNetworkReply                           *m_pReplyJiJi;      // 時事ドットコム用HTTPレスポンスのオブジェクト
-    QNetworkReply                           *m_pReplyKyodo;     // 共同通信用HTTPレスポンスのオブジェクト
-    QNetworkReply                           *m_pReplyAsahi;     // 朝日新聞デジタル用HTTPレスポンスのオブジェクト
-    QNetworkReply                           *m_pReplyMainichi;  // 毎日新聞用HTTPレスポンスのオブジェクト
-    QNetworkReply                           *m_pReplyCNet;      // CNET用HTTPレスポンスのオブジェクト
-    QNetworkReply                           *m_pReplyHanJ;      // ハンギョレジャパン用HTTPレスポンスのオブジェクト
-    QNetworkReply                           *m_pReplyReuters;   // ロイター通信用HTTPレスポンスのオブジェクト
+
+    // 各ニュースサイトの障害検知および再試行
+    SourceHealth                            *m_pSourceHealth;   // ホストごとの障害検知 (サーキットブレーカ) および再試行用オブジェクト
+    HEALTH_INFO                             m_HealthInfo;       // 障害検知および再試行に関する設定
+    RATELIMIT_INFO                          m_RateLimitInfo;    // ホストごとのリクエスト数の制限に関する設定
+    TLSSESSION_INFO                         m_TlsSessionInfo;   // TLSセッションの再開 (セッションチケット) に関する設定
+    DNSCACHE_INFO                           m_DnsCacheInfo;     // DNSキャッシュに関する設定
+    PARSER_INFO                             m_ParserInfo;       // HTMLおよびXMLのパース処理に関する設定
+    REPLAY_INFO                             m_ReplayInfo;       // HTTP通信の記録 / 再生に関する設定
+    METRICS_INFO                            m_MetricsInfo;      // メトリクスの公開に関する設定
+    TRACE_INFO                              m_TraceInfo;        // 処理時間のトレースに関する設定
+    LOGGING_INFO                            m_LoggingInfo;      // ログの出力に関する設定
+    WATCHDOG_INFO                           m_WatchdogInfo;     // イベントループの停止の検出に関する設定
+    PERSIST_INFO                            m_PersistInfo;      // ログファイルおよび設定ファイルへの書き込みに関する設定
+    StallWatchdog                           m_Watchdog;         // メインスレッドのイベントループの停止を検出するオブジェクト
 
     // ニュース記事群に関する情報
     QList<Article>                          m_BeforeWritingArticles;  // 各ニュースサイトから一時的に取得したニュース記事群 (書き込む前のニュース記事群のこと)
     QList<Article>                          m_WrittenArticles;        // スレッドに書き込み済みのニュース記事群 (ログファイルに保存されているニュース記事群のこと)
+    CandidatePool                           m_CandidatePool;          // 書き込み候補のニュース記事群 (書き込まれるまで、または、有効期限が切れるまで保持する)
+    qint64                                  m_PoolExpire;             // 候補プールにニュース記事を保持する時間 [ミリ秒] (0の場合は無期限)
+    ArticleSelector                         m_Selector;               // 候補プールから書き込むニュース記事を選択するオブジェクト
+    SELECTION_INFO                          m_SelectionInfo;          // 書き込むニュース記事の選択方法に関する設定
+    DuplicateIndex                          m_DuplicateIndex;         // 書き込み済みのニュース記事の類似度の索引 (他のニュースサイトの同じ話題を検出する)
+    DEDUP_INFO                              m_DedupInfo;              // 類似ニュース記事の検出に関する設定
+    PostedUrlFilter                         m_PostedFilter;           // 書き込み済みのURLを長期間記録するブルームフィルタ (ログファイルより前の書き込み済みのURLを判定する)
+    POSTEDFILTER_INFO                       m_PostedFilterInfo;       // 書き込み済みのURLの長期間の記録に関する設定
+    SharedPostedIndex                       m_SharedIndex;            // 複数のプロセス間で共有する書き込み済みのニュース記事の索引 (他のqNewsFlashの書き込みを判定する)
+    SHAREDINDEX_INFO                        m_SharedIndexInfo;        // 共有メモリの索引に関する設定
+
+    // マルチテナントモード
+    // 1つのプロセスで、複数の設定ファイル (テナント) のスレッドに書き込む (ニュースサイトの取得およびパースは全てのテナントで共有する)
+    QStringList                             m_TenantFiles;            // テナントの設定ファイルのパス群 (プライマリのみ)
+    qint64                                  m_TenantFreshness;        // 取得したニュース記事群をテナント間で共有する期間 [ミリ秒]
+    Runner                                  *m_pPrimary;              // プライマリ (テナントの場合のみ、プライマリの場合はnullptr)
+    std::vector<std::unique_ptr<Runner>>    m_Tenants;                // テナント群 (プライマリのみ)
 
     // スレッドに関する情報
     THREAD_INFO                             m_ThreadInfo;       // ニュース記事を書き込むスレッドの情報
@@ -166,6 +228,19 @@ private:  // Variables
 public:  // Variables
 
 private:  // Methods
+    // ニュースサイトの種類
+    enum NEWSSOURCE {
+        NEWSAPI,                                                // News API
+        JIJI,                                                   // 時事ドットコム
+        KYODO,                                                  // 共同通信
+        ASAHI,                                                  // 朝日新聞デジタル
+        MAINICHI,                                               // 毎日新聞
+        CNET,                                                   // CNET Japan
+        HANJ,                                                   // ハンギョレジャパン
+        REUTERS,                                                // ロイター通信
+        TOKYONP                                                 // 東京新聞
+    };
+
     int            getConfiguration(QString &filepath);         // このソフトウェアの設定ファイルの情報を取得
 
 #if (QNEWSFLASH_VERSION_MAJOR == 0 && QNEWSFLASH_VERSION_MINOR < 1)
@@ -175,20 +250,66 @@ private:  // Methods
 
     static int     checkLogFile(QString &filepath);             // このソフトウェアのログ情報を保存するファイルのパスを設定
                                                                 // ログ情報とは、書き込み済みのニュース記事を指す
-    void           itemTagsforJiJi(xmlNode *a_node);            // 時事ドットコムのニュース記事(RSS)を分解して取得
-    void           itemTagsforKyodo(xmlNode *a_node);           // 共同通信のニュース記事(RSS)を分解して取得
-    void           itemTagsforAsahi(xmlNode *a_node);           // 朝日新聞デジタルのニュース記事(RSS)を分解して取得
-    void           itemTagsforMainichi(xmlNode *a_node);        // 毎日新聞のニュース記事(RSS)を分解して取得
-    void           itemTagsforCNet(xmlNode *a_node);            // CNET Japanのニュース記事(RSS)を分解して取得
-    void           itemTagsforHanJ(xmlNode *a_node);            // ハンギョレジャパンのニュース記事(RSS)を分解して取得
-    void           itemTagsforReuters(xmlNode *a_node);         // ロイター通信のニュース記事(RSS)を分解して取得
+    static void    itemTagsforJiJi(xmlNode *a_node,             // 時事ドットコムのニュース記事(RSS)を分解して取得 (ワーカスレッドで実行)
+                                   QList<FEED_ITEM> &items);
+    static void    itemTagsforKyodo(xmlNode *a_node,            // 共同通信のニュース記事(RSS)を分解して取得 (ワーカスレッドで実行)
+                                    long long maxParagraph, bool newsOnly, QList<FEED_ITEM> &items);
+    static void    itemTagsforAsahi(xmlNode *a_node,            // 朝日新聞デジタルのニュース記事(RSS)を分解して取得 (ワーカスレッドで実行)
+                                    QList<FEED_ITEM> &items);
+    static void    itemTagsforMainichi(xmlNode *a_node,         // 毎日新聞のニュース記事(RSS)を分解して取得 (ワーカスレッドで実行)
+                                       QList<FEED_ITEM> &items);
+    static void    itemTagsforCNet(xmlNode *a_node,             // CNET Japanのニュース記事(RSS)を分解して取得 (ワーカスレッドで実行)
+                                   QList<FEED_ITEM> &items);
+    static void    itemTagsforHanJ(xmlNode *a_node,             // ハンギョレジャパンのニュース記事(RSS)を分解して取得 (ワーカスレッドで実行)
+                                   long long maxParagraph, const QString &topUrl, QList<FEED_ITEM> &items);
+    static void    itemTagsforReuters(xmlNode *a_node,          // ロイター通信のニュース記事(RSS)を分解して取得 (ワーカスレッドで実行)
+                                      QList<FEED_ITEM> &items);
+    QList<FEED_ITEM> filterItems(const QList<FEED_ITEM> &items) const;  // RSSから取得したニュース記事群から、書き込み対象外のニュース記事を除外
     static QString convertJPDate(QString &strDate);             // UTC時刻から日本時間および"yyyy/M/d h時m分"に変換 (News API等で使用)
     static QString convertJPDateforKyodo(QString &strDate);     // 共同通信のニュース記事にある日付を日本時間および"yyyy/M/d h時m分"に変換
     static QString convertDate(QString &strDate);               // ISO8601形式の時刻を"yyyy年M月d日 H時m分"に変換 (時事ドットコム、ロイター通信等で使用)
     static QString convertDateHanJ(QString &strDate);           // RFC 2822形式の時刻を"yyyy年M月d日 H時m分"に変換 (ハンギョレジャパン等で使用)
     static bool    isToday(const QString &dateString);          // ニュース記事が今日の日付かどうかを確認
     bool           isHoursAgo(const QString &dateString) const; // ニュース記事が指定時間以内の時刻かどうかを確認
-    Article        selectArticle();                             // 取得したニュース記事群からランダムで1つを選択
+    void           fetchPendingArticles(const QList<FEED_ITEM> &items,  // 本文を取得する前のニュース記事群の本文を同時に取得して、
+                                        const QString &xpath,           // 書き込む前のニュース記事群に追加 (XPathが空の場合は、記事の概要を取得)
+                                        bool bTrim,                     // 待機せずに戻り、全ての取得の完了後にdoneを実行する
+                                        const std::function<void()> &done);
+    Article        selectArticle();                             // 候補プールのニュース記事群からスコアに基づいて1つを選択
+    int            checkDateChange();                           // 日付が変わっているかどうかを確認 (変わっている場合は書き込み済みのニュース記事群を再取得)
+    QList<int>     enabledSources() const;                      // 有効なニュースサイトの一覧を取得
+    static QString sourceName(int source);                      // ニュースサイト名を取得
+    static QString sourceKey(int source);                       // ニュースサイトの設定名 (設定ファイルのキー名) を取得
+    void           ingestSources(QList<int> sources,            // 指定したニュースサイト群から順番にニュース記事を取得して、候補プールへ追加
+                                 const std::function<void()> &done);    // 全ての取得の完了後にdoneを実行する
+    void           ingestSource(int source,                     // 指定したニュースサイトからニュース記事を取得して、候補プールへ追加
+                                const std::function<void()> &done);     // HTTPレスポンスを待機せずに戻り、候補プールへの追加の完了後にdoneを実行する
+    QUrl           feedUrl(int source) const;                   // ニュースサイトのRSSフィード (News APIの場合はJSON) のURLを取得
+    void           fetchNewsAPI(QNetworkReply *reply);          // News APIからニュース記事の取得後に実行する
+    void           fetchRSS(int source, QNetworkReply *reply,   // 各ニュースサイトからRSSの取得後に実行する
+                            const std::function<void()> &done); // パースおよび走査はワーカスレッドで実行して、書き込む前のニュース記事群への追加の完了後にdoneを実行する
+    void           fetchTokyoNP(QNetworkReply *reply,           // 東京新聞からニュース記事を取得するページの取得後に実行する
+                                const std::function<void()> &done); // 各ニュース記事の取得の完了後にdoneを実行する
+    void           fetchTokyoNPArticles(const QList<QUrl> &urls,    // 東京新聞の各ニュース記事のJSONオブジェクトを同時に取得して、書き込む前のニュース記事群に追加
+                                        bool bHeadline,             // (bHeadlineがtrueの場合、先頭のURLはヘッドラインニュースの記事)
+                                        const std::function<void()> &done);
+    void           emitFinished(int source);                    // 指定したニュースサイトからニュース記事の取得の終了を知らせるシグナルを送信
+    void           expireCandidates();                          // 候補プールから、書き込み対象外となったニュース記事群を削除
+    bool           isWritten(const QString &url) const;         // 指定したURLのニュース記事が書き込み済みかどうかを確認
+    void           writeFromPool();                             // 候補プールからニュース記事を1つ選択して書き込む
+    static void    armTimer(QTimer &timer, const QString &name, // タイマを開始して、発火の遅延の計測を開始
+                            qint64 interval);
+    int            parseArguments();                            // コマンドラインオプションの確認 (終了する場合は-1を返す)
+    int            setupProcess();                              // プロセス全体の設定 (プライマリのみ実行する)
+    QStringList    configuredHosts() const;                     // 有効なニュースサイトおよび掲示板のホストを取得
+    void           addCandidates(int source,                    // 取得したニュース記事群を候補プールへ追加
+                                 const QList<Article> &articles);
+    QString        ingestKey(int source) const;                 // ニュースサイトの取得結果を共有するためのキーを取得
+    bool           isWrittenForAll(const QString &url) const;   // 取得時に省略する書き込み済みのニュース記事かどうかを確認 (全てのテナントで書き込み済みの場合のみ)
+    bool           isDuplicateForAll(const QString &title) const;   // 取得時に省略する類似ニュース記事かどうかを確認 (全てのテナントで類似している場合のみ)
+    void           startTenants();                              // マルチテナントモードの各テナントを順番に開始 (前のテナントの起動直後の処理の完了後に次のテナントを開始)
+    void           finishStartup();                             // 起動直後のニュース記事の取得および書き込みの完了後に実行する
+    void           finishRun();                                 // 起動直後の処理の完了を通知する (ワンショットの場合は本ソフトウェアを終了する)
 
 public:  // Methods
 
@@ -210,23 +331,18 @@ signals:
     void HanJfinished();        // ハンギョレジャパンからニュース記事の取得の終了を知らせるためのシグナル
     void Reutersfinished();     // ロイター通信からニュース記事の取得の終了を知らせるためのシグナル
     void TokyoNPfinished();     // 東京新聞からニュース記事の取得の終了を知らせるためのシグナル
+    void finished();            // 起動直後の処理 (ニュース記事の取得および書き込み) の完了を知らせるためのシグナル
 
 public slots:
     void run();                     // このソフトウェアを最初に実行する時にのみ実行するメイン処理
-    void fetchNonBreakingNews();    // 速報ニュース以外のニュース記事の取得するスロット
-    void fetchNewsAPI();            // News APIからニュース記事の取得後に実行するスロット
-    void fetchJiJiRSS();            // 時事ドットコムからニュース記事の取得後に実行するスロット
-    void fetchKyodoRSS();           // 共同通信からニュース記事の取得後に実行するスロット
-    void fetchAsahiRSS();           // 朝日新聞デジタルからニュース記事の取得後に実行するスロット
-    void fetchMainichiRSS();        // 毎日新聞からニュース記事の取得後に実行するスロット
-    void fetchCNetRSS();            // CNET Japanからニュース記事の取得後に実行するスロット
-    void fetchHanJRSS();            // ハンギョレジャパンからニュース記事の取得後に実行するスロット
-    void fetchReutersRSS();         // ロイター通信からニュース記事の取得後に実行するスロット
-    void fetchTokyoNP();            // 東京新聞からニュース記事の取得後に実行するスロット
+    void fetchNonBreakingNews();    // 速報ニュース以外のニュース記事を全てのニュースサイトから取得して書き込むスロット (起動直後およびワンショット用)
+    void postFromPool();            // 候補プールからニュース記事を1つ選択して書き込むスロット
+    void ingestNext();              // 次のニュースサイトからニュース記事を取得して、候補プールへ追加するスロット
     void JiJiFlashfetch();          // 時事ドットコムから速報記事の取得するスロット
     void KyodoFlashfetch();         // 共同通信から速報記事の取得するスロット
     void bottomThread();            // 書き込み済みのスレッドに!bottomコマンドを書き込むスロット
     void onReadyRead();             // ノンブロッキングでキー入力を受信するスロット
+    void onIngestPublished(const QString &key, const QList<Article> &articles);    // 他のテナントが取得したニュース記事群を候補プールへ追加するスロット
 };
 
 #endif // RUNNER_H
@@ -0,0 +1,362 @@
+#include <QDateTime>
+#include <cstring>
+#include <limits>
+
+#ifndef Q_OS_WIN
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <grp.h>
+    #include <sys/file.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "SharedPostedIndex.h"
+#include "DuplicateIndex.h"
+#include "Logger.h"
+
+
+SharedPostedIndex::SharedPostedIndex() :
+#ifndef Q_OS_WIN
+    m_pMapping(nullptr), m_MappingSize(0),
+#endif
+    m_pSlots(nullptr), m_Mask(0)
+{
+}
+
+
+SharedPostedIndex::~SharedPostedIndex()
+{
+    close();
+}
+
+
+// 共有メモリの索引に関する設定を指定
+// スロット数は2の累乗に切り上げる
+void SharedPostedIndex::setSharedIndexInfo(const SHAREDINDEX_INFO &info)
+{
+    m_Info = info;
+
+    auto slotCount = 1;
+    while (slotCount < m_Info.Slots) slotCount <<= 1;
+    m_Info.Slots = slotCount;
+}
+
+
+// 共有メモリを作成または接続する
+// 使用できない場合は、このプロセスの書き込み済みのニュース記事 (ログファイルおよびブルームフィルタ) のみで判定する
+int SharedPostedIndex::open()
+{
+    close();
+
+    if (!m_Info.Enable) return 0;
+
+    m_Error.clear();
+
+    if (attach()) {
+        LOG_WARNING(QString("共有メモリの索引を使用できません (%1)").arg(m_Error), {{"key", m_Info.Key}});
+        LOG_WARNING(QString("他のプロセスの書き込み済みのニュース記事は判定しません"));
+
+        close();
+    }
+
+    return 0;
+}
+
+
+// 共有メモリを作成または接続して、ヘッダを初期化または検証
+// 作成したプロセスがヘッダを書き込む前に他のプロセスが接続する場合があるため、ヘッダが未初期化の場合は先にロックしたプロセスが初期化する
+// (共有メモリは、作成時に0で初期化されている)
+int SharedPostedIndex::attach()
+{
+    const auto size = HEADER_SIZE + static_cast<qint64>(m_Info.Slots) * static_cast<qint64>(sizeof(SLOT));
+
+#ifdef Q_OS_WIN
+    m_Memory.setKey(m_Info.Key);
+
+    if (!m_Memory.create(static_cast<int>(size))) {
+        if (m_Memory.error() != QSharedMemory::AlreadyExists || !m_Memory.attach()) {
+            m_Error = m_Memory.errorString();
+            return -1;
+        }
+    }
+
+    if (!m_Memory.lock()) {
+        m_Error = m_Memory.errorString();
+        return -1;
+    }
+
+    auto iRet = validate(static_cast<uchar*>(m_Memory.data()), m_Memory.size());
+
+    m_Memory.unlock();
+
+    return iRet;
+#else
+    // POSIXの共有メモリの名前は"/"から始まり、以降に"/"を含まない
+    auto name = m_Info.Key.toUtf8();
+    name.replace('/', '_');
+    name.prepend('/');
+
+    const auto mode = static_cast<mode_t>(m_Info.Mode);
+
+    // 作成したプロセスのみが、アクセス権 (umaskの影響を受けないように再設定する) およびグループを設定する
+    auto bCreated = true;
+    auto fd       = ::shm_open(name.constData(), O_RDWR | O_CREAT | O_EXCL, mode);
+    if (fd < 0 && errno == EEXIST) {
+        bCreated = false;
+        fd       = ::shm_open(name.constData(), O_RDWR, 0);
+    }
+
+    if (fd < 0) {
+        m_Error = QString::fromLocal8Bit(std::strerror(errno));
+        return -1;
+    }
+
+    auto fail = [this, fd]() {
+        m_Error = QString::fromLocal8Bit(std::strerror(errno));
+        ::close(fd);
+
+        return -1;
+    };
+
+    if (bCreated) {
+        if (::fchmod(fd, mode) != 0) return fail();
+
+        if (!m_Info.Group.isEmpty()) {
+            auto pGroup = ::getgrnam(m_Info.Group.toLocal8Bit().constData());
+            if (pGroup == nullptr) {
+                m_Error = QString("グループ %1 が存在しません").arg(m_Info.Group);
+                ::close(fd);
+
+                return -1;
+            }
+
+            if (::fchown(fd, static_cast<uid_t>(-1), pGroup->gr_gid) != 0) return fail();
+        }
+    }
+
+    // ヘッダの初期化および検証の間は、共有メモリを排他ロックする
+    if (::flock(fd, LOCK_EX) != 0) return fail();
+
+    // サイズが0の場合 (作成直後) は、サイズを確保する
+    struct stat status = {};
+    if (::fstat(fd, &status) != 0) return fail();
+
+    if (status.st_size == 0) {
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) return fail();
+        status.st_size = static_cast<off_t>(size);
+    }
+
+    auto data = ::mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) return fail();
+
+    m_pMapping    = data;
+    m_MappingSize = static_cast<size_t>(status.st_size);
+
+    auto iRet = validate(static_cast<uchar*>(data), static_cast<qint64>(status.st_size));
+
+    // マッピングした領域は、ファイルディスクリプタを閉じた後も有効である
+    ::flock(fd, LOCK_UN);
+    ::close(fd);
+
+    return iRet;
+#endif
+}
+
+
+// ヘッダを初期化または検証して、スロットの配列を設定
+int SharedPostedIndex::validate(uchar *data, qint64 size)
+{
+    quint32 header[4] = {};
+    std::memcpy(header, data, sizeof(header));
+
+    if (header[0] == 0) {
+        // 未初期化の場合は、共有メモリのサイズに収まるスロット数で初期化する
+        auto slotCount = static_cast<quint32>(m_Info.Slots);
+        while (slotCount > 1 && HEADER_SIZE + static_cast<qint64>(slotCount) * static_cast<qint64>(sizeof(SLOT)) > size) slotCount >>= 1;
+
+        header[0] = MAGIC;
+        header[1] = VERSION;
+        header[2] = slotCount;
+        std::memcpy(data, header, sizeof(header));
+    }
+
+    const auto slotCount = header[2];
+    const auto bValid    = header[0] == MAGIC && header[1] == VERSION && slotCount > 0 && (slotCount & (slotCount - 1)) == 0 &&
+                           HEADER_SIZE + static_cast<qint64>(slotCount) * static_cast<qint64>(sizeof(SLOT)) <= size;
+
+    if (!bValid) {
+        m_Error = QString("共有メモリの索引の形式が異なります (異なるバージョンのqNewsFlashが使用しています)");
+        return -1;
+    }
+
+    // 他のプロセスが作成した共有メモリの場合は、そのスロット数を使用する
+    if (slotCount != static_cast<quint32>(m_Info.Slots)) {
+        LOG_INFO(QString("共有メモリの索引は、既存のスロット数 (%1) を使用します").arg(slotCount), {{"key", m_Info.Key}});
+    }
+
+    m_pSlots = reinterpret_cast<SLOT*>(data + HEADER_SIZE);
+    m_Mask   = slotCount - 1;
+
+    return 0;
+}
+
+
+// 共有メモリから切断する
+// Windowsでは、全てのプロセスが切断した時に共有メモリは破棄される
+// POSIXでは、共有メモリは削除しない (再起動したプロセスも、書き込み済みのニュース記事を判定できるようにする)
+void SharedPostedIndex::close()
+{
+#ifdef Q_OS_WIN
+    if (m_Memory.isAttached()) m_Memory.detach();
+#else
+    if (m_pMapping != nullptr) ::munmap(m_pMapping, m_MappingSize);
+
+    m_pMapping    = nullptr;
+    m_MappingSize = 0;
+#endif
+
+    m_pSlots = nullptr;
+    m_Mask   = 0;
+}
+
+
+// 書き込み済みと見なす期間 [秒]
+qint64 SharedPostedIndex::horizon() const
+{
+    return static_cast<qint64>(m_Info.Hours) * 60 * 60;
+}
+
+
+// 種類 (URL / タイトル) と文字列からフィンガープリント (40ビット) を生成
+// 他のプロセスと共有するため、プロセスごとにシード値が変わるqHash()関数は使用しない (FNV-1a 64ビット + SplitMix64の最終段)
+// 0は未使用のスロットを表すため、生成しない
+quint64 SharedPostedIndex::fingerprint(char kind, const QString &text)
+{
+    quint64 hash = 0xCBF29CE484222325ULL;
+
+    hash ^= static_cast<uchar>(kind);
+    hash *= 0x100000001B3ULL;
+
+    const auto bytes = text.toUtf8();
+    for (const auto byte : bytes) {
+        hash ^= static_cast<uchar>(byte);
+        hash *= 0x100000001B3ULL;
+    }
+
+    hash ^= hash >> 30;
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94D049BB133111EBULL;
+    hash ^= hash >> 31;
+
+    hash >>= TIME_BITS;
+
+    return hash == 0 ? 1 : hash;
+}
+
+
+// フィンガープリントと時刻 [秒] からスロットの値を生成
+// 時刻は1時間単位に切り上げる (書き込み済みと見なす期間は、最大で1時間延びる)
+quint64 SharedPostedIndex::pack(quint64 fingerprint, qint64 time)
+{
+    const auto hours = static_cast<quint64>((time + 60 * 60 - 1) / (60 * 60));
+
+    return (fingerprint << TIME_BITS) | (hours & TIME_MASK);
+}
+
+
+// 期間内に記録したフィンガープリントかどうか
+// スロットは未使用に戻らないため、未使用のスロットに到達した場合は記録されていない
+bool SharedPostedIndex::contains(quint64 fingerprint) const
+{
+    const auto now = QDateTime::currentSecsSinceEpoch();
+
+    for (auto i = 0; i < MAX_PROBES; i++) {
+        const auto value = m_pSlots[(fingerprint + static_cast<quint64>(i)) & m_Mask].load(std::memory_order_acquire);
+
+        if (value == 0) return false;
+        if ((value >> TIME_BITS) == fingerprint) return now - static_cast<qint64>(value & TIME_MASK) * 60 * 60 < horizon();
+    }
+
+    return false;
+}
+
+
+// フィンガープリントを記録
+// 既に記録されている場合は時刻のみを更新して、それ以外の場合は期間を過ぎたスロット、未使用のスロットの順に使用する
+// 探索範囲の全てのスロットが期間内の場合は、最も古いスロットを上書きする
+// フィンガープリントと時刻は1回の比較交換で書き込むため、他のプロセスと競合して失敗した場合は記録しない (次の書き込み時に再度記録される)
+void SharedPostedIndex::insert(quint64 fingerprint)
+{
+    const auto now   = QDateTime::currentSecsSinceEpoch();
+    const auto value = pack(fingerprint, now);
+
+    SLOT    *pVictim     = nullptr;     // 期間を過ぎたスロット
+    quint64 victimValue  = 0;
+    SLOT    *pOldest     = nullptr;     // 最も古いスロット
+    quint64 oldestValue  = 0;
+    quint64 oldestTime   = std::numeric_limits<quint64>::max();
+
+    for (auto i = 0; i < MAX_PROBES; i++) {
+        auto &slot    = m_pSlots[(fingerprint + static_cast<quint64>(i)) & m_Mask];
+        auto  current = slot.load(std::memory_order_acquire);
+
+        if (current == 0) {
+            if (pVictim != nullptr) break;
+
+            if (slot.compare_exchange_strong(current, value, std::memory_order_acq_rel)) return;
+            // 他のプロセスが先に使用した場合は、そのスロットの値として扱う
+        }
+
+        if ((current >> TIME_BITS) == fingerprint) {
+            slot.compare_exchange_strong(current, value, std::memory_order_acq_rel);
+            return;
+        }
+
+        const auto time = current & TIME_MASK;
+        if (pVictim == nullptr && now - static_cast<qint64>(time) * 60 * 60 >= horizon()) {
+            pVictim     = &slot;
+            victimValue = current;
+        }
+
+        if (time < oldestTime) {
+            pOldest     = &slot;
+            oldestValue = current;
+            oldestTime  = time;
+        }
+    }
+
+    if (pVictim == nullptr) {
+        pVictim     = pOldest;
+        victimValue = oldestValue;
+    }
+
+    if (pVictim != nullptr) pVictim->compare_exchange_strong(victimValue, value, std::memory_order_acq_rel);
+}
+
+
+// いずれかのプロセスが期間内に書き込んだURLまたはタイトルかどうか
+// タイトルは類似ニュース記事の検出と同じ正規化 (NFKC正規化、大文字 / 小文字の統一、空白および記号の除去) をした後に比較する
+bool SharedPostedIndex::contains(const QString &url, const QString &title) const
+{
+    if (m_pSlots == nullptr) return false;
+
+    if (!url.isEmpty() && contains(fingerprint('U', url))) return true;
+
+    const auto normalized = title.isEmpty() ? QString() : DuplicateIndex::normalize(title);
+    return !normalized.isEmpty() && contains(fingerprint('T', normalized));
+}
+
+
+// 書き込んだニュース記事のURLおよびタイトルを記録
+void SharedPostedIndex::add(const QString &url, const QString &title)
+{
+    if (m_pSlots == nullptr) return;
+
+    if (!url.isEmpty()) insert(fingerprint('U', url));
+
+    const auto normalized = title.isEmpty() ? QString() : DuplicateIndex::normalize(title);
+    if (!normalized.isEmpty()) insert(fingerprint('T', normalized));
+}
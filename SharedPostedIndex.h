@@ -0,0 +1,92 @@
+#ifndef SHAREDPOSTEDINDEX_H
+#define SHAREDPOSTEDINDEX_H
+
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+
+#ifdef Q_OS_WIN
+    #include <QSharedMemory>
+#endif
+
+
+// 複数のプロセス間で共有する書き込み済みのニュース記事の索引に関する設定
+struct SHAREDINDEX_INFO {
+    bool        Enable  = false;                    // 共有メモリの索引を使用するかどうか
+    QString     Key     = "qNewsFlash_posted";      // 共有メモリのキー (同じキーを指定したプロセス間で共有する)
+    int         Slots   = 65536;                    // スロット数 (2の累乗)
+    int         Hours   = 48;                       // 書き込み済みと見なす期間 [時間]
+    int         Mode    = 0660;                     // 共有メモリを作成する場合のアクセス権 (Windowsでは使用しない)
+    QString     Group   = "";                       // 共有メモリを作成する場合のグループ名 (空の場合は変更しない、Windowsでは使用しない)
+};
+
+
+// 複数のプロセス間で共有する書き込み済みのニュース記事の索引
+// 別々のプロセス (異なるsystemdサービス等) で動作するqNewsFlashが、関連する掲示板に同じニュース記事を書き込まないようにする
+// 書き込んだニュース記事のURLおよびタイトル (正規化したもの) のフィンガープリントを共有メモリのハッシュテーブルに記録する
+// 他のプロセスのログファイルを読み込まずに、一定時間で判定できる
+//
+// ハッシュテーブルはオープンアドレス法 (線形探索) で、各スロットの読み書きはアトミック操作のみで行う (ロックしない)
+// スロットは削除せず、書き込み済みと見なす期間を過ぎたスロットを再利用する
+// 共有メモリのロック (POSIXではflock()関数、Windowsではシステムセマフォ) は、接続時のヘッダの初期化および検証のみで使用する
+//
+// POSIXでは、shm_open()関数で作成した共有メモリ (/dev/shm/<キー>) を使用して、アクセス権およびグループを指定できる
+// (異なるユーザで実行しているqNewsFlashの間でも、同じグループに属していれば共有できる)
+// 共有メモリは全てのプロセスの終了後も残るため、再起動したqNewsFlashも書き込み済みのニュース記事を判定できる
+//
+// 共有メモリの構造
+//     ヘッダ (マジックナンバー、バージョン、スロット数、予約) : 16[バイト]
+//     各スロット (フィンガープリントおよび記録した時刻を1つの64ビットの値に格納) : 8[バイト] × スロット数
+class SharedPostedIndex
+{
+private:    // Variables
+    static constexpr quint32    MAGIC       = 0x49535051;   // マジックナンバー ("QPSI")
+    static constexpr quint32    VERSION     = 2;            // 共有メモリの構造のバージョン
+    static constexpr qint64     HEADER_SIZE = 16;           // ヘッダのサイズ [バイト]
+    static constexpr int        MAX_PROBES  = 32;           // 探索するスロット数の最大値
+    static constexpr int        TIME_BITS   = 24;           // スロットの下位に格納する、記録した時刻のビット数
+    static constexpr quint64    TIME_MASK   = (1ULL << TIME_BITS) - 1;
+
+    // スロット (0の場合は未使用)
+    // 上位40ビットはURLまたはタイトルのフィンガープリント、下位24ビットは記録した時刻 (エポックからの経過時間 [時間]、切り上げ)
+    // 1つの値として読み書きするため、他のプロセスからフィンガープリントと異なる時刻の組が参照されることはない
+    using SLOT = std::atomic<quint64>;
+
+    static_assert(SLOT::is_always_lock_free, "共有メモリのスロットには、ロックフリーの64ビットのアトミック操作が必要です");
+    static_assert(sizeof(SLOT) == 8, "スロットのサイズは8バイトである必要があります");
+
+    SHAREDINDEX_INFO    m_Info;         // 共有メモリの索引に関する設定
+#ifdef Q_OS_WIN
+    QSharedMemory       m_Memory;       // 共有メモリ
+#else
+    void                *m_pMapping;    // 共有メモリをマッピングした領域 (未接続の場合はnullptr)
+    size_t              m_MappingSize;  // 共有メモリをマッピングした領域のサイズ [バイト]
+#endif
+    QString             m_Error;        // 接続に失敗した理由
+    SLOT                *m_pSlots;      // スロットの配列 (未接続の場合はnullptr)
+    quint32             m_Mask;         // スロット数 - 1
+
+private:    // Methods
+    [[nodiscard]] int       attach();                                   // 共有メモリを作成または接続して、ヘッダを初期化または検証
+    [[nodiscard]] int       validate(uchar *data, qint64 size);         // ヘッダを初期化または検証して、スロットの配列を設定 (共有メモリのロック中に呼ぶ)
+    [[nodiscard]] qint64    horizon() const;                            // 書き込み済みと見なす期間 [秒]
+    static quint64          fingerprint(char kind, const QString &text);    // 種類 (URL / タイトル) と文字列からフィンガープリント (40ビット) を生成
+    static quint64          pack(quint64 fingerprint, qint64 time);     // フィンガープリントと時刻 [秒] からスロットの値を生成
+    [[nodiscard]] bool      contains(quint64 fingerprint) const;        // 期間内に記録したフィンガープリントかどうか
+    void                    insert(quint64 fingerprint);                // フィンガープリントを記録
+
+public:     // Methods
+    SharedPostedIndex();
+    ~SharedPostedIndex();
+    SharedPostedIndex(const SharedPostedIndex&)             = delete;   // コピーコンストラクタの禁止
+    SharedPostedIndex& operator=(const SharedPostedIndex&)  = delete;   // 代入の禁止
+
+    void                setSharedIndexInfo(const SHAREDINDEX_INFO &info);   // 共有メモリの索引に関する設定を指定
+    int                 open();                                             // 共有メモリを作成または接続する (失敗した場合は使用しない)
+    void                close();                                            // 共有メモリから切断する
+    [[nodiscard]] bool  contains(const QString &url, const QString &title = QString()) const;  // いずれかのプロセスが期間内に書き込んだURLまたはタイトルかどうか
+    void                add(const QString &url, const QString &title);      // 書き込んだニュース記事のURLおよびタイトルを記録
+};
+
+
+#endif // SHAREDPOSTEDINDEX_H
@@ -0,0 +1,347 @@
+#include <QMutexLocker>
+#include <QTimer>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <memory>
+#include "SourceHealth.h"
+#include "Logger.h"
+#include "RateLimiter.h"
+#include "TlsSessionCache.h"
+#include "DnsCache.h"
+#include "Metrics.h"
+#include "Trace.h"
+
+
+// 静的メンバの初期化
+SourceHealth*   SourceHealth::m_instance = nullptr;
+QMutex          SourceHealth::m_mutex;
+
+
+SourceHealth::SourceHealth(QObject *parent) : QObject{parent}
+{
+    m_Clock.start();
+}
+
+
+SourceHealth::~SourceHealth()
+{
+}
+
+
+// シングルトンインスタンスを取得するための静的メソッド
+SourceHealth* SourceHealth::getInstance()
+{
+    if (m_instance == nullptr) {
+        QMutexLocker locker(&m_mutex);
+
+        if (m_instance == nullptr) {
+            m_instance = new SourceHealth();
+        }
+    }
+
+    return m_instance;
+}
+
+
+// 障害検知および再試行に関する設定を指定
+void SourceHealth::setHealthInfo(const HEALTH_INFO &info)
+{
+    QMutexLocker locker(&m_mutex);
+    m_Info = info;
+}
+
+
+// 障害検知および再試行に関する設定を取得
+// 設定はsetHealthInfo()メソッドで変更されるため、ロックして複写する
+HEALTH_INFO SourceHealth::healthInfo() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_Info;
+}
+
+
+// 失敗の種類を文字列で取得
+QString SourceHealth::failureName(FAILURE failure)
+{
+    switch (failure) {
+        case NONE:          return QString("成功");
+        case DNS:           return QString("名前解決の失敗");
+        case TLS:           return QString("TLSエラー");
+        case HTTP5XX:       return QString("HTTP 5xx");
+        case TIMEOUT:       return QString("タイムアウト");
+        case CONNECTION:    return QString("接続エラー");
+        case PARSE:         return QString("パースエラー");
+        default:            return QString("その他のエラー");
+    }
+}
+
+
+// 失敗の種類を英字で取得 (メトリクスのラベルに使用する)
+QString SourceHealth::failureKey(FAILURE failure)
+{
+    switch (failure) {
+        case NONE:          return QString("ok");
+        case DNS:           return QString("dns");
+        case TLS:           return QString("tls");
+        case HTTP5XX:       return QString("http5xx");
+        case TIMEOUT:       return QString("timeout");
+        case CONNECTION:    return QString("connection");
+        case PARSE:         return QString("parse");
+        default:            return QString("other");
+    }
+}
+
+
+// HTTPレスポンスのエラーを分類
+SourceHealth::FAILURE SourceHealth::classify(QNetworkReply *reply)
+{
+    // HTTPステータスコードが5xxの場合は、QNetworkReplyのエラーの種類に関わらずサーバ側の障害とする
+    auto statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (statusCode >= 500 && statusCode < 600) {
+        return HTTP5XX;
+    }
+
+    switch (reply->error()) {
+        case QNetworkReply::NoError:
+            return NONE;
+        case QNetworkReply::HostNotFoundError:
+        case QNetworkReply::TemporaryNetworkFailureError:
+            return DNS;
+        case QNetworkReply::SslHandshakeFailedError:
+            return TLS;
+        case QNetworkReply::TimeoutError:
+        case QNetworkReply::OperationCanceledError:
+            return TIMEOUT;
+        case QNetworkReply::ConnectionRefusedError:
+        case QNetworkReply::RemoteHostClosedError:
+        case QNetworkReply::NetworkSessionFailedError:
+        case QNetworkReply::UnknownNetworkError:
+            return CONNECTION;
+        case QNetworkReply::InternalServerError:
+        case QNetworkReply::OperationNotImplementedError:
+        case QNetworkReply::ServiceUnavailableError:
+        case QNetworkReply::UnknownServerError:
+            return HTTP5XX;
+        default:
+            return OTHER;
+    }
+}
+
+
+// 再試行により回復する見込みのあるエラーかどうかを確認
+// TLSエラーは証明書の不一致等であることが多いため、再試行しない
+bool SourceHealth::isTransient(FAILURE failure)
+{
+    return failure == DNS || failure == HTTP5XX || failure == TIMEOUT || failure == CONNECTION;
+}
+
+
+// 再試行までの待機時間 (ジッタ付きの指数バックオフ) を計算
+// 待機時間 = [基準時間 * 2^attempt / 2, 基準時間 * 2^attempt] の一様乱数 (ただし、最大待機時間を超えない)
+int SourceHealth::backoff(int attempt) const
+{
+    const auto info = healthInfo();
+
+    qint64 delay = static_cast<qint64>(info.BaseBackoff) << std::min(attempt, 16);
+    delay        = std::min(delay, static_cast<qint64>(info.MaxBackoff));
+
+    auto half    = static_cast<int>(delay / 2);
+
+    return half + static_cast<int>(QRandomGenerator::global()->bounded(half + 1));
+}
+
+
+// ホストのサーキットの状態を取得
+SourceHealth::STATE SourceHealth::getState(const QString &host)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_Hosts.constFind(host);
+    return it == m_Hosts.constEnd() ? CLOSED : it->State;
+}
+
+
+// 指定されたURLのホストへリクエストを送信してよいかどうかを確認
+bool SourceHealth::isAvailable(const QUrl &url)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_Hosts.find(url.host());
+    if (it == m_Hosts.end() || it->State == CLOSED) {
+        return true;
+    }
+
+    // サーキットが開いている場合、または、試行リクエストの結果待ちの場合は、クールダウンが終わるまでリクエストを送信しない
+    // 試行リクエストの結果が記録されなかった場合に備えて、試行中の状態もクールダウンの経過で再度試行する
+    auto elapsed = m_Clock.elapsed() - it->OpenedAt;
+    if (elapsed < static_cast<qint64>(m_Info.CoolDown) * 1000) {
+        return false;
+    }
+
+    // クールダウンが終わっている場合は、試行リクエストを1つのみ許可する
+    it->State    = HALFOPEN;
+    it->OpenedAt = m_Clock.elapsed();
+
+    LOG_INFO(QString("%1 へ試行リクエストを送信します").arg(url.host()));
+
+    return true;
+}
+
+
+// 指定されたURLのホストへのリクエストが成功したことを記録
+void SourceHealth::recordSuccess(const QUrl &url)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_Hosts.find(url.host());
+    if (it == m_Hosts.end()) {
+        return;
+    }
+
+    if (it->State != CLOSED) {
+        LOG_INFO(QString("%1 への接続が回復しました").arg(url.host()));
+    }
+
+    m_Hosts.erase(it);
+}
+
+
+// 指定されたURLのホストへのリクエストが失敗したことを記録
+void SourceHealth::recordFailure(const QUrl &url, FAILURE failure)
+{
+    // ホストの障害とは見なさないエラーの場合は記録しない
+    if (failure == NONE || failure == OTHER) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    auto &state = m_Hosts[url.host()];
+    state.Failures++;
+    state.LastFailure = failure;
+
+    // 試行リクエストが失敗した場合、または、連続失敗回数が閾値に達した場合は、サーキットを開く
+    if (state.State == HALFOPEN || (state.State == CLOSED && state.Failures >= m_Info.Threshold)) {
+        state.State    = OPEN;
+        state.OpenedAt = m_Clock.elapsed();
+
+        LOG_WARNING(QString("%1 への接続を%2秒間停止します (連続%3回の失敗 : %4)")
+                    .arg(url.host()).arg(m_Info.CoolDown).arg(state.Failures).arg(failureName(failure)));
+    }
+}
+
+
+// HTTPリクエストを送信して、待機せずに戻る
+// 一時的なエラー (名前解決、HTTP 5xx、タイムアウト、接続エラー) の場合は、ジッタ付きの指数バックオフで再試行する
+// ただし、試行リクエスト (サーキットが半開の状態) の場合、および、retryがfalseの場合は再試行しない
+// 最終的なレスポンス (エラー状態を含む) は、完了時にdoneに渡す (再試行の待機中もイベントループを入れ子にしない)
+void SourceHealth::getAsync(QNetworkAccessManager *manager, QNetworkRequest request, const std::function<void(QNetworkReply*)> &done, bool retry)
+{
+    const auto url      = request.url();
+    const auto maxRetry = (!retry || getState(url.host()) == HALFOPEN) ? 0 : healthInfo().MaxRetry;
+
+    // 初めてアクセスするホストの場合は、DNSキャッシュに登録して以降の名前解決をバックグラウンドで更新する
+    DnsCache::getInstance()->addHost(url.host());
+
+    // 前回のTLSセッションチケットが存在する場合は、TLSセッションを再開する
+    TlsSessionCache::getInstance()->apply(request);
+
+    send(manager, request, 0, maxRetry, done);
+}
+
+
+// リクエスト数の制限の待機後にHTTPリクエストを送信する
+// 待機はタイマで行い、イベントループを入れ子にしない (同じホストへの複数のリクエストは、補充速度の間隔で順番に送信される)
+void SourceHealth::send(QNetworkAccessManager *manager, const QNetworkRequest &request, int attempt, int maxRetry,
+                        const std::function<void(QNetworkReply*)> &done)
+{
+    const auto url  = request.url();
+    const auto wait = RateLimiter::getInstance()->reserve(url);
+
+    if (wait > 0) {
+        LOG_DEBUG(QString("%1 へのリクエストを%2[ミリ秒]待機します").arg(url.host()).arg(wait));
+    }
+
+    QTimer::singleShot(static_cast<int>(std::max<qint64>(wait, 0)), manager, [this, manager, request, attempt, maxRetry, done]() {
+        const auto url    = request.url();
+        auto       pReply = manager->get(request);
+
+        QElapsedTimer elapsed;
+        elapsed.start();
+
+        // トレースが有効の場合は、接続 (名前解決、TCP、TLS)、最初のレスポンスの受信まで、ボディの受信の各段階を記録
+        if (Trace::isEnabled()) {
+            const auto start    = Trace::getInstance()->now();
+            const auto host     = url.host();
+            auto       pHeaders = std::make_shared<qint64>(-1);
+
+            QObject::connect(pReply, &QNetworkReply::encrypted, pReply, [start, host]() {
+                Trace::getInstance()->completeAsync("net", "connect + TLS", start, host);
+            });
+            QObject::connect(pReply, &QNetworkReply::metaDataChanged, pReply, [start, host, pHeaders]() {
+                if (*pHeaders >= 0) return;
+                *pHeaders = Trace::getInstance()->now();
+                Trace::getInstance()->completeAsync("net", "wait (TTFB)", start, host);
+            });
+            QObject::connect(pReply, &QNetworkReply::finished, pReply, [host, pHeaders]() {
+                if (*pHeaders >= 0) Trace::getInstance()->completeAsync("net", "transfer", *pHeaders, host);
+            });
+        }
+
+        // タイムアウトの設定
+        // タイムアウトした場合は、リクエストを中断する
+        const auto timeout = healthInfo().Timeout;
+        auto       pTimer  = new QTimer(pReply);
+        pTimer->setSingleShot(true);
+        QObject::connect(pTimer, &QTimer::timeout, pReply, &QNetworkReply::abort);
+        if (timeout > 0) pTimer->start(timeout * 1000);
+
+        // レスポンスの受信後
+        QObject::connect(pReply, &QNetworkReply::finished, manager, [this, manager, request, attempt, maxRetry, done, pReply, pTimer, elapsed]() {
+            pTimer->stop();
+
+            const auto url     = request.url();
+            const auto failure = classify(pReply);
+
+            // 応答時間、ステータスコード (レスポンスが無い場合は失敗の種類)、ボディのサイズを記録
+            auto pMetrics   = Metrics::getInstance();
+            auto statusCode = pReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+            pMetrics->observe(Metrics::FETCH_DURATION, {url.host()}, elapsed.nsecsElapsed() / 1000);
+            pMetrics->count(Metrics::FETCH_REQUESTS, {url.host(), statusCode > 0 ? QString::number(statusCode) : failureKey(failure)});
+            pMetrics->count(Metrics::FETCH_BYTES, {url.host()}, static_cast<quint64>(std::max<qint64>(pReply->bytesAvailable(), 0)));
+            if (failure == NONE || failure == OTHER) {
+                // HTTPステータスコード 4xx等のレスポンスを受信した場合は、ホストは稼働していると見なして、サーキットを閉じる
+                // (試行リクエストの場合、成功とも失敗とも記録しないと、サーキットが半開の状態のまま残るため)
+                // 正常なレスポンスの場合は、呼び出し元でパースの成否を確認した後に記録する
+                if (failure == OTHER && statusCode > 0) recordSuccess(url);
+
+                TlsSessionCache::getInstance()->store(pReply);
+                done(pReply);
+                return;
+            }
+
+            if (!isTransient(failure) || attempt >= maxRetry) {
+                // 再試行しない場合、または、再試行回数の上限に達した場合
+                recordFailure(url, failure);
+                done(pReply);
+                return;
+            }
+
+            // 再試行までの待機
+            auto wait = backoff(attempt);
+
+            LOG_WARNING(QString("%1 (%2) %3ミリ秒後に再試行します (%4 / %5)")
+                        .arg(url.host(), failureName(failure)).arg(wait).arg(attempt + 1).arg(maxRetry));
+
+            pReply->deleteLater();
+
+            const auto start = Trace::isEnabled() ? Trace::getInstance()->now() : qint64(-1);
+
+            QTimer::singleShot(wait, manager, [this, manager, request, attempt, maxRetry, done, start]() {
+                if (start >= 0) Trace::getInstance()->completeAsync("net", "SourceHealth::backoff", start, request.url().host());
+
+                send(manager, request, attempt + 1, maxRetry, done);
+            });
+        });
+    });
+}
@@ -0,0 +1,98 @@
+#ifndef SOURCEHEALTH_H
+#define SOURCEHEALTH_H
+
+#include <QObject>
+#include <QMutex>
+#include <QMap>
+#include <QUrl>
+#include <QElapsedTimer>
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+#include <functional>
+
+
+// ニュースサイトの障害検知および再試行に関する設定
+struct HEALTH_INFO {
+    int     MaxRetry    = 2;        // 一時的なエラーが発生した場合の再試行回数
+    int     BaseBackoff = 1000;     // 再試行までの基準の待機時間 [ミリ秒] (再試行ごとに2倍となり、ジッタを加える)
+    int     MaxBackoff  = 8000;     // 再試行までの最大の待機時間 [ミリ秒]
+    int     Threshold   = 3;        // サーキットを開く (ホストへのアクセスを停止する) までの連続失敗回数
+    int     CoolDown    = 600;      // サーキットを開いてから、試行リクエストを1つ送信するまでの時間 [秒]
+    int     Timeout     = 30;       // 1回のHTTPリクエストのタイムアウト [秒] (0の場合は無効)
+};
+
+
+class SourceHealth : public QObject
+{
+    Q_OBJECT
+
+public:     // Variables
+    // 失敗の種類
+    enum FAILURE {
+        NONE        = 0,    // 成功
+        DNS         = 1,    // 名前解決の失敗
+        TLS         = 2,    // TLSハンドシェイクの失敗
+        HTTP5XX     = 3,    // HTTPステータスコード 5xx
+        TIMEOUT     = 4,    // タイムアウト
+        CONNECTION  = 5,    // 接続の拒否および切断
+        PARSE       = 6,    // RSS / HTMLのパースの失敗
+        OTHER       = 7     // その他 (HTTPステータスコード 4xx等、ホストの障害とは見なさない)
+    };
+
+    // サーキットの状態
+    enum STATE {
+        CLOSED      = 0,    // 正常 (リクエストを送信する)
+        OPEN        = 1,    // 障害中 (クールダウンが終わるまでリクエストを送信しない)
+        HALFOPEN    = 2     // 試行中 (試行リクエストを1つのみ送信する)
+    };
+
+private:    // Variables
+    // ホストごとの状態
+    struct HOST_STATE {
+        STATE       State       = CLOSED;   // サーキットの状態
+        int         Failures    = 0;        // 連続失敗回数
+        FAILURE     LastFailure = NONE;     // 最後に失敗した種類
+        qint64      OpenedAt    = 0;        // サーキットを開いた時刻 (または、試行リクエストを送信した時刻) [ミリ秒]
+    };
+
+    static SourceHealth         *m_instance;    // 静的インスタンスポインタ
+    static QMutex               m_mutex;        // シングルトンとホスト状態の操作用のミューテックス
+
+    HEALTH_INFO                 m_Info;         // 障害検知および再試行に関する設定
+    QMap<QString, HOST_STATE>   m_Hosts;        // ホスト名をキーとしたホストごとの状態
+    QElapsedTimer               m_Clock;        // クールダウンの計測に使用する単調増加の時計
+
+private:    // Methods
+    explicit SourceHealth(QObject *parent = nullptr);                       // プライベートコンストラクタ
+    ~SourceHealth() override;                                               // プライベートデストラクタ
+
+    static FAILURE  classify(QNetworkReply *reply);                         // HTTPレスポンスのエラーを分類
+    static bool     isTransient(FAILURE failure);                           // 再試行により回復する見込みのあるエラーかどうかを確認
+    HEALTH_INFO     healthInfo() const;                                     // 障害検知および再試行に関する設定を取得
+    int             backoff(int attempt) const;                             // 再試行までの待機時間 (ジッタ付きの指数バックオフ) を計算
+    STATE           getState(const QString &host);                          // ホストのサーキットの状態を取得
+    void            send(QNetworkAccessManager *manager,                    // リクエスト数の制限の待機後にHTTPリクエストを送信して、
+                         const QNetworkRequest &request, int attempt,       // 一時的なエラーの場合は待機時間の経過後に再度送信する
+                         int maxRetry, const std::function<void(QNetworkReply*)> &done);
+
+public:     // Methods
+    SourceHealth(const SourceHealth&)             = delete;                 // コピーコンストラクタの禁止
+    SourceHealth& operator=(const SourceHealth&)  = delete;                 // 代入の禁止
+
+    static SourceHealth* getInstance();                                     // シングルトンインスタンスを取得するための静的メソッド
+    static QString  failureName(FAILURE failure);                           // 失敗の種類を文字列で取得
+    static QString  failureKey(FAILURE failure);                            // 失敗の種類を英字で取得 (メトリクスのラベルに使用する)
+    void            setHealthInfo(const HEALTH_INFO &info);                 // 障害検知および再試行に関する設定を指定
+    bool            isAvailable(const QUrl &url);                           // 指定されたURLのホストへリクエストを送信してよいかどうかを確認
+                                                                            // クールダウンが終わっている場合は、試行リクエストとして1回のみtrueを返す
+    void            recordSuccess(const QUrl &url);                         // 指定されたURLのホストへのリクエストが成功したことを記録
+    void            recordFailure(const QUrl &url, FAILURE failure);        // 指定されたURLのホストへのリクエストが失敗したことを記録
+    void            getAsync(QNetworkAccessManager *manager,                // HTTPリクエストを送信して、待機せずに戻る
+                             QNetworkRequest request,                       // 一時的なエラーの場合は、ジッタ付きの指数バックオフで再試行 (retryがfalseの場合は再試行しない)
+                             const std::function<void(QNetworkReply*)> &done,   // 最終的なレスポンス (エラー状態を含む) は、完了時にdoneに渡す
+                             bool retry = true);
+};
+
+
+#endif // SOURCEHEALTH_H
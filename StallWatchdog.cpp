@@ -0,0 +1,120 @@
+#include <QMutexLocker>
+#include <algorithm>
+#include "StallWatchdog.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include "Trace.h"
+
+
+StallWatchdog::StallWatchdog(QObject *parent) : QThread(parent), m_pOperation(nullptr), m_LastBeat(0), m_ReportedBeat(-1),
+    m_StallOperation(nullptr), m_Stalls(0), m_MaxStall(0), m_bStop(false)
+{
+    m_Heartbeat.setTimerType(Qt::PreciseTimer);
+    connect(&m_Heartbeat, &QTimer::timeout, this, &StallWatchdog::onHeartbeat);
+}
+
+
+StallWatchdog::~StallWatchdog()
+{
+    stopWatchdog();
+}
+
+
+// イベントループの停止の検出に関する設定を指定
+void StallWatchdog::setWatchdogInfo(const WATCHDOG_INFO &info)
+{
+    m_Info = info;
+}
+
+
+// ハートビートおよび監視を開始
+// メインスレッドの実行中の処理名を参照するため、メインスレッドから実行する
+void StallWatchdog::startWatchdog()
+{
+    if (!m_Info.Enable || isRunning()) return;
+
+    m_pOperation = Trace::operation();
+    m_Clock.start();
+    m_LastBeat.store(0);
+    m_ReportedBeat.store(-1);
+    m_bStop = false;
+
+    m_Heartbeat.start(m_Info.Interval);
+    start(QThread::LowPriority);
+}
+
+
+// ハートビートおよび監視を終了して、停止の統計を出力
+void StallWatchdog::stopWatchdog()
+{
+    if (!isRunning()) return;
+
+    m_Heartbeat.stop();
+
+    {
+        QMutexLocker locker(&m_StopMutex);
+        m_bStop = true;
+        m_StopCondition.wakeAll();
+    }
+    wait();
+
+    LOG_INFO(QString("イベントループの停止 : %1回 (最長 %2[ミリ秒])").arg(m_Stalls.load()).arg(m_MaxStall));
+}
+
+
+// 処理名 (イベントループ内の場合は"event loop")
+QString StallWatchdog::operationName(const char *operation)
+{
+    return operation == nullptr ? QString("event loop") : QString(operation);
+}
+
+
+// ハートビート (メインスレッド)
+// 前回のハートビートからの経過時間とタイマの間隔の差を、イベントループの遅延として記録する
+// 監視用スレッドが停止を検出していた場合は、停止から再開したことおよび停止時間をログに出力する
+void StallWatchdog::onHeartbeat()
+{
+    const auto now      = m_Clock.elapsed();
+    const auto previous = m_LastBeat.exchange(now);
+    const auto lag      = std::max<qint64>(now - previous - m_Info.Interval, 0);
+
+    Metrics::getInstance()->observe(Metrics::LOOP_LAG, {}, lag * 1000);
+
+    if (m_ReportedBeat.load() == previous) {
+        const auto stall = now - previous;
+        m_MaxStall       = std::max(m_MaxStall, stall);
+        m_ReportedBeat.store(-1);
+
+        LOG_WARNING(QString("イベントループが再開しました (停止時間 : %1[ミリ秒])").arg(stall),
+                    {{"operation", operationName(m_StallOperation.load())}});
+    }
+}
+
+
+// 監視用スレッドの処理
+// 閾値の1/4の間隔でハートビートの時刻を確認して、閾値を超えて途絶えた場合は停止としてログに出力する (1回の停止につき1回のみ)
+// 停止中のメインスレッドで実行中の処理名が、イベントループをブロックしている処理である
+void StallWatchdog::run()
+{
+    const auto poll = std::max(m_Info.Threshold / 4, 10);
+
+    QMutexLocker locker(&m_StopMutex);
+    while (!m_bStop) {
+        m_StopCondition.wait(&m_StopMutex, static_cast<unsigned long>(poll));
+        if (m_bStop) break;
+
+        const auto last = m_LastBeat.load();
+        const auto gap  = m_Clock.elapsed() - last;
+        if (gap < m_Info.Interval + m_Info.Threshold || m_ReportedBeat.load() == last) continue;
+
+        const auto operation = m_pOperation->load(std::memory_order_relaxed);
+        m_StallOperation.store(operation);
+        m_ReportedBeat.store(last);
+        m_Stalls.fetch_add(1);
+
+        Metrics::getInstance()->count(Metrics::LOOP_STALLS, {operationName(operation)});
+
+        LOG_WARNING(QString("イベントループが停止しています (経過時間 : %1[ミリ秒])").arg(gap),
+                    {{"operation", operationName(operation)}});
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef STALLWATCHDOG_H
+#define STALLWATCHDOG_H
+
+#include <QThread>
+#include <QTimer>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <atomic>
+
+
+// イベントループの停止の検出に関する設定
+struct WATCHDOG_INFO {
+    bool        Enable      = false;    // イベントループの停止の検出の有効 / 無効
+    int         Interval    = 100;      // メインスレッドのハートビートの間隔 [ミリ秒]
+    int         Threshold   = 1000;     // 停止と見なすハートビートの遅延 [ミリ秒]
+};
+
+
+// メインスレッドのイベントループの停止の検出
+// メインスレッドのタイマでハートビートを送り、監視用スレッドでハートビートが閾値を超えて途絶えたことを検出する
+// 停止を検出した場合は、停止時間およびメインスレッドで実行中の処理名 (TraceSpanのスパン名) をログに出力する
+// また、ハートビートの遅延をイベントループの遅延としてヒストグラムに記録する
+// 同期処理を待機するQEventLoopの間はハートビートが送られるため、停止として検出するのはイベントループに戻らない処理 (ファイルのロック、パース等) のみである
+class StallWatchdog : public QThread
+{
+    Q_OBJECT
+
+private:    // Variables
+    WATCHDOG_INFO                   m_Info;             // イベントループの停止の検出に関する設定
+    QTimer                          m_Heartbeat;        // メインスレッドのハートビート用タイマ
+    QElapsedTimer                   m_Clock;            // 単調増加の時計
+    std::atomic<const char*>        *m_pOperation;      // メインスレッドで実行中の処理名
+    std::atomic<qint64>             m_LastBeat;         // 最後のハートビートの時刻 [ミリ秒]
+    std::atomic<qint64>             m_ReportedBeat;     // 停止を検出した時の最後のハートビートの時刻 [ミリ秒] (未検出の場合は-1)
+    std::atomic<const char*>        m_StallOperation;   // 停止を検出した時に実行中の処理名
+    std::atomic<quint64>            m_Stalls;           // 停止を検出した回数
+    qint64                          m_MaxStall;         // 最長の停止時間 [ミリ秒] (メインスレッドのみで更新する)
+    bool                            m_bStop;            // 監視用スレッドの終了要求
+    QMutex                          m_StopMutex;        // 終了要求用のミューテックス
+    QWaitCondition                  m_StopCondition;    // 終了要求用の待機条件
+
+private:    // Methods
+    static QString  operationName(const char *operation);                   // 処理名 (イベントループ内の場合は"event loop")
+
+protected:  // Methods
+    void            run() override;                                         // 監視用スレッドの処理 (ハートビートの途絶を検出)
+
+public:     // Methods
+    explicit StallWatchdog(QObject *parent = nullptr);
+    ~StallWatchdog() override;
+    StallWatchdog(const StallWatchdog&)             = delete;               // コピーコンストラクタの禁止
+    StallWatchdog& operator=(const StallWatchdog&)  = delete;               // 代入の禁止
+
+    void            setWatchdogInfo(const WATCHDOG_INFO &info);             // イベントループの停止の検出に関する設定を指定
+    void            startWatchdog();                                        // ハートビートおよび監視を開始 (メインスレッドから実行する)
+    void            stopWatchdog();                                         // ハートビートおよび監視を終了して、停止の統計を出力
+
+private slots:
+    void            onHeartbeat();                                          // ハートビート (メインスレッド)
+};
+
+
+#endif // STALLWATCHDOG_H
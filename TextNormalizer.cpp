@@ -0,0 +1,186 @@
+#include <cstring>
+#include "TextNormalizer.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+    #include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+#endif
+
+
+// 1回のSIMD命令で判定するUTF-16の文字数
+#if defined(__AVX2__)
+static constexpr qsizetype BLOCK_SIZE = 16;
+#elif defined(__SSE2__) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+static constexpr qsizetype BLOCK_SIZE = 8;
+#else
+static constexpr qsizetype BLOCK_SIZE = 0;
+#endif
+
+
+TextNormalizer::TextNormalizer(MODE mode, const QString &extra) : m_Mode(mode), m_Extra{}, m_ExtraCount(0)
+{
+    for (const auto &ch : extra) {
+        if (m_ExtraCount >= MAX_EXTRA) break;
+        m_Extra[m_ExtraCount++] = ch.unicode();
+    }
+}
+
+
+// 除去する文字かどうか
+bool TextNormalizer::isStripChar(char16_t c) const
+{
+    if (c == u' ' || (c >= u'\t' && c <= u'\r') || c == u'　') return true;
+
+    for (auto i = 0; i < m_ExtraCount; i++) {
+        if (c == m_Extra[i]) return true;
+    }
+
+    return false;
+}
+
+
+// ブロック (BLOCK_SIZE文字) 内に除去する文字が含まれるかどうか
+// \t (0x09) から\r (0x0D) までは、(c - 0x09)を符号無し飽和減算で4減じて0になるかどうかで判定する
+bool TextNormalizer::hasStripChar(const char16_t *p) const
+{
+#if defined(__AVX2__)
+    const auto v    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    const auto ctrl = _mm256_cmpeq_epi16(_mm256_subs_epu16(_mm256_sub_epi16(v, _mm256_set1_epi16(0x09)), _mm256_set1_epi16(4)), _mm256_setzero_si256());
+    auto mask       = _mm256_or_si256(ctrl, _mm256_cmpeq_epi16(v, _mm256_set1_epi16(0x20)));
+    mask            = _mm256_or_si256(mask, _mm256_cmpeq_epi16(v, _mm256_set1_epi16(static_cast<short>(0x3000))));
+
+    for (auto i = 0; i < m_ExtraCount; i++) {
+        mask = _mm256_or_si256(mask, _mm256_cmpeq_epi16(v, _mm256_set1_epi16(static_cast<short>(m_Extra[i]))));
+    }
+
+    return _mm256_movemask_epi8(mask) != 0;
+#elif defined(__SSE2__)
+    const auto v    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const auto ctrl = _mm_cmpeq_epi16(_mm_subs_epu16(_mm_sub_epi16(v, _mm_set1_epi16(0x09)), _mm_set1_epi16(4)), _mm_setzero_si128());
+    auto mask       = _mm_or_si128(ctrl, _mm_cmpeq_epi16(v, _mm_set1_epi16(0x20)));
+    mask            = _mm_or_si128(mask, _mm_cmpeq_epi16(v, _mm_set1_epi16(static_cast<short>(0x3000))));
+
+    for (auto i = 0; i < m_ExtraCount; i++) {
+        mask = _mm_or_si128(mask, _mm_cmpeq_epi16(v, _mm_set1_epi16(static_cast<short>(m_Extra[i]))));
+    }
+
+    return _mm_movemask_epi8(mask) != 0;
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    const auto v    = vld1q_u16(reinterpret_cast<const uint16_t*>(p));
+    const auto ctrl = vcleq_u16(vsubq_u16(v, vdupq_n_u16(0x09)), vdupq_n_u16(4));
+    auto mask       = vorrq_u16(ctrl, vceqq_u16(v, vdupq_n_u16(0x20)));
+    mask            = vorrq_u16(mask, vceqq_u16(v, vdupq_n_u16(0x3000)));
+
+    for (auto i = 0; i < m_ExtraCount; i++) {
+        mask = vorrq_u16(mask, vceqq_u16(v, vdupq_n_u16(m_Extra[i])));
+    }
+
+    const auto mask64 = vreinterpretq_u64_u16(mask);
+    return (vgetq_lane_u64(mask64, 0) | vgetq_lane_u64(mask64, 1)) != 0;
+#else
+    Q_UNUSED(p)
+    return true;
+#endif
+}
+
+
+// 除去および切り詰め
+// 出力先には、入力と同じ文字数の領域が必要である
+// limitが0以上の場合、出力がlimit文字を超える時点で走査を終了してtruncatedをtrueにする (サロゲートペアの上位のみが残る場合は、それも除去する)
+qsizetype TextNormalizer::run(const char16_t *src, qsizetype size, char16_t *dst, qsizetype limit, bool &truncated) const
+{
+    qsizetype i       = 0;
+    qsizetype out     = 0;
+    bool      pending = false;      // 半角スペースの出力待ち (FOLDの場合のみ)
+
+    truncated = false;
+
+    // 1文字ずつ処理する (戻り値がfalseの場合は、指定文字数を超えるため終了)
+    auto step = [&](char16_t c) -> bool {
+        if (isStripChar(c)) {
+            if (m_Mode == FOLD && out > 0) pending = true;
+            return true;
+        }
+
+        if (limit >= 0 && out + (pending ? 2 : 1) > limit) {
+            truncated = true;
+            return false;
+        }
+
+        if (pending) {
+            dst[out++] = u' ';
+            pending    = false;
+        }
+        dst[out++] = c;
+
+        return true;
+    };
+
+    // 除去する文字を含まないブロックはまとめて複写する
+    if constexpr (BLOCK_SIZE > 0) {
+        while (i + BLOCK_SIZE <= size) {
+            // 指定文字数を超える可能性がある場合は、1文字ずつ処理する
+            if (limit >= 0 && out + BLOCK_SIZE + 1 > limit) break;
+
+            if (hasStripChar(src + i)) {
+                for (auto j = 0; j < BLOCK_SIZE; j++) step(src[i + j]);
+            }
+            else {
+                if (pending) {
+                    dst[out++] = u' ';
+                    pending    = false;
+                }
+                std::memcpy(dst + out, src + i, BLOCK_SIZE * sizeof(char16_t));
+                out += BLOCK_SIZE;
+            }
+
+            i += BLOCK_SIZE;
+        }
+    }
+
+    // 残りの文字
+    for (; i < size; i++) {
+        if (!step(src[i])) break;
+    }
+
+    // サロゲートペアを分割しない (FOLDの場合は、末尾の半角スペースも除去する)
+    if (truncated && out > 0 && QChar::isHighSurrogate(dst[out - 1])) {
+        out--;
+    }
+    if (truncated && m_Mode == FOLD && out > 0 && dst[out - 1] == u' ') {
+        out--;
+    }
+
+    return out;
+}
+
+
+// 不要な文字を除去して、指定文字数を超える場合は切り詰めて"..."を付加
+// maxLengthが負の場合は切り詰めない
+QString TextNormalizer::normalize(const QString &text, long long maxLength) const
+{
+    QString result(text.size(), Qt::Uninitialized);
+
+    bool truncated = false;
+    auto length    = run(reinterpret_cast<const char16_t*>(text.utf16()), text.size(),
+                         reinterpret_cast<char16_t*>(result.data()), static_cast<qsizetype>(maxLength), truncated);
+    result.truncate(length);
+
+    if (truncated) result.append(QString("..."));
+
+    return result;
+}
+
+
+// 指定文字数を超える場合は切り詰めて"..."を付加
+// 切り詰める位置がサロゲートペアの間の場合は、その前で切り詰める
+QString TextNormalizer::truncate(const QString &text, long long maxLength)
+{
+    if (maxLength < 0 || text.size() <= maxLength) return text;
+
+    auto length = static_cast<qsizetype>(maxLength);
+    if (length > 0 && text.at(length - 1).isHighSurrogate()) length--;
+
+    return text.left(length) + QString("...");
+}
@@ -0,0 +1,41 @@
+#ifndef TEXTNORMALIZER_H
+#define TEXTNORMALIZER_H
+
+#include <QString>
+#include <array>
+
+
+// ニュース記事の本文から不要な空白文字を除去する
+// ASCIIの空白文字 (\t, \n, \v, \f, \r, 半角スペース)、全角スペース (U+3000)、および、指定した文字を1回の走査で除去 (または1つの半角スペースに置換) する
+// x86 / x64版はSSE2 (AVX2が有効な場合はAVX2)、ARM / AArch64版はNEONを使用して、除去する文字を含まないブロックをまとめて複写する
+class TextNormalizer
+{
+public:     // Variables
+    // 除去する文字の扱い
+    enum MODE {
+        REMOVE,             // 除去する
+        FOLD                // 連続する場合は1つの半角スペースに置換する (先頭および末尾は除去する)
+    };
+
+    static constexpr int    MAX_EXTRA = 8;              // 追加で除去できる文字数の最大値
+
+private:    // Variables
+    MODE                                m_Mode;         // 除去する文字の扱い
+    std::array<char16_t, MAX_EXTRA>     m_Extra;        // 追加で除去する文字群
+    int                                 m_ExtraCount;   // 追加で除去する文字数
+
+private:    // Methods
+    [[nodiscard]] bool      isStripChar(char16_t c) const;                      // 除去する文字かどうか
+    [[nodiscard]] bool      hasStripChar(const char16_t *p) const;              // ブロック内に除去する文字が含まれるかどうか (SIMD)
+    qsizetype               run(const char16_t *src, qsizetype size, char16_t *dst, qsizetype limit, bool &truncated) const;   // 除去および切り詰め
+
+public:     // Methods
+    explicit TextNormalizer(MODE mode = REMOVE, const QString &extra = QString());
+    ~TextNormalizer() = default;
+
+    [[nodiscard]] QString   normalize(const QString &text, long long maxLength = -1) const;     // 不要な文字を除去して、指定文字数を超える場合は切り詰めて"..."を付加
+    static QString          truncate(const QString &text, long long maxLength);                 // 指定文字数を超える場合は切り詰めて"..."を付加 (サロゲートペアを分割しない)
+};
+
+
+#endif // TEXTNORMALIZER_H
@@ -0,0 +1,229 @@
+#include <QMutexLocker>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QLockFile>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSslConfiguration>
+#include "TlsSessionCache.h"
+#include "Logger.h"
+
+
+// 静的メンバの初期化
+TlsSessionCache*    TlsSessionCache::m_instance = nullptr;
+QMutex              TlsSessionCache::m_mutex;
+
+
+TlsSessionCache::TlsSessionCache(QObject *parent) : QObject{parent}, m_Offered(0)
+{
+}
+
+
+TlsSessionCache::~TlsSessionCache()
+{
+}
+
+
+// シングルトンインスタンスを取得するための静的メソッド
+TlsSessionCache* TlsSessionCache::getInstance()
+{
+    if (m_instance == nullptr) {
+        QMutexLocker locker(&m_mutex);
+
+        if (m_instance == nullptr) {
+            m_instance = new TlsSessionCache();
+        }
+    }
+
+    return m_instance;
+}
+
+
+// TLSセッションの再開に関する設定を指定
+void TlsSessionCache::setTlsSessionInfo(const TLSSESSION_INFO &info)
+{
+    QMutexLocker locker(&m_mutex);
+    m_Info = info;
+}
+
+
+// チケットのキー (ホスト名 + ポート番号) を取得
+QString TlsSessionCache::hostKey(const QUrl &url)
+{
+    return QString("%1:%2").arg(url.host().toLower()).arg(url.port(443));
+}
+
+
+// 保存されているTLSセッションチケットを読み込む
+// 有効期限切れのチケットは読み込まない
+int TlsSessionCache::load()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_Info.Enable || m_Info.File.isEmpty() || !QFile::exists(m_Info.File)) {
+        return 0;
+    }
+
+    QFileInfo fileInfo(m_Info.File);
+    QString   lockFilePath = fileInfo.dir().filePath(fileInfo.baseName() + ".lock");
+    QLockFile lockFile(lockFilePath);
+
+    // 最大30秒の間に、システムは繰り返しロックの取得を試みる
+    if (!lockFile.tryLock(30000)) {
+        LOG_ERROR(QString("30秒以内にTLSセッションファイルのロックの取得に失敗"));
+        return -1;
+    }
+
+    QFile File(m_Info.File);
+    if (!File.open(QIODevice::ReadOnly)) {
+        lockFile.unlock();
+        LOG_ERROR(QString("TLSセッションファイルのオープンに失敗 %1").arg(File.errorString()));
+
+        return -1;
+    }
+
+    auto doc = QJsonDocument::fromJson(File.readAll());
+    File.close();
+    lockFile.unlock();
+
+    if (!doc.isObject()) {
+        // ファイルが破損している場合は、チケットを使用しない (次回の保存時に上書きする)
+        LOG_WARNING(QString("TLSセッションファイルが有効なJSONオブジェクトではありません"));
+        return 0;
+    }
+
+    const auto now     = QDateTime::currentSecsSinceEpoch();
+    const auto rootObj = doc.object();
+    for (auto it = rootObj.constBegin(); it != rootObj.constEnd(); ++it) {
+        auto obj = it.value().toObject();
+
+        SESSION session;
+        session.Ticket = QByteArray::fromBase64(obj["ticket"].toString().toLatin1());
+        session.Expire = static_cast<qint64>(obj["expire"].toDouble(0));
+
+        if (session.Ticket.isEmpty() || session.Expire <= now) continue;
+
+        m_Sessions.insert(it.key(), session);
+    }
+
+    LOG_DEBUG(QString("TLSセッションチケットを%1件読み込みました").arg(m_Sessions.size()));
+
+    return 0;
+}
+
+
+// TLSセッションチケットをファイルに保存
+// 有効期限切れのチケットは保存しない
+int TlsSessionCache::save()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_Info.Enable || m_Info.File.isEmpty()) {
+        return 0;
+    }
+
+    QFileInfo fileInfo(m_Info.File);
+    QString   lockFilePath = fileInfo.dir().filePath(fileInfo.baseName() + ".lock");
+    QLockFile lockFile(lockFilePath);
+
+    // 最大30秒の間に、システムは繰り返しロックの取得を試みる
+    if (!lockFile.tryLock(30000)) {
+        LOG_ERROR(QString("30秒以内にTLSセッションファイルのロックの取得に失敗"));
+        return -1;
+    }
+
+    const auto now = QDateTime::currentSecsSinceEpoch();
+    QJsonObject rootObj;
+    for (auto it = m_Sessions.constBegin(); it != m_Sessions.constEnd(); ++it) {
+        if (it->Expire <= now) continue;
+
+        QJsonObject obj;
+        obj["ticket"] = QString::fromLatin1(it->Ticket.toBase64());
+        obj["expire"] = static_cast<double>(it->Expire);
+        rootObj[it.key()] = obj;
+    }
+
+    // セッションチケットは再利用可能な秘密情報のため、所有者のみ読み書き可能にする
+    QFile File(m_Info.File);
+    if (!File.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        lockFile.unlock();
+        LOG_ERROR(QString("TLSセッションファイルのオープンに失敗 %1").arg(File.errorString()));
+
+        return -1;
+    }
+    File.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner);
+
+    File.write(QJsonDocument(rootObj).toJson(QJsonDocument::Compact));
+    File.close();
+
+    lockFile.unlock();
+
+    return 0;
+}
+
+
+// HTTPSリクエストに、キャッシュしたTLSセッションチケットを設定
+// チケットが無い場合でも、セッションの永続化を有効にして、サーバからチケットを受け取れるようにする
+void TlsSessionCache::apply(QNetworkRequest &request)
+{
+#if QT_CONFIG(ssl)
+    if (request.url().scheme().compare("https", Qt::CaseInsensitive) != 0) return;
+
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_Info.Enable) return;
+
+    auto conf = request.sslConfiguration();
+    conf.setSslOption(QSsl::SslOptionDisableSessionPersistence, false);
+
+    auto it = m_Sessions.constFind(hostKey(request.url()));
+    if (it != m_Sessions.constEnd() && it->Expire > QDateTime::currentSecsSinceEpoch()) {
+        conf.setSessionTicket(it->Ticket);
+        m_Offered++;
+    }
+
+    request.setSslConfiguration(conf);
+#else
+    Q_UNUSED(request)
+#endif
+}
+
+
+// HTTPSレスポンスから、TLSセッションチケットを取得してキャッシュ
+void TlsSessionCache::store(QNetworkReply *reply)
+{
+#if QT_CONFIG(ssl)
+    if (reply->url().scheme().compare("https", Qt::CaseInsensitive) != 0) return;
+
+    auto conf   = reply->sslConfiguration();
+    auto ticket = conf.sessionTicket();
+    if (ticket.isEmpty()) return;
+
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_Info.Enable) return;
+
+    // サーバが通知したチケットの有効期限を使用 (通知されない場合は、設定ファイルの有効期限を使用)
+    auto lifetime = conf.sessionTicketLifeTimeHint();
+
+    SESSION session;
+    session.Ticket = ticket;
+    session.Expire = QDateTime::currentSecsSinceEpoch() + (lifetime > 0 ? lifetime : m_Info.Expire);
+
+    m_Sessions.insert(hostKey(reply->url()), session);
+#else
+    Q_UNUSED(reply)
+#endif
+}
+
+
+// キャッシュしたチケットを提示したリクエスト数を表示
+// セッションを再開できたかどうかは、Qtからハンドシェイクの種類を取得できないため集計しない
+void TlsSessionCache::printStatistics() const
+{
+    if (!m_Info.Enable) return;
+
+    LOG_INFO(QString("TLSセッション : チケットを提示したリクエスト数 %1").arg(m_Offered));
+}
@@ -0,0 +1,60 @@
+#ifndef TLSSESSIONCACHE_H
+#define TLSSESSIONCACHE_H
+
+#include <QObject>
+#include <QMutex>
+#include <QMap>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+#if QT_CONFIG(ssl)
+    #include <QSslConfiguration>
+#endif
+
+
+// TLSセッションの再開 (セッションチケット) に関する設定
+struct TLSSESSION_INFO {
+    bool        Enable  = true;     // TLSセッションチケットを保存および再利用するかどうか
+    QString     File    = "";       // TLSセッションチケットを保存するJSONファイルのパス
+    qint64      Expire  = 3600;     // サーバがチケットの有効期限を通知しない場合の有効期限 [秒]
+};
+
+
+class TlsSessionCache : public QObject
+{
+    Q_OBJECT
+
+private:    // Variables
+    // ホストごとのTLSセッションチケット
+    struct SESSION {
+        QByteArray  Ticket;         // TLSセッションチケット
+        qint64      Expire = 0;     // 有効期限 (エポックタイム) [秒]
+    };
+
+    static TlsSessionCache      *m_instance;    // 静的インスタンスポインタ
+    static QMutex               m_mutex;        // シングルトンとチケットの操作用のミューテックス
+
+    TLSSESSION_INFO             m_Info;         // TLSセッションの再開に関する設定
+    QMap<QString, SESSION>      m_Sessions;     // ホスト名 + ポート番号をキーとしたTLSセッションチケット
+    int                         m_Offered;      // キャッシュしたチケットを提示したリクエスト数
+
+private:    // Methods
+    explicit TlsSessionCache(QObject *parent = nullptr);                    // プライベートコンストラクタ
+    ~TlsSessionCache() override;                                            // プライベートデストラクタ
+
+    static QString  hostKey(const QUrl &url);                               // チケットのキー (ホスト名 + ポート番号) を取得
+
+public:     // Methods
+    TlsSessionCache(const TlsSessionCache&)             = delete;           // コピーコンストラクタの禁止
+    TlsSessionCache& operator=(const TlsSessionCache&)  = delete;           // 代入の禁止
+
+    static TlsSessionCache* getInstance();                                  // シングルトンインスタンスを取得するための静的メソッド
+    void            setTlsSessionInfo(const TLSSESSION_INFO &info);         // TLSセッションの再開に関する設定を指定
+    int             load();                                                 // 保存されているTLSセッションチケットを読み込む (有効期限切れのチケットは破棄)
+    int             save();                                                 // TLSセッションチケットをファイルに保存
+    void            apply(QNetworkRequest &request);                        // HTTPSリクエストに、キャッシュしたTLSセッションチケットを設定
+    void            store(QNetworkReply *reply);                            // HTTPSレスポンスから、TLSセッションチケットを取得してキャッシュ
+    void            printStatistics() const;                                // キャッシュしたチケットを提示したリクエスト数を表示
+};
+
+
+#endif // TLSSESSIONCACHE_H
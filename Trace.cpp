@@ -0,0 +1,202 @@
+#include <QCoreApplication>
+#include <QMutexLocker>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QSet>
+#include <algorithm>
+#include "Trace.h"
+#include "Logger.h"
+
+
+// 静的メンバの初期化
+Trace*              Trace::m_instance = nullptr;
+QMutex              Trace::m_mutex;
+std::atomic<bool>   Trace::m_bEnabled{false};
+
+// スレッドごとのスレッド番号 (0の場合は未割り当て)
+static thread_local quint32 t_Thread = 0;
+
+
+Trace::Trace() : m_Next(0), m_NextThread(0), m_MainThread(0)
+{
+    m_Clock.start();
+}
+
+
+// シングルトンインスタンスを取得するための静的メソッド
+Trace* Trace::getInstance()
+{
+    if (m_instance == nullptr) {
+        QMutexLocker locker(&m_mutex);
+
+        if (m_instance == nullptr) {
+            m_instance = new Trace();
+        }
+    }
+
+    return m_instance;
+}
+
+
+// トレースに関する設定を指定
+// リングバッファを確保した後に有効にするため、メインスレッドから他の処理の開始前に実行する
+void Trace::setTraceInfo(const TRACE_INFO &info)
+{
+    m_bEnabled.store(false);
+
+    m_Info = info;
+    m_Events.clear();
+    m_Events.shrink_to_fit();
+    m_Next.store(0);
+
+    if (!m_Info.Enable) return;
+
+    m_Events.resize(static_cast<size_t>(std::max(m_Info.Capacity, 1)));
+    m_MainThread = currentThread();
+
+    m_bEnabled.store(true);
+}
+
+
+// 現在時刻 [マイクロ秒] (トレースの開始からの経過時間)
+qint64 Trace::now() const
+{
+    return m_Clock.nsecsElapsed() / 1000;
+}
+
+
+// 現在のスレッドのスレッド番号を取得 (初回に割り当てる)
+quint32 Trace::currentThread()
+{
+    if (t_Thread == 0) t_Thread = m_NextThread.fetch_add(1, std::memory_order_relaxed) + 1;
+
+    return t_Thread;
+}
+
+
+// スパンをリングバッファに記録
+// 通し番号をアトミックに取得するため、複数のスレッドから同時に記録できる (容量を超えた場合は古いスパンから上書きする)
+void Trace::record(EVENT &&event)
+{
+    if (m_Events.empty()) return;
+
+    const auto index = m_Next.fetch_add(1, std::memory_order_relaxed) % m_Events.size();
+    m_Events[index]  = std::move(event);
+}
+
+
+// 指定時刻から現在までのスパンを記録
+void Trace::complete(const char *category, const char *name, qint64 start, const QString &arg)
+{
+    if (!isEnabled()) return;
+
+    EVENT event;
+    event.Category = category;
+    event.Name     = name;
+    event.Start    = start;
+    event.Duration = now() - start;
+    event.Thread   = currentThread();
+    event.Arg      = arg;
+
+    record(std::move(event));
+}
+
+
+// 指定時刻から現在までの非同期のスパンを記録
+// 名前解決やHTTP通信の各段階は、イベントループ内で他のスパンと重なるため、スレッドのスパンとは別のトラックに表示する
+void Trace::completeAsync(const char *category, const char *name, qint64 start, const QString &arg)
+{
+    if (!isEnabled()) return;
+
+    static std::atomic<quint64> nextId{0};
+
+    EVENT event;
+    event.Category = category;
+    event.Name     = name;
+    event.Start    = start;
+    event.Duration = now() - start;
+    event.Thread   = 0;
+    event.Id       = nextId.fetch_add(1, std::memory_order_relaxed) + 1;
+    event.Arg      = arg;
+
+    record(std::move(event));
+}
+
+
+// リングバッファのスパンをChrome trace event形式で出力
+// 終了時 (全てのスパンの記録が終わった後) に実行する
+int Trace::dump()
+{
+    if (!isEnabled()) return 0;
+
+    const auto pid      = static_cast<qint64>(QCoreApplication::applicationPid());
+    const auto total    = m_Next.load();
+    const auto capacity = static_cast<quint64>(m_Events.size());
+    const auto first    = total > capacity ? total - capacity : 0;
+
+    QJsonArray  events;
+    QSet<quint32> threads;
+
+    for (auto i = first; i < total; i++) {
+        const auto &event = m_Events[i % capacity];
+
+        QJsonObject object;
+        object["name"] = event.Name;
+        object["cat"]  = event.Category;
+        object["ts"]   = event.Start;
+        object["pid"]  = pid;
+        if (!event.Arg.isEmpty()) object["args"] = QJsonObject{{"detail", event.Arg}};
+
+        if (event.Id == 0) {
+            // 完了イベント (入れ子のスパンとして表示される)
+            object["ph"]  = "X";
+            object["dur"] = event.Duration;
+            object["tid"] = static_cast<qint64>(event.Thread);
+            threads.insert(event.Thread);
+
+            events.append(object);
+        }
+        else {
+            // 非同期イベント (開始および終了の組)
+            object["ph"]  = "b";
+            object["id"]  = QString::number(event.Id);
+            object["tid"] = 0;
+            events.append(object);
+
+            object["ph"]  = "e";
+            object["ts"]  = event.Start + event.Duration;
+            object.remove("args");
+            events.append(object);
+        }
+    }
+
+    // プロセス名およびスレッド名のメタデータ
+    events.append(QJsonObject{{"name", "process_name"}, {"ph", "M"}, {"pid", pid}, {"args", QJsonObject{{"name", "qNewsFlash"}}}});
+    for (const auto thread : std::as_const(threads)) {
+        const auto name = thread == m_MainThread ? QString("main") : QString("worker %1").arg(thread);
+        events.append(QJsonObject{{"name", "thread_name"}, {"ph", "M"}, {"pid", pid}, {"tid", static_cast<qint64>(thread)},
+                                  {"args", QJsonObject{{"name", name}}}});
+    }
+
+    QJsonObject root;
+    root["traceEvents"]     = events;
+    root["displayTimeUnit"] = "ms";
+
+    QFile file(m_Info.File);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        LOG_ERROR(QString("トレースファイルのオープンに失敗 %1").arg(file.errorString()));
+        return -1;
+    }
+
+    const auto data = QJsonDocument(root).toJson(QJsonDocument::Compact);
+    if (file.write(data) != data.size()) {
+        LOG_ERROR(QString("トレースファイルの書き込みに失敗 %1").arg(file.errorString()));
+        return -1;
+    }
+
+    LOG_INFO(QString("トレースを出力しました (%1件のスパン) : %2").arg(total - first).arg(m_Info.File));
+
+    return 0;
+}
@@ -0,0 +1,106 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QMutex>
+#include <QString>
+#include <QElapsedTimer>
+#include <atomic>
+#include <vector>
+
+
+// トレース (Chrome trace event形式) に関する設定
+struct TRACE_INFO {
+    bool        Enable      = false;    // トレースの有効 / 無効
+    QString     File        = "";       // トレースを出力するファイルのパス (空欄の場合は、ログファイルと同じディレクトリのqNewsFlash_trace.json)
+    int         Capacity    = 65536;    // リングバッファに保持するスパンの最大数 (超えた場合は古いスパンから上書きする)
+};
+
+
+// 処理時間のトレース
+// 各処理の開始時刻および処理時間 [マイクロ秒] をスパンとしてリングバッファに記録して、終了時にChrome trace event形式のJSONファイルに出力する
+// 出力したファイルは、Perfetto (https://ui.perfetto.dev) またはchrome://tracingで表示できる
+// 同じスレッドで入れ子になったスパンは、親子関係として表示される
+// 無効の場合は、スパンの記録はアトミック変数の読み込みおよび実行中の処理名の更新のみとなる
+class Trace
+{
+private:    // Variables
+    // スパン
+    struct EVENT {
+        const char  *Category   = "";       // カテゴリ (文字列リテラルのみ)
+        const char  *Name       = "";       // スパン名 (文字列リテラルのみ)
+        qint64      Start       = 0;        // 開始時刻 [マイクロ秒] (トレースの開始からの経過時間)
+        qint64      Duration    = 0;        // 処理時間 [マイクロ秒]
+        quint32     Thread      = 0;        // スレッド番号 (非同期のスパンの場合は0)
+        quint64     Id          = 0;        // 非同期のスパンの識別番号
+        QString     Arg;                    // 付加情報 (URL、ホスト名等)
+    };
+
+    static Trace                *m_instance;    // 静的インスタンスポインタ
+    static QMutex               m_mutex;        // シングルトンの操作用のミューテックス
+    static std::atomic<bool>    m_bEnabled;     // トレースの有効 / 無効
+    static inline thread_local std::atomic<const char*> m_Operation{nullptr};  // 現在のスレッドで実行中の処理名 (最も内側のスパン名、トレースの有効 / 無効に関わらず更新する)
+
+    TRACE_INFO                  m_Info;         // トレースに関する設定
+    std::vector<EVENT>          m_Events;       // スパンのリングバッファ
+    std::atomic<quint64>        m_Next;         // 次に記録するスパンの通し番号
+    std::atomic<quint32>        m_NextThread;   // 次に割り当てるスレッド番号
+    quint32                     m_MainThread;   // メインスレッドのスレッド番号
+    QElapsedTimer               m_Clock;        // 単調増加の時計
+
+private:    // Methods
+    Trace();                                                                    // プライベートコンストラクタ
+    ~Trace() = default;                                                         // プライベートデストラクタ
+
+    quint32             currentThread();                                        // 現在のスレッドのスレッド番号を取得 (初回に割り当てる)
+    void                record(EVENT &&event);                                  // スパンをリングバッファに記録
+
+public:     // Methods
+    Trace(const Trace&)             = delete;                                   // コピーコンストラクタの禁止
+    Trace& operator=(const Trace&)  = delete;                                   // 代入の禁止
+
+    static Trace*       getInstance();                                          // シングルトンインスタンスを取得するための静的メソッド
+    static bool         isEnabled() { return m_bEnabled.load(std::memory_order_relaxed); }  // トレースが有効かどうか
+    static std::atomic<const char*>* operation() { return &m_Operation; }      // 現在のスレッドの実行中の処理名 (他のスレッドから参照するために使用する)
+    static const char*  enterOperation(const char *name) { return m_Operation.exchange(name, std::memory_order_relaxed); }  // 実行中の処理名を指定 (以前の処理名を返す)
+    static void         leaveOperation(const char *previous) { m_Operation.store(previous, std::memory_order_relaxed); }     // 実行中の処理名を以前の処理名に戻す
+    void                setTraceInfo(const TRACE_INFO &info);                   // トレースに関する設定を指定 (メインスレッドから実行する)
+    qint64              now() const;                                            // 現在時刻 [マイクロ秒] (トレースの開始からの経過時間)
+    void                complete(const char *category, const char *name,        // 指定時刻から現在までのスパンを記録
+                                 qint64 start, const QString &arg = QString());
+    void                completeAsync(const char *category, const char *name,   // 指定時刻から現在までの非同期のスパン (DNS等、他のスパンと重なる処理) を記録
+                                      qint64 start, const QString &arg = QString());
+    int                 dump();                                                 // リングバッファのスパンをChrome trace event形式で出力
+};
+
+
+// スコープの開始から終了までのスパンを記録する
+// また、トレースの有効 / 無効に関わらず、スコープの間はスパン名を実行中の処理名とする (イベントループの停止の検出で使用する)
+// 使用例 : TraceSpan span("fetch", "Runner::fetchJiJiRSS");
+class TraceSpan
+{
+private:
+    const char  *m_Category;            // カテゴリ
+    const char  *m_Name;                // スパン名
+    const char  *m_Previous;            // 以前の実行中の処理名
+    qint64      m_Start;                // 開始時刻 [マイクロ秒] (無効の場合は-1)
+    QString     m_Arg;                  // 付加情報
+
+public:
+    TraceSpan(const char *category, const char *name)
+        : m_Category(category), m_Name(name), m_Previous(Trace::enterOperation(name)),
+          m_Start(Trace::isEnabled() ? Trace::getInstance()->now() : -1) {}
+    ~TraceSpan()
+    {
+        Trace::leaveOperation(m_Previous);
+        if (m_Start >= 0) Trace::getInstance()->complete(m_Category, m_Name, m_Start, m_Arg);
+    }
+
+    TraceSpan(const TraceSpan&)             = delete;
+    TraceSpan& operator=(const TraceSpan&)  = delete;
+
+    explicit operator bool() const { return m_Start >= 0; }                     // スパンを記録中かどうか (付加情報の生成を省略するために使用する)
+    void        setArg(const QString &arg) { m_Arg = arg; }                     // 付加情報を指定
+};
+
+
+#endif // TRACE_H
@@ -1,16 +1,21 @@
 #include <QFileInfo>
 #include <QDir>
-#include <QLockFile>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QMutexLocker>
 #include <QTimeZone>
 #include <QException>
-#include <iostream>
+#ifdef Q_OS_WIN
+    #include <io.h>
+#else
+    #include <unistd.h>
+#endif
 #include "WriteMode.h"
+#include "Logger.h"
 #include "HtmlFetcher.h"
 #include "Poster.h"
+#include "Trace.h"
 
 
 // 静的メンバの初期化
@@ -21,11 +26,21 @@ QMutex      WriteMode::m_logMutex;
 
 WriteMode::WriteMode(QObject *parent) : QObject{parent}, m_Article(nullptr)
 {
+    // ログファイルおよび設定ファイルへの書き込み専用のスレッド
+    m_pPersist = std::make_unique<PersistThread>(
+        [this](const QList<PersistThread::COMMAND> &commands) { return commitLog(commands); },
+        [this](const QString &date) {
+            QMutexLocker confLocker(&m_confMutex);
+            return updateDateJsonWrapper(date);
+        });
+
+    connect(m_pPersist.get(), &PersistThread::completed, this, &WriteMode::persistCompleted);
 }
 
 
 WriteMode::~WriteMode()
 {
+    m_pPersist->stop();
 }
 
 
@@ -45,6 +60,15 @@ WriteMode* WriteMode::getInstance()
 }
 
 
+// テナントごとのインスタンスを生成 (マルチテナントモードで使用する)
+// 各テナントは、それぞれの設定ファイルおよびログファイルに書き込む
+// 生成したインスタンスは、親オブジェクトの破棄時に破棄される
+WriteMode* WriteMode::createInstance(QObject *parent)
+{
+    return new WriteMode(parent);
+}
+
+
 // qNewsFlashの設定ファイルを指定
 void WriteMode::setSysConfFile(const QString &confFile)
 {
@@ -59,6 +83,20 @@ void WriteMode::setLogFile(const QString &logFile)
 }
 
 
+// ログファイルおよび設定ファイルへの書き込みに関する設定を指定
+void WriteMode::setPersistInfo(const PERSIST_INFO &info)
+{
+    m_pPersist->setPersistInfo(info);
+}
+
+
+// 書き込み用スレッドに依頼した全ての書き込みの完了を待機
+void WriteMode::flush()
+{
+    m_pPersist->flush();
+}
+
+
 // 書き込むニュース記事を指定
 void WriteMode::setArticle(const Article &object)
 {
@@ -104,6 +142,8 @@ WRITE_INFO WriteMode::getWriteInfo() const
 // 書き込みモード 1 : 1つのスレッドにニュース記事および時事ドットコムの速報ニュースを書き込むモード
 int WriteMode::writeMode1()
 {
+    TraceSpan span("post", "WriteMode::writeMode1");
+
     // ニュース記事のタイトル --> 公開日 --> 本文の一部 --> URL の順に並べて書き込む
     // ただし、ニュース記事の本文を取得しない場合は、ニュース記事のタイトル --> 公開日 --> URL の順とする
     auto [title, paragraph, link, pubDate] = m_Article.getArticleData();
@@ -156,7 +196,7 @@ int WriteMode::writeMode1()
         auto ret = checkLastThreadNum();
         if (ret == -1) {
             // 最後尾のレス番号の取得に失敗した場合
-            std::cerr << QString("エラー : レス数の取得に失敗").toStdString() << std::endl;
+            LOG_ERROR(QString("レス数の取得に失敗"));
             return WRITEERROR::POSTERROR;
         }
         else if (ret == 1) {
@@ -206,6 +246,7 @@ int WriteMode::writeMode1()
             bool isHogo = false;
             if (m_WriteInfo.SaveThread) {
                 try {
+                    QMutexLocker confLocker(&m_confMutex);
                     isHogo = isHogoValue();
                     if (!isHogo) {
                         // "!hogo"コマンドを使用
@@ -271,7 +312,7 @@ int WriteMode::writeMode1()
                 // !hogoコマンドが有効の場合
                 try {
                     // "ishogo"キーの値をtrueにする
-                    QMutexLocker logLocker(&m_logMutex);
+                    QMutexLocker confLocker(&m_confMutex);
                     if (updateHogoJson(true)) {
                         // スレッド情報の保存に失敗
                         return WRITEERROR::POSTERROR;
@@ -341,12 +382,9 @@ int WriteMode::writeMode1()
     }
 #endif
 
-    // ログファイルに書き込む
-    {
-        QMutexLocker logLocker(&m_logMutex);
-        if (writeLog(m_Article, m_WriteInfo.ThreadTitle, m_WriteInfo.ThreadURL, m_ThreadInfo.key)) {
-            return WRITEERROR::LOGERROR;
-        }
+    // ログファイルに書き込む (書き込み用スレッドに依頼する)
+    if (writeLog(m_Article, m_WriteInfo.ThreadTitle, m_WriteInfo.ThreadURL, m_ThreadInfo.key)) {
+        return WRITEERROR::LOGERROR;
     }
 
     return WRITEERROR::SUCCEED;
@@ -356,6 +394,8 @@ int WriteMode::writeMode1()
 // 書き込みモード 2 : ニュース記事および時事ドットコムの速報ニュースにおいて、常に新規スレッドを立てるモード
 int WriteMode::writeMode2()
 {
+    TraceSpan span("post", "WriteMode::writeMode2");
+
     // ニュース記事のタイトル --> 公開日 --> 本文の一部 --> URL の順に並べて書き込む
     // ただし、ニュース記事の本文を取得しない場合は、ニュース記事のタイトル --> 公開日 --> URL の順とする
     auto [title, paragraph, link, pubDate] = m_Article.getArticleData();
@@ -437,18 +477,29 @@ int WriteMode::writeMode2()
     }
 #endif
 
-    // ログファイルに書き込む
-    {
-        QMutexLocker logLocker(&m_logMutex);
-        if (writeLog(m_Article, threadtitle, threadurl, tInfo.key, true)) {
-            return WRITEERROR::LOGERROR;
-        }
+    // ログファイルに書き込む (書き込み用スレッドに依頼する)
+    if (writeLog(m_Article, threadtitle, threadurl, tInfo.key, true)) {
+        return WRITEERROR::LOGERROR;
     }
 
     return WRITEERROR::SUCCEED;
 }
 
 
+// ログファイルおよび設定ファイルの所有権を取得 (本ソフトウェアの終了まで保持する)
+// 他のプロセスが所有している場合は、待機せずに失敗する
+// 所有権の取得後は、ファイル操作をミューテックス (m_confMutex, m_logMutex) のみで排他する
+int WriteMode::acquireOwnership()
+{
+    if (m_InstanceLock.acquire(m_LogFile) || m_InstanceLock.acquire(m_SysConfFile)) {
+        m_InstanceLock.release();
+        return -1;
+    }
+
+    return 0;
+}
+
+
 // 現在のエポックタイム (UNIX時刻) を秒単位で取得する
 qint64 WriteMode::getEpocTime()
 {
@@ -490,7 +541,7 @@ QString WriteMode::replaceSubjectToken(QString subject, QString title)
 
     int count = subject.count("%t");
     if (count > 1) {
-        std::cout << QString("警告 : \"%t\"トークンが複数存在します").toStdString() << std::endl;
+        LOG_WARNING(QString("\"%t\"トークンが複数存在します"));
                      subject.replace(tempToken, "%%t");
 
         return QString();
@@ -564,7 +615,7 @@ int WriteMode::CompareThreadTitle(const QUrl &url, QString &title)
     HtmlFetcher fetcher(this);
     if (fetcher.extractThreadTitle(url, true, m_WriteInfo.ExpiredXpath, m_ThreadInfo.shiftjis)) {
         // <title>タグの取得に失敗した場合
-        std::cerr << QString("エラー : <title>タグの取得に失敗 - CompareThreadTitle()").toStdString() << std::endl;
+        LOG_ERROR(QString("<title>タグの取得に失敗 - CompareThreadTitle()"));
         return -1;
     }
 
@@ -594,21 +645,12 @@ int WriteMode::CompareThreadTitle(const QUrl &url, QString &title)
 // スレッド情報 (スレッドのタイトル、スレッドのURL、スレッド番号) を設定ファイルに保存
 int WriteMode::updateThreadJson(const QString &title)
 {
-    QFileInfo configFileInfo(m_SysConfFile);
-    QString   lockFilePath = configFileInfo.dir().filePath(configFileInfo.baseName() + ".lock");
-    QLockFile lockFile(lockFilePath);
-
-    // 最大30秒の間に、システムは繰り返しロックの取得を試みる
-    if (!lockFile.tryLock(30000)) {
-        std::cerr << QString("エラー: 30秒以内に書き込み用ログファイルのロックの取得に失敗").toStdString() << std::endl;
-        return -1;
-    }
+    TraceSpan span("file", "WriteMode::updateThreadJson");
 
     // 設定ファイルの読み込み
     QFile File(m_SysConfFile);
     if (!File.open(QIODevice::ReadWrite)) {
-        lockFile.unlock();
-        std::cerr << QString("エラー : 設定ファイルのオープンに失敗 %1").arg(m_SysConfFile).toStdString() << std::endl;
+        LOG_ERROR(QString("設定ファイルのオープンに失敗 %1").arg(m_SysConfFile));
 
         return -1;
     }
@@ -619,8 +661,7 @@ int WriteMode::updateThreadJson(const QString &title)
         doc = QJsonDocument::fromJson(File.readAll());
         if (!doc.isObject()) {
             if (File.isOpen())  File.close();
-            lockFile.unlock();
-            std::cerr << QString("エラー : 設定ファイルがオブジェクトではありません").toStdString() << std::endl;
+            LOG_ERROR(QString("設定ファイルがオブジェクトではありません"));
 
             return -1;
         }
@@ -643,11 +684,11 @@ int WriteMode::updateThreadJson(const QString &title)
         File.write(doc.toJson());
         File.resize(File.pos());    // ファイルサイズを現在の位置に切り詰める
         File.flush();               // 確実にディスクに書き込む
+        if (m_pPersist->getPersistInfo().Fsync) syncFile(File);
     }
     catch (QException &ex) {
         if (File.isOpen())  File.close();
-        lockFile.unlock();
-        std::cerr << QString("エラー : %1").arg(ex.what()).toStdString() << std::endl;
+        LOG_ERROR(QString("%1").arg(ex.what()));
 
         return -1;
     }
@@ -655,9 +696,6 @@ int WriteMode::updateThreadJson(const QString &title)
     // 設定ファイルを閉じる
     File.close();
 
-    // ロックファイルを削除
-    lockFile.unlock();
-
     return 0;
 }
 
@@ -665,15 +703,7 @@ int WriteMode::updateThreadJson(const QString &title)
 // スレッドに!hogoコマンドが書かれているかどうかを確認
 bool WriteMode::isHogoValue()
 {
-    QFileInfo configFileInfo(m_SysConfFile);
-    QString lockFilePath = configFileInfo.dir().filePath(configFileInfo.baseName() + ".lock");
-    QLockFile lockFile(lockFilePath);
-
-    // 最大30秒の間に、システムは繰り返しロックの取得を試みる
-    if (!lockFile.tryLock(30000)) {
-        std::cerr << QString("エラー: 30秒以内に設定ファイルのロックの取得に失敗").toStdString() << std::endl;
-        throw std::runtime_error("");
-    }
+    TraceSpan span("file", "WriteMode::isHogoValue");
 
     bool isHogo = false;
 
@@ -684,7 +714,6 @@ bool WriteMode::isHogoValue()
     try {
         // 設定ファイルを開く
         if(!File.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            lockFile.unlock();
             throw std::runtime_error(QString("設定ファイルのオープンに失敗しました %1").arg(File.errorString()).toStdString());
         }
 
@@ -703,15 +732,13 @@ bool WriteMode::isHogoValue()
     }
     catch (const std::runtime_error &e) {
         if (File.isOpen())          File.close();
-        if (lockFile.isLocked())    lockFile.unlock();
-        std::cerr << QString("エラー: %1").arg(e.what()).toStdString() << std::endl;
+        LOG_ERROR(QString("%1").arg(e.what()));
 
         throw;
     }
     catch (const std::exception &e) {
         if (File.isOpen())          File.close();
-        if (lockFile.isLocked())    lockFile.unlock();
-        std::cerr << QString("エラー: %1").arg(e.what()).toStdString() << std::endl;
+        LOG_ERROR(QString("%1").arg(e.what()));
 
         throw;
     }
@@ -719,9 +746,6 @@ bool WriteMode::isHogoValue()
     // ファイルを閉じる
     File.close();
 
-    // ロックファイルを削除
-    lockFile.unlock();
-
     return isHogo;
 }
 
@@ -729,23 +753,14 @@ bool WriteMode::isHogoValue()
 // !hogoコマンド (有効 / 無効) の状態を設定ファイルに保存
 int WriteMode::updateHogoJson(bool isHogo)
 {
-    QFileInfo configFileInfo(m_SysConfFile);
-    QString lockFilePath = configFileInfo.dir().filePath(configFileInfo.baseName() + ".lock");
-    QLockFile lockFile(lockFilePath);
-
-    // 最大30秒の間に、システムは繰り返しロックの取得を試みる
-    if (!lockFile.tryLock(30000)) {
-        std::cerr << QString("エラー: 30秒以内に設定ファイルのロックの取得に失敗").toStdString() << std::endl;
-        return -1;
-    }
+    TraceSpan span("file", "WriteMode::updateHogoJson");
 
     QJsonDocument doc;
     QFile File(m_SysConfFile);
 
     // 設定ファイルを開く
     if (!File.open(QIODevice::ReadWrite)) {
-        lockFile.unlock();
-        std::cerr << QString("エラー : 設定ファイルのオープンに失敗 %1").arg(m_SysConfFile).toStdString() << std::endl;
+        LOG_ERROR(QString("設定ファイルのオープンに失敗 %1").arg(m_SysConfFile));
 
         return -1;
     }
@@ -772,13 +787,13 @@ int WriteMode::updateHogoJson(bool isHogo)
 
         // 更新したJSONオブジェクトをファイルに書き込む
         File.write(doc.toJson());
-        File.flush();
         File.resize(File.pos());  // ファイルサイズを現在の位置に切り詰める
+        File.flush();
+        if (m_pPersist->getPersistInfo().Fsync) syncFile(File);
     }
     catch(const std::exception &ex) {
         if (File.isOpen())       File.close();
-        if (lockFile.isLocked()) lockFile.unlock();
-        std::cerr << QString("エラー : %1").arg(ex.what()).toStdString() << std::endl;
+        LOG_ERROR(QString("%1").arg(ex.what()));
 
         return -1;
     }
@@ -786,32 +801,71 @@ int WriteMode::updateHogoJson(bool isHogo)
     // 設定ファイルを閉じる
     File.close();
 
-    // ロックファイルを削除
-    lockFile.unlock();
-
     return 0;
 }
 
 
 // 書き込み済みのニュース記事をJSONファイルに保存
+// ログファイルへの書き込みは書き込み用スレッドに依頼して、完了を待機しない (persistキーのwaitキーがtrueの場合は待機する)
 int WriteMode::writeLog(Article &article, const QString &threadtitle, const QString &threadurl, const QString &key, bool bNewThread)
 {
-    QFileInfo logFileInfo(m_LogFile);
-    QString   lockFilePath = logFileInfo.dir().filePath(logFileInfo.baseName() + ".lock");
-    QLockFile lockFile(lockFilePath);
+    auto [title, paragraph, url, date] = article.getArticleData();
+    QJsonObject newObject;
+
+    // ニュース記事の情報をログファイルに保存
+    newObject["title"]      = title;
+    newObject["paragraph"]  = paragraph;
+    newObject["url"]        = url;
+    newObject["date"]       = date;
+
+    // スレッドの情報をログファイルに保存
+    QJsonObject threadObject;
+    threadObject["title"]   = threadtitle;                      // スレッドのタイトル
+    threadObject["url"]     = threadurl;                        // スレッドのURL
+    threadObject["key"]     = key;                              // スレッド番号
+    auto currentDate        = WriteMode::getCurrentTime();      // スレッドの作成日時
+    threadObject["time"]    = currentDate;
+    threadObject["new"]     = bNewThread;                       // ニュース記事を新規スレッドで立てているかどうか
+    threadObject["bottom"]  = false;                            // !bottomコマンド ("書き込みモード 2", "書き込みモード 3の一般ニュース"の場合のみ、このフラグを使用)
+
+    newObject["thread"] = threadObject;
+
+    // !bottomコマンド機能を有効にしている場合
+    // 新規スレッドを立てる場合のみ、!bottomコマンド機能向けに書き込みログを保存
+    // 書き込みモード 2 または 書き込みモード 3の一般ニュースのみ
+    if (bNewThread && m_WriteInfo.BottomThread) {
+        WRITE_LOG log {
+            .Title    = threadtitle,    // スレッドのタイトル
+            .Url      = threadurl,      // スレッドのURL
+            .Key      = key,            // スレッド番号
+            .Time     = currentDate,    // スレッドの作成日時
+            .bottom   = false           // !bottomコマンド
+        };
+        m_WriteLogs.append(log);
+    }
+
+    PersistThread::COMMAND command;
+    command.Kind  = PersistThread::APPEND_LOG;
+    command.Entry = newObject;
+
+    return m_pPersist->submit(std::move(command), m_pPersist->getPersistInfo().Wait);
+}
+
+
+// ログファイルへの連続した書き込みをまとめて実行 (書き込み用スレッドで実行する)
+// ログファイルの読み込みおよび書き換えは、まとめた書き込みにつき1回のみ行う
+int WriteMode::commitLog(const QList<PersistThread::COMMAND> &commands)
+{
+    TraceSpan span("file", "WriteMode::commitLog");
 
-    // 最大30秒の間に、システムは繰り返しロックの取得を試みる
-    if (!lockFile.tryLock(30000)) {
-        std::cerr << QString("エラー: ログファイルのロックの取得に失敗").toStdString() << std::endl;
-        return -1;
-    }
+    QMutexLocker logLocker(&m_logMutex);
 
     QFile File(m_LogFile);
 
     try {
         // ログファイルを開く
         if (!File.open(QIODevice::ReadWrite)) {
-            throw std::runtime_error(QString("エラー: ログファイルのオープンに失敗  %1").arg(File.errorString()).toStdString());
+            throw std::runtime_error(QString("ログファイルのオープンに失敗  %1").arg(File.errorString()).toStdString());
         }
 
         // ログファイルを読み込む
@@ -821,72 +875,55 @@ int WriteMode::writeLog(Article &article, const QString &threadtitle, const QStr
             QJsonParseError jsonError;
             jsonDoc = QJsonDocument::fromJson(jsonData, &jsonError);
             if (jsonDoc.isNull()) {
-                throw std::runtime_error(jsonError.errorString().toStdString());
+                throw std::runtime_error(QString("ログファイルの解析に失敗  (%1)").arg(jsonError.errorString()).toStdString());
             }
         }
 
-        if (!jsonDoc.isArray()) {
-            jsonDoc.setArray(QJsonArray());
-        }
-
-        auto jsonArray = jsonDoc.array();
-        auto [title, paragraph, url, date] = article.getArticleData();
-        QJsonObject newObject;
-
-        // ニュース記事の情報をログファイルに保存
-        newObject["title"]      = title;
-        newObject["paragraph"]  = paragraph;
-        newObject["url"]        = url;
-        newObject["date"]       = date;
+        auto jsonArray = jsonDoc.isArray() ? jsonDoc.array() : QJsonArray();
+        bool modified  = false;
 
-        // スレッドの情報をログファイルに保存
-        QJsonObject threadObject;
-        threadObject["title"]   = threadtitle;                      // スレッドのタイトル
-        threadObject["url"]     = threadurl;                        // スレッドのURL
-        threadObject["key"]     = key;                              // スレッド番号
-        auto currentDate        = WriteMode::getCurrentTime();      // スレッドの作成日時
-        threadObject["time"]    = currentDate;
-        threadObject["new"]     = bNewThread;                       // ニュース記事を新規スレッドで立てているかどうか
-        threadObject["bottom"]  = false;                            // !bottomコマンド ("書き込みモード 2", "書き込みモード 3の一般ニュース"の場合のみ、このフラグを使用)
+        for (const auto &command : commands) {
+            if (command.Kind == PersistThread::APPEND_LOG) {
+                // 書き込み済みのニュース記事を追加
+                jsonArray.append(command.Entry);
+                modified = true;
+                continue;
+            }
 
-        newObject["thread"] = threadObject;
+            // 同じURLを持つオブジェクトの"thread"オブジェクト -> "bottom"キーの値をtrueに更新
+            for (auto i = 0; i < jsonArray.size(); i++) {
+                QJsonObject obj          = jsonArray[i].toObject();
+                QJsonObject threadObject = obj["thread"].toObject();
 
-        jsonArray.append(newObject);
+                // 書き込みモード 2 または 書き込みモード 3の一般ニュースかどうかを確認
+                if (!threadObject["new"].toBool()) continue;
 
-        File.seek(0);
-        File.resize(0);
-        QByteArray newJsonData = QJsonDocument(jsonArray).toJson();
-        if (File.write(newJsonData) != newJsonData.size()) {
-            throw std::runtime_error(File.errorString().toStdString());
+                if (threadObject["url"].toString().compare(command.Value, Qt::CaseSensitive) == 0 && !threadObject["bottom"].toBool()) {
+                    threadObject["bottom"] = true;
+                    obj["thread"]          = threadObject;
+                    jsonArray[i]           = obj;
+                    modified               = true;
+                }
+            }
         }
 
-        File.flush();
+        // 各オブジェクトが追加または変更された場合のみログファイルに書き込む
+        if (modified) {
+            File.seek(0);
+            QByteArray newJsonData = QJsonDocument(jsonArray).toJson();
+            if (File.write(newJsonData) != newJsonData.size()) {
+                throw std::runtime_error(File.errorString().toStdString());
+            }
+            File.resize(File.pos());
 
-        // !bottomコマンド機能を有効にしている場合
-        // 新規スレッドを立てる場合のみ、!bottomコマンド機能向けに書き込みログを保存
-        // 書き込みモード 2 または 書き込みモード 3の一般ニュースのみ
-        if (bNewThread && m_WriteInfo.BottomThread) {
-            WRITE_LOG log {
-                .Title    = threadtitle,    // スレッドのタイトル
-                .Url      = threadurl,      // スレッドのURL
-                .Key      = key,            // スレッド番号
-                .Time     = currentDate,    // スレッドの作成日時
-                .bottom   = false           // !bottomコマンド
-            };
-            m_WriteLogs.append(log);
+            if (!File.flush() || (m_pPersist->getPersistInfo().Fsync && !syncFile(File))) {
+                throw std::runtime_error(QString("ログファイルのフラッシュに失敗  %1").arg(File.errorString()).toStdString());
+            }
         }
     }
-    catch (const std::runtime_error &e) {
-        if (File.isOpen())          File.close();
-        if (lockFile.isLocked())    lockFile.unlock();
-        std::cerr << QString("エラー: %1").arg(e.what()).toStdString() << std::endl;
-
-        return -1;
-    }
     catch (const std::exception &e) {
         if (File.isOpen())          File.close();
-        if (lockFile.isLocked())    lockFile.unlock();
-        std::cerr << QString("エラー: %1").arg(e.what()).toStdString() << std::endl;
+        LOG_ERROR(QString("%1").arg(e.what()));
 
         return -1;
     }
@@ -894,42 +931,45 @@ int WriteMode::writeLog(Article &article, const QString &threadtitle, const QStr
     // ログファイルを閉じる
     File.close();
 
-    // ロックファイルを削除
-    lockFile.unlock();
-
     return 0;
 }
 
 
+// ファイルの内容をディスクに同期 (fsync)
+bool WriteMode::syncFile(QFile &file)
+{
+#ifdef Q_OS_WIN
+    return ::_commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+
+
 // 最後にニュース記事を取得した日付を設定ファイルに保存 (フォーマット : "yyyy/M/d")
+// 設定ファイルへの書き込みは書き込み用スレッドに依頼して、完了を待機しない (persistキーのwaitキーがtrueの場合は待機する)
+// 失敗した場合は、persistCompletedシグナルで通知する
 int WriteMode::updateDateJson(const QString &currentDate)
 {
-    QMutexLocker confLocker(&m_confMutex);
+    PersistThread::COMMAND command;
+    command.Kind  = PersistThread::UPDATE_DATE;
+    command.Value = currentDate;
 
-    return updateDateJsonWrapper(currentDate);
+    return m_pPersist->submit(std::move(command), m_pPersist->getPersistInfo().Wait);
 }
 
 
 // (ラッパー向け) 最後にニュース記事を取得した日付を設定ファイルに保存 (フォーマット : "yyyy/M/d")
 int WriteMode::updateDateJsonWrapper(const QString &currentDate)
 {
-    QFileInfo configFileInfo(m_SysConfFile);
-    QString lockFilePath = configFileInfo.dir().filePath(configFileInfo.baseName() + ".lock");
-    QLockFile lockFile(lockFilePath);
-
-    // 最大30秒の間に、システムは繰り返しロックの取得を試みる
-    if (!lockFile.tryLock(30000)) {
-        std::cerr << QString("エラー: 30秒以内に設定ファイルのロックの取得に失敗").toStdString() << std::endl;
-        return -1;
-    }
+    TraceSpan span("file", "WriteMode::updateDateJsonWrapper");
 
     QJsonDocument doc;
     QFile File(m_SysConfFile);
 
     // 設定ファイルを開く
     if (!File.open(QIODevice::ReadWrite)) {
-        lockFile.unlock();
-        std::cerr << QString("エラー : 設定ファイルのオープンに失敗 %1").arg(m_SysConfFile).toStdString() << std::endl;
+        LOG_ERROR(QString("設定ファイルのオープンに失敗 %1").arg(m_SysConfFile));
 
         return -1;
     }
@@ -953,13 +993,13 @@ int WriteMode::updateDateJsonWrapper(const QString &currentDate)
 
         // 更新したJSONオブジェクトをファイルに書き込む
         File.write(doc.toJson());
-        File.flush();
         File.resize(File.pos());  // ファイルサイズを現在の位置に切り詰める
+        File.flush();
+        if (m_pPersist->getPersistInfo().Fsync) syncFile(File);
     }
     catch(const std::exception &ex) {
         if (File.isOpen())       File.close();
-        if (lockFile.isLocked()) lockFile.unlock();
-        std::cerr << QString("エラー : %1").arg(ex.what()).toStdString() << std::endl;
+        LOG_ERROR(QString("%1").arg(ex.what()));
 
         return -1;
     }
@@ -967,9 +1007,6 @@ int WriteMode::updateDateJsonWrapper(const QString &currentDate)
     // 設定ファイルを閉じる
     File.close();
 
-    // ロックファイルを削除
-    lockFile.unlock();
-
     return 0;
 }
 
@@ -1002,7 +1039,7 @@ int WriteMode::writeJSON(Article &article)
         // JSONファイルを作成
         QFile file(m_WriteFile);
         if (!file.open(QIODevice::WriteOnly)) {
-            std::cerr << QString("エラー : ファイルのオープンに失敗 %1").arg(file.errorString()).toStdString() << std::endl;
+            LOG_ERROR(QString("ファイルのオープンに失敗 %1").arg(File.errorString()));
             return -1;
         }
 
@@ -1010,7 +1047,7 @@ int WriteMode::writeJSON(Article &article)
         file.close();
     }
     catch (QException &ex) {
-        std::cerr << QString("エラー : JSONファイルの作成に失敗 %1").arg(ex.what()).toStdString() << std::endl;
+        LOG_ERROR(QString("JSONファイルの作成に失敗 %1").arg(ex.what()));
         return -1;
     }
 
@@ -1024,14 +1061,14 @@ int WriteMode::truncateJSON()
         // JSONファイルを作成
         QFile File(m_WriteFile);
         if (!File.open(QIODevice::WriteOnly)) {
-            std::cerr << QString("エラー : ファイルのオープンに失敗 %1").arg().toStdString(file.errorString()) << std::endl;
+            LOG_ERROR(QString("ファイルのオープンに失敗 %1").arg(File.errorString()));
             return -1;
         }
 
         File.close();
     }
     catch (QException &ex) {
-        std::cerr << QString("エラー : JSONファイルの作成に失敗 %1").arg(ex.what()).toStdString() << std::endl;
+        LOG_ERROR(QString("JSONファイルの作成に失敗 %1").arg(ex.what()));
         return -1;
     }
 
@@ -1041,32 +1078,26 @@ int WriteMode::truncateJSON()
 
 
 // ログ情報を保存するファイルから、昨日以前(昨日も含む)の書き込み済みのニュース記事を削除
+// 書き込み用スレッドで、キュー内のログファイルへの書き込みの後に実行して、完了まで待機する
 int WriteMode::deleteLogNotToday()
 {
-    QMutexLocker logLocker(&m_logMutex);
+    return m_pPersist->call([this]() {
+        QMutexLocker logLocker(&m_logMutex);
 
-    return deleteLogNotTodayWrapper();
+        return deleteLogNotTodayWrapper();
+    });
 }
 
 
 // (ラッパー向け) ログ情報を保存するファイルから、昨日以前(昨日も含む)の書き込み済みのニュース記事を削除
 int WriteMode::deleteLogNotTodayWrapper()
 {
-    QFileInfo logFileInfo(m_LogFile);
-    QString   lockFilePath = logFileInfo.dir().filePath(logFileInfo.baseName() + ".lock");
-    QLockFile lockFile(lockFilePath);
-
-    // 最大30秒の間に、システムは繰り返しロックの取得を試みる
-    if (!lockFile.tryLock(30000)) {
-        std::cerr << QString("エラー: 30秒以内に書き込み用ログファイルのロックの取得に失敗").toStdString() << std::endl;
-        return -1;
-    }
+    TraceSpan span("file", "WriteMode::deleteLogNotTodayWrapper");
 
     // ログファイルを開く
     QFile File(m_LogFile);
     if (!File.open(QIODevice::ReadWrite)) {
-        if (lockFile.isLocked())    lockFile.unlock();
-        std::cerr << QString("エラー: ログファイルのオープンに失敗").toStdString() << std::endl;
+        LOG_ERROR(QString("ログファイルのオープンに失敗"));
 
         return -1;
     }
@@ -1119,8 +1150,7 @@ int WriteMode::deleteLogNotTodayWrapper()
     }
     catch (const std::exception &ex) {
         if (File.isOpen())       File.close();
-        if (lockFile.isLocked()) lockFile.unlock();
-        std::cerr << "エラー : " << ex.what() << std::endl;
+        LOG_ERROR(QString(ex.what()));
 
         return -1;
     }
@@ -1169,9 +1199,6 @@ int WriteMode::deleteLogNotTodayWrapper()
     // ログファイルを閉じる
     File.close();
 
-    // ロックファイルを削除
-    lockFile.unlock();
-
     return 0;
 }
 
@@ -1179,23 +1206,32 @@ int WriteMode::deleteLogNotTodayWrapper()
 // ログファイルから、本日の書き込み済みのニュース記事を取得
 // また、取得した記事群のデータは、メンバ変数m_WrittenArticlesに保存
 // ただし、このメソッドは、deleteLogNotToday()メソッドの直後に実行する必要がある
+// 書き込み用スレッドで、キュー内のログファイルへの書き込みの後に実行して、完了まで待機する
 QList<Article> WriteMode::getDatafromWrittenLog()
 {
-    QMutexLocker logLocker(&m_logMutex);
+    QList<Article>  writtenArticles;
+    std::string     error;
 
-    try {
-        return getDatafromWrittenLogWrapper();
-    }
-    catch (const std::runtime_error &e) {
-        // 例外を再スローして、呼び出し元に伝播させる
-        throw;
-    }
-    catch (const std::exception &e) {
+    auto ret = m_pPersist->call([this, &writtenArticles, &error]() {
+        QMutexLocker logLocker(&m_logMutex);
+
+        try {
+            writtenArticles = getDatafromWrittenLogWrapper();
+        }
+        catch (const std::exception &e) {
+            error = e.what();
+            return -1;
+        }
+
+        return 0;
+    });
+
+    if (ret) {
         // 例外を再スローして、呼び出し元に伝播させる
-        throw;
+        throw std::runtime_error(error);
     }
 
-    return QList<Article>{};
+    return writtenArticles;
 }
 
 
@@ -1204,23 +1240,14 @@ QList<Article> WriteMode::getDatafromWrittenLog()
 // ただし、このメソッドは、deleteLogNotToday()メソッドの直後に実行する必要がある
 QList<Article> WriteMode::getDatafromWrittenLogWrapper()
 {
-    QList<Article> writtenArticles;
-
-    QFileInfo logFileInfo(m_LogFile);
-    QString   lockFilePath = logFileInfo.dir().filePath(logFileInfo.baseName() + ".lock");
-    QLockFile lockFile(lockFilePath);
+    TraceSpan span("file", "WriteMode::getDatafromWrittenLogWrapper");
 
-    // 最大30秒の間に、システムは繰り返しロックの取得を試みる
-    if (!lockFile.tryLock(30000)) {
-        std::cerr << QString("エラー: 30秒以内に書き込み用ログファイルのロックの取得に失敗").toStdString() << std::endl;
-        throw std::runtime_error("エラー : ログファイルのロック取得に失敗");
-    }
+    QList<Article> writtenArticles;
 
     try {
         // ログファイルを開く
         QFile File(m_LogFile);
         if (!File.open(QIODevice::ReadOnly)) {
-            lockFile.unlock();
             throw std::runtime_error("エラー : ログファイルのオープンに失敗");
         }
 
@@ -1233,7 +1260,6 @@ QList<Article> WriteMode::getDatafromWrittenLogWrapper()
         // ログファイル内にある書き込み済みの記事群を取得 (本日分のみ)
         QJsonDocument jsonDoc = QJsonDocument::fromJson(data);
         if (!jsonDoc.isArray()) {
-            lockFile.unlock();
             throw std::runtime_error("エラー : ログファイルのフォーマットが不正です");
         }
 
@@ -1245,18 +1271,13 @@ QList<Article> WriteMode::getDatafromWrittenLogWrapper()
         }
     }
     catch (const QException &ex) {
-        lockFile.unlock();
         throw std::runtime_error(QString("エラー : ログファイルの読み込みに失敗 %1").arg(ex.what()).toStdString());
     }
     catch (const std::exception &e) {
         // 既存の例外を再スロー
-        lockFile.unlock();
         throw;
     }
 
-    // ロックファイルを削除
-    lockFile.unlock();
-
     return writtenArticles;
 }
 
@@ -1282,6 +1303,8 @@ QString WriteMode::getOldestWriteLogDate() const
 // 任意の時間が過ぎた書き込み済みスレッドに対して、レスが無い場合は!bottomコマンドを書き込む
 int WriteMode::writeBottom()
 {
+    TraceSpan span("post", "WriteMode::writeBottom");
+
     // リストから先頭オブジェクトをポップ
     auto headWriteLog = m_WriteLogs.takeFirst();
 
@@ -1316,16 +1339,13 @@ int WriteMode::writeBottom()
         auto ret = checkLastThreadNum();
         if (ret == -1) {
             // 最後尾のレス番号の取得に失敗した場合
-            std::cerr << QString("エラー : レス数の取得に失敗").toStdString() << std::endl;
+            LOG_ERROR(QString("レス数の取得に失敗"));
             return WRITEERROR::POSTERROR;
         }
         else if (ret == 1) {
             // 既存のスレッドが最大レス数に達している場合、ログファイルの"thread"オブジェクトのbottomキーを"true"に上書きする
-            {
-                QMutexLocker logLocker(&m_logMutex);
-                if (writeBottomLog(headWriteLog)) {
-                    return WRITEERROR::LOGERROR;
-                }
+            if (writeBottomLog(headWriteLog)) {
+                return WRITEERROR::LOGERROR;
             }
         }
         else {
@@ -1338,21 +1358,15 @@ int WriteMode::writeBottom()
             }
 
             // ログファイルの"thread"オブジェクトのbottomキーを"true"に上書きする
-            {
-                QMutexLocker logLocker(&m_logMutex);
-                if (writeBottomLog(headWriteLog)) {
-                    return WRITEERROR::LOGERROR;
-                }
+            if (writeBottomLog(headWriteLog)) {
+                return WRITEERROR::LOGERROR;
             }
         }
     }
     else if (iExpired == 1) {
         // ログファイルにあるスレッドのURLが存在しない場合、ログファイルの"thread"オブジェクトのbottomキーを"true"に上書きする
-        {
-            QMutexLocker logLocker(&m_logMutex);
-            if (writeBottomLog(headWriteLog)) {
-                return WRITEERROR::LOGERROR;
-            }
+        if (writeBottomLog(headWriteLog)) {
+            return WRITEERROR::LOGERROR;
         }
     }
     else {
@@ -1365,92 +1379,14 @@ int WriteMode::writeBottom()
 
 
 // ログファイル内の該当オブジェクトに対して、"bottom"キーをtrueへ更新
+// ログファイルへの書き込みは書き込み用スレッドに依頼して、完了を待機しない (persistキーのwaitキーがtrueの場合は待機する)
 int WriteMode::writeBottomLog(const WRITE_LOG &writeLog)
 {
-    QFileInfo logFileInfo(m_LogFile);
-    QString   lockFilePath = logFileInfo.dir().filePath(logFileInfo.baseName() + ".lock");
-    QLockFile lockFile(lockFilePath);
-
-    // 最大30秒の間に、システムは繰り返しロックの取得を試みる
-    if (!lockFile.tryLock(30000)) {
-        if (lockFile.isLocked())    lockFile.unlock();
-        std::cerr << QString("30秒以内にログファイルのロックの取得に失敗").toStdString() << std::endl;
-
-        return -1;
-    }
-
-    QFile File(m_LogFile);
+    PersistThread::COMMAND command;
+    command.Kind  = PersistThread::MARK_BOTTOM;
+    command.Value = writeLog.Url;
 
-    try {
-        // ログファイルを開く
-        if (!File.open(QIODevice::ReadWrite)) {
-            throw std::runtime_error(QString("ログファイルのオープンに失敗  (%1)").arg(m_LogFile).toStdString());
-        }
-
-        // ログファイルを読み込む
-        QByteArray jsonData = File.readAll();
-        QJsonDocument doc = QJsonDocument::fromJson(jsonData);
-        if (doc.isNull()) {
-            throw std::runtime_error(QString("ログファイルの解析に失敗  (%1)").arg(m_LogFile).toStdString());
-        }
-
-        // ログファイルのデータを取得
-        QJsonArray jsonArray = doc.array();
-
-        // 同じURLを持つオブジェクトを検索
-        bool modified = false;
-        for (auto i = 0; i < jsonArray.size(); i++) {
-            QJsonObject obj          = jsonArray[i].toObject();
-            QJsonObject threadObject = obj["thread"].toObject();
-            QString     threadUrl    = threadObject["url"].toString();
-
-            // 書き込みモード 2 または 書き込みモード 3の一般ニュースかどうかを確認
-            if (!threadObject["new"].toBool()) {
-                // 書き込みモード 1 または 書き込みモード 3の時事ドットコムの速報ニュースの場合
-                continue;
-            }
-
-            if (threadUrl.compare(writeLog.Url, Qt::CaseSensitive) == 0) {
-                // 各オブジェクトの"thread"オブジェクト -> "bottom"キーの値をtrueに更新
-                if (!threadObject["bottom"].toBool()) {
-                    threadObject["bottom"] = true;
-                    obj["thread"]          = threadObject;
-                    jsonArray[i]           = obj;
-                    modified               = true;
-                }
-            }
-        }
-
-        // 各オブジェクトの値が変更された場合のみログファイルに書き込む
-        if (modified) {
-            QJsonDocument updatedDoc(jsonArray);
-            File.seek(0);
-            File.write(updatedDoc.toJson());
-            File.resize(File.pos());
-        }
-    }
-    catch (const std::runtime_error &e) {
-        if (File.isOpen())          File.close();
-        if (lockFile.isLocked())    lockFile.unlock();
-        std::cerr << QString("エラー: %1").arg(e.what()).toStdString() << std::endl;
-
-        return -1;
-    }
-    catch (const std::exception &e) {
-        if (File.isOpen())          File.close();
-        if (lockFile.isLocked())    lockFile.unlock();
-        std::cerr << QString("エラー: %1").arg(e.what()).toStdString() << std::endl;
-
-        return -1;
-    }
-
-    // ファイルを閉じる
-    File.close();
-
-    // ロックファイルを削除
-    lockFile.unlock();
-
-    return 0;
+    return m_pPersist->submit(std::move(command), m_pPersist->getPersistInfo().Wait);
 }
 
 
@@ -1489,7 +1425,7 @@ int WriteMode::writeBottomInitialization(const THREAD_INFO &tInfo, const WRITE_I
         auto num = getLastThreadNum(wInfo);
         if (num == -1) {
             // 最後尾のレス番号の取得に失敗した場合
-            std::cerr << QString("エラー : レス数の取得に失敗").toStdString() << std::endl;
+            LOG_ERROR(QString("レス数の取得に失敗"));
             return WRITEERROR::POSTERROR;
         }
         else if (num == 1) {
@@ -1519,29 +1455,26 @@ int WriteMode::writeBottomInitialization(const THREAD_INFO &tInfo, const WRITE_I
 
 
 // ログファイル内の該当オブジェクトに対して、"bottom"キーをtrueへ更新
+// ログファイルの読み込みのみをロック中に行い、!bottomコマンドの書き込み中はロックを保持しない
+// "bottom"キーの更新は書き込み用スレッドに依頼する
 int WriteMode::writeBottomLogInitialization(THREAD_INFO tInfo, WRITE_INFO wInfo, int thresholdMilliSec)
 {
-    QFileInfo logFileInfo(m_LogFile);
-    QString   lockFilePath = logFileInfo.dir().filePath(logFileInfo.baseName() + ".lock");
-    QLockFile lockFile(lockFilePath);
+    TraceSpan span("file", "WriteMode::writeBottomLogInitialization");
 
-    // 最大30秒の間に、システムは繰り返しロックの取得を試みる
-    if (!lockFile.tryLock(30000)) {
-        std::cerr << QString("エラー: 30秒以内に書き込み用ログファイルのロックの取得に失敗").toStdString() << std::endl;
-        return -1;
-    }
-
-    QFile File(m_LogFile);
+    QJsonArray jsonArray;
 
     try {
+        QMutexLocker logLocker(&m_logMutex);
+
         // ログファイルを開く
         QFile File(m_LogFile);
-        if (!File.open(QIODevice::ReadWrite)) {
+        if (!File.open(QIODevice::ReadOnly)) {
             throw std::runtime_error(QString("書き込み用ログファイルのオープンに失敗  (%1)").arg(File.errorString()).toStdString());
         }
 
         // ログファイルの内容を読み込む
         QByteArray jsonData = File.readAll();
+        File.close();
 
         // ログファイルの解析
         QJsonParseError jsonError;
@@ -1555,83 +1488,69 @@ int WriteMode::writeBottomLogInitialization(THREAD_INFO tInfo, WRITE_INFO wInfo,
             throw std::runtime_error("ログファイルのフォーマットが不正です");
         }
 
-        QJsonArray jsonArray        = doc.array();
-        QString    currentTime      = getCurrentTime();
-        bool       fileModified     = false;
+        jsonArray = doc.array();
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR(QString("%1").arg(e.what()));
 
-        // 該当するオブジェクトを検索
-        for (int i = 0; i < jsonArray.size(); ++i) {
-            QJsonObject obj = jsonArray[i].toObject();
+        return -1;
+    }
 
-            // threadオブジェクトが存在しており、有効なオブジェクトであることを確認
-            if (!obj.contains("thread") || !obj["thread"].isObject()) {
-                continue;
-            }
+    QString currentTime  = getCurrentTime();
+    bool    fileModified = false;
 
-            QJsonObject threadObj = obj["thread"].toObject();
+    // 該当するオブジェクトを検索
+    for (const auto &value : std::as_const(jsonArray)) {
+        QJsonObject obj = value.toObject();
 
-            // 必要なキーが存在しており、適切な型であることを確認
-            if (!threadObj.contains("new")    || !threadObj["new"].isBool()    ||
-                !threadObj.contains("bottom") || !threadObj["bottom"].isBool() ||
-                !threadObj.contains("time")   || !threadObj["time"].isString()) {
-                continue;
-            }
+        // threadオブジェクトが存在しており、有効なオブジェクトであることを確認
+        if (!obj.contains("thread") || !obj["thread"].isObject()) {
+            continue;
+        }
 
-            // "thread"オブジェクト -> "new"キーの値がtrue、かつ、"bottom"キーの値がfalseの場合のみ処理を続行
-            if (!threadObj["new"].toBool() || threadObj["bottom"].toBool()) {
-                continue;
-            }
+        QJsonObject threadObj = obj["thread"].toObject();
 
-            QString threadTime = threadObj["time"].toString();
+        // 必要なキーが存在しており、適切な型であることを確認
+        if (!threadObj.contains("new")    || !threadObj["new"].isBool()    ||
+            !threadObj.contains("bottom") || !threadObj["bottom"].isBool() ||
+            !threadObj.contains("time")   || !threadObj["time"].isString()) {
+            continue;
+        }
 
-            // !bottomコマンドを書き込む指定時間が過ぎているかどうかを確認
-            if (!compareTimeStrings(threadTime, currentTime, thresholdMilliSec)) {
-                continue;
-            }
+        // "thread"オブジェクト -> "new"キーの値がtrue、かつ、"bottom"キーの値がfalseの場合のみ処理を続行
+        if (!threadObj["new"].toBool() || threadObj["bottom"].toBool()) {
+            continue;
+        }
 
-            // 該当スレッドが存在している場合は、!bottomコマンドを書き込み、ログファイルの"thread"オブジェクト -> "bottom"を"true"に更新
-            // 該当スレッドが落ちている場合は、!bottomコマンドを書き込まずに、ログファイルの"thread"オブジェクト -> "bottom"を"true"に更新
-            wInfo.ThreadTitle = threadObj["title"].toString();
-            wInfo.ThreadURL = threadObj["url"].toString();
-            if (writeBottomInitialization(tInfo, wInfo, threadObj["key"].toString())) {
-                continue;
-            }
+        QString threadTime = threadObj["time"].toString();
 
-            threadObj["bottom"] = true;
-            obj["thread"]       = threadObj;
-            jsonArray[i]        = obj;
-            fileModified        = true;
+        // !bottomコマンドを書き込む指定時間が過ぎているかどうかを確認
+        if (!compareTimeStrings(threadTime, currentTime, thresholdMilliSec)) {
+            continue;
         }
 
-        if (fileModified) {
-            // ファイルの先頭に戻り、更新されたJSONを書き込む
-            File.seek(0);
-            File.write(QJsonDocument(jsonArray).toJson());
-            File.resize(File.pos());
+        // 該当スレッドが存在している場合は、!bottomコマンドを書き込み、ログファイルの"thread"オブジェクト -> "bottom"を"true"に更新
+        // 該当スレッドが落ちている場合は、!bottomコマンドを書き込まずに、ログファイルの"thread"オブジェクト -> "bottom"を"true"に更新
+        wInfo.ThreadTitle = threadObj["title"].toString();
+        wInfo.ThreadURL = threadObj["url"].toString();
+        if (writeBottomInitialization(tInfo, wInfo, threadObj["key"].toString())) {
+            continue;
         }
-        else {
-            std::cout << QString("ログファイル: 起動時に!bottomコマンドが必要なスレッドはありません").toStdString() << std::endl << std::endl;
+
+        PersistThread::COMMAND command;
+        command.Kind  = PersistThread::MARK_BOTTOM;
+        command.Value = wInfo.ThreadURL;
+        if (m_pPersist->submit(std::move(command), m_pPersist->getPersistInfo().Wait)) {
+            return -1;
         }
-    }
-    catch (const std::runtime_error &e) {
-        if (File.isOpen())          File.close();
-        if (lockFile.isLocked())    lockFile.unlock();
-        std::cerr << QString("エラー: %1").arg(e.what()).toStdString() << std::endl;
 
-        return -1;
+        fileModified = true;
     }
-    catch (const std::exception &e) {
-        if (File.isOpen())  File.close();
-        if (lockFile.isLocked())    lockFile.unlock();
-        std::cerr << QString("エラー: %1").arg(e.what()).toStdString() << std::endl;
 
-        return -1;
+    if (!fileModified) {
+        LOG_INFO(QString("ログファイル: 起動時に!bottomコマンドが必要なスレッドはありません"));
     }
 
-    File.close();
-
-    lockFile.unlock();
-
     return 0;
 }
 
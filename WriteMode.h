@@ -3,9 +3,13 @@
 
 #include <QObject>
 #include <QMutex>
+#include <QFile>
 #include <optional>
+#include <memory>
 #include "Article.h"
 #include "Poster.h"
+#include "PersistThread.h"
+#include "InstanceLock.h"
 
 
 // スレッドへの書き込みに必要な情報
@@ -42,6 +46,8 @@ class WriteMode : public QObject
 {
     Q_OBJECT
 
+    friend class CoreBench;     // ベンチマーク (bench/CoreBench.cpp) から非公開メソッドを計測するため
+
 private:    // Variables
     static WriteMode    *m_instance;        // 静的インスタンスポインタ
     static QMutex       m_confMutex;        // シングルトンとファイル操作用のミューテックス
@@ -55,6 +61,8 @@ private:    // Variables
     THREAD_INFO         m_ThreadInfo;       // 記事を書き込むスレッドの情報
     WRITE_INFO          m_WriteInfo;        // スレッドの書き込みに必要な情報
     QList<WRITE_LOG>    m_WriteLogs;        // 書き込み直後のログファイルオブジェクト群
+    std::unique_ptr<PersistThread> m_pPersist;  // ログファイルおよび設定ファイルへの書き込み専用のスレッド
+    InstanceLock        m_InstanceLock;     // ログファイルおよび設定ファイルの所有権 (プロセス単位の排他ロック)
 
 public:     // Variables
     enum WRITEERROR {
@@ -68,6 +76,7 @@ private:    // Methods
     WriteMode(QObject *parent = nullptr);                                   // プライベートコンストラクタ
     ~WriteMode();                                                           // プライベートデストラクタ
 
+    static bool    syncFile(QFile &file);                                   // ファイルの内容をディスクに同期 (fsync)
     static qint64  getEpocTime();                                           // 現在のエポックタイム (UNIX時刻) を秒単位で取得
     static QString getCurrentTime();                                        // 現在の日本時刻を"yyyy年M月d日 H時m分"形式で取得
     QString        replaceSubjectToken(QString subject,                     // 文字列 %tトークンをスレッドのタイトルに置換
@@ -79,17 +88,18 @@ private:    // Methods
     int            updateThreadJson(const QString &title);                  // スレッド情報 (スレッドのタイトル、スレッドのURL、スレッド番号) を設定ファイルに保存
     bool           isHogoValue();                                           // スレッドに!hogoコマンドが書かれているかどうかを確認
     int            updateHogoJson(bool isHogo);                             // !hogoコマンド (有効 / 無効) の状態を設定ファイルに保存
-    int            writeLog(Article       &article,                         // 書き込み済みのニュース記事をJSONファイルに保存
+    int            writeLog(Article       &article,                         // 書き込み済みのニュース記事をJSONファイルに保存 (書き込み用スレッドに依頼する)
                             const QString &threadtitle,
                             const QString &threadurl,
                             const QString &key,
                             bool          bNewThread = false);
+    int            commitLog(const QList<PersistThread::COMMAND> &commands);  // ログファイルへの連続した書き込みをまとめて実行 (書き込み用スレッドで実行する)
     int            updateDateJsonWrapper(const QString &currentDate);       // (ラッパー向け) 最後にニュース記事を取得した日付を設定ファイルに保存 (フォーマット : "yyyy/M/d")
     int            deleteLogNotTodayWrapper();                              // (ラッパー向け) ログ情報を保存するファイルから、昨日以前(昨日も含む)の書き込み済みのニュース記事を削除
     QList<Article> getDatafromWrittenLogWrapper();                          // (ラッパー向け) ログ情報を保存するファイルから、本日の書き込み済みのニュース記事を取得
                                                                             // また、取得した記事群のデータは、メンバ変数m_WrittenArticlesに保存
                                                                             // ただし、このメソッドは、deleteLogNotToday()メソッドの直後に実行する必要がある
-    int            writeBottomLog(const WRITE_LOG &writeLog);               // 書き込み済みログファイル内の該当スレッドに対して、"bottom"キーをtrueへ更新
+    int            writeBottomLog(const WRITE_LOG &writeLog);               // 書き込み済みログファイル内の該当スレッドに対して、"bottom"キーをtrueへ更新 (書き込み用スレッドに依頼する)
     int            writeBottomInitialization(const THREAD_INFO &tInfo,      // 書き込み済みログファイル内の該当スレッドに対して、"bottom"キーをtrueへ更新
                                              const WRITE_INFO  &wInfo,
                                              const QString     &key);
@@ -110,8 +120,12 @@ public:     // Methods
     WriteMode& operator=(const WriteMode&)  = delete;                       // 代入の禁止
 
     static WriteMode* getInstance();                                        // シングルトンインスタンスを取得するための静的メソッド
+    static WriteMode* createInstance(QObject *parent);                      // テナントごとのインスタンスを生成 (マルチテナントモードで使用する)
     void            setSysConfFile(const QString &confFile);                // qNewsFlashの設定ファイルを指定
     void            setLogFile(const QString &logFile);                     // 書き込みに成功したニュース記事の情報を保存するログファイルを指定
+    void            setPersistInfo(const PERSIST_INFO &info);               // ログファイルおよび設定ファイルへの書き込みに関する設定を指定
+    int             acquireOwnership();                                     // ログファイルおよび設定ファイルの所有権を取得 (他のプロセスが所有している場合は-1を返す)
+    void            flush();                                                // 書き込み用スレッドに依頼した全ての書き込みの完了を待機
     void            setArticle(const Article &object);                      // 書き込むニュース記事を指定
     void            setArticle(const QString &title,                        // 書き込むニュース記事を指定
                                const QString &paragraph,
@@ -136,6 +150,7 @@ public:     // Methods
                                                  int         thresholdMilliSec);
 
 signals:
+    void            persistCompleted(int kind, quint64 sequence, int result);   // 書き込み用スレッドに依頼した書き込みの完了 (kindはPersistThread::KIND)
 
 };
 
@@ -0,0 +1,206 @@
+#include <libxml/xmlmemory.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "XmlArena.h"
+
+
+// 静的メンバの初期化
+thread_local XmlArena*  XmlArena::t_Active = nullptr;
+std::atomic<bool>       XmlArena::s_Installed{false};
+
+
+static constexpr size_t HEADER_SIZE     = 16;               // 各領域の先頭に格納する情報 (所有するアリーナおよびサイズ) の領域 (16バイト境界を維持する)
+static constexpr size_t MIN_CHUNK_SIZE  = 64 * 1024;        // 最初のチャンクのサイズ [バイト]
+static constexpr size_t MAX_CHUNK_SIZE  = 4 * 1024 * 1024;  // チャンクのサイズの上限 [バイト] (これより大きい領域は、その領域専用のチャンクを確保する)
+
+
+XmlArena::XmlArena() : m_Bytes(0), m_Reserved(0), m_Last(nullptr)
+{
+    static_assert(sizeof(BLOCK) <= HEADER_SIZE, "各領域の先頭に格納する情報は、16バイト以下である必要があります");
+}
+
+
+XmlArena::~XmlArena()
+{
+    if (t_Active == this) t_Active = nullptr;
+
+    for (auto &chunk : m_Chunks) {
+        std::free(chunk.Data);
+    }
+}
+
+
+// libxml2のメモリ関数を登録
+// libxml2の仕様により、他のlibxml2の関数 (xmlInitParser()関数を含む) より前に呼ぶ必要がある
+bool XmlArena::install()
+{
+    if (s_Installed) return true;
+
+    if (xmlGcMemSetup(hookFree, hookMalloc, hookMalloc, hookRealloc, hookStrdup) != 0) {
+        return false;
+    }
+
+    s_Installed = true;
+
+    return true;
+}
+
+
+// メモリ関数を登録したかどうか
+bool XmlArena::isInstalled()
+{
+    return s_Installed;
+}
+
+
+// 呼び出し元のスレッドでアリーナを有効にする
+void XmlArena::activate()
+{
+    t_Active = this;
+}
+
+
+// 呼び出し元のスレッドでアリーナを無効にする
+void XmlArena::deactivate()
+{
+    if (t_Active == this) t_Active = nullptr;
+}
+
+
+// 確保を要求された合計サイズ
+size_t XmlArena::bytes() const
+{
+    return m_Bytes;
+}
+
+
+// チャンク群の合計サイズ
+size_t XmlArena::reserved() const
+{
+    return m_Reserved;
+}
+
+
+// アリーナから領域を確保
+// 各領域の先頭には、このアリーナおよび領域のサイズ (再確保時に内容を複写するため) を格納する
+void *XmlArena::allocate(size_t size)
+{
+    const auto need = HEADER_SIZE + ((size + 15) & ~static_cast<size_t>(15));
+
+    if (m_Chunks.empty() || m_Chunks.back().Size - m_Chunks.back().Used < need) {
+        auto chunkSize = m_Chunks.empty() ? MIN_CHUNK_SIZE : std::min(m_Chunks.back().Size * 2, MAX_CHUNK_SIZE);
+        chunkSize      = std::max(chunkSize, need);
+
+        CHUNK chunk;
+        chunk.Data = static_cast<char*>(std::malloc(chunkSize));
+        if (chunk.Data == nullptr) return nullptr;
+        chunk.Size = chunkSize;
+
+        // 空き領域が多いチャンクは残して、新しいチャンクを末尾に追加する
+        m_Chunks.push_back(chunk);
+        m_Reserved += chunkSize;
+    }
+
+    auto &chunk = m_Chunks.back();
+    auto *block = chunk.Data + chunk.Used;
+    chunk.Used += need;
+    m_Bytes    += size;
+
+    *reinterpret_cast<BLOCK*>(block) = BLOCK{this, size};
+    m_Last = block + HEADER_SIZE;
+
+    return m_Last;
+}
+
+
+// 領域の先頭に格納した情報
+// 領域を確保したスレッドで書き込んだ後は変更しないため (アリーナ内の領域のサイズは、アリーナが有効なスレッドのみが変更する)、
+// 他のスレッドからもロックせずに参照できる
+XmlArena::BLOCK *XmlArena::header(const void *ptr)
+{
+    return reinterpret_cast<BLOCK*>(static_cast<char*>(const_cast<void*>(ptr)) - HEADER_SIZE);
+}
+
+
+// libxml2のメモリ関数 (malloc)
+// アリーナ外の領域も、先頭に所有者が存在しないこと (nullptr) およびサイズを格納する
+void *XmlArena::hookMalloc(size_t size)
+{
+    if (t_Active != nullptr) return t_Active->allocate(size);
+
+    auto block = static_cast<char*>(std::malloc(HEADER_SIZE + size));
+    if (block == nullptr) return nullptr;
+
+    *reinterpret_cast<BLOCK*>(block) = BLOCK{nullptr, size};
+
+    return block + HEADER_SIZE;
+}
+
+
+// libxml2のメモリ関数 (realloc)
+// アリーナ内の領域が最後に確保した領域の場合は、その場で拡張する
+void *XmlArena::hookRealloc(void *ptr, size_t size)
+{
+    if (ptr == nullptr) return hookMalloc(size);
+
+    auto pHeader = header(ptr);
+    auto pOwner  = pHeader->Owner;
+
+    if (pOwner == nullptr) {
+        auto block = static_cast<char*>(std::realloc(pHeader, HEADER_SIZE + size));
+        if (block == nullptr) return nullptr;
+
+        reinterpret_cast<BLOCK*>(block)->Size = size;
+
+        return block + HEADER_SIZE;
+    }
+
+    const auto oldSize = pHeader->Size;
+    if (pOwner == t_Active && ptr == pOwner->m_Last) {
+        auto &chunk    = pOwner->m_Chunks.back();
+        auto oldNeed   = (oldSize + 15) & ~static_cast<size_t>(15);
+        auto newNeed   = (size + 15) & ~static_cast<size_t>(15);
+        auto blockEnd  = static_cast<char*>(ptr) + oldNeed;
+
+        if (blockEnd == chunk.Data + chunk.Used && (newNeed <= oldNeed || chunk.Size - chunk.Used >= newNeed - oldNeed)) {
+            chunk.Used       = chunk.Used - oldNeed + newNeed;
+            pOwner->m_Bytes += size > oldSize ? size - oldSize : 0;
+            pHeader->Size    = size;
+
+            return ptr;
+        }
+    }
+
+    // 新しい領域を確保して内容を複写 (アリーナ内の古い領域は解放しない)
+    auto newPtr = hookMalloc(size);
+    if (newPtr != nullptr) std::memcpy(newPtr, ptr, std::min(oldSize, size));
+
+    return newPtr;
+}
+
+
+// libxml2のメモリ関数 (free)
+// アリーナ内の領域は、アリーナの解放時に一括で解放するため何もしない
+void XmlArena::hookFree(void *ptr)
+{
+    if (ptr == nullptr) return;
+
+    auto pHeader = header(ptr);
+    if (pHeader->Owner != nullptr) return;
+
+    std::free(pHeader);
+}
+
+
+// libxml2のメモリ関数 (strdup)
+char *XmlArena::hookStrdup(const char *str)
+{
+    if (str == nullptr) return nullptr;
+
+    const auto length = std::strlen(str) + 1;
+    auto       copy   = static_cast<char*>(hookMalloc(length));
+    if (copy != nullptr) std::memcpy(copy, str, length);
+
+    return copy;
+}
@@ -0,0 +1,67 @@
+#ifndef XMLARENA_H
+#define XMLARENA_H
+
+#include <vector>
+#include <atomic>
+#include <cstddef>
+
+
+// libxml2の1回のパース処理 (1つのドキュメント) 専用のメモリアリーナ
+// xmlMemSetup()関数で登録したメモリ関数は、呼び出し元のスレッドで有効なアリーナが存在する場合は、アリーナから領域を確保する
+// アリーナ内の領域の解放は何もせず、アリーナの破棄時に全体を一括で解放する (xmlFreeDoc()関数でノードを1つずつ解放しない)
+// アリーナを無効にした後にドキュメントを操作すると、アリーナ外の領域がドキュメントから参照されて解放されないため、
+// パースからドキュメントの最後の走査までをアリーナが有効な間に行い、アリーナの破棄後はドキュメントを使用しないこと
+// アリーナが有効ではないスレッド、および、アリーナ外の領域は、通常のmalloc() / free()関数を使用する
+//
+// メモリ関数が確保する全ての領域 (アリーナ外を含む) の先頭には、所有するアリーナ (アリーナ外の場合はnullptr) およびサイズを格納する
+// 解放および再確保時は、この情報のみで所有者を判別するため、ロックおよびアリーナ群の検索は不要である
+class XmlArena
+{
+private:    // Variables
+    // アリーナの領域 (チャンク)
+    struct CHUNK {
+        char        *Data   = nullptr;  // 領域の先頭
+        size_t      Size    = 0;        // 領域のサイズ [バイト]
+        size_t      Used    = 0;        // 使用済みのサイズ [バイト]
+    };
+
+    // 各領域の先頭に格納する情報
+    struct BLOCK {
+        XmlArena    *Owner  = nullptr;  // 領域を所有するアリーナ (アリーナ外の場合はnullptr)
+        size_t      Size    = 0;        // 領域のサイズ [バイト]
+    };
+
+    std::vector<CHUNK>              m_Chunks;               // チャンク群 (サイズは倍々に増加する)
+    size_t                          m_Bytes;                // 確保を要求された合計サイズ [バイト]
+    size_t                          m_Reserved;             // チャンク群の合計サイズ [バイト]
+    void                            *m_Last;                // 最後に確保した領域 (再確保時にその場で拡張するため)
+
+    static thread_local XmlArena    *t_Active;              // 呼び出し元のスレッドで有効なアリーナ
+    static std::atomic<bool>        s_Installed;            // メモリ関数を登録したかどうか
+
+private:    // Methods
+    void                *allocate(size_t size);                     // アリーナから領域を確保
+    static BLOCK        *header(const void *ptr);                   // 領域の先頭に格納した情報 (所有するアリーナおよびサイズ)
+
+    static void         *hookMalloc(size_t size);                   // libxml2のメモリ関数 (malloc)
+    static void         *hookRealloc(void *ptr, size_t size);       // libxml2のメモリ関数 (realloc)
+    static void         hookFree(void *ptr);                        // libxml2のメモリ関数 (free)
+    static char         *hookStrdup(const char *str);               // libxml2のメモリ関数 (strdup)
+
+public:     // Methods
+    XmlArena();
+    ~XmlArena();
+    XmlArena(const XmlArena&)             = delete;
+    XmlArena& operator=(const XmlArena&)  = delete;
+
+    static bool         install();                                  // libxml2のメモリ関数を登録 (xmlInitParser()関数より前に呼ぶ必要がある)
+    static bool         isInstalled();                              // メモリ関数を登録したかどうか
+
+    void                activate();                                 // 呼び出し元のスレッドでアリーナを有効にする
+    void                deactivate();                               // 呼び出し元のスレッドでアリーナを無効にする
+    [[nodiscard]] size_t bytes() const;                             // 確保を要求された合計サイズ [バイト]
+    [[nodiscard]] size_t reserved() const;                          // チャンク群の合計サイズ [バイト]
+};
+
+
+#endif // XMLARENA_H
@@ -0,0 +1,41 @@
+#ifndef XMLPTR_H
+#define XMLPTR_H
+
+#include <QString>
+#include <memory>
+#include <libxml/tree.h>
+#include <libxml/xpath.h>
+
+
+// libxml2のリソースを所有するスマートポインタ群
+// スコープを抜ける時 (早期リターンを含む) に、各リソースに対応する解放関数を自動的に呼ぶ
+namespace XmlPtr
+{
+    struct DocDeleter           { void operator()(xmlDoc *p) const              { xmlFreeDoc(p); } };
+    struct XPathContextDeleter  { void operator()(xmlXPathContext *p) const     { xmlXPathFreeContext(p); } };
+    struct XPathObjectDeleter   { void operator()(xmlXPathObject *p) const      { xmlXPathFreeObject(p); } };
+    struct CharDeleter          { void operator()(xmlChar *p) const             { xmlFree(p); } };
+
+    using Doc           = std::unique_ptr<xmlDoc, DocDeleter>;                  // xmlDocPtr (xmlFreeDoc()関数で解放)
+    using XPathContext  = std::unique_ptr<xmlXPathContext, XPathContextDeleter>;   // xmlXPathContextPtr (xmlXPathFreeContext()関数で解放)
+    using XPathObject   = std::unique_ptr<xmlXPathObject, XPathObjectDeleter>;     // xmlXPathObjectPtr (xmlXPathFreeObject()関数で解放)
+    using Char          = std::unique_ptr<xmlChar, CharDeleter>;                // xmlChar* (xmlFree()関数で解放)
+
+
+    // ノードのテキストを取得 (xmlNodeGetContent()関数の戻り値は解放する)
+    inline QString content(const xmlNode *node)
+    {
+        Char text(xmlNodeGetContent(node));
+        return text ? QString::fromUtf8(reinterpret_cast<const char*>(text.get())) : QString("");
+    }
+
+
+    // 文字列をxmlChar*に変換 (XPath式等)
+    inline Char fromString(const QString &str)
+    {
+        return Char(xmlStrdup(reinterpret_cast<const xmlChar*>(str.toUtf8().constData())));
+    }
+}
+
+
+#endif // XMLPTR_H
@@ -0,0 +1,178 @@
+// libxml2のメモリアリーナ (XmlArena) の有無で、パースおよび解放の処理時間とメモリ使用量を比較する
+// 使用方法 : qnewsflash_arenabench [-n <繰り返し回数>] [-m <heap | arena | both>] <保存したニュース記事のHTMLファイル> ...
+// 各HTMLファイルをパースして全てのノードを走査した後、ドキュメントを破棄するまでの処理時間、1つのドキュメントあたりのサイズ、
+// および、ヒープの断片化 (解放済みだがOSに返却されていない領域) を表示する
+// ヒープの断片化を正確に比較する場合は、-m heap と -m arena を別のプロセスで実行すること
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <libxml/HTMLparser.h>
+#include <libxml/tree.h>
+#include <iostream>
+#include <algorithm>
+#include <memory>
+#include <malloc.h>
+#include "../XmlArena.h"
+
+
+// ヒープの使用状況 [バイト]
+struct HEAP_INFO {
+    qint64  Arena   = -1;   // ヒープの合計サイズ
+    qint64  Free    = -1;   // ヒープ内の解放済みの領域の合計サイズ
+};
+
+
+static HEAP_INFO heapInfo()
+{
+    HEAP_INFO info;
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    auto mi    = mallinfo2();
+    info.Arena = static_cast<qint64>(mi.arena);
+    info.Free  = static_cast<qint64>(mi.fordblks);
+#endif
+
+    return info;
+}
+
+
+// 全てのノードを再帰的に走査 (ニュース記事の本文の抽出と同程度の負荷)
+static qint64 walk(xmlNodePtr node)
+{
+    qint64 count = 0;
+
+    for (auto cur = node; cur != nullptr; cur = cur->next) {
+        if (cur->content != nullptr) count += xmlStrlen(cur->content);
+        count += 1 + walk(cur->children);
+    }
+
+    return count;
+}
+
+
+// パース、走査、破棄を繰り返して計測
+static int measure(const QList<QByteArray> &pages, int iterations, bool useArena)
+{
+    qint64        sink      = 0;
+    qint64        bytes     = 0;
+    qint64        peak      = 0;
+    qint64        freeNsec  = 0;
+    QElapsedTimer timer;
+    QElapsedTimer freeTimer;
+
+    const auto before = heapInfo();
+    timer.start();
+
+    for (auto n = 0; n < iterations; n++) {
+        for (const auto &data : pages) {
+            // アリーナはパースから走査までの間のみ有効にして、走査の後にドキュメントを含めてアリーナごと解放する (ParserPoolクラスと同様)
+            std::unique_ptr<XmlArena> arena;
+            if (useArena) {
+                xmlResetLastError();
+                arena = std::make_unique<XmlArena>();
+                arena->activate();
+            }
+
+            auto doc = htmlReadMemory(data.constData(), static_cast<int>(data.size()), nullptr, "UTF-8",
+                                      HTML_PARSE_RECOVER | HTML_PARSE_NOERROR | HTML_PARSE_NOWARNING);
+            if (doc == nullptr) {
+                std::cerr << "エラー : パースに失敗" << std::endl;
+                return -1;
+            }
+
+            sink += walk(xmlDocGetRootElement(doc));
+            xmlResetLastError();
+
+            freeTimer.start();
+            if (arena != nullptr) {
+                arena->deactivate();
+                bytes += static_cast<qint64>(arena->bytes());
+                peak   = std::max(peak, static_cast<qint64>(arena->reserved()));
+                arena.reset();
+            }
+            else {
+                xmlFreeDoc(doc);
+            }
+            freeNsec += freeTimer.nsecsElapsed();
+        }
+    }
+
+    const auto elapsed = timer.nsecsElapsed();
+    const auto after   = heapInfo();
+    const auto docs    = static_cast<qint64>(pages.size()) * iterations;
+
+    if (sink < 0) std::cout << sink << std::endl;   // 最適化による除去を防ぐ
+
+    std::cout << QString("%1 : 合計 %2 [ミリ秒], 解放 %3 [ミリ秒], 1文書あたり %4 [マイクロ秒]")
+                 .arg(useArena ? "アリーナ" : "ヒープ  ")
+                 .arg(elapsed / 1e6, 0, 'f', 2).arg(freeNsec / 1e6, 0, 'f', 2).arg(elapsed / 1e3 / docs, 0, 'f', 1).toStdString() << std::endl;
+
+    if (useArena) {
+        std::cout << QString("           1文書あたりの要求サイズ %1 [KB], チャンクの最大サイズ %2 [KB]")
+                     .arg(bytes / 1024.0 / docs, 0, 'f', 1).arg(peak / 1024.0, 0, 'f', 1).toStdString() << std::endl;
+    }
+
+    if (after.Arena >= 0) {
+        std::cout << QString("           ヒープ %1 -> %2 [KB], 解放済み領域 %3 -> %4 [KB]")
+                     .arg(before.Arena / 1024).arg(after.Arena / 1024).arg(before.Free / 1024).arg(after.Free / 1024).toStdString() << std::endl;
+    }
+
+    return 0;
+}
+
+
+int main(int argc, char *argv[])
+{
+    // メモリ関数は、libxml2の初期化より前に登録する必要がある
+    if (!XmlArena::install()) {
+        std::cerr << "エラー : libxml2のメモリ関数の登録に失敗" << std::endl;
+        return -1;
+    }
+
+    xmlInitParser();
+
+    QCoreApplication app(argc, argv);
+
+    auto args       = app.arguments();
+    auto iterations = 200;
+    auto mode       = QString("both");
+    args.removeFirst();
+
+    while (args.size() >= 2 && (args.at(0) == "-n" || args.at(0) == "-m")) {
+        if (args.at(0) == "-n") iterations = std::max(1, args.at(1).toInt());
+        else                    mode       = args.at(1);
+        args.removeFirst();
+        args.removeFirst();
+    }
+
+    if (args.isEmpty() || (mode != "heap" && mode != "arena" && mode != "both")) {
+        std::cerr << "使用方法 : qnewsflash_arenabench [-n <繰り返し回数>] [-m <heap | arena | both>] <HTMLファイル> ..." << std::endl;
+        return -1;
+    }
+
+    QList<QByteArray> pages;
+    qint64            totalBytes = 0;
+
+    for (const auto &path : std::as_const(args)) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            std::cerr << QString("エラー : %1 のオープンに失敗 %2").arg(path, file.errorString()).toStdString() << std::endl;
+            return -1;
+        }
+
+        pages.append(file.readAll());
+        totalBytes += pages.last().size();
+        file.close();
+    }
+
+    std::cout << QString("ファイル数 : %1, 合計サイズ : %2 [KB], 繰り返し回数 : %3").arg(pages.size()).arg(totalBytes / 1024).arg(iterations).toStdString() << std::endl;
+
+    if (mode != "arena" && measure(pages, iterations, false) != 0) return -1;
+    if (mode != "heap"  && measure(pages, iterations, true)  != 0) return -1;
+
+    xmlCleanupParser();
+
+    return 0;
+}
@@ -0,0 +1,448 @@
+#include <QtGlobal>
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    #include <QStringEncoder>
+    #include <QStringDecoder>
+#else
+    #include <QTextCodec>
+#endif
+
+#include <QDateTime>
+#include <QTimeZone>
+#include <QLocale>
+#include <QCryptographicHash>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <iostream>
+#include "BoardEmulator.h"
+
+
+BoardEmulator::BoardEmulator(QObject *parent) : QObject{parent}, m_AgeCounter(0), m_LastKey(0)
+{
+    connect(&m_Server, &QTcpServer::newConnection, this, &BoardEmulator::onNewConnection);
+}
+
+
+// 掲示板エミュレータの動作に関する設定を指定
+void BoardEmulator::setBoardInfo(const BOARDEMULATOR_INFO &info)
+{
+    m_Info = info;
+}
+
+
+// 待ち受けを開始
+bool BoardEmulator::listen(quint16 port)
+{
+    if (!m_Server.listen(QHostAddress::LocalHost, port)) {
+        std::cerr << QString("エラー : 掲示板エミュレータの起動に失敗 %1").arg(m_Server.errorString()).toStdString() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+
+// 掲示板のURL
+QString BoardEmulator::url() const
+{
+    return QString("http://127.0.0.1:%1").arg(m_Server.serverPort());
+}
+
+
+// bbs.cgiのURL
+QString BoardEmulator::requestUrl() const
+{
+    return url() + "/test/bbs.cgi";
+}
+
+
+// スレッドのURL
+QString BoardEmulator::threadUrl(const QString &key) const
+{
+    return QString("%1/test/read.cgi/%2/%3/").arg(url(), m_Info.Bbs, key);
+}
+
+
+// スレッドのレス数
+int BoardEmulator::responseCount(const QString &key) const
+{
+    auto it = m_Threads.constFind(key);
+
+    return it == m_Threads.constEnd() ? -1 : static_cast<int>(it->Responses.size());
+}
+
+
+// 書き込みの統計情報を取得
+BoardEmulator::STATS BoardEmulator::stats() const
+{
+    return m_Stats;
+}
+
+
+// 新しい接続を受け付けた時の処理
+void BoardEmulator::onNewConnection()
+{
+    while (auto pSocket = m_Server.nextPendingConnection()) {
+        connect(pSocket, &QTcpSocket::readyRead, this, [this, pSocket]() { onReadyRead(pSocket); });
+        connect(pSocket, &QTcpSocket::disconnected, this, [this, pSocket]() {
+            m_Buffers.remove(pSocket);
+            pSocket->deleteLater();
+        });
+    }
+}
+
+
+// リクエストを受信した時の処理
+// リクエストヘッダおよびボディ (Content-Lengthヘッダのサイズ) を全て受信した後に、レスポンスを返して接続を閉じる
+void BoardEmulator::onReadyRead(QTcpSocket *socket)
+{
+    auto &buffer = m_Buffers[socket];
+    buffer.append(socket->readAll());
+
+    const auto headEnd = buffer.indexOf("\r\n\r\n");
+    if (headEnd < 0) return;
+
+    const auto lines       = buffer.left(headEnd).split('\n');
+    const auto requestLine = lines.value(0).trimmed().split(' ');
+
+    QHash<QByteArray, QByteArray> headers;
+    for (auto i = 1; i < lines.size(); i++) {
+        const auto colon = lines.at(i).indexOf(':');
+        if (colon > 0) headers.insert(lines.at(i).left(colon).trimmed().toLower(), lines.at(i).mid(colon + 1).trimmed());
+    }
+
+    const auto contentLength = headers.value("content-length").toLongLong();
+    if (buffer.size() < headEnd + 4 + contentLength) return;
+
+    const auto body = buffer.mid(headEnd + 4, contentLength);
+    m_Buffers.remove(socket);
+
+    m_Stats.Requests++;
+
+    const auto response = handle(requestLine.value(0), requestLine.value(1), headers, body, socket->peerAddress().toString());
+    m_Stats.Bytes += response.size();
+
+    socket->write(response);
+    socket->disconnectFromHost();
+}
+
+
+// リクエストを処理して、レスポンスを生成
+QByteArray BoardEmulator::handle(const QByteArray &method, const QByteArray &target,
+                                 const QHash<QByteArray, QByteArray> &headers, const QByteArray &body, const QString &client)
+{
+    const auto path        = QString::fromLatin1(target).section('?', 0, 0);
+    const auto contentType = "text/html; charset=" + charset().toLatin1();
+
+    // bbs.cgi
+    if (path == "/test/bbs.cgi") {
+        if (method == "POST") return post(headers, body, client);
+
+        // クッキーの発行
+        const auto cookie = QByteArray::number(QRandomGenerator::global()->generate64(), 16);
+        m_Cookies.insert(cookie);
+
+        return httpResponse(200, "OK", contentType, encode(resultPage("書き込み確認", "クッキーを発行しました。")),
+                            "Set-Cookie: 0chSID=" + cookie + "; path=/\r\n");
+    }
+
+    // スレッドのHTML
+    static const QString readPrefix = "/test/read.cgi/";
+    if (path.startsWith(readPrefix)) {
+        const auto parts = path.mid(readPrefix.size()).split('/');
+        if (parts.value(0) == m_Info.Bbs) return httpResponse(200, "OK", contentType, readThread(parts.value(1)));
+    }
+
+    // スレッドのdat
+    const auto datPrefix = QString("/%1/dat/").arg(m_Info.Bbs);
+    if (path.startsWith(datPrefix) && path.endsWith(".dat")) {
+        const auto key = path.mid(datPrefix.size()).chopped(4);
+        if (m_Threads.contains(key)) {
+            return httpResponse(200, "OK", "text/plain; charset=" + charset().toLatin1(), dat(key));
+        }
+    }
+
+    // スレッドの一覧
+    if (path == QString("/%1/subject.txt").arg(m_Info.Bbs)) {
+        return httpResponse(200, "OK", "text/plain; charset=" + charset().toLatin1(), subject());
+    }
+
+    return httpResponse(404, "Not Found", "text/plain", "404 Not Found");
+}
+
+
+// 書き込みを処理
+// keyが空欄の場合はスレッドを作成して、それ以外の場合は既存のスレッドに書き込む
+// 成功した場合は、0ch系と同様にRefreshヘッダでスレッドのURLを返す (HtmlFetcher::extractThreadPath()メソッドで抽出される)
+QByteArray BoardEmulator::post(const QHash<QByteArray, QByteArray> &headers, const QByteArray &body, const QString &client)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const auto contentType = "text/html; charset=" + charset().toLatin1();
+    auto reject = [this, &contentType, &timer](const QString &message) {
+        m_Stats.Rejected++;
+        m_Stats.PostNsec += timer.nsecsElapsed();
+        return httpResponse(200, "OK", contentType, encode(resultPage("ＥＲＲＯＲ！", "ＥＲＲＯＲ：" + message)));
+    };
+
+    // POSTデータのデコード (各値はパーセントエンコード済み)
+    QHash<QString, QString> form;
+    for (const auto &pair : body.split('&')) {
+        const auto equal = pair.indexOf('=');
+        if (equal < 0) continue;
+
+        form.insert(QString::fromLatin1(pair.left(equal)), decode(QByteArray::fromPercentEncoding(pair.mid(equal + 1))));
+    }
+
+    // クッキーの確認
+    if (m_Info.RequireCookie) {
+        const auto cookieHeader = headers.value("cookie");
+        const auto start        = cookieHeader.indexOf("0chSID=");
+        const auto cookie       = start < 0 ? QByteArray() : cookieHeader.mid(start + 7).split(';').value(0).trimmed();
+        if (!m_Cookies.contains(cookie)) return reject("クッキーがありません。");
+    }
+
+    if (form.value("bbs") != m_Info.Bbs) return reject("板が存在しません。");
+
+    const auto message = form.value("MESSAGE");
+    if (message.trimmed().isEmpty()) return reject("本文がありません。");
+
+    QString key = form.value("key");
+    if (key.isEmpty()) {
+        // スレッドの作成
+        const auto subject = form.value("subject").trimmed();
+        if (subject.isEmpty()) return reject("サブジェクトが存在しません。");
+
+        m_LastKey = std::max(QDateTime::currentSecsSinceEpoch(), m_LastKey + 1);
+        key       = QString::number(m_LastKey);
+
+        THREAD thread;
+        thread.Key   = key;
+        thread.Title = escapeHtml(subject);
+        thread.Owner = client;
+        thread.Age   = ++m_AgeCounter;
+        thread.Responses.append(makeResponse(form.value("FROM"), form.value("mail"), message, client));
+        applyCommands(thread, message, client);
+
+        m_Threads.insert(key, thread);
+        m_Stats.Threads++;
+        fallThreads();
+    }
+    else {
+        // 既存のスレッドへの書き込み
+        auto it = m_Threads.find(key);
+        if (it == m_Threads.end()) return reject("該当するスレッドは存在しません。");
+        if (it->Responses.size() >= m_Info.MaxResponses) {
+            return reject(QString("このスレッドは%1を超えました。もう書けないので、新しいスレッドを立ててください。").arg(m_Info.MaxResponses));
+        }
+
+        it->Responses.append(makeResponse(form.value("FROM"), form.value("mail"), message, client));
+
+        // sageの場合は、スレッドの並び順を変更しない
+        if (form.value("mail").compare("sage", Qt::CaseInsensitive) != 0) it->Age = ++m_AgeCounter;
+
+        applyCommands(*it, message, client);
+    }
+
+    m_Stats.Posts++;
+    m_Stats.PostNsec += timer.nsecsElapsed();
+
+    const auto refresh = QString("1;URL=/test/read.cgi/%1/%2/l10#bottom").arg(m_Info.Bbs, key);
+
+    return httpResponse(200, "OK", contentType, encode(resultPage("書きこみました。", "書きこみが終わりました。", refresh)));
+}
+
+
+// !chtt、!hogo、!bottomコマンドを適用
+// いずれのコマンドも、スレッドを作成したクライアントの書き込みのみ有効とする
+void BoardEmulator::applyCommands(THREAD &thread, const QString &message, const QString &client)
+{
+    if (thread.Owner != client) return;
+
+    // !chtt : 本文の1行目 (!chttの後) をスレッドのタイトルにする
+    if (message.startsWith("!chtt")) {
+        const auto title = message.mid(5).section('\n', 0, 0).trimmed();
+        if (!title.isEmpty()) thread.Title = escapeHtml(title);
+    }
+
+    const auto lines = message.split('\n');
+    for (const auto &line : lines) {
+        const auto command = line.trimmed();
+
+        // !hogo : スレッドをdat落ちから保護する
+        if (command == "!hogo")   thread.Hogo = true;
+
+        // !bottom : スレッドを最下位に移動する (次にdat落ちする候補になる)
+        if (command == "!bottom") thread.Age = 0;
+    }
+}
+
+
+// 最大数を超えたスレッドをdat落ちさせる
+// 並び順が最下位のスレッドから落とすが、!hogoコマンドで保護されたスレッドは落とさない
+void BoardEmulator::fallThreads()
+{
+    while (m_Threads.size() > m_Info.MaxThreads) {
+        auto victim = m_Threads.end();
+        for (auto it = m_Threads.begin(); it != m_Threads.end(); ++it) {
+            if (!it->Hogo && (victim == m_Threads.end() || it->Age < victim->Age)) victim = it;
+        }
+
+        if (victim == m_Threads.end()) break;
+
+        m_Fallen.insert(victim.key());
+        m_Threads.erase(victim);
+        m_Stats.Fallen++;
+    }
+}
+
+
+// レスを生成
+// 日時は日本時間、IDはクライアントのアドレスと日付から生成する
+BoardEmulator::RESPONSE BoardEmulator::makeResponse(const QString &name, const QString &mail, const QString &message, const QString &client) const
+{
+    const auto now = QDateTime::currentDateTime().toTimeZone(QTimeZone("Asia/Tokyo"));
+    const auto id  = QCryptographicHash::hash((client + now.toString("yyyyMMdd")).toUtf8(), QCryptographicHash::Sha1).toBase64().left(8);
+
+    RESPONSE response;
+    response.Name    = name.isEmpty() ? QString("名無しさん") : escapeHtml(name);
+    response.Mail    = escapeHtml(mail);
+    response.Date    = QLocale(QLocale::Japanese, QLocale::Japan).toString(now, "yyyy/MM/dd(ddd) HH:mm:ss.zzz").chopped(1) + " ID:" + QString::fromLatin1(id);
+    response.Message = escapeHtml(message).replace("\r\n", "\n").replace("\n", " <br> ");
+
+    return response;
+}
+
+
+// スレッドのHTMLを生成
+// レス番号は、設定ファイルのthreadxpathキーの既定値 (/html/body/div/dl[@class='thread']/div/@id) で取得できる構造にする
+QByteArray BoardEmulator::readThread(const QString &key) const
+{
+    auto it = m_Threads.constFind(key);
+    if (it == m_Threads.constEnd()) {
+        // dat落ち、または、存在しないスレッド (設定ファイルのexpiredelementキーの既定値と同じタイトルを返す)
+        return encode(resultPage("指定されたスレッドは存在しません", "指定されたスレッドは存在しません。"));
+    }
+
+    QString html = QString("<html><head><meta http-equiv=\"Content-Type\" content=\"text/html; charset=%1\"><title>%2</title></head>\n"
+                           "<body><div><h1>%2</h1><dl class=\"thread\">\n").arg(charset(), it->Title);
+
+    for (auto i = 0; i < it->Responses.size(); i++) {
+        const auto &response = it->Responses.at(i);
+        html += QString("<div id=\"%1\" class=\"post\"><dt>%1 ：<b>%2</b>：%3</dt><dd> %4 </dd></div>\n")
+                    .arg(QString::number(i + 1), response.Name, response.Date, response.Message);
+    }
+
+    html += "</dl></div></body></html>\n";
+
+    return encode(html);
+}
+
+
+// スレッドのdatを生成 (名前<>メール欄<>日時 ID<>本文<>タイトル)
+QByteArray BoardEmulator::dat(const QString &key) const
+{
+    const auto thread = m_Threads.value(key);
+
+    QString text;
+    for (auto i = 0; i < thread.Responses.size(); i++) {
+        const auto &response = thread.Responses.at(i);
+        text += QString("%1<>%2<>%3<> %4 <>%5\n").arg(response.Name, response.Mail, response.Date, response.Message, i == 0 ? thread.Title : QString());
+    }
+
+    return encode(text);
+}
+
+
+// スレッドの一覧を生成 (上位から順)
+QByteArray BoardEmulator::subject() const
+{
+    auto threads = m_Threads.values();
+    std::sort(threads.begin(), threads.end(), [](const THREAD &a, const THREAD &b) { return a.Age > b.Age; });
+
+    QString text;
+    for (const auto &thread : std::as_const(threads)) {
+        text += QString("%1.dat<>%2 (%3)\n").arg(thread.Key, thread.Title).arg(thread.Responses.size());
+    }
+
+    return encode(text);
+}
+
+
+// 書き込みの結果のHTMLを生成
+QString BoardEmulator::resultPage(const QString &title, const QString &message, const QString &refresh) const
+{
+    return QString("<html><head><meta http-equiv=\"Content-Type\" content=\"text/html; charset=%1\">%2<title>%3</title></head>"
+                   "<body>%4</body></html>\n")
+               .arg(charset(),
+                    refresh.isEmpty() ? QString() : QString("<meta http-equiv=\"Refresh\" content=\"%1\">").arg(refresh),
+                    title, message);
+}
+
+
+// 掲示板の文字コード名
+QString BoardEmulator::charset() const
+{
+    return m_Info.ShiftJIS ? QString("Shift_JIS") : QString("UTF-8");
+}
+
+
+// 掲示板の文字コードにエンコード
+QByteArray BoardEmulator::encode(const QString &text) const
+{
+    if (!m_Info.ShiftJIS) return text.toUtf8();
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    QStringEncoder encoder("Shift-JIS");
+    return encoder(text);
+#else
+    auto codec = QTextCodec::codecForName("Shift-JIS");
+    return codec->fromUnicode(text);
+#endif
+}
+
+
+// 掲示板の文字コードからデコード
+QString BoardEmulator::decode(const QByteArray &data) const
+{
+    if (!m_Info.ShiftJIS) return QString::fromUtf8(data);
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    QStringDecoder decoder("Shift-JIS");
+    return decoder(data);
+#else
+    auto codec = QTextCodec::codecForName("Shift-JIS");
+    return codec->toUnicode(data);
+#endif
+}
+
+
+// HTTPレスポンスを生成
+QByteArray BoardEmulator::httpResponse(int status, const QByteArray &reason, const QByteArray &contentType,
+                                       const QByteArray &body, const QByteArray &extraHeaders)
+{
+    return "HTTP/1.1 " + QByteArray::number(status) + " " + reason + "\r\n"
+           "Content-Type: " + contentType + "\r\n" + extraHeaders +
+           "Content-Length: " + QByteArray::number(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+}
+
+
+// HTMLの特殊文字をエスケープ
+// 文字参照 (&#...;) は、Shift-JISに変換できない文字の表現に使用されるため、そのまま残す
+QString BoardEmulator::escapeHtml(const QString &text)
+{
+    QString escaped;
+    escaped.reserve(text.size());
+
+    for (auto i = 0; i < text.size(); i++) {
+        const auto c = text.at(i);
+        if (c == '<')                                                       escaped += "&lt;";
+        else if (c == '>')                                                  escaped += "&gt;";
+        else if (c == '"')                                                  escaped += "&quot;";
+        else if (c == '&' && (i + 1 >= text.size() || text.at(i + 1) != '#')) escaped += "&amp;";
+        else                                                                escaped += c;
+    }
+
+    return escaped;
+}
@@ -0,0 +1,113 @@
+#ifndef BOARDEMULATOR_H
+#define BOARDEMULATOR_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QList>
+#include <QByteArray>
+#include <QElapsedTimer>
+
+
+// 掲示板エミュレータの動作に関する設定
+struct BOARDEMULATOR_INFO {
+    QString     Bbs             = "news";   // BBS名
+    bool        ShiftJIS        = true;     // レスポンスおよびPOSTデータの文字コードをShift-JISにするかどうか (falseの場合はUTF-8)
+    int         MaxResponses    = 1000;     // スレッドの最大レス数 (これを超える書き込みはエラー)
+    int         MaxThreads      = 100;      // 板に保持するスレッドの最大数 (これを超える場合は、最下位の保護されていないスレッドをdat落ちさせる)
+    bool        RequireCookie   = true;     // bbs.cgiへのGETで発行したクッキーが無い書き込みをエラーにするかどうか
+};
+
+
+// 0ch互換の掲示板エミュレータ (ローカルのHTTPサーバ)
+// Posterクラス、HtmlFetcherクラス、WriteModeクラスが使用する以下のURLに応答する
+//   GET  /test/bbs.cgi                     : クッキーの発行
+//   POST /test/bbs.cgi                     : スレッドの作成 (keyが空欄)、既存のスレッドへの書き込み
+//   GET  /test/read.cgi/<BBS名>/<スレッド番号>/ : スレッドのHTML (dat落ちしたスレッドは「指定されたスレッドは存在しません」)
+//   GET  /<BBS名>/dat/<スレッド番号>.dat     : スレッドのdat
+//   GET  /<BBS名>/subject.txt               : スレッドの一覧 (上位から順)
+// 書き込みの本文の!chtt (スレッドのタイトルの変更)、!hogo (dat落ちの保護)、!bottom (スレッドを最下位に移動) コマンドに対応する
+class BoardEmulator : public QObject
+{
+    Q_OBJECT
+
+public:     // Variables
+    // 書き込みの統計情報
+    struct STATS {
+        qint64      Requests        = 0;    // 受信したリクエストの数
+        qint64      Posts           = 0;    // 成功した書き込みの数 (スレッドの作成を含む)
+        qint64      Threads         = 0;    // 作成したスレッドの数
+        qint64      Rejected        = 0;    // エラーにした書き込みの数
+        qint64      Fallen          = 0;    // dat落ちしたスレッドの数
+        qint64      PostNsec        = 0;    // 書き込みの処理時間の合計 [ナノ秒] (サーバ内部のみ)
+        qint64      Bytes           = 0;    // 送信したレスポンスの合計サイズ [バイト] (ヘッダを含む)
+    };
+
+private:    // Variables
+    // レス
+    struct RESPONSE {
+        QString     Name;                   // 名前欄
+        QString     Mail;                   // メール欄
+        QString     Date;                   // 日時およびID
+        QString     Message;                // 本文 (HTMLエスケープ済み)
+    };
+
+    // スレッド
+    struct THREAD {
+        QString             Key;            // スレッド番号
+        QString             Title;          // スレッドのタイトル
+        QList<RESPONSE>     Responses;      // レス群
+        QString             Owner;          // スレッドを作成したクライアントのアドレス (!chtt、!hogoコマンドの権限)
+        bool                Hogo    = false;    // !hogoコマンドで保護されているかどうか
+        qint64              Age     = 0;    // 並び順 (大きいほど上位、!bottomコマンドの場合は0)
+    };
+
+    QTcpServer                          m_Server;       // 待ち受け用のソケット
+    BOARDEMULATOR_INFO                  m_Info;         // 掲示板エミュレータの動作に関する設定
+    QMap<QString, THREAD>               m_Threads;      // スレッド番号をキーとした生存しているスレッド群
+    QSet<QString>                       m_Fallen;       // dat落ちしたスレッド番号群
+    QSet<QByteArray>                    m_Cookies;      // 発行したクッキーの値
+    QHash<QTcpSocket*, QByteArray>      m_Buffers;      // 接続ごとの受信途中のリクエスト
+    qint64                              m_AgeCounter;   // スレッドの並び順の採番
+    qint64                              m_LastKey;      // 最後に作成したスレッド番号
+    STATS                               m_Stats;        // 書き込みの統計情報
+
+private:    // Methods
+    void                onNewConnection();                                                      // 新しい接続を受け付けた時の処理
+    void                onReadyRead(QTcpSocket *socket);                                        // リクエストを受信した時の処理
+    QByteArray          handle(const QByteArray &method, const QByteArray &target,              // リクエストを処理して、レスポンスを生成
+                               const QHash<QByteArray, QByteArray> &headers, const QByteArray &body, const QString &client);
+    QByteArray          post(const QHash<QByteArray, QByteArray> &headers, const QByteArray &body, const QString &client);   // 書き込みを処理
+    QByteArray          readThread(const QString &key) const;                                   // スレッドのHTMLを生成
+    QByteArray          dat(const QString &key) const;                                          // スレッドのdatを生成
+    QByteArray          subject() const;                                                        // スレッドの一覧を生成
+    void                applyCommands(THREAD &thread, const QString &message, const QString &client);   // !chtt、!hogo、!bottomコマンドを適用
+    void                fallThreads();                                                          // 最大数を超えたスレッドをdat落ちさせる
+    RESPONSE            makeResponse(const QString &name, const QString &mail, const QString &message, const QString &client) const;   // レスを生成
+    QString             resultPage(const QString &title, const QString &message, const QString &refresh = QString()) const;   // 書き込みの結果のHTMLを生成
+
+    [[nodiscard]] QString charset() const;                                                      // 掲示板の文字コード名
+    QByteArray          encode(const QString &text) const;                                      // 掲示板の文字コードにエンコード
+    QString             decode(const QByteArray &data) const;                                   // 掲示板の文字コードからデコード
+    static QByteArray   httpResponse(int status, const QByteArray &reason, const QByteArray &contentType,
+                                     const QByteArray &body, const QByteArray &extraHeaders = QByteArray());   // HTTPレスポンスを生成
+    static QString      escapeHtml(const QString &text);                                        // HTMLの特殊文字をエスケープ
+
+public:     // Methods
+    explicit BoardEmulator(QObject *parent = nullptr);
+    ~BoardEmulator() override = default;
+
+    void                setBoardInfo(const BOARDEMULATOR_INFO &info);                           // 掲示板エミュレータの動作に関する設定を指定
+    bool                listen(quint16 port = 0);                                               // 待ち受けを開始 (0の場合は空いているポート番号)
+    [[nodiscard]] QString url() const;                                                          // 掲示板のURL (例: http://127.0.0.1:18081)
+    [[nodiscard]] QString requestUrl() const;                                                   // bbs.cgiのURL (設定ファイルのthreadキーのrequesturlキーに指定する)
+    [[nodiscard]] QString threadUrl(const QString &key) const;                                  // スレッドのURL
+    [[nodiscard]] int   responseCount(const QString &key) const;                                // スレッドのレス数 (dat落ちまたは存在しない場合は-1)
+    [[nodiscard]] STATS stats() const;                                                          // 書き込みの統計情報を取得
+};
+
+
+#endif // BOARDEMULATOR_H
@@ -0,0 +1,59 @@
+// 0ch互換の掲示板エミュレータ
+// 使用方法 : qnewsflash_board [-p <ポート番号>] [-b <BBS名>] [-r <最大レス数>] [-t <最大スレッド数>] [-u] [-n]
+// -u : UTF-8の掲示板 (既定はShift-JIS)、-n : クッキーの無い書き込みを許可
+// qNewsFlashの設定ファイルのthreadキーのrequesturlキーに、表示されたbbs.cgiのURLを指定して実行する
+
+#include <QCoreApplication>
+#include <QTimer>
+#include <csignal>
+#include <algorithm>
+#include <iostream>
+#include "BoardEmulator.h"
+
+
+static volatile std::sig_atomic_t g_Stop = 0;   // 終了シグナルを受信したかどうか
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    auto               args = app.arguments();
+    quint16            port = 18081;
+    BOARDEMULATOR_INFO info;
+
+    for (auto i = 1; i < args.size(); i++) {
+        if (args.at(i) == "-p" && i + 1 < args.size())      port              = static_cast<quint16>(args.at(++i).toUInt());
+        else if (args.at(i) == "-b" && i + 1 < args.size()) info.Bbs          = args.at(++i);
+        else if (args.at(i) == "-r" && i + 1 < args.size()) info.MaxResponses = std::max(1, args.at(++i).toInt());
+        else if (args.at(i) == "-t" && i + 1 < args.size()) info.MaxThreads   = std::max(1, args.at(++i).toInt());
+        else if (args.at(i) == "-u")                        info.ShiftJIS     = false;
+        else if (args.at(i) == "-n")                        info.RequireCookie = false;
+        else {
+            std::cerr << "使用方法 : qnewsflash_board [-p <ポート番号>] [-b <BBS名>] [-r <最大レス数>] [-t <最大スレッド数>] [-u] [-n]" << std::endl;
+            return -1;
+        }
+    }
+
+    BoardEmulator board;
+    board.setBoardInfo(info);
+    if (!board.listen(port)) return -1;
+
+    std::cout << QString("掲示板エミュレータ : %1 (BBS名 : %2)").arg(board.requestUrl(), info.Bbs).toStdString() << std::endl;
+
+    // Ctrl + Cで終了する時に、書き込みの統計情報を表示
+    // シグナルハンドラではフラグのみを設定して、イベントループから終了する
+    std::signal(SIGINT,  [](int) { g_Stop = 1; });
+    std::signal(SIGTERM, [](int) { g_Stop = 1; });
+
+    QTimer stopTimer;
+    QObject::connect(&stopTimer, &QTimer::timeout, &app, []() { if (g_Stop) QCoreApplication::quit(); });
+    stopTimer.start(200);
+
+    auto ret   = app.exec();
+    auto stats = board.stats();
+    std::cout << QString("リクエスト : %1, 書き込み : %2, スレッド作成 : %3, エラー : %4, dat落ち : %5")
+                 .arg(stats.Requests).arg(stats.Posts).arg(stats.Threads).arg(stats.Rejected).arg(stats.Fallen).toStdString() << std::endl;
+
+    return ret;
+}
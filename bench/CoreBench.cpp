@@ -0,0 +1,503 @@
+// qNewsFlashの主要な処理のマイクロベンチマーク (QtTestのQBENCHMARK)
+// 使用方法 : qnewsflash_bench [QtTestのオプション (例: -median 5 -csv)] [ベンチマーク名 ...]
+// 入力には、HttpReplayクラスの記録形式のコーパス (既定は bench/corpus) を使用するため、コミット間で結果を比較できる
+// 環境変数QNEWSFLASH_BENCH_CORPUSに、"replay"キーの"record"で記録したディレクトリを指定すると、実際の通信を入力にできる
+
+#include <QtTest>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <vector>
+#include "HttpReplayServer.h"
+#include "../Runner.h"
+#include "../HtmlFetcher.h"
+#include "../TextNormalizer.h"
+#include "../DuplicateIndex.h"
+#include "../PostedUrlFilter.h"
+#include "../ParserPool.h"
+#include "../HttpReplay.h"
+#include "../RateLimiter.h"
+#include "../DnsCache.h"
+#include "../XmlPtr.h"
+
+
+#ifndef QNEWSFLASH_BENCH_CORPUS
+    #define QNEWSFLASH_BENCH_CORPUS "bench/corpus"
+#endif
+
+
+class CoreBench : public QObject
+{
+    Q_OBJECT
+
+private:    // Variables
+    // コーパスに記録したレスポンス
+    struct DOCUMENT {
+        QString     Url;            // 記録したURL
+        QByteArray  Body;           // ボディ
+    };
+
+    QList<DOCUMENT>             m_Feeds;        // RSS群
+    QList<DOCUMENT>             m_Pages;        // ニュース記事のHTML群
+    QStringList                 m_Titles;       // RSSから抽出したタイトル群
+    QStringList                 m_Descriptions; // RSSから抽出した"description"要素群
+    QStringList                 m_IsoDates;     // RSSから抽出したISO 8601形式の日付群
+    QStringList                 m_RfcDates;     // RSSから抽出したRFC 2822形式の日付群
+    HttpReplayServer            m_Server;       // コーパスを配信する再生サーバ
+    QTemporaryDir               m_TempDir;      // ログファイル等を作成する一時ディレクトリ
+    std::unique_ptr<Runner>     m_pRunner;      // RSSの走査および日付の処理を計測するランナー
+
+private:    // Methods
+    int             loadCorpus(const QString &directory);                   // コーパスを読み込み、RSSとHTMLに分類
+    void            collect(xmlNode *node, const QString &parent);          // RSSからタイトル、本文、日付を抽出
+    [[nodiscard]] QByteArray feed(const QString &host) const;               // 指定したホストのRSSを取得 (存在しない場合は空)
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void parseRss_data();
+    void parseRss();
+    void itemTagsforHanJ();
+    void itemTagsforJiJi();
+    void parseHtml();
+    void extractParagraph_data();
+    void extractParagraph();
+    void normalize();
+    void convertNonSjisToReference();
+    void convertDate();
+    void convertDateHanJ();
+    void isToday();
+    void isHoursAgo();
+    void isDuplicate_data();
+    void isDuplicate();
+    void postedUrlFilter();
+    void writeLog_data();
+    void writeLog();
+};
+
+
+// コーパスを読み込み、Content-TypeヘッダでRSSとHTMLに分類
+int CoreBench::loadCorpus(const QString &directory)
+{
+    QDir dir(directory);
+    const auto files = dir.entryList({"*.json"}, QDir::Files, QDir::Name);
+
+    for (const auto &file : files) {
+        QFile metaFile(dir.filePath(file));
+        if (!metaFile.open(QIODevice::ReadOnly)) continue;
+
+        auto meta = QJsonDocument::fromJson(metaFile.readAll()).object();
+        if (meta["status"].toInt() != 200) continue;
+
+        QFile bodyFile(dir.filePath(meta["body"].toString()));
+        if (!bodyFile.open(QIODevice::ReadOnly)) continue;
+
+        QString contentType;
+        for (const auto &header : meta["headers"].toArray()) {
+            auto pair = header.toArray();
+            if (pair.at(0).toString().compare("Content-Type", Qt::CaseInsensitive) == 0) contentType = pair.at(1).toString();
+        }
+
+        DOCUMENT document{meta["url"].toString(), bodyFile.readAll()};
+        if (contentType.contains("xml") || contentType.contains("rss") || contentType.contains("rdf")) m_Feeds.append(document);
+        else if (contentType.contains("html"))                                                          m_Pages.append(document);
+    }
+
+    return static_cast<int>(m_Feeds.size() + m_Pages.size());
+}
+
+
+// RSSからタイトル、本文、日付を抽出
+void CoreBench::collect(xmlNode *node, const QString &parent)
+{
+    for (auto cur = node; cur; cur = cur->next) {
+        if (cur->type != XML_ELEMENT_NODE) continue;
+
+        const auto name = QString::fromUtf8(reinterpret_cast<const char*>(cur->name));
+        if (parent == "item") {
+            if (name == "title")            m_Titles.append(XmlPtr::content(cur));
+            else if (name == "description") m_Descriptions.append(XmlPtr::content(cur));
+            else if (name == "date")        m_IsoDates.append(XmlPtr::content(cur));
+            else if (name == "pubDate")     m_RfcDates.append(XmlPtr::content(cur));
+        }
+
+        collect(cur->children, name);
+    }
+}
+
+
+// 指定したホストのRSSを取得
+QByteArray CoreBench::feed(const QString &host) const
+{
+    for (const auto &document : m_Feeds) {
+        if (QUrl(document.Url).host() == host) return document.Body;
+    }
+
+    return {};
+}
+
+
+void CoreBench::initTestCase()
+{
+    auto directory = qEnvironmentVariable("QNEWSFLASH_BENCH_CORPUS", QStringLiteral(QNEWSFLASH_BENCH_CORPUS));
+    QVERIFY2(loadCorpus(directory) > 0, qPrintable(QString("コーパス %1 を読み込めません").arg(directory)));
+    QVERIFY(m_TempDir.isValid());
+
+    for (const auto &document : std::as_const(m_Feeds)) {
+        auto doc = ParserPool::getInstance()->parseXml(document.Body);
+        if (doc != nullptr) collect(xmlDocGetRootElement(doc.get()), QString());
+    }
+    QVERIFY2(!m_Titles.isEmpty(), "コーパスのRSSにitem要素が存在しません");
+
+    // ニュース記事の本文の取得は、コーパスを配信する再生サーバに送信する
+    QVERIFY(m_Server.load(directory) > 0);
+    QVERIFY(m_Server.listen());
+
+    REPLAY_INFO replayInfo;
+    replayInfo.Mode   = "replay";
+    replayInfo.Server = m_Server.url();
+    QCOMPARE(HttpReplay::getInstance()->setReplayInfo(replayInfo), 0);
+
+    DNSCACHE_INFO dnsCacheInfo;
+    dnsCacheInfo.Enable = false;
+    DnsCache::getInstance()->setDnsCacheInfo(dnsCacheInfo);
+
+    RATELIMIT_INFO rateLimitInfo;
+    rateLimitInfo.NewsRate  = 0.0;
+    rateLimitInfo.BoardRate = 0.0;
+    RateLimiter::getInstance()->setRateLimitInfo(rateLimitInfo);
+
+    // 公開日による除外を無効にするため、十分に長い期間を指定する
+    m_pRunner = std::make_unique<Runner>(QStringList{"qnewsflash_bench"}, QString());
+    m_pRunner->m_pNotifier->setEnabled(false);
+    m_pRunner->m_MaxParagraph = 100;
+    m_pRunner->m_WithinHours  = 24 * 365 * 50;
+    m_pRunner->m_HanJTopURL   = "https://japan.hani.co.kr";
+}
+
+
+void CoreBench::cleanupTestCase()
+{
+    m_pRunner.reset();
+    ParserPool::getInstance()->shutdown();
+}
+
+
+// RSSのパース
+void CoreBench::parseRss_data()
+{
+    QTest::addColumn<QByteArray>("body");
+
+    for (const auto &document : std::as_const(m_Feeds)) {
+        QTest::newRow(qPrintable(QUrl(document.Url).host())) << document.Body;
+    }
+}
+
+
+void CoreBench::parseRss()
+{
+    QFETCH(QByteArray, body);
+
+    QBENCHMARK {
+        auto doc = ParserPool::getInstance()->parseXml(body);
+        QVERIFY(doc != nullptr);
+    }
+}
+
+
+// ハンギョレジャパンのRSSの走査 ("description"要素の不要な文字列の除去、日付の変換を含む)
+void CoreBench::itemTagsforHanJ()
+{
+    auto body = feed("japan.hani.co.kr");
+    if (body.isEmpty()) QSKIP("コーパスにハンギョレジャパンのRSSが存在しません");
+
+    auto doc = ParserPool::getInstance()->parseXml(body);
+    QVERIFY(doc != nullptr);
+
+    QList<Runner::FEED_ITEM> items;
+
+    QBENCHMARK {
+        items.clear();
+        Runner::itemTagsforHanJ(xmlDocGetRootElement(doc.get()), m_pRunner->m_MaxParagraph, m_pRunner->m_HanJTopURL, items);
+    }
+
+    QVERIFY(!items.isEmpty());
+}
+
+
+// 時事ドットコムのRSSの走査 (URLの変換、日付の変換を含む)
+// 各ニュース記事の本文の取得は、書き込み対象の選別の後に非同期で実行するため含まない
+void CoreBench::itemTagsforJiJi()
+{
+    auto body = feed("www.jiji.com");
+    if (body.isEmpty()) QSKIP("コーパスに時事ドットコムのRSSが存在しません");
+
+    auto doc = ParserPool::getInstance()->parseXml(body);
+    QVERIFY(doc != nullptr);
+
+    QList<Runner::FEED_ITEM> items;
+
+    QBENCHMARK {
+        items.clear();
+        Runner::itemTagsforJiJi(xmlDocGetRootElement(doc.get()), items);
+    }
+
+    QVERIFY(!items.isEmpty());
+}
+
+
+// ニュース記事のHTMLのパース (全てのHTML)
+void CoreBench::parseHtml()
+{
+    QStringList pages;
+    for (const auto &document : std::as_const(m_Pages)) pages.append(QString::fromUtf8(document.Body));
+
+    QBENCHMARK {
+        for (const auto &page : std::as_const(pages)) {
+            auto doc = ParserPool::getInstance()->parseHtml(page);
+            QVERIFY(doc != nullptr);
+        }
+    }
+}
+
+
+// XPathによるニュース記事の本文の抽出 (パース済みの全てのHTML)
+void CoreBench::extractParagraph_data()
+{
+    QTest::addColumn<QString>("xpath");
+
+    QTest::newRow("meta description") << QString("//head/meta[@name='description']/@content");
+    QTest::newRow("article body")     << QString("/html/body/div[@id='Contents']//div[@id='Main']//article//div[contains(@class, 'ArticleText clearfix')]//p");
+}
+
+
+void CoreBench::extractParagraph()
+{
+    QFETCH(QString, xpath);
+
+    std::vector<XmlPtr::Doc> docs;
+    for (const auto &document : std::as_const(m_Pages)) {
+        auto doc = ParserPool::getInstance()->parseHtml(QString::fromUtf8(document.Body));
+        if (doc != nullptr) docs.push_back(std::move(doc));
+    }
+
+    HtmlFetcher fetcher(100);
+
+    QBENCHMARK {
+        for (const auto &doc : docs) {
+            fetcher.extractParagraph(doc.get(), xpath);
+        }
+    }
+}
+
+
+// 空白文字の除去および文字数の切り詰め
+void CoreBench::normalize()
+{
+    const TextNormalizer normalizer;
+
+    QBENCHMARK {
+        for (const auto &description : std::as_const(m_Descriptions)) {
+            auto text = normalizer.normalize(description, 100);
+            Q_UNUSED(text)
+        }
+    }
+}
+
+
+// Shift-JISに変換できない文字の文字参照への変換
+void CoreBench::convertNonSjisToReference()
+{
+    const auto message = m_Titles.join("\n") + "\n" + m_Descriptions.join("\n");
+
+    QBENCHMARK {
+        auto result = Poster::convertNonSjisToReference(message);
+        Q_UNUSED(result)
+    }
+}
+
+
+// ISO 8601形式の日付の変換
+void CoreBench::convertDate()
+{
+    if (m_IsoDates.isEmpty()) QSKIP("コーパスにISO 8601形式の日付が存在しません");
+
+    QBENCHMARK {
+        for (auto date : std::as_const(m_IsoDates)) {
+            auto result = Runner::convertDate(date);
+            Q_UNUSED(result)
+        }
+    }
+}
+
+
+// RFC 2822形式の日付の変換
+void CoreBench::convertDateHanJ()
+{
+    if (m_RfcDates.isEmpty()) QSKIP("コーパスにRFC 2822形式の日付が存在しません");
+
+    QBENCHMARK {
+        for (auto date : std::as_const(m_RfcDates)) {
+            auto result = Runner::convertDateHanJ(date);
+            Q_UNUSED(result)
+        }
+    }
+}
+
+
+// 今日の日付かどうかの確認
+void CoreBench::isToday()
+{
+    QStringList dates;
+    for (auto date : std::as_const(m_IsoDates)) dates.append(Runner::convertDate(date));
+
+    QBENCHMARK {
+        for (const auto &date : std::as_const(dates)) {
+            auto result = Runner::isToday(date);
+            Q_UNUSED(result)
+        }
+    }
+}
+
+
+// 指定時間以内の時刻かどうかの確認
+void CoreBench::isHoursAgo()
+{
+    QStringList dates;
+    for (auto date : std::as_const(m_IsoDates)) dates.append(Runner::convertDate(date));
+
+    QBENCHMARK {
+        for (const auto &date : std::as_const(dates)) {
+            auto result = m_pRunner->isHoursAgo(date);
+            Q_UNUSED(result)
+        }
+    }
+}
+
+
+// 類似ニュース記事の検索 (索引の登録数ごと)
+void CoreBench::isDuplicate_data()
+{
+    QTest::addColumn<int>("entries");
+
+    QTest::newRow("100")   << 100;
+    QTest::newRow("1000")  << 1000;
+    QTest::newRow("10000") << 10000;
+}
+
+
+void CoreBench::isDuplicate()
+{
+    QFETCH(int, entries);
+
+    // コーパスのタイトルに番号を付加して、類似しないタイトル群を登録
+    DuplicateIndex index;
+    const auto     now = QDateTime::currentSecsSinceEpoch();
+    for (auto i = 0; i < entries; i++) {
+        const auto &title = m_Titles.at(i % m_Titles.size());
+        index.add(QString("%1 %2 %3").arg(i * 7919).arg(title.right(title.size() / 2)).arg(i), QString(), now);
+    }
+
+    QBENCHMARK {
+        for (const auto &title : std::as_const(m_Titles)) {
+            auto result = index.isDuplicate(title);
+            Q_UNUSED(result)
+        }
+    }
+}
+
+
+// 書き込み済みのURLの長期間の記録の検索
+void CoreBench::postedUrlFilter()
+{
+    POSTEDFILTER_INFO info;
+    info.File = m_TempDir.filePath("posted.bin");
+
+    PostedUrlFilter filter;
+    filter.setPostedFilterInfo(info);
+    QCOMPARE(filter.open(), 0);
+
+    for (auto i = 0; i < 1000; i++) filter.add(QString("https://www.jiji.com/jc/article?k=2025101800%1&g=soc").arg(i, 4, 10, QChar('0')));
+
+    QStringList urls;
+    for (const auto &document : std::as_const(m_Pages)) urls.append(document.Url);
+
+    QBENCHMARK {
+        for (const auto &url : std::as_const(urls)) {
+            auto result = filter.contains(url);
+            Q_UNUSED(result)
+        }
+    }
+
+    filter.close();
+}
+
+
+// 書き込み済みのニュース記事のログファイルへの追記 (既存の書き込み数ごと)
+// ログファイルは計測の反復ごとに1件ずつ増加する (運用時と同様)
+// 書き込み用スレッドへの依頼、ファイルの読み込み、書き換えの合計を計測する
+void CoreBench::writeLog_data()
+{
+    QTest::addColumn<int>("entries");
+
+    QTest::newRow("0")    << 0;
+    QTest::newRow("100")  << 100;
+    QTest::newRow("1000") << 1000;
+}
+
+
+void CoreBench::writeLog()
+{
+    QFETCH(int, entries);
+
+    QJsonArray logs;
+    for (auto i = 0; i < entries; i++) {
+        QJsonObject threadObject;
+        threadObject["title"]  = "ニュース速報スレ";
+        threadObject["url"]    = "http://127.0.0.1:18081/test/read.cgi/news/1760832000/";
+        threadObject["key"]    = "1760832000";
+        threadObject["time"]   = "2025/10/19 09:00:00";
+        threadObject["new"]    = false;
+        threadObject["bottom"] = false;
+
+        QJsonObject object;
+        object["title"]     = m_Titles.at(i % m_Titles.size());
+        object["paragraph"] = m_Descriptions.value(i % std::max(1, static_cast<int>(m_Descriptions.size()))).left(100);
+        object["url"]       = QString("https://www.jiji.com/jc/article?k=2025101800%1&g=soc").arg(i, 4, 10, QChar('0'));
+        object["date"]      = "2025年10月19日 9時0分";
+        object["thread"]    = threadObject;
+        logs.append(object);
+    }
+
+    const auto logFile = m_TempDir.filePath(QString("qNewsFlash_log_%1.json").arg(entries));
+    QFile file(logFile);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(QJsonDocument(logs).toJson());
+    file.close();
+
+    auto pWriteMode = WriteMode::getInstance();
+    pWriteMode->setLogFile(logFile);
+
+    WRITE_INFO writeInfo{};
+    pWriteMode->setWriteInfo(writeInfo);
+
+    // 書き込み用スレッドでのファイルの書き換えまでを計測するため、書き込みの完了を待機する
+    PERSIST_INFO persistInfo;
+    persistInfo.Wait = true;
+    pWriteMode->setPersistInfo(persistInfo);
+
+    Article article(m_Titles.first(), m_Descriptions.value(0).left(100), "https://www.jiji.com/jc/article?k=2025101900100&g=soc", "2025年10月19日 9時0分");
+
+    QBENCHMARK {
+        QCOMPARE(pWriteMode->writeLog(article, "ニュース速報スレ", "http://127.0.0.1:18081/test/read.cgi/news/1760832000/", "1760832000"), 0);
+    }
+}
+
+
+QTEST_GUILESS_MAIN(CoreBench)
+
+#include "CoreBench.moc"
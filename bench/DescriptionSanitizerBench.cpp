@@ -0,0 +1,111 @@
+// DescriptionSanitizerクラスと、従来の正規表現による"description"要素の不要な文字列の除去の処理時間を比較する
+// 使用方法 : qnewsflash_sanitizebench [-n <繰り返し回数>]
+// 正規表現でバックトラックが多発する入力 (終了タグが無いtableタグ等) を含む複数の入力について、入力の長さごとの処理時間を表示する
+
+#include <QCoreApplication>
+#include <QStringList>
+#include <QRegularExpression>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include "../DescriptionSanitizer.h"
+
+
+// 入力文字列の種類
+struct INPUT {
+    QString                             Name;       // 入力の名前
+    std::function<QString(int)>         Generate;   // 指定した長さの入力文字列を生成
+};
+
+
+// 処理時間を計測 [マイクロ秒]
+static double measure(const std::function<QString(const QString&)> &func, const QString &input, int iterations)
+{
+    qsizetype     sink = 0;
+    QElapsedTimer timer;
+    timer.start();
+
+    for (auto n = 0; n < iterations; n++) {
+        sink += func(input).size();
+    }
+
+    auto elapsed = timer.nsecsElapsed();
+    if (sink < 0) std::cout << sink << std::endl;   // 最適化による除去を防ぐ
+
+    return static_cast<double>(elapsed) / iterations / 1000.0;
+}
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    auto args       = app.arguments();
+    auto iterations = 20;
+
+    if (args.size() >= 3 && args.at(1) == "-n") {
+        iterations = std::max(1, args.at(2).toInt());
+    }
+
+    // 従来の処理
+    auto legacyTable = [](const QString &text) {
+        static QRegularExpression re("<table.*>.*</table>", QRegularExpression::DotMatchesEverythingOption);
+        return QString(text).remove(re);
+    };
+    auto legacyLink = [](const QString &text) {
+        static QRegularExpression re("<br .*</a>", QRegularExpression::DotMatchesEverythingOption);
+        return QString(text).remove(re);
+    };
+    auto legacyDateline = [](const QString &text) {
+        static QRegularExpression re("^[0-9０-９]{4}年[0-9０-９]{1,2}月[0-9０-９]{1,2}日[=＝][0-9０-９,，]+");
+        return QString(text).remove(re);
+    };
+
+    // DescriptionSanitizerクラスを使用する処理
+    auto sanitizeTable = [](const QString &text) {
+        return DescriptionSanitizer::sanitize(text, DescriptionSanitizer::DROP_TABLE);
+    };
+    auto sanitizeLink = [](const QString &text) {
+        return DescriptionSanitizer::sanitize(text, DescriptionSanitizer::DROP_BR | DescriptionSanitizer::DROP_LINK);
+    };
+    auto sanitizeDateline = [](const QString &text) {
+        return DescriptionSanitizer::stripDateline(text);
+    };
+
+    // 入力文字列 (通常の入力、および、正規表現でバックトラックが多発する入力)
+    const QList<std::tuple<INPUT, std::function<QString(const QString&)>, std::function<QString(const QString&)>>> cases = {
+        {{"通常の本文 + table",           [](int n) { return QString("本文").repeated(n / 2) + "<table><tr><td>写真</td></tr></table>"; }},
+         legacyTable, sanitizeTable},
+        {{"終了タグが無いtable",          [](int n) { return QString("<table>").repeated(std::max(1, n / 7)); }},
+         legacyTable, sanitizeTable},
+        {{"閉じていない<table",           [](int n) { return QString("<table").repeated(std::max(1, n / 6)) + ">"; }},
+         legacyTable, sanitizeTable},
+        {{"終了タグが無いbr + a",         [](int n) { return QString("<br />").repeated(std::max(1, n / 6)); }},
+         legacyLink, sanitizeLink},
+        {{"\">\"が無い\"<\"の連続",       [](int n) { return QString("<").repeated(n); }},
+         legacyTable, sanitizeTable},
+        {{"日付 + 長い文字数",            [](int n) { return QString("２０２４年１月１日＝") + QString("１，").repeated(n / 2) + "本文"; }},
+         legacyDateline, sanitizeDateline},
+    };
+
+    std::cout << QString("繰り返し回数 : %1").arg(iterations).toStdString() << std::endl;
+
+    for (const auto &[input, legacy, sanitize] : cases) {
+        std::cout << QString("[%1]").arg(input.Name).toStdString() << std::endl;
+
+        for (const auto length : {1024, 4096, 16384, 65536}) {
+            const auto text = input.Generate(length);
+
+            auto legacyUsec   = measure(legacy, text, iterations);
+            auto sanitizeUsec = measure(sanitize, text, iterations);
+
+            std::cout << QString("  長さ %1 : 正規表現 %2 [マイクロ秒], DescriptionSanitizer %3 [マイクロ秒]")
+                             .arg(text.size(), 6)
+                             .arg(legacyUsec, 10, 'f', 1)
+                             .arg(sanitizeUsec, 8, 'f', 1).toStdString() << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,248 @@
+#include <QDir>
+#include <QFile>
+#include <QUrl>
+#include <QTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QPointer>
+#include <algorithm>
+#include <iostream>
+#include "HttpReplayServer.h"
+#include "../HttpReplay.h"
+
+
+HttpReplayServer::HttpReplayServer(QObject *parent) : QObject{parent}
+{
+    m_Random.Seed(m_Info.Seed);
+
+    connect(&m_Server, &QTcpServer::newConnection, this, &HttpReplayServer::onNewConnection);
+}
+
+
+// コーパスを読み込む
+// ファイル名 (<キー>-<連番>.json) の順に読み込むため、同じキーのレスポンスは記録した順になる
+int HttpReplayServer::load(const QString &directory)
+{
+    QDir dir(directory);
+    if (!dir.exists()) {
+        std::cerr << QString("エラー : コーパスのディレクトリ %1 が存在しません").arg(directory).toStdString() << std::endl;
+        return -1;
+    }
+
+    m_Entries.clear();
+    m_Cursor.clear();
+
+    auto count = 0;
+    for (const auto &name : dir.entryList({"*.json"}, QDir::Files, QDir::Name)) {
+        QFile metaFile(dir.filePath(name));
+        if (!metaFile.open(QIODevice::ReadOnly)) continue;
+
+        const auto meta = QJsonDocument::fromJson(metaFile.readAll()).object();
+        if (meta.isEmpty()) {
+            std::cerr << QString("警告 : %1 の読み込みに失敗").arg(name).toStdString() << std::endl;
+            continue;
+        }
+
+        ENTRY entry;
+        entry.Status  = meta["status"].toInt(200);
+        entry.Reason  = meta["reason"].toString("OK").toLatin1();
+        entry.Elapsed = static_cast<qint64>(meta["elapsed"].toDouble(0));
+
+        for (const auto &header : meta["headers"].toArray()) {
+            const auto pair = header.toArray();
+            entry.Headers.append({pair.at(0).toString().toLatin1(), pair.at(1).toString().toLatin1()});
+        }
+
+        QFile bodyFile(dir.filePath(meta["body"].toString()));
+        if (bodyFile.open(QIODevice::ReadOnly)) entry.Body = bodyFile.readAll();
+
+        m_Entries[HttpReplay::key(meta["method"].toString("GET"), QUrl(meta["url"].toString()))].append(entry);
+        count++;
+    }
+
+    return count;
+}
+
+
+// 再生サーバの動作に関する設定を指定
+void HttpReplayServer::setServerInfo(const REPLAYSERVER_INFO &info)
+{
+    m_Info = info;
+    m_Random.Seed(m_Info.Seed);
+}
+
+
+// 待ち受けを開始
+bool HttpReplayServer::listen(quint16 port)
+{
+    if (!m_Server.listen(QHostAddress::LocalHost, port)) {
+        std::cerr << QString("エラー : 再生サーバの起動に失敗 %1").arg(m_Server.errorString()).toStdString() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+
+// 再生サーバのURL
+QString HttpReplayServer::url() const
+{
+    return QString("http://127.0.0.1:%1").arg(m_Server.serverPort());
+}
+
+
+// 全てのキーの配信位置を先頭に戻す
+void HttpReplayServer::rewind()
+{
+    m_Cursor.clear();
+}
+
+
+// 配信の統計情報を取得
+HttpReplayServer::STATS HttpReplayServer::stats() const
+{
+    return m_Stats;
+}
+
+
+// 新しい接続を受け付けた時の処理
+void HttpReplayServer::onNewConnection()
+{
+    while (auto pSocket = m_Server.nextPendingConnection()) {
+        connect(pSocket, &QTcpSocket::readyRead, this, [this, pSocket]() { onReadyRead(pSocket); });
+        connect(pSocket, &QTcpSocket::disconnected, this, [this, pSocket]() {
+            m_Buffers.remove(pSocket);
+            pSocket->deleteLater();
+        });
+    }
+}
+
+
+// リクエストを受信した時の処理
+// リクエストヘッダおよびボディ (Content-Lengthヘッダのサイズ) を全て受信した後に、レスポンスを返す
+void HttpReplayServer::onReadyRead(QTcpSocket *socket)
+{
+    if (!m_Buffers.contains(socket) && socket->property("responded").toBool()) {
+        socket->readAll();
+        return;
+    }
+
+    auto &buffer = m_Buffers[socket];
+    buffer.append(socket->readAll());
+
+    const auto headEnd = buffer.indexOf("\r\n\r\n");
+    if (headEnd < 0) return;
+
+    const auto head = buffer.left(headEnd);
+
+    qint64 contentLength = 0;
+    for (const auto &line : head.split('\n')) {
+        if (line.toLower().startsWith("content-length:")) contentLength = line.mid(15).trimmed().toLongLong();
+    }
+
+    if (buffer.size() < headEnd + 4 + contentLength) return;
+
+    m_Buffers.remove(socket);
+    socket->setProperty("responded", true);
+
+    respond(socket, head);
+}
+
+
+// リクエストヘッダからレスポンスを返す
+// 元のURLはX-Replay-Urlヘッダから取得して、存在しない場合はHostヘッダとパスから生成する
+void HttpReplayServer::respond(QTcpSocket *socket, const QByteArray &head)
+{
+    const auto lines       = head.split('\n');
+    const auto requestLine = lines.value(0).trimmed().split(' ');
+    const auto method      = QString::fromLatin1(requestLine.value(0));
+    const auto target      = QString::fromLatin1(requestLine.value(1));
+
+    QString originalUrl;
+    QString host;
+    for (auto i = 1; i < lines.size(); i++) {
+        const auto line  = lines.at(i).trimmed();
+        const auto colon = line.indexOf(':');
+        if (colon < 0) continue;
+
+        const auto name  = line.left(colon).trimmed().toLower();
+        const auto value = QString::fromLatin1(line.mid(colon + 1).trimmed());
+        if (name == QByteArray(HttpReplay::URL_HEADER).toLower()) originalUrl = value;
+        else if (name == "host")                                  host        = value;
+    }
+
+    if (originalUrl.isEmpty()) originalUrl = "http://" + host + target;
+
+    m_Stats.Requests++;
+
+    // エラーの注入 (HTTP 503、または、レスポンスを返さずに接続を切断)
+    if (m_Info.ErrorRate > 0.0 && m_Random.GenerateReal() < m_Info.ErrorRate) {
+        m_Stats.Errors++;
+
+        if (m_Random.GenerateReal() < 0.5) {
+            socket->abort();
+        }
+        else {
+            send(socket, "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+        }
+
+        return;
+    }
+
+    const auto key = HttpReplay::key(method, QUrl(originalUrl));
+    auto       it  = m_Entries.constFind(key);
+    if (it == m_Entries.constEnd() || it->isEmpty()) {
+        m_Stats.Misses++;
+        std::cerr << QString("警告 : 未記録のリクエスト %1 %2").arg(method, originalUrl).toStdString() << std::endl;
+        send(socket, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+
+        return;
+    }
+
+    // 同じキーのレスポンスは記録した順に返して、最後のレスポンスは繰り返し返す
+    auto       &cursor = m_Cursor[key];
+    const auto &entry  = it->at(std::min(cursor, static_cast<int>(it->size()) - 1));
+    cursor++;
+
+    QByteArray response = "HTTP/1.1 " + QByteArray::number(entry.Status) + " " + entry.Reason + "\r\n";
+    for (const auto &header : entry.Headers) {
+        response += header.first + ": " + header.second + "\r\n";
+    }
+    response += "Content-Length: " + QByteArray::number(entry.Body.size()) + "\r\nConnection: close\r\n\r\n";
+    if (method != "HEAD") response += entry.Body;
+
+    m_Stats.Bytes += entry.Body.size();
+
+    const auto latency = m_Info.Latency < 0 ? entry.Elapsed : static_cast<qint64>(m_Info.Latency);
+    if (latency <= 0) {
+        send(socket, response);
+        return;
+    }
+
+    QPointer<QTcpSocket> pSocket(socket);
+    QTimer::singleShot(latency, this, [this, pSocket, response]() {
+        if (pSocket != nullptr) send(pSocket, response);
+    });
+}
+
+
+// 送信速度の上限に従ってレスポンスを送信して、接続を閉じる
+// 上限が指定されている場合は、100[ミリ秒]ごとに上限の1/10ずつ送信する
+void HttpReplayServer::send(QTcpSocket *socket, const QByteArray &data)
+{
+    if (m_Info.Bandwidth <= 0 || data.size() <= m_Info.Bandwidth / 10) {
+        socket->write(data);
+        socket->disconnectFromHost();
+        return;
+    }
+
+    const auto chunk = std::max<qint64>(m_Info.Bandwidth / 10, 1);
+    socket->write(data.left(chunk));
+
+    QPointer<QTcpSocket> pSocket(socket);
+    const auto rest = data.mid(chunk);
+    QTimer::singleShot(100, this, [this, pSocket, rest]() {
+        if (pSocket != nullptr) send(pSocket, rest);
+    });
+}
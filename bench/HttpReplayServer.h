@@ -0,0 +1,75 @@
+#ifndef HTTPREPLAYSERVER_H
+#define HTTPREPLAYSERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHash>
+#include <QList>
+#include <QByteArray>
+#include "../RandomGenerator.h"
+
+
+// 再生サーバの動作に関する設定
+struct REPLAYSERVER_INFO {
+    int         Latency     = 0;        // レスポンスを返すまでの遅延 [ミリ秒] (-1の場合は、記録時の応答時間)
+    qint64      Bandwidth   = 0;        // 1接続あたりの送信速度の上限 [バイト / 秒] (0の場合は無制限)
+    double      ErrorRate   = 0.0;      // エラーを注入する確率 (0 - 1、HTTP 503または接続の切断)
+    quint64     Seed        = 1;        // エラーの注入に使用する乱数のシード値 (同じ値の場合は同じ順序でエラーを注入する)
+};
+
+
+// HttpReplayクラスが記録したコーパスを配信するローカルのHTTPサーバ
+// リクエストのX-Replay-Urlヘッダ (元のURL) とメソッドからコーパスのキーを生成して、記録したレスポンスを返す
+// 同じキーのレスポンスが複数存在する場合は記録した順に返して、最後のレスポンスは繰り返し返す
+class HttpReplayServer : public QObject
+{
+    Q_OBJECT
+
+public:     // Variables
+    // 配信の統計情報
+    struct STATS {
+        qint64      Requests    = 0;    // 受信したリクエストの数
+        qint64      Misses      = 0;    // コーパスに存在しないリクエストの数 (HTTP 404を返す)
+        qint64      Errors      = 0;    // エラーを注入したリクエストの数
+        qint64      Bytes       = 0;    // 送信したボディの合計サイズ [バイト]
+    };
+
+private:    // Variables
+    // 記録したレスポンス
+    struct ENTRY {
+        int                                     Status  = 200;  // ステータスコード
+        QByteArray                              Reason;         // ステータスコードの説明
+        QList<QPair<QByteArray, QByteArray>>    Headers;        // ヘッダ群
+        QByteArray                              Body;           // ボディ
+        qint64                                  Elapsed = 0;    // 記録時の応答時間 [ミリ秒]
+    };
+
+    QTcpServer                          m_Server;       // 待ち受け用のソケット
+    REPLAYSERVER_INFO                   m_Info;         // 再生サーバの動作に関する設定
+    QHash<QString, QList<ENTRY>>        m_Entries;      // コーパスのキーごとの記録したレスポンス群 (記録した順)
+    QHash<QString, int>                 m_Cursor;       // コーパスのキーごとに次に返すレスポンスの位置
+    QHash<QTcpSocket*, QByteArray>      m_Buffers;      // 接続ごとの受信途中のリクエスト
+    RandomGenerator                     m_Random;       // エラーの注入に使用する乱数生成器
+    STATS                               m_Stats;        // 配信の統計情報
+
+private:    // Methods
+    void            onNewConnection();                                      // 新しい接続を受け付けた時の処理
+    void            onReadyRead(QTcpSocket *socket);                        // リクエストを受信した時の処理
+    void            respond(QTcpSocket *socket, const QByteArray &head);    // リクエストヘッダからレスポンスを返す
+    void            send(QTcpSocket *socket, const QByteArray &data);       // 送信速度の上限に従ってレスポンスを送信して、接続を閉じる
+
+public:     // Methods
+    explicit HttpReplayServer(QObject *parent = nullptr);
+    ~HttpReplayServer() override = default;
+
+    int             load(const QString &directory);                         // コーパスを読み込む (読み込んだレスポンスの数、失敗した場合は-1)
+    void            setServerInfo(const REPLAYSERVER_INFO &info);           // 再生サーバの動作に関する設定を指定
+    bool            listen(quint16 port = 0);                               // 待ち受けを開始 (0の場合は空いているポート番号)
+    [[nodiscard]] QString url() const;                                      // 再生サーバのURL (設定ファイルのreplayキーのserverキーに指定する)
+    void            rewind();                                               // 全てのキーの配信位置を先頭に戻す (1周期分の処理を繰り返す場合)
+    [[nodiscard]] STATS stats() const;                                      // 配信の統計情報を取得
+};
+
+
+#endif // HTTPREPLAYSERVER_H
@@ -0,0 +1,308 @@
+// 記録したHTTP通信 (コーパス) の再生および掲示板エミュレータに対して、ニュース記事の取得から書き込みまでの1周期を繰り返し実行して、
+// 1周期あたりのリクエスト数、転送量、メモリの確保回数、常駐メモリの最大値、処理時間をベースラインと比較する
+// 使用方法 : qnewsflash_perfgate [-c <周期数>] [-b <ベースラインのパス>] [-u] [コーパスのディレクトリ]
+// -u : 計測結果でベースラインを作成 (または更新) する
+// いずれかの指標がベースラインの許容範囲を超えて増加した場合は、終了コード1で終了する
+//
+// 1周期の内容は、ワンショット (autofetchキーがfalse) で実行した場合と同じ
+//     News API以外の全てのニュースサイト (時事ドットコム、共同通信、朝日新聞デジタル、毎日新聞、CNET Japan、ハンギョレジャパン、ロイター通信、東京新聞) の
+//     RSSの取得、各ニュース記事の本文の取得、候補プールからの書き込み (書き込みモード 2)、
+//     時事ドットコムおよび共同通信 (47NEWS) の速報記事の確認および書き込み、その後、書き込み済みの全てのスレッドへの!bottomコマンドの書き込み
+// リクエスト数、転送量は決定的な値のため、処理時間よりも厳しい許容範囲で比較する
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <iostream>
+#include "HttpReplayServer.h"
+#include "BoardEmulator.h"
+#include "ReplayCycle.h"
+
+
+#ifndef QNEWSFLASH_BENCH_CORPUS
+    #define QNEWSFLASH_BENCH_CORPUS     "bench/corpus"
+#endif
+
+#ifndef QNEWSFLASH_PERF_BASELINE
+    #define QNEWSFLASH_PERF_BASELINE    "bench/perfgate_baseline.json"
+#endif
+
+
+// メモリの確保回数 (全てのスレッド)
+// glibcのmalloc()、calloc()、realloc()関数を置き換えて計数する (Qtのコンテナおよびlibxml2の確保も含む)
+static std::atomic<qint64> g_Allocations{0};
+
+extern "C" {
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t count, size_t size);
+    void *__libc_realloc(void *ptr, size_t size);
+
+    void *malloc(size_t size) noexcept
+    {
+        g_Allocations.fetch_add(1, std::memory_order_relaxed);
+        return __libc_malloc(size);
+    }
+
+    void *calloc(size_t count, size_t size) noexcept
+    {
+        g_Allocations.fetch_add(1, std::memory_order_relaxed);
+        return __libc_calloc(count, size);
+    }
+
+    void *realloc(void *ptr, size_t size) noexcept
+    {
+        g_Allocations.fetch_add(1, std::memory_order_relaxed);
+        return __libc_realloc(ptr, size);
+    }
+}
+
+
+// 1周期の計測結果
+struct METRICS {
+    double      WallMsec    = 0.0;  // 処理時間 [ミリ秒]
+    qint64      Requests    = 0;    // リクエスト数 (ニュースサイトおよび掲示板)
+    qint64      Bytes       = 0;    // 転送量 [バイト] (ニュースサイトのボディおよび掲示板のレスポンス)
+    qint64      Allocations = 0;    // メモリの確保回数
+    qint64      PeakRssKB   = 0;    // 常駐メモリの最大値 [KB]
+    qint64      Posts       = 0;    // 成功した書き込みの数 (!bottomコマンドを含む)
+};
+
+
+// 比較する指標 (ベースラインのキー名、既定の許容範囲 (増加率))
+static const QList<QPair<QString, double>> METRIC_KEYS = {
+    {"requests",    0.0},
+    {"bytes",       0.02},
+    {"allocations", 0.05},
+    {"peakrss",     0.10},
+    {"wallms",      0.25},
+};
+
+
+// 指標の値を取得
+static double metricValue(const METRICS &metrics, const QString &key)
+{
+    if (key == "requests")    return static_cast<double>(metrics.Requests);
+    if (key == "bytes")       return static_cast<double>(metrics.Bytes);
+    if (key == "allocations") return static_cast<double>(metrics.Allocations);
+    if (key == "peakrss")     return static_cast<double>(metrics.PeakRssKB);
+    if (key == "wallms")      return metrics.WallMsec;
+
+    return 0.0;
+}
+
+
+// 常駐メモリの最大値 (VmHWM) を現在の常駐メモリにリセット
+static void resetPeakRss()
+{
+    QFile clearRefs("/proc/self/clear_refs");
+    if (clearRefs.open(QIODevice::WriteOnly)) clearRefs.write("5");
+}
+
+
+// 常駐メモリの最大値 (VmHWM) [KB]
+static qint64 peakRssKB()
+{
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly)) return -1;
+
+    for (const auto &line : status.readAll().split('\n')) {
+        if (line.startsWith("VmHWM:")) return line.mid(6).trimmed().split(' ').value(0).toLongLong();
+    }
+
+    return -1;
+}
+
+
+// 1周期を実行して計測
+static int runCycle(HttpReplayServer &server, const QString &confFile, const QString &workDir, METRICS &metrics)
+{
+    // 前回の周期のログファイル等を削除して、毎周期同じ状態から開始する
+    QDir dir(workDir);
+    for (const auto &file : dir.entryList({"qNewsFlash_*"}, QDir::Files)) dir.remove(file);
+
+    BoardEmulator board;
+    if (!board.listen()) return -1;
+
+    if (ReplayCycle::writeConfig(confFile, workDir, server.url(), board.requestUrl())) return -1;
+
+    server.rewind();
+
+    const auto serverBefore = server.stats();
+    const auto allocBefore  = g_Allocations.load(std::memory_order_relaxed);
+    resetPeakRss();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    ReplayCycle::run();
+
+    // 破棄待ちのオブジェクト (QNetworkReply等) を破棄
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+
+    const auto serverAfter = server.stats();
+    const auto boardStats  = board.stats();
+
+    metrics.WallMsec    = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+    metrics.Requests    = (serverAfter.Requests - serverBefore.Requests) + boardStats.Requests;
+    metrics.Bytes       = (serverAfter.Bytes - serverBefore.Bytes) + boardStats.Bytes;
+    metrics.Allocations = g_Allocations.load(std::memory_order_relaxed) - allocBefore;
+    metrics.PeakRssKB   = peakRssKB();
+    metrics.Posts       = boardStats.Posts;
+
+    if (serverAfter.Misses != serverBefore.Misses) {
+        std::cerr << QString("警告 : コーパスに存在しないリクエストが %1 件あります").arg(serverAfter.Misses - serverBefore.Misses).toStdString() << std::endl;
+    }
+
+    return 0;
+}
+
+
+// 中央値
+static double median(QList<double> values)
+{
+    std::sort(values.begin(), values.end());
+
+    return values.isEmpty() ? 0.0 : values.at(values.size() / 2);
+}
+
+
+int main(int argc, char *argv[])
+{
+    // このツールのオプションを解析
+    // Runnerクラスはアプリケーションのコマンドライン引数 (--sysconf) を使用するため、QCoreApplicationには設定ファイルのパスのみを渡す
+    auto    cycles   = 5;
+    auto    update   = false;
+    QString baseline = QStringLiteral(QNEWSFLASH_PERF_BASELINE);
+    QString corpus   = QStringLiteral(QNEWSFLASH_BENCH_CORPUS);
+
+    for (auto i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "-c") == 0 && i + 1 < argc)      cycles   = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "-b") == 0 && i + 1 < argc) baseline = QString::fromLocal8Bit(argv[++i]);
+        else if (std::strcmp(argv[i], "-u") == 0)                 update   = true;
+        else if (argv[i][0] != '-')                               corpus   = QString::fromLocal8Bit(argv[i]);
+        else {
+            std::cerr << "使用方法 : qnewsflash_perfgate [-c <周期数>] [-b <ベースラインのパス>] [-u] [コーパスのディレクトリ]" << std::endl;
+            return -1;
+        }
+    }
+
+    QTemporaryDir tempDir;
+    if (!tempDir.isValid()) {
+        std::cerr << "エラー : 一時ディレクトリの作成に失敗" << std::endl;
+        return -1;
+    }
+
+    const auto confFile   = tempDir.filePath("qNewsFlash.json");
+    const auto workDir    = tempDir.path();
+    auto       sysconfArg = QString("--sysconf=%1").arg(confFile).toLocal8Bit();
+    char       appName[]  = "qnewsflash_perfgate";
+    char      *appArgv[]  = {appName, sysconfArg.data(), nullptr};
+    int        appArgc    = 2;
+
+    QCoreApplication app(appArgc, appArgv);
+
+    // Runnerクラスは標準入力 ([q]キー) を監視するため、入力の無いパイプに置き換える (標準入力が/dev/null等の場合に、監視が発火し続けるため)
+    int fds[2];
+    if (pipe(fds) == 0) dup2(fds[0], STDIN_FILENO);
+
+    QDir(workDir).mkpath("corpus");
+    if (ReplayCycle::copyCorpus(corpus, QDir(workDir).filePath("corpus"))) return -1;
+
+    HttpReplayServer server;
+    if (server.load(QDir(workDir).filePath("corpus")) <= 0 || !server.listen()) return -1;
+
+    // 1周期目はウォームアップ (libxml2およびワーカスレッドの初期化等) とする
+    METRICS warmup;
+    if (runCycle(server, confFile, workDir, warmup)) return -1;
+
+    QList<METRICS> results;
+    for (auto i = 0; i < cycles; i++) {
+        METRICS metrics;
+        if (runCycle(server, confFile, workDir, metrics)) return -1;
+        results.append(metrics);
+
+        std::cout << QString("周期 %1 : %2 [ミリ秒], リクエスト %3, 転送量 %4 [バイト], メモリの確保 %5 回, 常駐メモリの最大値 %6 [KB], 書き込み %7")
+                     .arg(i + 1).arg(metrics.WallMsec, 0, 'f', 1).arg(metrics.Requests).arg(metrics.Bytes)
+                     .arg(metrics.Allocations).arg(metrics.PeakRssKB).arg(metrics.Posts).toStdString() << std::endl;
+    }
+
+    // 周期ごとの中央値
+    QJsonObject current;
+    for (const auto &metric : METRIC_KEYS) {
+        QList<double> values;
+        for (const auto &result : std::as_const(results)) values.append(metricValue(result, metric.first));
+        current[metric.first] = median(values);
+    }
+
+    QList<double> posts;
+    for (const auto &result : std::as_const(results)) posts.append(static_cast<double>(result.Posts));
+    current["posts"] = median(posts);
+
+    if (current["posts"].toDouble() == 0.0) {
+        std::cerr << "エラー : 書き込みが1件も成功していません (設定ファイルのテンプレートまたはコーパスを確認してください)" << std::endl;
+        return 1;
+    }
+
+    // ベースラインの作成 (許容範囲は既存の値を維持する)
+    QFile baselineFile(baseline);
+    QJsonObject baselineObject;
+    if (baselineFile.open(QIODevice::ReadOnly)) {
+        baselineObject = QJsonDocument::fromJson(baselineFile.readAll()).object();
+        baselineFile.close();
+    }
+
+    auto tolerance = baselineObject["tolerance"].toObject();
+    for (const auto &metric : METRIC_KEYS) {
+        if (!tolerance.contains(metric.first)) tolerance[metric.first] = metric.second;
+    }
+
+    if (update || baselineObject.isEmpty()) {
+        baselineObject["cycles"]    = cycles;
+        baselineObject["metrics"]   = current;
+        baselineObject["tolerance"] = tolerance;
+
+        if (!baselineFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            std::cerr << QString("エラー : ベースライン %1 の作成に失敗").arg(baseline).toStdString() << std::endl;
+            return -1;
+        }
+        baselineFile.write(QJsonDocument(baselineObject).toJson());
+
+        std::cout << QString("ベースライン %1 を%2しました").arg(baseline, update ? "更新" : "作成").toStdString() << std::endl;
+        return 0;
+    }
+
+    // ベースラインと比較
+    const auto expected = baselineObject["metrics"].toObject();
+    auto       failed   = false;
+
+    if (expected["posts"].toDouble() != current["posts"].toDouble()) {
+        std::cerr << QString("エラー : 書き込みの数がベースラインと異なります (ベースライン %1, 今回 %2)")
+                     .arg(expected["posts"].toDouble()).arg(current["posts"].toDouble()).toStdString() << std::endl;
+        failed = true;
+    }
+
+    for (const auto &metric : METRIC_KEYS) {
+        const auto base  = expected[metric.first].toDouble();
+        const auto value = current[metric.first].toDouble();
+        const auto limit = base * (1.0 + tolerance[metric.first].toDouble());
+        const auto over  = value > limit;
+
+        std::cout << QString("%1 : ベースライン %2, 今回 %3 (%4%5%), 上限 %6 %7")
+                     .arg(metric.first, -12).arg(base, 0, 'f', 1).arg(value, 0, 'f', 1)
+                     .arg(value >= base ? "+" : "").arg(base > 0 ? (value - base) / base * 100.0 : 0.0, 0, 'f', 1)
+                     .arg(limit, 0, 'f', 1).arg(over ? "超過" : "OK").toStdString() << std::endl;
+
+        failed |= over;
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,190 @@
+// 掲示板エミュレータ (BoardEmulator) に対して、WriteModeクラスの書き込みを連続して実行し、1回あたりの処理時間を計測する
+// 使用方法 : qnewsflash_postbench [-m <1 | 2>] [-n <書き込み数>] [-r <最大レス数>] [-t <最大スレッド数>] [-c] [-h] [-b <間隔>] [-u]
+// -m : 書き込みモード (1 : 1つのスレッドに書き込む、2 : 常に新規スレッドを立てる)
+// -c : !chttコマンドを使用、-h : !hogoコマンドを使用、-u : UTF-8の掲示板
+// -b : 書き込みモード 2の場合に、指定した書き込み数ごとに最も古いスレッドへ!bottomコマンドを書き込む
+// 掲示板のリクエスト数の制限は無効にして、クッキーの取得、スレッドの生存確認、レス数の確認、書き込み、ログの保存までを計測する
+// 書き込みまたは!bottomコマンドの書き込みに1回でも失敗した場合は、終了コード1で終了する
+
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <algorithm>
+#include <iostream>
+#include "BoardEmulator.h"
+#include "../WriteMode.h"
+#include "../RateLimiter.h"
+
+
+// 処理時間の統計を表示
+static void printLatency(const QString &label, QList<qint64> nsecs, qint64 failures)
+{
+    if (nsecs.isEmpty()) {
+        std::cout << QString("%1 : 成功 0, 失敗 %2").arg(label).arg(failures).toStdString() << std::endl;
+        return;
+    }
+
+    std::sort(nsecs.begin(), nsecs.end());
+
+    auto percentile = [&nsecs](double p) {
+        return nsecs.at(std::min(static_cast<qsizetype>(p * static_cast<double>(nsecs.size())), nsecs.size() - 1)) / 1e6;
+    };
+
+    qint64 total = 0;
+    for (auto nsec : std::as_const(nsecs)) total += nsec;
+
+    std::cout << QString("%1 : 成功 %2, 失敗 %3, %4 [回 / 秒], p50 %5, p95 %6, p99 %7, 最大 %8 [ミリ秒]")
+                 .arg(label).arg(nsecs.size()).arg(failures)
+                 .arg(static_cast<double>(nsecs.size()) / (total / 1e9), 0, 'f', 1)
+                 .arg(percentile(0.50), 0, 'f', 2).arg(percentile(0.95), 0, 'f', 2).arg(percentile(0.99), 0, 'f', 2)
+                 .arg(nsecs.last() / 1e6, 0, 'f', 2).toStdString() << std::endl;
+}
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    auto               args        = app.arguments();
+    auto               mode        = 1;
+    auto               posts       = 500;
+    auto               bottomEvery = 0;
+    auto               changeTitle = false;
+    auto               saveThread  = false;
+    BOARDEMULATOR_INFO info;
+
+    for (auto i = 1; i < args.size(); i++) {
+        if (args.at(i) == "-m" && i + 1 < args.size())      mode              = args.at(++i).toInt() == 2 ? 2 : 1;
+        else if (args.at(i) == "-n" && i + 1 < args.size()) posts             = std::max(1, args.at(++i).toInt());
+        else if (args.at(i) == "-r" && i + 1 < args.size()) info.MaxResponses = std::max(2, args.at(++i).toInt());
+        else if (args.at(i) == "-t" && i + 1 < args.size()) info.MaxThreads   = std::max(1, args.at(++i).toInt());
+        else if (args.at(i) == "-b" && i + 1 < args.size()) bottomEvery       = std::max(0, args.at(++i).toInt());
+        else if (args.at(i) == "-c")                        changeTitle       = true;
+        else if (args.at(i) == "-h")                        saveThread        = true;
+        else if (args.at(i) == "-u")                        info.ShiftJIS     = false;
+        else {
+            std::cerr << "使用方法 : qnewsflash_postbench [-m <1 | 2>] [-n <書き込み数>] [-r <最大レス数>] [-t <最大スレッド数>] [-c] [-h] [-b <間隔>] [-u]" << std::endl;
+            return -1;
+        }
+    }
+
+    BoardEmulator board;
+    board.setBoardInfo(info);
+    if (!board.listen()) return -1;
+
+    // WriteModeクラスが読み書きする設定ファイルおよびログファイル
+    QTemporaryDir tempDir;
+    if (!tempDir.isValid()) {
+        std::cerr << "エラー : 一時ディレクトリの作成に失敗" << std::endl;
+        return -1;
+    }
+
+    const auto confFile = tempDir.filePath("qNewsFlash.json");
+    const auto logFile  = tempDir.filePath("qNewsFlash_log.json");
+
+    QJsonObject threadObject;
+    threadObject["ishogo"]      = false;
+    threadObject["key"]         = "";
+    threadObject["threadurl"]   = "";
+    threadObject["threadtitle"] = "";
+
+    QJsonObject confObject;
+    confObject["thread"] = threadObject;
+
+    QFile conf(confFile);
+    if (!conf.open(QIODevice::WriteOnly) || conf.write(QJsonDocument(confObject).toJson()) < 0) {
+        std::cerr << "エラー : 設定ファイルの作成に失敗" << std::endl;
+        return -1;
+    }
+    conf.close();
+
+    // 掲示板のリクエスト数は制限しない
+    RATELIMIT_INFO rateLimitInfo;
+    rateLimitInfo.BoardRate = 0.0;
+    rateLimitInfo.NewsRate  = 0.0;
+    RateLimiter::getInstance()->setRateLimitInfo(rateLimitInfo);
+
+    auto pWriteMode = WriteMode::getInstance();
+    pWriteMode->setSysConfFile(confFile);
+    pWriteMode->setLogFile(logFile);
+
+    WRITE_INFO writeInfo;
+    writeInfo.RequestURL     = board.requestUrl();
+    writeInfo.ThreadURL      = "";
+    writeInfo.ThreadTitle    = "";
+    writeInfo.ThreadXPath    = "/html/body/div/dl[@class='thread']/div/@id";
+    writeInfo.ExpiredXpath   = "/html/head/title";
+    writeInfo.ExpiredElement = "指定されたスレッドは存在しません";
+    writeInfo.MaxThreadNum   = info.MaxResponses;
+    writeInfo.ChangeTitle    = changeTitle;
+    writeInfo.SaveThread     = saveThread;
+    writeInfo.BottomThread   = mode == 2 && bottomEvery > 0;
+    pWriteMode->setWriteInfo(writeInfo);
+
+    THREAD_INFO threadInfo;
+    threadInfo.subject      = "ニュースを貼るスレ - %t";
+    threadInfo.bbs          = info.Bbs;
+    threadInfo.shiftjis     = info.ShiftJIS;
+    threadInfo.expiredXPath = writeInfo.ExpiredXpath;
+    pWriteMode->setThreadInfo(threadInfo);
+
+    auto exitCode = 0;
+    QTimer::singleShot(0, &app, [&]() {
+        QList<qint64> postNsecs;
+        QList<qint64> bottomNsecs;
+        qint64        postFailures   = 0;
+        qint64        bottomFailures = 0;
+        QElapsedTimer total;
+        total.start();
+
+        for (auto n = 1; n <= posts; n++) {
+            pWriteMode->setArticle(QString("速報 %1 : 掲示板エミュレータへの書き込み").arg(n),
+                                   QString("本文の一部です。%1").arg(QString(80, QChar(0x3042))),
+                                   QString("https://example.com/news/%1").arg(n),
+                                   QString("2026年1月1日 0時%1分").arg(n % 60));
+
+            QElapsedTimer timer;
+            timer.start();
+            auto ret = mode == 1 ? pWriteMode->writeMode1() : pWriteMode->writeMode2();
+            if (ret == WriteMode::SUCCEED) postNsecs.append(timer.nsecsElapsed());
+            else                           postFailures++;
+
+            // 最も古いスレッドに!bottomコマンドを書き込む
+            if (writeInfo.BottomThread && n % bottomEvery == 0) {
+                auto oldest = pWriteMode->getOldestWriteLog();
+                if (oldest.has_value()) {
+                    // レス数の確認は書き込みに関する情報のスレッドのURLを使用するため、対象のスレッドのURLを指定する
+                    auto bottomInfo      = pWriteMode->getWriteInfo();
+                    bottomInfo.ThreadURL = oldest->Url;
+                    pWriteMode->setWriteInfo(bottomInfo);
+
+                    timer.restart();
+                    if (pWriteMode->writeBottom() == WriteMode::SUCCEED) bottomNsecs.append(timer.nsecsElapsed());
+                    else                                                 bottomFailures++;
+                }
+            }
+        }
+
+        const auto elapsed = total.nsecsElapsed();
+        const auto stats   = board.stats();
+
+        std::cout << QString("書き込みモード %1, 書き込み数 : %2, 合計 %3 [秒]").arg(mode).arg(posts).arg(elapsed / 1e9, 0, 'f', 2).toStdString() << std::endl;
+        printLatency("書き込み", postNsecs, postFailures);
+        if (writeInfo.BottomThread) printLatency("!bottom ", bottomNsecs, bottomFailures);
+
+        std::cout << QString("掲示板 : リクエスト %1, 書き込み %2, スレッド作成 %3, エラー %4, dat落ち %5, サーバ内の処理時間 %6 [マイクロ秒 / 書き込み]")
+                     .arg(stats.Requests).arg(stats.Posts).arg(stats.Threads).arg(stats.Rejected).arg(stats.Fallen)
+                     .arg(stats.Posts > 0 ? stats.PostNsec / 1e3 / stats.Posts : 0.0, 0, 'f', 1).toStdString() << std::endl;
+
+        exitCode = (postFailures > 0 || bottomFailures > 0) ? 1 : 0;
+        QCoreApplication::exit(exitCode);
+    });
+
+    app.exec();
+
+    return exitCode;
+}
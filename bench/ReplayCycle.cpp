@@ -0,0 +1,203 @@
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QRegularExpression>
+#include <QDateTime>
+#include <QTimer>
+#include <QLocale>
+#include <QHash>
+#include <iostream>
+#include "ReplayCycle.h"
+#include "../Runner.h"
+#include "../WriteMode.h"
+
+
+#ifndef QNEWSFLASH_CONFIG_TEMPLATE
+    #define QNEWSFLASH_CONFIG_TEMPLATE  "etc/qNewsFlash.json.in"
+#endif
+
+
+// コーパスを複写して、RSSおよびHTML内の日付を現在時刻の直前に移動する
+// 公開日が指定時間以内 (withinhoursキー) のニュース記事のみが書き込み対象となるため
+int ReplayCycle::copyCorpus(const QString &source, const QString &destination)
+{
+    static const QRegularExpression isoDate(R"((\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}(?:Z|[+-]\d{2}:\d{2})))");
+    static const QRegularExpression rfcDate(R"(([A-Z][a-z]{2}, \d{2} [A-Z][a-z]{2} \d{4} \d{2}:\d{2}:\d{2} [+-]\d{4}))");
+    const auto       c = QLocale::c();
+
+    QDir srcDir(source);
+    const auto files = srcDir.entryList(QDir::Files, QDir::Name);
+    if (files.isEmpty()) {
+        std::cerr << QString("エラー : コーパス %1 が存在しません").arg(source).toStdString() << std::endl;
+        return -1;
+    }
+
+    // 最も新しい日付を取得
+    QHash<QString, QByteArray> bodies;
+    QDateTime                  newest;
+    for (const auto &file : files) {
+        QFile in(srcDir.filePath(file));
+        if (!in.open(QIODevice::ReadOnly)) return -1;
+        bodies.insert(file, in.readAll());
+
+        if (!file.endsWith(".body")) continue;
+
+        const auto text = QString::fromUtf8(bodies.value(file));
+        for (auto it = isoDate.globalMatch(text); it.hasNext();) {
+            auto date = QDateTime::fromString(it.next().captured(1), Qt::ISODate);
+            if (date.isValid() && (!newest.isValid() || date > newest)) newest = date;
+        }
+        for (auto it = rfcDate.globalMatch(text); it.hasNext();) {
+            auto date = QDateTime::fromString(it.next().captured(1), Qt::RFC2822Date);
+            if (date.isValid() && (!newest.isValid() || date > newest)) newest = date;
+        }
+    }
+
+    const auto shift = newest.isValid() ? newest.secsTo(QDateTime::currentDateTimeUtc()) - 5 * 60 : 0;
+
+    QDir dstDir(destination);
+    for (auto it = bodies.constBegin(); it != bodies.constEnd(); ++it) {
+        auto data = it.value();
+
+        if (it.key().endsWith(".body") && shift != 0) {
+            auto text = QString::fromUtf8(data);
+
+            // 時差表記は元のまま維持する
+            QString shifted;
+            qsizetype last = 0;
+            for (auto match = isoDate.globalMatch(text); match.hasNext();) {
+                auto m    = match.next();
+                auto date = QDateTime::fromString(m.captured(1), Qt::ISODate);
+                if (!date.isValid()) continue;
+
+                shifted += text.mid(last, m.capturedStart(1) - last);
+                shifted += date.addSecs(shift).toOffsetFromUtc(date.offsetFromUtc()).toString(Qt::ISODate);
+                last     = m.capturedEnd(1);
+            }
+            shifted += text.mid(last);
+            text     = shifted;
+
+            shifted.clear();
+            last = 0;
+            for (auto match = rfcDate.globalMatch(text); match.hasNext();) {
+                auto m    = match.next();
+                auto date = QDateTime::fromString(m.captured(1), Qt::RFC2822Date);
+                if (!date.isValid()) continue;
+
+                shifted += text.mid(last, m.capturedStart(1) - last);
+                shifted += c.toString(date.addSecs(shift).toOffsetFromUtc(date.offsetFromUtc()), "ddd, dd MMM yyyy hh:mm:ss ")
+                           + m.captured(1).right(5);
+                last     = m.capturedEnd(1);
+            }
+            shifted += text.mid(last);
+
+            data = shifted.toUtf8();
+        }
+
+        QFile out(dstDir.filePath(it.key()));
+        if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate) || out.write(data) != data.size()) {
+            std::cerr << QString("エラー : %1 の複写に失敗").arg(out.fileName()).toStdString() << std::endl;
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+
+// 1周期分の設定ファイルを作成
+// 設定ファイルのテンプレートから、コーパスに存在するニュースサイトのみを有効にして、全ての通信を再生サーバおよび掲示板エミュレータへ送信する
+int ReplayCycle::writeConfig(const QString &confFile, const QString &workDir, const QString &replayServer, const QString &requestUrl,
+                             const QJsonObject &overrides)
+{
+    QFile templateFile(QStringLiteral(QNEWSFLASH_CONFIG_TEMPLATE));
+    if (!templateFile.open(QIODevice::ReadOnly)) {
+        std::cerr << QString("エラー : 設定ファイルのテンプレート %1 のオープンに失敗").arg(templateFile.fileName()).toStdString() << std::endl;
+        return -1;
+    }
+
+    auto conf = QJsonDocument::fromJson(templateFile.readAll()).object();
+
+    for (const auto &source : {"newsapi"}) {
+        auto object = conf[source].toObject();
+        object["enable"] = false;
+        conf[source] = object;
+    }
+
+    for (const auto &source : {"asahi", "cnet", "hanj", "jiji", "jijiflash", "kyodo", "kyodoflash", "mainichi", "reuters", "tokyonp"}) {
+        auto object = conf[source].toObject();
+        object["enable"] = true;
+        conf[source] = object;
+    }
+
+    conf["autofetch"]   = false;
+    conf["withinhours"] = "24";
+    conf["logfile"]     = QDir(workDir).filePath("qNewsFlash_log.json");
+    conf["update"]      = "";
+
+    conf["dnscache"]    = QJsonObject{{"enable", false}, {"hosts", QJsonArray()}};
+    conf["posted"]      = QJsonObject{{"enable", true}, {"file", QDir(workDir).filePath("qNewsFlash_posted.bloom")}, {"horizon", 30}};
+    conf["tlssession"]  = QJsonObject{{"enable", false}, {"expire", 3600}, {"file", ""}};
+    conf["replay"]      = QJsonObject{{"directory", ""}, {"mode", "replay"}, {"server", replayServer}};
+    conf["ratelimit"]   = QJsonObject{{"board", QJsonObject{{"burst", 2}, {"rate", 0.0}}}, {"news", QJsonObject{{"burst", 4}, {"rate", 0.0}}}};
+
+    // 候補の選択は乱数のシード値を固定して、毎周期同じニュース記事を選択する
+    auto selection = conf["selection"].toObject();
+    selection["mode"] = "uniform";
+    selection["seed"] = 1;
+    conf["selection"] = selection;
+
+    auto thread = conf["thread"].toObject();
+    thread["bbs"]         = "news";
+    thread["requesturl"]  = requestUrl;
+    thread["writemode"]   = 2;
+    thread["key"]         = "";
+    thread["threadurl"]   = "";
+    thread["threadtitle"] = "";
+    conf["thread"] = thread;
+
+    auto command = conf["threadcommand"].toObject();
+    command["bottom"] = QJsonObject{{"enable", true}, {"interval", 180}};
+    conf["threadcommand"] = command;
+
+    // 呼び出し元が指定した設定 (メモリアリーナの有効化等) で上書きする
+    for (auto it = overrides.constBegin(); it != overrides.constEnd(); ++it) {
+        auto       object = conf[it.key()].toObject();
+        const auto values = it.value().toObject();
+        for (auto value = values.constBegin(); value != values.constEnd(); ++value) object[value.key()] = value.value();
+        conf[it.key()] = object;
+    }
+
+    QFile file(confFile);
+    const auto data = QJsonDocument(conf).toJson();
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(data) != data.size()) {
+        std::cerr << QString("エラー : 設定ファイル %1 の作成に失敗").arg(confFile).toStdString() << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
+
+
+// Runnerクラスを1周期実行して、書き込み済みの全てのスレッドに!bottomコマンドを書き込む
+void ReplayCycle::run()
+{
+    // Runnerクラスはワンショットの場合、起動直後の処理の完了後にQCoreApplication::exit()を実行するため、周期ごとにイベントループを実行する
+    // (イベントループの外側でQCoreApplication::exit()を実行すると、以降に入れ子にしたイベントループが即座に終了するため)
+    Runner runner(QCoreApplication::arguments(), QString());
+    QTimer::singleShot(0, &runner, &Runner::run);
+    QCoreApplication::exec();
+
+    // 書き込み済みの全てのスレッドに!bottomコマンドを書き込む
+    // レス数の確認は書き込みに関する情報のスレッドのURLを使用するため、対象のスレッドのURLを指定する
+    auto pWriteMode = WriteMode::getInstance();
+    for (auto oldest = pWriteMode->getOldestWriteLog(); oldest.has_value(); oldest = pWriteMode->getOldestWriteLog()) {
+        auto writeInfo      = pWriteMode->getWriteInfo();
+        writeInfo.ThreadURL = oldest->Url;
+        pWriteMode->setWriteInfo(writeInfo);
+
+        pWriteMode->writeBottom();
+    }
+}
@@ -0,0 +1,24 @@
+#ifndef REPLAYCYCLE_H
+#define REPLAYCYCLE_H
+
+#include <QString>
+#include <QJsonObject>
+
+
+// コーパスの再生サーバおよび掲示板エミュレータに対して、ワンショット (autofetchキーがfalse) の1周期を実行する
+// qnewsflash_perfgateおよびqnewsflash_soakで共用する
+namespace ReplayCycle
+{
+    // コーパスを複写して、RSSおよびHTML内の日付を現在時刻の直前に移動する
+    int  copyCorpus(const QString &source, const QString &destination);
+
+    // 1周期分の設定ファイルを作成
+    // overridesの各キーは、設定ファイルのテンプレートの同名のオブジェクトに上書きする (例 : {"parser": {"arena": true}})
+    int  writeConfig(const QString &confFile, const QString &workDir, const QString &replayServer, const QString &requestUrl,
+                     const QJsonObject &overrides = QJsonObject());
+
+    // Runnerクラスを1周期実行して、書き込み済みの全てのスレッドに!bottomコマンドを書き込む
+    void run();
+}
+
+#endif // REPLAYCYCLE_H
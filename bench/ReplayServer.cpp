@@ -0,0 +1,69 @@
+// 記録したHTTP通信 (コーパス) を配信する再生サーバ
+// 使用方法 : qnewsflash_replay [-p <ポート番号>] [-l <遅延 [ミリ秒]>] [-b <送信速度 [バイト / 秒]>] [-e <エラーの確率>] [-s <シード値>] <コーパスのディレクトリ>
+// コーパスは、設定ファイルのreplayキーのmodeキーに"record"を指定して、1周期分の処理を実行すると作成される
+// qNewsFlashの設定ファイルのreplayキーに、modeキーは"replay"、serverキーは表示されたURLを指定して実行する
+// 遅延に-1を指定する場合は、記録時の応答時間で返す
+
+#include <QCoreApplication>
+#include <QTimer>
+#include <csignal>
+#include <algorithm>
+#include <iostream>
+#include "HttpReplayServer.h"
+
+
+static volatile std::sig_atomic_t g_Stop = 0;   // 終了シグナルを受信したかどうか
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    auto              args = app.arguments();
+    quint16           port = 18080;
+    REPLAYSERVER_INFO info;
+    QString           directory;
+
+    for (auto i = 1; i < args.size(); i++) {
+        if (args.at(i) == "-p" && i + 1 < args.size())      port           = static_cast<quint16>(args.at(++i).toUInt());
+        else if (args.at(i) == "-l" && i + 1 < args.size()) info.Latency   = std::max(-1, args.at(++i).toInt());
+        else if (args.at(i) == "-b" && i + 1 < args.size()) info.Bandwidth = std::max(0LL, args.at(++i).toLongLong());
+        else if (args.at(i) == "-e" && i + 1 < args.size()) info.ErrorRate = std::clamp(args.at(++i).toDouble(), 0.0, 1.0);
+        else if (args.at(i) == "-s" && i + 1 < args.size()) info.Seed      = args.at(++i).toULongLong();
+        else                                                directory      = args.at(i);
+    }
+
+    if (directory.isEmpty()) {
+        std::cerr << "使用方法 : qnewsflash_replay [-p <ポート番号>] [-l <遅延>] [-b <送信速度>] [-e <エラーの確率>] [-s <シード値>] <ディレクトリ>" << std::endl;
+        return -1;
+    }
+
+    HttpReplayServer server;
+    server.setServerInfo(info);
+
+    const auto count = server.load(directory);
+    if (count <= 0) {
+        std::cerr << QString("エラー : %1 に記録したHTTP通信が存在しません").arg(directory).toStdString() << std::endl;
+        return -1;
+    }
+
+    if (!server.listen(port)) return -1;
+
+    std::cout << QString("%1 件のレスポンスを %2 で配信します").arg(count).arg(server.url()).toStdString() << std::endl;
+
+    // Ctrl + Cで終了する時に、配信の統計情報を表示
+    // シグナルハンドラではフラグのみを設定して、イベントループから終了する
+    std::signal(SIGINT,  [](int) { g_Stop = 1; });
+    std::signal(SIGTERM, [](int) { g_Stop = 1; });
+
+    QTimer stopTimer;
+    QObject::connect(&stopTimer, &QTimer::timeout, &app, []() { if (g_Stop) QCoreApplication::quit(); });
+    stopTimer.start(200);
+
+    auto ret   = app.exec();
+    auto stats = server.stats();
+    std::cout << QString("リクエスト : %1, 未記録 : %2, エラー注入 : %3, 送信 : %4 [KB]")
+                 .arg(stats.Requests).arg(stats.Misses).arg(stats.Errors).arg(stats.Bytes / 1024).toStdString() << std::endl;
+
+    return ret;
+}
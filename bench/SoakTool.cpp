@@ -0,0 +1,156 @@
+// 長時間運転時のメモリリークを検出する
+// 使用方法 : qnewsflash_soak [-c <周期数>] [-t <許容する増加量 [KB]>] [-a] [コーパスのディレクトリ]
+// -a : メモリアリーナ (parserキーのarenaキー) を有効にする
+// 記録したHTTP通信 (コーパス) の再生サーバおよび掲示板エミュレータに対して、qnewsflash_perfgateと同じ1周期
+// (Runnerクラスによる各ニュースサイトのRSSの取得および走査、各ニュース記事の本文の取得、書き込み、!bottomコマンドの書き込み) を指定周期数だけ繰り返す
+// ウォームアップ後の常駐メモリ (RSS) に対して、終了時の常駐メモリが許容量を超えて増加している場合は、終了コード1で終了する
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QJsonObject>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <iostream>
+#include "HttpReplayServer.h"
+#include "BoardEmulator.h"
+#include "ReplayCycle.h"
+#include "../ParserPool.h"
+
+
+#ifndef QNEWSFLASH_BENCH_CORPUS
+    #define QNEWSFLASH_BENCH_CORPUS     "bench/corpus"
+#endif
+
+
+// 常駐メモリのサイズ [KB]
+static qint64 residentKB()
+{
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly)) return -1;
+
+    auto fields = QString(statm.readAll()).split(' ');
+    if (fields.size() < 2) return -1;
+
+    return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE) / 1024;
+}
+
+
+// 1周期を実行
+// 戻り値 : 掲示板エミュレータへの書き込みに成功した数 (!bottomコマンドを含む)、失敗した場合は-1
+static qint64 runCycle(HttpReplayServer &server, const QString &confFile, const QString &workDir, const QJsonObject &overrides)
+{
+    // 前回の周期のログファイル等を削除して、毎周期同じ状態から開始する
+    QDir dir(workDir);
+    for (const auto &file : dir.entryList({"qNewsFlash_*"}, QDir::Files)) dir.remove(file);
+
+    BoardEmulator board;
+    if (!board.listen()) return -1;
+
+    if (ReplayCycle::writeConfig(confFile, workDir, server.url(), board.requestUrl(), overrides)) return -1;
+
+    server.rewind();
+    ReplayCycle::run();
+
+    // 破棄待ちのオブジェクト (QNetworkReply等) を破棄
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+
+    return board.stats().Posts;
+}
+
+
+int main(int argc, char *argv[])
+{
+    // このツールのオプションを解析
+    // Runnerクラスはアプリケーションのコマンドライン引数 (--sysconf) を使用するため、QCoreApplicationには設定ファイルのパスのみを渡す
+    auto    cycles    = 500;
+    auto    threshold = 8 * 1024LL;
+    auto    arena     = false;
+    QString corpus    = QStringLiteral(QNEWSFLASH_BENCH_CORPUS);
+
+    for (auto i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "-c") == 0 && i + 1 < argc)      cycles    = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "-t") == 0 && i + 1 < argc) threshold = std::max(0LL, std::atoll(argv[++i]));
+        else if (std::strcmp(argv[i], "-a") == 0)                 arena     = true;
+        else if (argv[i][0] != '-')                               corpus    = QString::fromLocal8Bit(argv[i]);
+        else {
+            std::cerr << "使用方法 : qnewsflash_soak [-c <周期数>] [-t <許容する増加量 [KB]>] [-a] [コーパスのディレクトリ]" << std::endl;
+            return -1;
+        }
+    }
+
+    QTemporaryDir tempDir;
+    if (!tempDir.isValid()) {
+        std::cerr << "エラー : 一時ディレクトリの作成に失敗" << std::endl;
+        return -1;
+    }
+
+    const auto confFile   = tempDir.filePath("qNewsFlash.json");
+    const auto workDir    = tempDir.path();
+    auto       sysconfArg = QString("--sysconf=%1").arg(confFile).toLocal8Bit();
+    char       appName[]  = "qnewsflash_soak";
+    char      *appArgv[]  = {appName, sysconfArg.data(), nullptr};
+    int        appArgc    = 2;
+
+    QCoreApplication app(appArgc, appArgv);
+
+    // Runnerクラスは標準入力 ([q]キー) を監視するため、入力の無いパイプに置き換える
+    int fds[2];
+    if (pipe(fds) == 0) dup2(fds[0], STDIN_FILENO);
+
+    QDir(workDir).mkpath("corpus");
+    if (ReplayCycle::copyCorpus(corpus, QDir(workDir).filePath("corpus"))) return -1;
+
+    HttpReplayServer server;
+    if (server.load(QDir(workDir).filePath("corpus")) <= 0 || !server.listen()) return -1;
+
+    // メモリアリーナは、RSSおよびニュース記事の本文のパースおよび走査 (ワーカスレッド) で使用される
+    const auto overrides = arena ? QJsonObject{{"parser", QJsonObject{{"arena", true}}}} : QJsonObject();
+
+    const auto warmup   = std::max(1, cycles / 10);
+    const auto interval = std::max(1, cycles / 20);
+    qint64     baseline = -1;
+
+    for (auto cycle = 1; cycle <= cycles; cycle++) {
+        const auto posts = runCycle(server, confFile, workDir, overrides);
+        if (posts < 0) return -1;
+
+        // 書き込みが無い場合は、各ニュースサイトのRSSの走査まで到達していない (設定ファイルのテンプレートまたはコーパスの不備)
+        if (cycle == 1 && posts == 0) {
+            std::cerr << "エラー : 書き込みが1件も成功していません (設定ファイルのテンプレートまたはコーパスを確認してください)" << std::endl;
+            return -1;
+        }
+
+        // メモリアリーナは、libxml2の初期化前に有効にする必要があるため、実際に使用されたことを確認する
+        if (cycle == 1 && arena && ParserPool::getInstance()->arenaStats().Documents == 0) {
+            std::cerr << "エラー : メモリアリーナが使用されていません" << std::endl;
+            return -1;
+        }
+
+        if (cycle == warmup) baseline = residentKB();
+        if (cycle % interval == 0 || cycle == cycles) {
+            std::cout << QString("周期 %1 / %2 : 常駐メモリ %3 [KB]").arg(cycle).arg(cycles).arg(residentKB()).toStdString() << std::endl;
+        }
+    }
+
+    const auto stats = server.stats();
+    if (stats.Misses > 0) {
+        std::cerr << QString("警告 : コーパスに存在しないリクエストが %1 件あります").arg(stats.Misses).toStdString() << std::endl;
+    }
+
+    auto growth   = residentKB() - baseline;
+    auto exitCode = 0;
+    std::cout << QString("ウォームアップ後の常駐メモリの増加量 : %1 [KB] (許容量 : %2 [KB])").arg(growth).arg(threshold).toStdString() << std::endl;
+
+    if (growth > threshold) {
+        std::cerr << "エラー : 常駐メモリが増加し続けています (メモリリークの可能性があります)" << std::endl;
+        exitCode = 1;
+    }
+
+    ParserPool::getInstance()->shutdown();
+
+    return exitCode;
+}
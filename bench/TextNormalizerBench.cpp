@@ -0,0 +1,147 @@
+// TextNormalizerクラスと、従来の正規表現による空白文字の除去の処理時間を比較する
+// 使用方法 : qnewsflash_textbench [-n <繰り返し回数>] <保存したニュース記事のHTMLファイル> ...
+// 各HTMLファイルから全てのテキストノードを抽出して、両方の方法で空白文字を除去し、結果が一致することを確認した後、処理時間を表示する
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QStringList>
+#include <QRegularExpression>
+#include <QElapsedTimer>
+#include <libxml/HTMLparser.h>
+#include <libxml/tree.h>
+#include <iostream>
+#include <algorithm>
+#include "../TextNormalizer.h"
+
+
+// テキストノードを再帰的に抽出
+static void collectText(xmlNodePtr node, QStringList &texts)
+{
+    for (auto cur = node; cur != nullptr; cur = cur->next) {
+        if (cur->type == XML_TEXT_NODE && cur->content != nullptr) {
+            texts.append(QString::fromUtf8(reinterpret_cast<const char*>(cur->content)));
+        }
+        else if (cur->type == XML_ELEMENT_NODE) {
+            // script要素およびstyle要素は、本文として扱わない
+            if (xmlStrcasecmp(cur->name, BAD_CAST "script") == 0 || xmlStrcasecmp(cur->name, BAD_CAST "style") == 0) continue;
+        }
+
+        collectText(cur->children, texts);
+    }
+}
+
+
+// 従来の処理 (HtmlFetcher::fetchParagraph()メソッドと同様)
+static QString legacy(const QStringList &texts)
+{
+    QString content = "";
+
+    for (auto buffer : texts) {
+        static QRegularExpression regex("[\\s]", QRegularExpression::CaseInsensitiveOption);
+        buffer = buffer.replace(regex, "");
+        buffer.replace(" ", "").replace("　", "");
+
+        content.append(buffer);
+    }
+
+    return content;
+}
+
+
+// TextNormalizerクラスを使用する処理
+static QString normalized(const QStringList &texts)
+{
+    const TextNormalizer normalizer;
+    QString content = "";
+
+    for (const auto &buffer : texts) {
+        content.append(normalizer.normalize(buffer));
+    }
+
+    return content;
+}
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    auto args       = app.arguments();
+    auto iterations = 200;
+    args.removeFirst();
+
+    if (args.size() >= 2 && args.at(0) == "-n") {
+        iterations = std::max(1, args.at(1).toInt());
+        args.removeFirst();
+        args.removeFirst();
+    }
+
+    if (args.isEmpty()) {
+        std::cerr << "使用方法 : qnewsflash_textbench [-n <繰り返し回数>] <HTMLファイル> ..." << std::endl;
+        return -1;
+    }
+
+    // HTMLファイルからテキストノードを抽出
+    QList<QStringList> pages;
+    qsizetype          totalChars = 0;
+
+    for (const auto &path : std::as_const(args)) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            std::cerr << QString("エラー : %1 のオープンに失敗 %2").arg(path, file.errorString()).toStdString() << std::endl;
+            return -1;
+        }
+
+        auto data = file.readAll();
+        file.close();
+
+        htmlDocPtr doc = htmlReadMemory(data.constData(), static_cast<int>(data.size()), nullptr, "UTF-8",
+                                        HTML_PARSE_RECOVER | HTML_PARSE_NOERROR | HTML_PARSE_NOWARNING);
+        if (doc == nullptr) {
+            std::cerr << QString("エラー : %1 のパースに失敗").arg(path).toStdString() << std::endl;
+            return -1;
+        }
+
+        QStringList texts;
+        collectText(xmlDocGetRootElement(doc), texts);
+        xmlFreeDoc(doc);
+
+        for (const auto &text : std::as_const(texts)) totalChars += text.size();
+        pages.append(texts);
+    }
+
+    // 結果が一致することを確認
+    for (auto i = 0; i < pages.size(); i++) {
+        if (legacy(pages.at(i)) != normalized(pages.at(i))) {
+            std::cerr << QString("エラー : %1 の処理結果が一致しません").arg(args.at(i)).toStdString() << std::endl;
+            return -1;
+        }
+    }
+
+    // 処理時間を計測
+    auto measure = [&](QString (*func)(const QStringList&)) -> qint64 {
+        qsizetype     sink = 0;
+        QElapsedTimer timer;
+        timer.start();
+
+        for (auto n = 0; n < iterations; n++) {
+            for (const auto &texts : std::as_const(pages)) sink += func(texts).size();
+        }
+
+        auto elapsed = timer.nsecsElapsed();
+        if (sink < 0) std::cout << sink << std::endl;   // 最適化による除去を防ぐ
+
+        return elapsed;
+    };
+
+    auto legacyNsec     = measure(legacy);
+    auto normalizedNsec = measure(normalized);
+    auto totalMB        = static_cast<double>(totalChars) * sizeof(char16_t) * iterations / (1024.0 * 1024.0);
+
+    std::cout << QString("ファイル数 : %1, 文字数 : %2, 繰り返し回数 : %3").arg(pages.size()).arg(totalChars).arg(iterations).toStdString() << std::endl;
+    std::cout << QString("正規表現       : %1 [ミリ秒] (%2 [MB/秒])").arg(legacyNsec / 1e6, 0, 'f', 2).arg(totalMB / (legacyNsec / 1e9), 0, 'f', 1).toStdString() << std::endl;
+    std::cout << QString("TextNormalizer : %1 [ミリ秒] (%2 [MB/秒])").arg(normalizedNsec / 1e6, 0, 'f', 2).arg(totalMB / (normalizedNsec / 1e9), 0, 'f', 1).toStdString() << std::endl;
+    std::cout << QString("速度比         : %1 倍").arg(static_cast<double>(legacyNsec) / std::max<qint64>(normalizedNsec, 1), 0, 'f', 2).toStdString() << std::endl;
+
+    return 0;
+}
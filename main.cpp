@@ -2,8 +2,9 @@
 #include <QTimer>
 #include <pwd.h>
 #include <unistd.h>
-#include <iostream>
 #include "Runner.h"
+#include "ParserPool.h"
+#include "Logger.h"
 
 
 int main(int argc, char *argv[])
@@ -18,7 +19,7 @@ int main(int argc, char *argv[])
         RunUser = QString::fromLocal8Bit(pw->pw_name);
     }
 
-    if (RunUser.isEmpty()) std::cerr << QString("エラー : 実行ユーザ名の取得に失敗しました").toStdString() << std::endl;
+    if (RunUser.isEmpty()) LOG_ERROR(QString("実行ユーザ名の取得に失敗しました"));
 
     // ランナーのインスタンス生成
     Runner runner(QCoreApplication::arguments(), RunUser);
@@ -30,5 +31,13 @@ int main(int argc, char *argv[])
     // ランナー開始
     QTimer::singleShot(0, &runner, &Runner::run);
 
-    return app.exec();
+    auto ret = app.exec();
+
+    // 全てのパース処理の完了を待機して、libxml2をクリーンアップ
+    ParserPool::getInstance()->shutdown();
+
+    // 出力用スレッドに残っているログを全て出力
+    Logger::getInstance()->flush();
+
+    return ret;
 }
@@ -0,0 +1,456 @@
+// qNewsFlashの主要なクラスの単体テスト (QtTest)
+// 使用方法 : qnewsflash_test [QtTestのオプション] [テスト名 ...]
+// ctestコマンドから実行する場合は、BUILD_TESTSオプションをONにしてビルドする
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QTimeZone>
+#include <QDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <memory>
+#include "../bench/HttpReplayServer.h"
+#include "../HttpReplay.h"
+#include "../TextNormalizer.h"
+#include "../DescriptionSanitizer.h"
+#include "../DuplicateIndex.h"
+#include "../PostedUrlFilter.h"
+#include "../ArticleSelector.h"
+
+
+#ifndef QNEWSFLASH_BENCH_CORPUS
+    #define QNEWSFLASH_BENCH_CORPUS "bench/corpus"
+#endif
+
+
+class CoreTest : public QObject
+{
+    Q_OBJECT
+
+private:    // Methods
+    static CandidatePool::CANDIDATE candidate(const QString &title, const QString &paragraph, const QString &source, const QString &date = QString());   // 書き込み候補を生成
+    static std::unique_ptr<QNetworkReply> replay(QNetworkAccessManager &manager, const HttpReplayServer &server, const QString &url);  // 再生サーバに元のURLを指定して取得 (完了まで待機)
+
+private slots:
+    void textNormalizerRemove();
+    void textNormalizerFold();
+    void textNormalizerTruncate();
+    void stripDateline_data();
+    void stripDateline();
+    void sanitize_data();
+    void sanitize();
+    void duplicateIndexNormalize();
+    void duplicateIndexIsDuplicate();
+    void duplicateIndexExpire();
+    void postedUrlFilterMemory();
+    void postedUrlFilterFile();
+    void articleSelectorScore();
+    void articleSelectorSelect();
+    void replayServer();
+};
+
+
+// 書き込み候補を生成
+CandidatePool::CANDIDATE CoreTest::candidate(const QString &title, const QString &paragraph, const QString &source, const QString &date)
+{
+    CandidatePool::CANDIDATE candidate;
+    candidate.Title     = title;
+    candidate.Paragraph = paragraph;
+    candidate.URL       = "https://example.com/" + title;
+    candidate.Date      = date;
+    candidate.Source    = source;
+    candidate.FetchedAt = QDateTime::currentMSecsSinceEpoch();
+
+    return candidate;
+}
+
+
+// 再生サーバに元のURLを指定して取得
+// 10秒以内に完了しない場合は、中断したレスポンスを返す
+std::unique_ptr<QNetworkReply> CoreTest::replay(QNetworkAccessManager &manager, const HttpReplayServer &server, const QString &url)
+{
+    QNetworkRequest request(QUrl(server.url() + "/"));
+    request.setRawHeader(HttpReplay::URL_HEADER, url.toUtf8());
+
+    std::unique_ptr<QNetworkReply> pReply(manager.get(request));
+
+    QEventLoop loop;
+    QTimer::singleShot(10000, &loop, &QEventLoop::quit);
+    QObject::connect(pReply.get(), &QNetworkReply::finished, &loop, &QEventLoop::quit);
+    if (!pReply->isFinished()) loop.exec();
+
+    if (!pReply->isFinished()) pReply->abort();
+
+    return pReply;
+}
+
+
+// ASCIIの空白文字、全角スペース、追加で指定した文字の除去
+// SIMDで処理するブロックをまたぐ長さの文字列も確認する
+void CoreTest::textNormalizerRemove()
+{
+    TextNormalizer normalizer;
+    QCOMPARE(normalizer.normalize(" a\tb　c\r\n"), QString("abc"));
+    QCOMPARE(normalizer.normalize(QString()), QString());
+
+    const auto longText = QString(40, u'x') + " \n" + QString(40, u'y');
+    QCOMPARE(normalizer.normalize(longText), QString(40, u'x') + QString(40, u'y'));
+
+    TextNormalizer extra(TextNormalizer::REMOVE, QString::fromUtf8("・"));
+    QCOMPARE(extra.normalize(QString::fromUtf8("速報・地震 情報")), QString::fromUtf8("速報地震情報"));
+}
+
+
+// 連続する空白文字を1つの半角スペースに置換 (先頭および末尾は除去)
+void CoreTest::textNormalizerFold()
+{
+    TextNormalizer normalizer(TextNormalizer::FOLD);
+    QCOMPARE(normalizer.normalize(QString::fromUtf8("  a \t b　　c  ")), QString("a b c"));
+
+    const auto longText = QString(20, u'x') + "\t\t\t" + QString(20, u'y') + "   ";
+    QCOMPARE(normalizer.normalize(longText), QString(20, u'x') + " " + QString(20, u'y'));
+
+    // 切り詰める位置の直前の半角スペースは残さない
+    QCOMPARE(normalizer.normalize("abc   def", 4), QString("abc..."));
+}
+
+
+// 指定文字数での切り詰め (サロゲートペアを分割しない)
+void CoreTest::textNormalizerTruncate()
+{
+    TextNormalizer normalizer;
+    QCOMPARE(normalizer.normalize("a b c d e f", 3), QString("abc..."));
+    QCOMPARE(normalizer.normalize("abc", 3), QString("abc"));
+    QCOMPARE(normalizer.normalize("abc", -1), QString("abc"));
+
+    const auto emoji = QString("ab") + QString::fromUcs4(U"\U0001F600") + "cd";
+    QCOMPARE(normalizer.normalize(emoji, 3), QString("ab..."));
+    QCOMPARE(TextNormalizer::truncate(emoji, 3), QString("ab..."));
+    QCOMPARE(TextNormalizer::truncate(emoji, 4), QString("ab") + QString::fromUcs4(U"\U0001F600") + "...");
+    QCOMPARE(TextNormalizer::truncate(emoji, -1), emoji);
+    QCOMPARE(TextNormalizer::truncate(emoji, 10), emoji);
+}
+
+
+void CoreTest::stripDateline_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("半角数字")       << QString::fromUtf8("2025年10月19日=1234本文")              << QString::fromUtf8("本文");
+    QTest::newRow("全角数字")       << QString::fromUtf8("２０２５年１月９日＝１，２３４本文")   << QString::fromUtf8("本文");
+    QTest::newRow("文字数が無い")   << QString::fromUtf8("2025年10月19日=本文")                  << QString::fromUtf8("2025年10月19日=本文");
+    QTest::newRow("年が3桁")        << QString::fromUtf8("202年10月19日=12本文")                 << QString::fromUtf8("202年10月19日=12本文");
+    QTest::newRow("先頭以外")       << QString::fromUtf8("本文2025年10月19日=12")                << QString::fromUtf8("本文2025年10月19日=12");
+    QTest::newRow("空文字列")       << QString()                                                 << QString();
+}
+
+
+// 先頭にある日付および文字数の削除
+void CoreTest::stripDateline()
+{
+    QFETCH(QString, text);
+    QFETCH(QString, expected);
+
+    QCOMPARE(DescriptionSanitizer::stripDateline(text), expected);
+}
+
+
+void CoreTest::sanitize_data()
+{
+    QTest::addColumn<QString>("html");
+    QTest::addColumn<int>("flags");
+    QTest::addColumn<QString>("expected");
+
+    const int all = DescriptionSanitizer::DROP_TABLE | DescriptionSanitizer::DROP_LINK | DescriptionSanitizer::DROP_BR;
+
+    QTest::newRow("brタグ")             << QString("a<br>b<br/>c<BR />d")                              << int(DescriptionSanitizer::DROP_BR)      << QString("abcd");
+    QTest::newRow("tableタグ")          << QString("x<table><tr><td>1</td></tr></table>y")             << int(DescriptionSanitizer::DROP_TABLE)   << QString("xy");
+    QTest::newRow("入れ子のtableタグ")  << QString("x<TABLE><table>1</table>2</TABLE>y")               << int(DescriptionSanitizer::DROP_TABLE)   << QString("xy");
+    QTest::newRow("aタグ")              << QString("before<a href=\"https://example.com/\">link</a>after") << int(DescriptionSanitizer::DROP_LINK) << QString("beforeafter");
+    QTest::newRow("類似のタグ名")       << QString("<abbr>t</abbr><tbody>u</tbody>")                   << all                                     << QString("<abbr>t</abbr><tbody>u</tbody>");
+    QTest::newRow("除去しないタグ")     << QString("<p>t<br>u</p>")                                    << 0                                       << QString("<p>t<br>u</p>");
+    QTest::newRow("閉じていないタグ")   << QString("a<table")                                          << all                                     << QString("a<table");
+}
+
+
+// 指定したHTMLタグの除去
+void CoreTest::sanitize()
+{
+    QFETCH(QString, html);
+    QFETCH(int, flags);
+    QFETCH(QString, expected);
+
+    QCOMPARE(DescriptionSanitizer::sanitize(html, flags), expected);
+}
+
+
+// NFKC正規化、大文字 / 小文字の統一、空白および記号の除去
+void CoreTest::duplicateIndexNormalize()
+{
+    QCOMPARE(DuplicateIndex::normalize(QString::fromUtf8("ＡＢＣ　ｄｅｆ！")), QString("abcdef"));
+    QCOMPARE(DuplicateIndex::normalize(QString::fromUtf8("ｶﾀｶﾅ、テスト。")), QString::fromUtf8("カタカナテスト"));
+
+    QCOMPARE(DuplicateIndex::simhash(QString()), 0ULL);
+    QCOMPARE(DuplicateIndex::simhash("a!"), 0ULL);
+    QCOMPARE(DuplicateIndex::simhash(QString::fromUtf8("震度5弱")), DuplicateIndex::simhash(QString::fromUtf8("震度５弱")));
+}
+
+
+// タイトルまたは本文が類似する書き込み済みのニュース記事の検出
+void CoreTest::duplicateIndexIsDuplicate()
+{
+    const auto title     = QString::fromUtf8("東京都で震度5弱の地震 津波の心配なし");
+    const auto paragraph = QString::fromUtf8("気象庁によると、19日午前10時ごろ、東京都23区で震度5弱の揺れを観測した。"
+                                             "震源は千葉県北西部で、地震の規模はマグニチュード5.2と推定される。");
+
+    DuplicateIndex index;
+    index.setDedupInfo(DEDUP_INFO());
+    QVERIFY(!index.isDuplicate(title));
+
+    index.add(title, paragraph, QDateTime::currentSecsSinceEpoch());
+
+    QVERIFY(index.isDuplicate(title));
+    QVERIFY(index.isDuplicate(QString::fromUtf8("東京都で震度５弱の地震　津波の心配なし")));
+    QVERIFY(index.isDuplicate(QString::fromUtf8("首都圏で強い揺れ"), paragraph));
+    QVERIFY(!index.isDuplicate(QString::fromUtf8("大阪の株価が大幅に上昇 日経平均は最高値")));
+    QVERIFY(!index.isDuplicate(QString::fromUtf8("衆議院が解散 来月に総選挙へ"), QString::fromUtf8("首相は本日、衆議院を解散した。")));
+
+    // 無効の場合は登録および検出しない
+    DEDUP_INFO disabled;
+    disabled.Enable = false;
+
+    DuplicateIndex disabledIndex;
+    disabledIndex.setDedupInfo(disabled);
+    disabledIndex.add(title, paragraph, QDateTime::currentSecsSinceEpoch());
+    QVERIFY(!disabledIndex.isDuplicate(title));
+}
+
+
+// 比較する期間を過ぎたニュース記事は類似と見なさない
+void CoreTest::duplicateIndexExpire()
+{
+    const auto title = QString::fromUtf8("東京都で震度5弱の地震 津波の心配なし");
+    const auto now   = QDateTime::currentSecsSinceEpoch();
+
+    DEDUP_INFO info;
+    info.Hours = 6;
+
+    // 期間外の時刻で登録した場合 (削除前でも比較しない)
+    DuplicateIndex index;
+    index.setDedupInfo(info);
+    index.add(title, QString(), now - 7 * 60 * 60);
+    QVERIFY(!index.isDuplicate(title));
+
+    // 期間内に登録して、期間を過ぎた後に削除した場合
+    index.add(title, QString(), now);
+    QVERIFY(index.isDuplicate(title));
+
+    index.expire(now + 7 * 60 * 60);
+    QVERIFY(!index.isDuplicate(title));
+}
+
+
+// ファイルを指定しない場合は、メモリ上に記録する
+void CoreTest::postedUrlFilterMemory()
+{
+    PostedUrlFilter filter;
+    filter.setPostedFilterInfo(POSTEDFILTER_INFO());
+    QCOMPARE(filter.open(), 0);
+
+    QVERIFY(!filter.contains("https://www.jiji.com/jc/article?k=2025101900198&g=soc"));
+
+    filter.add("https://www.jiji.com/jc/article?k=2025101900198&g=soc");
+    QVERIFY(filter.contains("https://www.jiji.com/jc/article?k=2025101900198&g=soc"));
+    QVERIFY(!filter.contains("https://www.jiji.com/jc/article?k=2025101900199&g=soc"));
+    QVERIFY(!filter.contains(QString()));
+
+    // 無効の場合は記録しない
+    POSTEDFILTER_INFO disabled;
+    disabled.Enable = false;
+
+    PostedUrlFilter disabledFilter;
+    disabledFilter.setPostedFilterInfo(disabled);
+    QCOMPARE(disabledFilter.open(), 0);
+    disabledFilter.add("https://example.com/");
+    QVERIFY(!disabledFilter.contains("https://example.com/"));
+}
+
+
+// ファイルに記録したURLは再度開いた後も判定できる
+// 他のインスタンスが使用中のファイルは共有せず、セグメント数が異なる場合は作成し直す
+void CoreTest::postedUrlFilterFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    POSTEDFILTER_INFO info;
+    info.File = dir.filePath("posted.bloom");
+
+    const QString url = "https://www.asahi.com/articles/ASV1234567.html";
+
+    {
+        PostedUrlFilter filter;
+        filter.setPostedFilterInfo(info);
+        QCOMPARE(filter.open(), 0);
+        filter.add(url);
+
+        // 使用中のファイルはロックされているため、メモリ上に記録する
+        PostedUrlFilter other;
+        other.setPostedFilterInfo(info);
+        QCOMPARE(other.open(), 0);
+        QVERIFY(!other.contains(url));
+    }
+
+    {
+        PostedUrlFilter filter;
+        filter.setPostedFilterInfo(info);
+        QCOMPARE(filter.open(), 0);
+        QVERIFY(filter.contains(url));
+    }
+
+    info.Horizon = 7;
+    PostedUrlFilter resized;
+    resized.setPostedFilterInfo(info);
+    QCOMPARE(resized.open(), 0);
+    QVERIFY(!resized.contains(url));
+}
+
+
+// 公開日からの経過時間、ニュースサイトの重み、タイトルの類似度、本文の有無によるスコア
+void CoreTest::articleSelectorScore()
+{
+    ArticleSelector selector;
+
+    SELECTION_INFO info;
+    info.Weights.insert("jiji", 2.0);
+    info.Weights.insert("muted", 0.0);
+    selector.setSelectionInfo(info);
+
+    const auto now    = QDateTime::currentDateTimeUtc().toTimeZone(QTimeZone("Asia/Tokyo"));
+    const auto format = QString::fromUtf8("yyyy年M月d日 H時m分");
+    const auto title  = QString::fromUtf8("東京都で震度5弱の地震");
+
+    const auto fresh = selector.score(candidate(title, "p", "asahi", now.toString(format)), {}, now);
+    const auto old   = selector.score(candidate(title, "p", "asahi", now.addSecs(-6 * 60 * 60).toString(format)), {}, now);
+    QVERIFY(fresh > old);
+    QVERIFY(old > 0.0);
+
+    // ニュースサイトの重み
+    const auto weighted = selector.score(candidate(title, "p", "jiji", now.toString(format)), {}, now);
+    QVERIFY(qFuzzyCompare(weighted, fresh * 2.0));
+    QCOMPARE(selector.score(candidate(title, "p", "muted", now.toString(format)), {}, now), 0.0);
+
+    // 本文が無いニュース記事
+    const auto noParagraph = selector.score(candidate(title, " ", "asahi", now.toString(format)), {}, now);
+    QVERIFY(qFuzzyCompare(noParagraph, fresh * info.NoParagraph));
+}
+
+
+// 候補プールからの選択
+void CoreTest::articleSelectorSelect()
+{
+    ArticleSelector selector;
+    QCOMPARE(selector.select({}, {}), -1);
+
+    // 重みが0のニュースサイトは選択しない
+    SELECTION_INFO weightedInfo;
+    weightedInfo.Seed = 1;
+    weightedInfo.Weights.insert("muted", 0.0);
+    selector.setSelectionInfo(weightedInfo);
+
+    const QList<CandidatePool::CANDIDATE> candidates = {
+        candidate(QString::fromUtf8("東京都で震度5弱の地震"), "p", "muted"),
+        candidate(QString::fromUtf8("大阪の株価が大幅に上昇"), "p", "asahi"),
+    };
+    for (auto i = 0; i < 50; i++) {
+        QCOMPARE(selector.select(candidates, {}), 1);
+    }
+
+    // 上位1件のみを候補とする場合は、直近に書き込んだタイトルと同じニュース記事を選択しない
+    SELECTION_INFO topInfo;
+    topInfo.Mode = "top";
+    topInfo.TopK = 1;
+    selector.setSelectionInfo(topInfo);
+
+    const QList<CandidatePool::CANDIDATE> topics = {
+        candidate(QString::fromUtf8("東京都で震度5弱の地震"), "p", "asahi"),
+        candidate(QString::fromUtf8("大阪の株価が大幅に上昇"), "p", "asahi"),
+    };
+    QCOMPARE(selector.select(topics, {QString::fromUtf8("東京都で震度5弱の地震")}), 1);
+    QCOMPARE(selector.select(topics, {QString::fromUtf8("大阪の株価が大幅に上昇")}), 0);
+
+    // 同じシード値の場合は、同じ順序で選択する
+    SELECTION_INFO uniformInfo;
+    uniformInfo.Mode = "uniform";
+    uniformInfo.Seed = 42;
+
+    QList<CandidatePool::CANDIDATE> many;
+    for (auto i = 0; i < 10; i++) many.append(candidate(QString::number(i), "p", "asahi"));
+
+    ArticleSelector first, second;
+    first.setSelectionInfo(uniformInfo);
+    second.setSelectionInfo(uniformInfo);
+    for (auto i = 0; i < 20; i++) {
+        const auto index = first.select(many, {});
+        QVERIFY(index >= 0 && index < many.size());
+        QCOMPARE(second.select(many, {}), index);
+    }
+}
+
+
+// 再生サーバは、コーパスに記録したレスポンスを元のURLごとに返す
+// 記録していないURLはHTTP 404を返して、エラーの確率を指定した場合はエラーを注入する
+void CoreTest::replayServer()
+{
+    const QString directory = QNEWSFLASH_BENCH_CORPUS;
+
+    HttpReplayServer server;
+    QVERIFY(server.load(directory) > 0);
+    QVERIFY(server.listen());
+
+    // 記録したレスポンスのうち1つ
+    QDir       dir(directory);
+    const auto metaName = dir.entryList({"*.json"}, QDir::Files, QDir::Name).value(0);
+
+    QFile metaFile(dir.filePath(metaName));
+    QVERIFY(metaFile.open(QIODevice::ReadOnly));
+    const auto meta = QJsonDocument::fromJson(metaFile.readAll()).object();
+
+    QFile bodyFile(dir.filePath(meta["body"].toString()));
+    QVERIFY(bodyFile.open(QIODevice::ReadOnly));
+    const auto body = bodyFile.readAll();
+
+    QNetworkAccessManager manager;
+
+    auto pReply = replay(manager, server, meta["url"].toString());
+    QVERIFY(pReply->isFinished());
+    QCOMPARE(pReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(), meta["status"].toInt(200));
+    QCOMPARE(pReply->readAll(), body);
+
+    pReply = replay(manager, server, "https://example.com/not-recorded");
+    QVERIFY(pReply->isFinished());
+    QCOMPARE(pReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(), 404);
+
+    auto stats = server.stats();
+    QCOMPARE(stats.Requests, 2LL);
+    QCOMPARE(stats.Misses, 1LL);
+    QCOMPARE(stats.Bytes, static_cast<qint64>(body.size()));
+
+    // 全てのリクエストにエラーを注入
+    REPLAYSERVER_INFO info;
+    info.ErrorRate = 1.0;
+    server.setServerInfo(info);
+
+    pReply = replay(manager, server, meta["url"].toString());
+    QVERIFY(pReply->isFinished());
+    QVERIFY(pReply->error() != QNetworkReply::NoError);
+    QCOMPARE(server.stats().Errors, 1LL);
+}
+
+
+QTEST_GUILESS_MAIN(CoreTest)
+
+#include "CoreTest.moc"